@@ -58,6 +58,7 @@ set(lib_list
     etdump
     bundled_program
     extension_data_loader
+    extension_prefetching_data_loader
     ${FLATCCRT_LIB}
     coremldelegate
     mpsdelegate
@@ -69,6 +70,7 @@ set(lib_list
     extension_runner_util
     extension_tensor
     extension_threadpool
+    extension_parallel
     extension_training
     xnnpack_backend
     # Start XNNPACK Lib Deps
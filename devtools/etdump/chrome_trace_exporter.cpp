@@ -0,0 +1,319 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/devtools/etdump/chrome_trace_exporter.h>
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include <executorch/devtools/etdump/etdump_schema_flatcc_reader.h>
+#include <executorch/devtools/etdump/etdump_schema_flatcc_verifier.h>
+#include <executorch/runtime/platform/assert.h>
+
+using ::executorch::runtime::Error;
+
+namespace executorch {
+namespace etdump {
+
+namespace {
+
+// Lanes of the process that holds the events of an ETDump.
+constexpr int kRuntimeTid = 1;
+constexpr int kDelegateTid = 2;
+
+void append_escaped(std::string& out, const char* str, size_t length) {
+  out += '"';
+  for (size_t i = 0; i < length; ++i) {
+    const char c = str[i];
+    switch (c) {
+      case '"':
+        out += "\\\"";
+        break;
+      case '\\':
+        out += "\\\\";
+        break;
+      case '\n':
+        out += "\\n";
+        break;
+      case '\t':
+        out += "\\t";
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          char escaped[8];
+          snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+          out += escaped;
+        } else {
+          out += c;
+        }
+    }
+  }
+  out += '"';
+}
+
+void append_escaped(std::string& out, const char* str) {
+  append_escaped(out, str, strlen(str));
+}
+
+} // namespace
+
+ChromeTraceWriter::ChromeTraceWriter(et_tick_ratio_t ticks_to_ns)
+    : ticks_to_ns_(ticks_to_ns) {
+  ET_CHECK_MSG(
+      ticks_to_ns_.denominator != 0, "Tick ratio denominator must be nonzero");
+}
+
+Error ChromeTraceWriter::add_etdump(const void* data, size_t size) {
+  ET_CHECK_OR_RETURN_ERROR(
+      data != nullptr, InvalidArgument, "ETDump data is null");
+  ET_CHECK_OR_RETURN_ERROR(
+      size >= sizeof(flatbuffers_uoffset_t) + FLATBUFFERS_IDENTIFIER_SIZE +
+              sizeof(flatbuffers_uoffset_t),
+      InvalidArgument,
+      "ETDump of %zu bytes is too small",
+      size);
+  size_t buffer_size = 0;
+  void* buffer =
+      flatbuffers_read_size_prefix(const_cast<void*>(data), &buffer_size);
+  ET_CHECK_OR_RETURN_ERROR(
+      buffer_size <= size - sizeof(flatbuffers_uoffset_t),
+      InvalidArgument,
+      "ETDump size prefix %zu exceeds buffer size %zu",
+      buffer_size,
+      size);
+  ET_CHECK_OR_RETURN_ERROR(
+      flatbuffers_has_identifier(buffer, etdump_ETDump_file_identifier),
+      InvalidArgument,
+      "Buffer is not an ETDump");
+  // The reader trusts every offset in the buffer, so check them all first.
+  const int verify_result = etdump_ETDump_verify_as_root_with_identifier(
+      buffer, buffer_size, etdump_ETDump_file_identifier);
+  ET_CHECK_OR_RETURN_ERROR(
+      verify_result == flatcc_verify_ok,
+      InvalidArgument,
+      "ETDump failed verification: %s",
+      flatcc_verify_error_string(verify_result));
+  etdump_ETDump_table_t etdump = etdump_ETDump_as_root_with_identifier(
+      buffer, etdump_ETDump_file_identifier);
+  ET_CHECK_OR_RETURN_ERROR(
+      etdump != nullptr, InvalidArgument, "Failed to read ETDump root");
+
+  const int pid = next_pid_++;
+  add_process(pid, "ETDump");
+  add_thread(pid, kRuntimeTid, "Runtime");
+  add_thread(pid, kDelegateTid, "Delegate");
+
+  etdump_RunData_vec_t run_data_vec = etdump_ETDump_run_data(etdump);
+  for (size_t run = 0; run < etdump_RunData_vec_len(run_data_vec); ++run) {
+    etdump_RunData_table_t run_data = etdump_RunData_vec_at(run_data_vec, run);
+
+    // Shared by all events of this run.
+    std::string run_args = "\"run\":";
+    run_args += std::to_string(run);
+    flatbuffers_string_t run_name = etdump_RunData_name(run_data);
+    if (run_name != nullptr) {
+      run_args += ",\"block\":";
+      append_escaped(run_args, run_name, flatbuffers_string_len(run_name));
+    }
+
+    etdump_Event_vec_t events = etdump_RunData_events(run_data);
+    for (size_t i = 0; i < etdump_Event_vec_len(events); ++i) {
+      etdump_ProfileEvent_table_t profile_event =
+          etdump_Event_profile_event(etdump_Event_vec_at(events, i));
+      if (profile_event == nullptr) {
+        continue;
+      }
+      std::string args = run_args;
+      args += ",\"chain\":";
+      args += std::to_string(etdump_ProfileEvent_chain_index(profile_event));
+      args += ",\"instruction\":";
+      args += std::to_string(etdump_ProfileEvent_instruction_id(profile_event));
+
+      const int32_t delegate_id_int =
+          etdump_ProfileEvent_delegate_debug_id_int(profile_event);
+      flatbuffers_string_t delegate_id_str =
+          etdump_ProfileEvent_delegate_debug_id_str(profile_event);
+      const et_timestamp_t start_time =
+          etdump_ProfileEvent_start_time(profile_event);
+      const et_timestamp_t end_time =
+          etdump_ProfileEvent_end_time(profile_event);
+
+      if (delegate_id_str != nullptr) {
+        add_complete_event(
+            pid,
+            kDelegateTid,
+            delegate_id_str,
+            flatbuffers_string_len(delegate_id_str),
+            "delegate",
+            start_time,
+            end_time,
+            args);
+      } else if (delegate_id_int != -1) {
+        // Unnamed delegate events are identified by their debug index, which
+        // maps back to the delegate's debug handle map.
+        const std::string name =
+            "delegate_debug_id_" + std::to_string(delegate_id_int);
+        args += ",\"delegate_debug_id\":";
+        args += std::to_string(delegate_id_int);
+        add_complete_event(
+            pid,
+            kDelegateTid,
+            name.c_str(),
+            name.size(),
+            "delegate",
+            start_time,
+            end_time,
+            args);
+      } else {
+        flatbuffers_string_t name = etdump_ProfileEvent_name(profile_event);
+        add_complete_event(
+            pid,
+            kRuntimeTid,
+            name != nullptr ? name : "",
+            name != nullptr ? flatbuffers_string_len(name) : 0,
+            "runtime",
+            start_time,
+            end_time,
+            args);
+      }
+    }
+  }
+  return Error::Ok;
+}
+
+void ChromeTraceWriter::add_ring_buffer(
+    const RingBufferEventTracer& tracer,
+    const char* process_name) {
+  std::vector<ProfilingRecord> records;
+  std::vector<size_t> thread_indices;
+  tracer.copy_records(records, &thread_indices);
+
+  const int pid = next_pid_++;
+  add_process(pid, process_name);
+  size_t num_threads = 0;
+  for (size_t i = 0; i < records.size(); ++i) {
+    const ProfilingRecord& record = records[i];
+    const size_t thread_index = thread_indices[i];
+    // Lanes start at 1 since some viewers treat tid 0 specially.
+    const int tid = static_cast<int>(thread_index) + 1;
+    // Records are grouped by thread in order of thread index.
+    while (num_threads <= thread_index) {
+      const std::string name = "Thread " + std::to_string(num_threads);
+      add_thread(pid, static_cast<int>(num_threads) + 1, name.c_str());
+      num_threads++;
+    }
+
+    std::string args = "\"debug_handle\":";
+    args += std::to_string(record.debug_handle);
+    if (!record.is_delegate) {
+      args += ",\"chain\":";
+      args += std::to_string(record.chain_id);
+    }
+    const char* name = tracer.get_name(record.name_index);
+    std::string unnamed;
+    if (name == nullptr) {
+      // Unnamed delegate events carry their delegate debug index. Runtime
+      // events lose their name when the name table is full, and carry the
+      // instruction's debug handle.
+      unnamed = record.is_delegate ? "delegate_debug_id_" : "debug_handle_";
+      unnamed += std::to_string(record.debug_handle);
+      name = unnamed.c_str();
+    }
+    add_complete_event(
+        pid,
+        tid,
+        name,
+        strlen(name),
+        record.is_delegate ? "delegate" : "runtime",
+        record.start_time,
+        record.end_time,
+        args);
+  }
+}
+
+std::string ChromeTraceWriter::json() const {
+  std::string out = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+  out += events_;
+  out += "\n]}\n";
+  return out;
+}
+
+void ChromeTraceWriter::add_process(int pid, const char* name) {
+  begin_event();
+  events_ += "{\"ph\":\"M\",\"name\":\"process_name\",\"pid\":";
+  events_ += std::to_string(pid);
+  events_ += ",\"args\":{\"name\":";
+  append_escaped(events_, name);
+  events_ += "}}";
+}
+
+void ChromeTraceWriter::add_thread(int pid, int tid, const char* name) {
+  begin_event();
+  events_ += "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":";
+  events_ += std::to_string(pid);
+  events_ += ",\"tid\":";
+  events_ += std::to_string(tid);
+  events_ += ",\"args\":{\"name\":";
+  append_escaped(events_, name);
+  events_ += "}}";
+}
+
+void ChromeTraceWriter::add_complete_event(
+    int pid,
+    int tid,
+    const char* name,
+    size_t name_length,
+    const char* category,
+    et_timestamp_t start_time,
+    et_timestamp_t end_time,
+    const std::string& args) {
+  begin_event();
+  events_ += "{\"ph\":\"X\",\"name\":";
+  append_escaped(events_, name, name_length);
+  events_ += ",\"cat\":\"";
+  events_ += category;
+  events_ += "\",\"pid\":";
+  events_ += std::to_string(pid);
+  events_ += ",\"tid\":";
+  events_ += std::to_string(tid);
+  events_ += ",\"ts\":";
+  append_timestamp(start_time);
+  events_ += ",\"dur\":";
+  // Clamp events whose clock went backwards, e.g. across cores.
+  append_timestamp(end_time > start_time ? end_time - start_time : 0);
+  events_ += ",\"args\":{";
+  events_ += args;
+  events_ += "}}";
+  num_events_++;
+}
+
+void ChromeTraceWriter::append_timestamp(et_timestamp_t ticks) {
+  // Chrome traces are in microseconds; keep nanosecond precision.
+  const uint64_t ns = static_cast<uint64_t>(ticks) * ticks_to_ns_.numerator /
+      ticks_to_ns_.denominator;
+  char buffer[32];
+  snprintf(
+      buffer,
+      sizeof(buffer),
+      "%" PRIu64 ".%03" PRIu64,
+      ns / 1000,
+      ns % 1000);
+  events_ += buffer;
+}
+
+void ChromeTraceWriter::begin_event() {
+  if (!events_.empty()) {
+    events_ += ',';
+  }
+  events_ += '\n';
+}
+
+} // namespace etdump
+} // namespace executorch
@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include <executorch/devtools/etdump/ring_buffer_event_tracer.h>
+#include <executorch/runtime/core/error.h>
+#include <executorch/runtime/platform/platform.h>
+
+namespace executorch {
+namespace etdump {
+
+/**
+ * Converts profiling events into the Chrome trace event JSON format, which
+ * can be opened in Perfetto (https://ui.perfetto.dev) or chrome://tracing.
+ *
+ * Every profiling event becomes a complete ("X") event. Events from an
+ * ETDump are placed in one process with two lanes: operator and runtime
+ * events, and delegate events logged through `start/end_profiling_delegate()`
+ * or `log_profiling_delegate()`. Delegate events get their own lane because
+ * delegates may report timestamps from their own clock, which need not nest
+ * inside the runtime's DELEGATE_CALL event. ETDump does not record which
+ * thread logged an event, so events from a RingBufferEventTracer are placed in
+ * a separate process with one lane per logging thread, e.g. per threadpool
+ * worker.
+ *
+ * Several sources can be added to the same trace; their timestamps share a
+ * timeline as long as they were recorded with the same clock.
+ */
+class ChromeTraceWriter final {
+ public:
+  /**
+   * @param[in] ticks_to_ns The ratio to convert the recorded timestamps from
+   *     ticks to nanoseconds. Defaults to the ratio of the current platform,
+   *     which is only correct if the events were recorded on the same kind of
+   *     device.
+   */
+  explicit ChromeTraceWriter(
+      et_tick_ratio_t ticks_to_ns = et_pal_ticks_to_ns_multiplier());
+
+  /**
+   * Adds the profiling events of an ETDump, as returned by
+   * `ETDumpGen::get_etdump_data()`. Debug and allocation events are skipped.
+   *
+   * @param[in] data The size-prefixed ETDump flatbuffer.
+   * @param[in] size The size of `data` in bytes.
+   *
+   * @returns Error::InvalidArgument if the buffer is not an ETDump, else
+   *     Error::Ok.
+   */
+  ET_NODISCARD ::executorch::runtime::Error add_etdump(
+      const void* data,
+      size_t size);
+
+  /**
+   * Adds the events currently held by a RingBufferEventTracer.
+   *
+   * @param[in] tracer The tracer to read. May be logging concurrently.
+   * @param[in] process_name Name of the process the thread lanes are grouped
+   *     under.
+   */
+  void add_ring_buffer(
+      const RingBufferEventTracer& tracer,
+      const char* process_name = "RingBufferEventTracer");
+
+  /**
+   * Returns the number of trace events added so far, excluding metadata.
+   */
+  size_t num_events() const {
+    return num_events_;
+  }
+
+  /**
+   * Returns the trace as a JSON document.
+   */
+  std::string json() const;
+
+ private:
+  void add_process(int pid, const char* name);
+  void add_thread(int pid, int tid, const char* name);
+  void add_complete_event(
+      int pid,
+      int tid,
+      const char* name,
+      size_t name_length,
+      const char* category,
+      et_timestamp_t start_time,
+      et_timestamp_t end_time,
+      const std::string& args);
+  void append_timestamp(et_timestamp_t ticks);
+  void begin_event();
+
+  const et_tick_ratio_t ticks_to_ns_;
+  std::string events_;
+  size_t num_events_ = 0;
+  int next_pid_ = 1;
+};
+
+} // namespace etdump
+} // namespace executorch
@@ -0,0 +1,433 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/devtools/etdump/ring_buffer_event_tracer.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <map>
+#include <tuple>
+#include <type_traits>
+
+#include <executorch/runtime/platform/clock.h>
+
+using ::executorch::runtime::ChainID;
+using ::executorch::runtime::DebugHandle;
+using ::executorch::runtime::DelegateDebugIdType;
+using ::executorch::runtime::EventTracerEntry;
+using ::executorch::runtime::kUnsetChainId;
+using ::executorch::runtime::kUnsetDebugHandle;
+
+namespace executorch {
+namespace etdump {
+
+namespace {
+
+// Size of the open-addressing name table. Twice the name limit keeps probe
+// sequences short.
+constexpr size_t kNameTableSize = 2 * RingBufferEventTracer::kMaxNames;
+
+// Marks entries returned for events in executions that are not sampled.
+constexpr int64_t kUnsampledEventId = -1;
+
+std::atomic<uint64_t> next_instance_id{1};
+
+// Caches the ring of the tracer that the current thread last logged to, so
+// that the common case doesn't touch the registry.
+struct ThreadRingCache {
+  uint64_t instance_id = 0;
+  void* ring = nullptr;
+};
+thread_local ThreadRingCache thread_ring_cache;
+
+// FNV-1a over at most `max_length` characters. Never returns zero, which marks
+// empty slots.
+uint64_t hash_name(const char* name, size_t max_length) {
+  uint64_t hash = 14695981039346656037ull;
+  for (size_t i = 0; i < max_length && name[i] != '\0'; ++i) {
+    hash ^= static_cast<uint8_t>(name[i]);
+    hash *= 1099511628211ull;
+  }
+  return hash | 1;
+}
+
+size_t round_up_to_power_of_2(size_t value) {
+  size_t result = 1;
+  while (result < value) {
+    result <<= 1;
+  }
+  return result;
+}
+
+} // namespace
+
+struct RingBufferEventTracer::NameSlot {
+  // Zero while the slot is empty. Published last, with release semantics, so
+  // that readers that observe it also observe `name`.
+  std::atomic<uint64_t> hash{0};
+  char name[kMaxNameLength];
+};
+
+struct RingBufferEventTracer::ThreadRing {
+  struct Slot {
+    static_assert(
+        std::is_trivially_copyable<ProfilingRecord>::value,
+        "ProfilingRecord is copied as raw words");
+    static constexpr size_t kNumWords =
+        (sizeof(ProfilingRecord) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    // Readers may copy a record while it is being overwritten, so it is
+    // stored as relaxed atomic words; the sequence tells them to discard it.
+    void store(const ProfilingRecord& record) {
+      uint64_t words[kNumWords] = {};
+      std::memcpy(words, &record, sizeof(record));
+      for (size_t i = 0; i < kNumWords; ++i) {
+        record_words[i].store(words[i], std::memory_order_relaxed);
+      }
+    }
+
+    ProfilingRecord load() const {
+      uint64_t words[kNumWords];
+      for (size_t i = 0; i < kNumWords; ++i) {
+        words[i] = record_words[i].load(std::memory_order_relaxed);
+      }
+      ProfilingRecord record;
+      std::memcpy(&record, words, sizeof(record));
+      return record;
+    }
+
+    // Odd while the record is being written.
+    std::atomic<uint32_t> sequence{0};
+    std::atomic<uint64_t> record_words[kNumWords] = {};
+  };
+
+  ThreadRing(std::thread::id thread_id_, size_t capacity)
+      : thread_id(thread_id_), slots(new Slot[capacity]), mask(capacity - 1) {}
+
+  const std::thread::id thread_id;
+  const std::unique_ptr<Slot[]> slots;
+  const size_t mask;
+  // Total number of records ever written; only the owning thread writes it.
+  std::atomic<uint64_t> write_index{0};
+};
+
+RingBufferEventTracer::RingBufferEventTracer(
+    size_t records_per_thread,
+    uint32_t sample_every)
+    : instance_id_(next_instance_id.fetch_add(1)),
+      records_per_thread_(
+          round_up_to_power_of_2(std::max<size_t>(records_per_thread, 1))),
+      sample_every_(std::max<uint32_t>(sample_every, 1)),
+      names_(new NameSlot[kNameTableSize]) {}
+
+RingBufferEventTracer::~RingBufferEventTracer() = default;
+
+void RingBufferEventTracer::set_sample_every(uint32_t sample_every) {
+  sample_every_.store(std::max<uint32_t>(sample_every, 1));
+}
+
+void RingBufferEventTracer::create_event_block(const char* name) {
+  (void)name;
+  const uint64_t block = num_blocks_.fetch_add(1, std::memory_order_relaxed);
+  sampling_.store(
+      block % sample_every_.load(std::memory_order_relaxed) == 0,
+      std::memory_order_relaxed);
+}
+
+EventTracerEntry RingBufferEventTracer::start_profiling(
+    const char* name,
+    ChainID chain_id,
+    DebugHandle debug_handle) {
+  EventTracerEntry entry;
+  entry.delegate_event_id_type = DelegateDebugIdType::kNone;
+  if (!sampling_.load(std::memory_order_relaxed)) {
+    entry.event_id = kUnsampledEventId;
+    return entry;
+  }
+  if (chain_id == kUnsetChainId && debug_handle == kUnsetDebugHandle) {
+    chain_id = chain_id_;
+    debug_handle = debug_handle_;
+  }
+  entry.event_id = intern_name(name);
+  entry.chain_id = chain_id;
+  entry.debug_handle = debug_handle;
+  entry.start_time = et_pal_current_ticks();
+  return entry;
+}
+
+void RingBufferEventTracer::end_profiling(EventTracerEntry prof_entry) {
+  if (prof_entry.event_id == kUnsampledEventId) {
+    return;
+  }
+  record(ProfilingRecord{
+      prof_entry.start_time,
+      et_pal_current_ticks(),
+      static_cast<uint32_t>(prof_entry.event_id),
+      prof_entry.debug_handle,
+      prof_entry.chain_id,
+      /*is_delegate=*/false});
+}
+
+EventTracerEntry RingBufferEventTracer::start_profiling_delegate(
+    const char* name,
+    DebugHandle delegate_debug_index) {
+  EventTracerEntry entry;
+  if (!sampling_.load(std::memory_order_relaxed)) {
+    entry.event_id = kUnsampledEventId;
+    entry.delegate_event_id_type = DelegateDebugIdType::kNone;
+    return entry;
+  }
+  entry.event_id = intern_name(name);
+  entry.delegate_event_id_type =
+      name != nullptr ? DelegateDebugIdType::kStr : DelegateDebugIdType::kInt;
+  entry.chain_id = kUnsetChainId;
+  entry.debug_handle = delegate_debug_index;
+  entry.start_time = et_pal_current_ticks();
+  return entry;
+}
+
+void RingBufferEventTracer::end_profiling_delegate(
+    EventTracerEntry prof_entry,
+    const void* metadata,
+    size_t metadata_len) {
+  (void)metadata;
+  (void)metadata_len;
+  if (prof_entry.event_id == kUnsampledEventId) {
+    return;
+  }
+  record(ProfilingRecord{
+      prof_entry.start_time,
+      et_pal_current_ticks(),
+      static_cast<uint32_t>(prof_entry.event_id),
+      prof_entry.debug_handle,
+      kUnsetChainId,
+      /*is_delegate=*/true});
+}
+
+void RingBufferEventTracer::log_profiling_delegate(
+    const char* name,
+    DebugHandle delegate_debug_index,
+    et_timestamp_t start_time,
+    et_timestamp_t end_time,
+    const void* metadata,
+    size_t metadata_len) {
+  (void)metadata;
+  (void)metadata_len;
+  if (!sampling_.load(std::memory_order_relaxed)) {
+    return;
+  }
+  record(ProfilingRecord{
+      start_time,
+      end_time,
+      intern_name(name),
+      delegate_debug_index,
+      kUnsetChainId,
+      /*is_delegate=*/true});
+}
+
+uint32_t RingBufferEventTracer::intern_name(const char* name) {
+  if (name == nullptr) {
+    return kNoName;
+  }
+  constexpr size_t kMaxChars = kMaxNameLength - 1;
+  const uint64_t hash = hash_name(name, kMaxChars);
+  const size_t mask = kNameTableSize - 1;
+
+  // Lock-free lookup; names are never removed, so a hit stays valid.
+  for (size_t probe = 0; probe < kNameTableSize; ++probe) {
+    const size_t index = (hash + probe) & mask;
+    const uint64_t slot_hash = names_[index].hash.load(std::memory_order_acquire);
+    if (slot_hash == 0) {
+      break;
+    }
+    if (slot_hash == hash &&
+        std::strncmp(names_[index].name, name, kMaxChars) == 0) {
+      return static_cast<uint32_t>(index);
+    }
+  }
+
+  // Slow path: insert under the lock, re-probing in case another thread got
+  // there first.
+  std::lock_guard<std::mutex> lock(registry_mutex_);
+  for (size_t probe = 0; probe < kNameTableSize; ++probe) {
+    const size_t index = (hash + probe) & mask;
+    NameSlot& slot = names_[index];
+    const uint64_t slot_hash = slot.hash.load(std::memory_order_relaxed);
+    if (slot_hash == hash && std::strncmp(slot.name, name, kMaxChars) == 0) {
+      return static_cast<uint32_t>(index);
+    }
+    if (slot_hash == 0) {
+      if (num_names_.load(std::memory_order_relaxed) >= kMaxNames) {
+        return kNoName;
+      }
+      std::strncpy(slot.name, name, kMaxChars);
+      slot.name[kMaxChars] = '\0';
+      num_names_.fetch_add(1, std::memory_order_relaxed);
+      slot.hash.store(hash, std::memory_order_release);
+      return static_cast<uint32_t>(index);
+    }
+  }
+  return kNoName;
+}
+
+const char* RingBufferEventTracer::get_name(uint32_t name_index) const {
+  if (name_index >= kNameTableSize ||
+      names_[name_index].hash.load(std::memory_order_acquire) == 0) {
+    return nullptr;
+  }
+  return names_[name_index].name;
+}
+
+RingBufferEventTracer::ThreadRing* RingBufferEventTracer::get_thread_ring() {
+  if (thread_ring_cache.instance_id == instance_id_) {
+    return static_cast<ThreadRing*>(thread_ring_cache.ring);
+  }
+  const std::thread::id thread_id = std::this_thread::get_id();
+  std::lock_guard<std::mutex> lock(registry_mutex_);
+  ThreadRing* ring = nullptr;
+  for (const auto& candidate : rings_) {
+    if (candidate->thread_id == thread_id) {
+      ring = candidate.get();
+      break;
+    }
+  }
+  if (ring == nullptr) {
+    rings_.emplace_back(new ThreadRing(thread_id, records_per_thread_));
+    ring = rings_.back().get();
+  }
+  thread_ring_cache.instance_id = instance_id_;
+  thread_ring_cache.ring = ring;
+  return ring;
+}
+
+void RingBufferEventTracer::record(const ProfilingRecord& record) {
+  ThreadRing* ring = get_thread_ring();
+  const uint64_t index = ring->write_index.load(std::memory_order_relaxed);
+  auto& slot = ring->slots[index & ring->mask];
+  // Seqlock-style write so that concurrent readers can detect torn records.
+  const uint32_t sequence = slot.sequence.load(std::memory_order_relaxed);
+  slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+  // Keeps the record stores below from becoming visible before the odd
+  // sequence.
+  std::atomic_thread_fence(std::memory_order_release);
+  slot.store(record);
+  slot.sequence.store(sequence + 2, std::memory_order_release);
+  ring->write_index.store(index + 1, std::memory_order_release);
+}
+
+void RingBufferEventTracer::copy_records(
+    std::vector<ProfilingRecord>& records,
+    std::vector<size_t>* thread_indices) const {
+  records.clear();
+  if (thread_indices != nullptr) {
+    thread_indices->clear();
+  }
+  std::lock_guard<std::mutex> lock(registry_mutex_);
+  for (size_t ring_index = 0; ring_index < rings_.size(); ++ring_index) {
+    const ThreadRing& ring = *rings_[ring_index];
+    const uint64_t end = ring.write_index.load(std::memory_order_acquire);
+    const uint64_t capacity = ring.mask + 1;
+    const uint64_t begin = end > capacity ? end - capacity : 0;
+    for (uint64_t index = begin; index < end; ++index) {
+      const auto& slot = ring.slots[index & ring.mask];
+      const uint32_t before = slot.sequence.load(std::memory_order_acquire);
+      if (before & 1) {
+        // Being overwritten right now.
+        continue;
+      }
+      const ProfilingRecord copy = slot.load();
+      // Keeps the record loads above from being satisfied after the recheck.
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (slot.sequence.load(std::memory_order_relaxed) != before) {
+        continue;
+      }
+      records.push_back(copy);
+      if (thread_indices != nullptr) {
+        thread_indices->push_back(ring_index);
+      }
+    }
+  }
+}
+
+void RingBufferEventTracer::clear() {
+  std::lock_guard<std::mutex> lock(registry_mutex_);
+  for (auto& ring : rings_) {
+    ring->write_index.store(0, std::memory_order_release);
+  }
+}
+
+std::vector<LatencyHistogram> RingBufferEventTracer::snapshot() const {
+  std::vector<ProfilingRecord> records;
+  copy_records(records);
+
+  const et_tick_ratio_t ratio = et_pal_ticks_to_ns_multiplier();
+  // Unnamed delegate events are told apart by their debug index.
+  using Key = std::tuple<uint32_t, bool, DebugHandle>;
+  std::map<Key, LatencyHistogram> histograms;
+  for (const auto& record : records) {
+    const Key key{
+        record.name_index,
+        record.is_delegate,
+        record.name_index == kNoName ? record.debug_handle : 0};
+    auto it = histograms.find(key);
+    if (it == histograms.end()) {
+      LatencyHistogram histogram{};
+      histogram.name = get_name(record.name_index);
+      histogram.is_delegate = record.is_delegate;
+      histogram.delegate_debug_index = std::get<2>(key);
+      histogram.min_ns = UINT64_MAX;
+      it = histograms.emplace(key, histogram).first;
+    }
+    LatencyHistogram& histogram = it->second;
+
+    const uint64_t ticks = record.end_time > record.start_time
+        ? record.end_time - record.start_time
+        : 0;
+    const uint64_t ns = ticks * ratio.numerator / ratio.denominator;
+    size_t bucket = 0;
+    for (uint64_t value = ns; value > 1; value >>= 1) {
+      bucket++;
+    }
+    bucket = std::min(bucket, LatencyHistogram::kNumBuckets - 1);
+
+    histogram.count++;
+    histogram.total_ns += ns;
+    histogram.min_ns = std::min(histogram.min_ns, ns);
+    histogram.max_ns = std::max(histogram.max_ns, ns);
+    histogram.buckets[bucket]++;
+  }
+
+  std::vector<LatencyHistogram> result;
+  result.reserve(histograms.size());
+  for (const auto& item : histograms) {
+    result.push_back(item.second);
+  }
+  return result;
+}
+
+uint64_t LatencyHistogram::percentile_ns(double percentile) const {
+  if (count == 0) {
+    return 0;
+  }
+  const double clamped = std::min(std::max(percentile, 0.0), 100.0);
+  const uint64_t target = std::max<uint64_t>(
+      1, static_cast<uint64_t>(std::ceil(count * clamped / 100.0)));
+  uint64_t seen = 0;
+  for (size_t i = 0; i < kNumBuckets; ++i) {
+    seen += buckets[i];
+    if (seen >= target) {
+      const uint64_t upper_bound = (uint64_t(1) << (i + 1)) - 1;
+      return std::max(min_ns, std::min(upper_bound, max_ns));
+    }
+  }
+  return max_ns;
+}
+
+} // namespace etdump
+} // namespace executorch
@@ -0,0 +1,239 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <executorch/runtime/core/event_tracer.h>
+#include <executorch/runtime/platform/platform.h>
+
+namespace executorch {
+namespace etdump {
+
+/**
+ * A fixed-size profiling record, as stored in the ring buffers of
+ * RingBufferEventTracer.
+ */
+struct ProfilingRecord {
+  /// Start of the event in system ticks.
+  et_timestamp_t start_time;
+  /// End of the event in system ticks.
+  et_timestamp_t end_time;
+  /// Index of the event name in the tracer's name table, or
+  /// RingBufferEventTracer::kNoName if the event has no name.
+  uint32_t name_index;
+  /// Debug handle of the instruction, or the delegate debug index for delegate
+  /// events.
+  ::executorch::runtime::DebugHandle debug_handle;
+  /// Chain of the instruction. kUnsetChainId for delegate events.
+  ::executorch::runtime::ChainID chain_id;
+  /// Whether this event was logged by a delegate.
+  bool is_delegate;
+};
+
+/**
+ * Latency distribution of one named event across the records that are
+ * currently held by a RingBufferEventTracer.
+ */
+struct LatencyHistogram {
+  /// Number of power-of-two buckets. Bucket `i` counts events that took
+  /// `[2^i, 2^(i+1))` nanoseconds; bucket 0 also counts zero-length events and
+  /// the last bucket also counts anything longer.
+  static constexpr size_t kNumBuckets = 40;
+
+  /// Event name; points into the tracer's name table and lives as long as the
+  /// tracer. Null for unnamed delegate events.
+  const char* name;
+  /// Whether the events were logged by a delegate.
+  bool is_delegate;
+  /// For unnamed delegate events, the delegate debug index.
+  ::executorch::runtime::DebugHandle delegate_debug_index;
+
+  uint64_t count;
+  uint64_t total_ns;
+  uint64_t min_ns;
+  uint64_t max_ns;
+  uint64_t buckets[kNumBuckets];
+
+  /**
+   * Estimates a percentile, using the upper bound of the bucket that contains
+   * it clamped to the observed maximum.
+   *
+   * @param[in] percentile In the range [0, 100].
+   */
+  uint64_t percentile_ns(double percentile) const;
+};
+
+/**
+ * An EventTracer for continuous, low-overhead per-operator timing in
+ * production.
+ *
+ * Unlike ETDumpGen, which serializes every event of a run into a flatbuffer
+ * for offline analysis, this tracer only records fixed-size start/end records
+ * for profiling events. Each thread that logs events gets its own ring buffer
+ * that it alone writes to, so logging takes no locks and never blocks; once a
+ * ring is full the oldest records are overwritten. Debug events (EValue and
+ * intermediate output logging) and allocation tracking are ignored.
+ *
+ * Sampling can be enabled so that only one in every N executions (event
+ * blocks, i.e. `Method::execute()` calls) is recorded, which bounds the
+ * overhead to a fraction of runs.
+ *
+ * `snapshot()` can be called from any thread at any time, concurrently with
+ * logging, to aggregate the records currently held into per-event latency
+ * histograms. It does not consume the records.
+ */
+class RingBufferEventTracer final : public ::executorch::runtime::EventTracer {
+ public:
+  /// name_index used for records without a name.
+  static constexpr uint32_t kNoName = UINT32_MAX;
+
+  /// Maximum number of distinct event names; events with other names are
+  /// recorded without a name.
+  static constexpr size_t kMaxNames = 512;
+
+  /// Maximum length of a stored name, including the null terminator. Longer
+  /// names are truncated.
+  static constexpr size_t kMaxNameLength = 64;
+
+  /**
+   * @param[in] records_per_thread Capacity of each per-thread ring buffer.
+   *     Rounded up to a power of two.
+   * @param[in] sample_every Record one in every `sample_every` executions.
+   *     1 records every execution.
+   */
+  explicit RingBufferEventTracer(
+      size_t records_per_thread = 4096,
+      uint32_t sample_every = 1);
+  ~RingBufferEventTracer() override;
+
+  /**
+   * Changes the sampling rate. Takes effect at the next event block.
+   */
+  void set_sample_every(uint32_t sample_every);
+
+  /**
+   * Aggregates the records currently held in all ring buffers into one
+   * histogram per distinct event.
+   */
+  std::vector<LatencyHistogram> snapshot() const;
+
+  /**
+   * Copies the records currently held in all ring buffers, oldest first within
+   * each thread.
+   *
+   * @param[out] records Receives the records. Cleared first.
+   * @param[out] thread_indices If non-null, receives the index of the thread
+   *     ring each record came from, in the order threads first logged an
+   *     event.
+   */
+  void copy_records(
+      std::vector<ProfilingRecord>& records,
+      std::vector<size_t>* thread_indices = nullptr) const;
+
+  /**
+   * Returns the name for a record's `name_index`, or nullptr for kNoName.
+   */
+  const char* get_name(uint32_t name_index) const;
+
+  /**
+   * Discards all records. Must not be called concurrently with logging.
+   */
+  void clear();
+
+  void create_event_block(const char* name) override;
+  ::executorch::runtime::EventTracerEntry start_profiling(
+      const char* name,
+      ::executorch::runtime::ChainID chain_id =
+          ::executorch::runtime::kUnsetChainId,
+      ::executorch::runtime::DebugHandle debug_handle =
+          ::executorch::runtime::kUnsetDebugHandle) override;
+  void end_profiling(::executorch::runtime::EventTracerEntry prof_entry)
+      override;
+  ::executorch::runtime::EventTracerEntry start_profiling_delegate(
+      const char* name,
+      ::executorch::runtime::DebugHandle delegate_debug_index) override;
+  void end_profiling_delegate(
+      ::executorch::runtime::EventTracerEntry prof_entry,
+      const void* metadata = nullptr,
+      size_t metadata_len = 0) override;
+  void log_profiling_delegate(
+      const char* name,
+      ::executorch::runtime::DebugHandle delegate_debug_index,
+      et_timestamp_t start_time,
+      et_timestamp_t end_time,
+      const void* metadata = nullptr,
+      size_t metadata_len = 0) override;
+
+  void track_allocation(::executorch::runtime::AllocatorID id, size_t size)
+      override {}
+  ::executorch::runtime::AllocatorID track_allocator(const char* name)
+      override {
+    return 0;
+  }
+  void log_evalue(
+      const ::executorch::runtime::EValue& evalue,
+      ::executorch::runtime::LoggedEValueType evalue_type) override {}
+  void log_intermediate_output_delegate(
+      const char* name,
+      ::executorch::runtime::DebugHandle delegate_debug_index,
+      const exec_aten::Tensor& output) override {}
+  void log_intermediate_output_delegate(
+      const char* name,
+      ::executorch::runtime::DebugHandle delegate_debug_index,
+      const ::executorch::runtime::ArrayRef<exec_aten::Tensor> output)
+      override {}
+  void log_intermediate_output_delegate(
+      const char* name,
+      ::executorch::runtime::DebugHandle delegate_debug_index,
+      const int& output) override {}
+  void log_intermediate_output_delegate(
+      const char* name,
+      ::executorch::runtime::DebugHandle delegate_debug_index,
+      const bool& output) override {}
+  void log_intermediate_output_delegate(
+      const char* name,
+      ::executorch::runtime::DebugHandle delegate_debug_index,
+      const double& output) override {}
+
+ private:
+  struct ThreadRing;
+  struct NameSlot;
+
+  ThreadRing* get_thread_ring();
+  uint32_t intern_name(const char* name);
+  void record(const ProfilingRecord& record);
+
+  RingBufferEventTracer(const RingBufferEventTracer&) = delete;
+  RingBufferEventTracer& operator=(const RingBufferEventTracer&) = delete;
+
+  // Distinguishes instances for the thread-local ring cache, since addresses
+  // may be reused.
+  const uint64_t instance_id_;
+  const size_t records_per_thread_;
+
+  std::atomic<uint32_t> sample_every_;
+  std::atomic<uint64_t> num_blocks_{0};
+  std::atomic<bool> sampling_{true};
+
+  // Guards registration of rings and names; never taken on the logging path
+  // once a thread's ring and the event names are registered.
+  mutable std::mutex registry_mutex_;
+  std::vector<std::unique_ptr<ThreadRing>> rings_;
+  std::unique_ptr<NameSlot[]> names_;
+  std::atomic<uint32_t> num_names_{0};
+};
+
+} // namespace etdump
+} // namespace executorch
@@ -114,3 +114,45 @@ def define_common_targets():
                 "@EXECUTORCH_CLIENTS",
             ],
         )
+
+        runtime.cxx_library(
+            name = "chrome_trace_exporter" + aten_suffix,
+            srcs = [
+                "chrome_trace_exporter.cpp",
+            ],
+            exported_headers = [
+                "chrome_trace_exporter.h",
+            ],
+            deps = [
+                ":etdump_schema_flatcc",
+                "//executorch/runtime/platform:platform",
+            ],
+            exported_deps = [
+                ":ring_buffer_event_tracer" + aten_suffix,
+                "//executorch/runtime/core:core",
+            ],
+            visibility = [
+                "//executorch/...",
+                "@EXECUTORCH_CLIENTS",
+            ],
+        )
+
+        runtime.cxx_library(
+            name = "ring_buffer_event_tracer" + aten_suffix,
+            srcs = [
+                "ring_buffer_event_tracer.cpp",
+            ],
+            exported_headers = [
+                "ring_buffer_event_tracer.h",
+            ],
+            deps = [
+                "//executorch/runtime/platform:platform",
+            ],
+            exported_deps = [
+                "//executorch/runtime/core:event_tracer" + aten_suffix,
+            ],
+            visibility = [
+                "//executorch/...",
+                "@EXECUTORCH_CLIENTS",
+            ],
+        )
@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/devtools/etdump/chrome_trace_exporter.h>
+
+#include <cstring>
+#include <string>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include <executorch/devtools/etdump/etdump_flatcc.h>
+#include <executorch/runtime/platform/runtime.h>
+
+using ::executorch::etdump::ChromeTraceWriter;
+using ::executorch::etdump::ETDumpGen;
+using ::executorch::etdump::ETDumpResult;
+using ::executorch::etdump::RingBufferEventTracer;
+using ::executorch::runtime::Error;
+using ::executorch::runtime::EventTracerEntry;
+
+namespace {
+
+size_t count_occurrences(
+    const std::string& haystack,
+    const std::string& needle) {
+  size_t count = 0;
+  for (size_t pos = haystack.find(needle); pos != std::string::npos;
+       pos = haystack.find(needle, pos + needle.size())) {
+    count++;
+  }
+  return count;
+}
+
+} // namespace
+
+class ChromeTraceExporterTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    executorch::runtime::runtime_init();
+  }
+};
+
+TEST_F(ChromeTraceExporterTest, ExportsETDumpEvents) {
+  ETDumpGen etdump_gen;
+  etdump_gen.create_event_block("Execute");
+  EventTracerEntry entry = etdump_gen.start_profiling("op\"quoted\"", 0, 3);
+  etdump_gen.end_profiling(entry);
+  etdump_gen.log_profiling_delegate("xnn_conv", -1, 1000, 3000);
+  etdump_gen.log_profiling_delegate(nullptr, 7, 2000, 2500);
+
+  ETDumpResult result = etdump_gen.get_etdump_data();
+  ASSERT_NE(result.buf, nullptr);
+
+  ChromeTraceWriter writer(/*ticks_to_ns=*/{1, 1});
+  ASSERT_EQ(writer.add_etdump(result.buf, result.size), Error::Ok);
+  EXPECT_EQ(writer.num_events(), 3);
+
+  const std::string json = writer.json();
+  EXPECT_NE(json.find("\"name\":\"op\\\"quoted\\\"\""), std::string::npos);
+  EXPECT_NE(json.find("\"instruction\":3"), std::string::npos);
+  EXPECT_NE(json.find("\"block\":\"Execute\""), std::string::npos);
+  // Delegate events go on their own lane, with ticks converted to us.
+  EXPECT_NE(
+      json.find(
+          "\"name\":\"xnn_conv\",\"cat\":\"delegate\",\"pid\":1,\"tid\":2,"
+          "\"ts\":1.000,\"dur\":2.000"),
+      std::string::npos);
+  EXPECT_NE(
+      json.find("\"name\":\"delegate_debug_id_7\",\"cat\":\"delegate\""),
+      std::string::npos);
+  EXPECT_EQ(count_occurrences(json, "\"ph\":\"X\""), 3);
+
+  free(result.buf);
+}
+
+TEST_F(ChromeTraceExporterTest, RejectsInvalidBuffer) {
+  ChromeTraceWriter writer;
+  uint8_t garbage[64] = {};
+  garbage[0] = 16;
+  EXPECT_EQ(
+      writer.add_etdump(garbage, sizeof(garbage)), Error::InvalidArgument);
+  EXPECT_EQ(writer.add_etdump(garbage, 4), Error::InvalidArgument);
+  EXPECT_EQ(writer.num_events(), 0);
+}
+
+TEST_F(ChromeTraceExporterTest, RejectsCorruptETDump) {
+  ETDumpGen etdump_gen;
+  etdump_gen.create_event_block("Execute");
+  etdump_gen.end_profiling(etdump_gen.start_profiling("op", 0, 1));
+  ETDumpResult result = etdump_gen.get_etdump_data();
+  ASSERT_NE(result.buf, nullptr);
+
+  // Point the root table, after the size prefix, past the end of the buffer.
+  // The identifier is intact, so only verification catches it.
+  uint8_t* data = static_cast<uint8_t*>(result.buf);
+  const uint32_t root_offset = static_cast<uint32_t>(result.size) * 2;
+  std::memcpy(data + sizeof(uint32_t), &root_offset, sizeof(root_offset));
+
+  ChromeTraceWriter writer;
+  EXPECT_EQ(writer.add_etdump(result.buf, result.size), Error::InvalidArgument);
+  EXPECT_EQ(writer.num_events(), 0);
+
+  free(result.buf);
+}
+
+TEST_F(ChromeTraceExporterTest, ExportsRingBufferThreadLanes) {
+  RingBufferEventTracer tracer;
+  tracer.end_profiling(tracer.start_profiling("main_op", 0, 1));
+  std::thread worker([&tracer] {
+    tracer.end_profiling(tracer.start_profiling("worker_op", 0, 2));
+    tracer.log_profiling_delegate("worker_delegate", -1, 10, 20);
+  });
+  worker.join();
+
+  ChromeTraceWriter writer;
+  writer.add_ring_buffer(tracer, "Threads");
+  EXPECT_EQ(writer.num_events(), 3);
+
+  const std::string json = writer.json();
+  EXPECT_NE(json.find("\"args\":{\"name\":\"Threads\"}"), std::string::npos);
+  EXPECT_EQ(count_occurrences(json, "\"name\":\"thread_name\""), 2);
+  EXPECT_NE(
+      json.find("\"name\":\"main_op\",\"cat\":\"runtime\",\"pid\":1,\"tid\":1"),
+      std::string::npos);
+  EXPECT_NE(
+      json.find(
+          "\"name\":\"worker_op\",\"cat\":\"runtime\",\"pid\":1,\"tid\":2"),
+      std::string::npos);
+  EXPECT_NE(
+      json.find(
+          "\"name\":\"worker_delegate\",\"cat\":\"delegate\",\"pid\":1,"
+          "\"tid\":2"),
+      std::string::npos);
+}
+
+TEST_F(ChromeTraceExporterTest, LabelsUnnamedRingBufferEvents) {
+  RingBufferEventTracer tracer;
+  tracer.end_profiling(tracer.start_profiling(nullptr, 2, 5));
+  tracer.log_profiling_delegate(nullptr, 7, 10, 20);
+
+  ChromeTraceWriter writer;
+  writer.add_ring_buffer(tracer, "Threads");
+  EXPECT_EQ(writer.num_events(), 2);
+
+  const std::string json = writer.json();
+  EXPECT_NE(
+      json.find("\"name\":\"debug_handle_5\",\"cat\":\"runtime\""),
+      std::string::npos);
+  EXPECT_NE(json.find("\"chain\":2"), std::string::npos);
+  EXPECT_NE(
+      json.find("\"name\":\"delegate_debug_id_7\",\"cat\":\"delegate\""),
+      std::string::npos);
+}
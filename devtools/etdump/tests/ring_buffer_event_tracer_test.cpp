@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/devtools/etdump/ring_buffer_event_tracer.h>
+
+#include <atomic>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <executorch/runtime/platform/runtime.h>
+
+using ::executorch::etdump::LatencyHistogram;
+using ::executorch::etdump::ProfilingRecord;
+using ::executorch::etdump::RingBufferEventTracer;
+using ::executorch::runtime::EventTracerEntry;
+
+namespace {
+
+const LatencyHistogram* find_histogram(
+    const std::vector<LatencyHistogram>& histograms,
+    const char* name) {
+  for (const auto& histogram : histograms) {
+    if (histogram.name != nullptr && std::strcmp(histogram.name, name) == 0) {
+      return &histogram;
+    }
+  }
+  return nullptr;
+}
+
+} // namespace
+
+class RingBufferEventTracerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    executorch::runtime::runtime_init();
+  }
+};
+
+TEST_F(RingBufferEventTracerTest, AggregatesPerName) {
+  RingBufferEventTracer tracer;
+  tracer.create_event_block("Execute");
+  for (int i = 0; i < 3; ++i) {
+    EventTracerEntry entry = tracer.start_profiling("op_a", 0, i);
+    tracer.end_profiling(entry);
+  }
+  tracer.end_profiling(tracer.start_profiling("op_b", 0, 7));
+
+  std::vector<LatencyHistogram> histograms = tracer.snapshot();
+  ASSERT_EQ(histograms.size(), 2);
+
+  const LatencyHistogram* op_a = find_histogram(histograms, "op_a");
+  ASSERT_NE(op_a, nullptr);
+  EXPECT_EQ(op_a->count, 3);
+  EXPECT_FALSE(op_a->is_delegate);
+  EXPECT_LE(op_a->min_ns, op_a->max_ns);
+  EXPECT_LE(op_a->percentile_ns(50), op_a->max_ns);
+  EXPECT_EQ(op_a->percentile_ns(100), op_a->max_ns);
+
+  const LatencyHistogram* op_b = find_histogram(histograms, "op_b");
+  ASSERT_NE(op_b, nullptr);
+  EXPECT_EQ(op_b->count, 1);
+
+  // Snapshots do not consume records.
+  EXPECT_EQ(tracer.snapshot().size(), 2);
+  tracer.clear();
+  EXPECT_EQ(tracer.snapshot().size(), 0);
+}
+
+TEST_F(RingBufferEventTracerTest, RingOverwritesOldestRecords) {
+  RingBufferEventTracer tracer(/*records_per_thread=*/4);
+  for (int i = 0; i < 10; ++i) {
+    tracer.end_profiling(tracer.start_profiling("op", 0, i));
+  }
+
+  std::vector<ProfilingRecord> records;
+  tracer.copy_records(records);
+  ASSERT_EQ(records.size(), 4);
+  for (size_t i = 0; i < records.size(); ++i) {
+    EXPECT_EQ(records[i].debug_handle, 6 + i);
+    EXPECT_STREQ(tracer.get_name(records[i].name_index), "op");
+  }
+}
+
+TEST_F(RingBufferEventTracerTest, SamplesOneInN) {
+  RingBufferEventTracer tracer(/*records_per_thread=*/1024, /*sample_every=*/4);
+  for (int block = 0; block < 8; ++block) {
+    tracer.create_event_block("Execute");
+    tracer.end_profiling(tracer.start_profiling("op"));
+    tracer.log_profiling_delegate("delegate_op", 0, 10, 20);
+  }
+
+  std::vector<LatencyHistogram> histograms = tracer.snapshot();
+  const LatencyHistogram* op = find_histogram(histograms, "op");
+  ASSERT_NE(op, nullptr);
+  EXPECT_EQ(op->count, 2);
+  const LatencyHistogram* delegate_op =
+      find_histogram(histograms, "delegate_op");
+  ASSERT_NE(delegate_op, nullptr);
+  EXPECT_EQ(delegate_op->count, 2);
+  EXPECT_TRUE(delegate_op->is_delegate);
+}
+
+TEST_F(RingBufferEventTracerTest, UnnamedDelegateEventsKeyedByIndex) {
+  RingBufferEventTracer tracer;
+  tracer.log_profiling_delegate(nullptr, 1, 0, 100);
+  tracer.log_profiling_delegate(nullptr, 2, 0, 100);
+  tracer.log_profiling_delegate(nullptr, 2, 0, 100);
+  tracer.end_profiling_delegate(tracer.start_profiling_delegate(nullptr, 1));
+
+  std::vector<LatencyHistogram> histograms = tracer.snapshot();
+  ASSERT_EQ(histograms.size(), 2);
+  for (const auto& histogram : histograms) {
+    EXPECT_EQ(histogram.name, nullptr);
+    EXPECT_TRUE(histogram.is_delegate);
+    EXPECT_EQ(histogram.count, 2);
+  }
+}
+
+TEST_F(RingBufferEventTracerTest, RecordsPerThread) {
+  RingBufferEventTracer tracer(/*records_per_thread=*/256);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&tracer, t] {
+      const std::string name = "op_" + std::to_string(t);
+      for (int i = 0; i < 100; ++i) {
+        tracer.end_profiling(tracer.start_profiling(name.c_str(), 0, i));
+      }
+    });
+  }
+  // Snapshots may run concurrently with logging.
+  (void)tracer.snapshot();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  std::vector<ProfilingRecord> records;
+  std::vector<size_t> thread_indices;
+  tracer.copy_records(records, &thread_indices);
+  EXPECT_EQ(records.size(), 400);
+  ASSERT_EQ(thread_indices.size(), records.size());
+  for (size_t i = 0; i < records.size(); ++i) {
+    // All records from one ring come from the same thread and thus share a
+    // name.
+    EXPECT_EQ(
+        records[i].name_index,
+        records[thread_indices[i] * 100].name_index);
+  }
+  EXPECT_EQ(tracer.snapshot().size(), 4);
+}
+
+TEST_F(RingBufferEventTracerTest, CopiesAreNeverTorn) {
+  // A small ring that the writer keeps lapping while records are copied.
+  RingBufferEventTracer tracer(/*records_per_thread=*/4);
+  std::atomic<bool> done{false};
+  std::thread writer([&tracer, &done] {
+    for (uint32_t i = 1; !done; ++i) {
+      tracer.log_profiling_delegate(nullptr, i, i, 2 * i);
+    }
+  });
+
+  std::vector<ProfilingRecord> records;
+  for (int copy = 0; copy < 20000; ++copy) {
+    tracer.copy_records(records);
+    for (const auto& record : records) {
+      // Every field of a record comes from the same write.
+      EXPECT_EQ(record.start_time, record.debug_handle);
+      EXPECT_EQ(record.end_time, 2 * record.start_time);
+    }
+  }
+  done = true;
+  writer.join();
+}
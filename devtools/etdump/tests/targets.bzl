@@ -19,3 +19,27 @@ def define_common_targets():
             "//executorch/runtime/core/exec_aten/testing_util:tensor_util",
         ],
     )
+
+    runtime.cxx_test(
+        name = "ring_buffer_event_tracer_test",
+        srcs = [
+            "ring_buffer_event_tracer_test.cpp",
+        ],
+        deps = [
+            "//executorch/devtools/etdump:ring_buffer_event_tracer",
+            "//executorch/runtime/platform:platform",
+        ],
+    )
+
+    runtime.cxx_test(
+        name = "chrome_trace_exporter_test",
+        srcs = [
+            "chrome_trace_exporter_test.cpp",
+        ],
+        deps = [
+            "//executorch/devtools/etdump:chrome_trace_exporter",
+            "//executorch/devtools/etdump:etdump_flatcc",
+            "//executorch/devtools/etdump:ring_buffer_event_tracer",
+            "//executorch/runtime/platform:platform",
+        ],
+    )
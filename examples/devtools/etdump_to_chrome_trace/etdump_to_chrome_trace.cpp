@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+/**
+ * @file
+ *
+ * Converts an ETDump file (.etdp) into a Chrome trace JSON file that can be
+ * opened in Perfetto (https://ui.perfetto.dev) or chrome://tracing, without
+ * needing the Python Inspector.
+ */
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <gflags/gflags.h>
+
+#include <executorch/devtools/etdump/chrome_trace_exporter.h>
+#include <executorch/runtime/platform/log.h>
+#include <executorch/runtime/platform/runtime.h>
+
+DEFINE_string(etdump_path, "etdump.etdp", "ETDump file to convert.");
+
+DEFINE_string(
+    trace_path,
+    "trace.json",
+    "Path to write the Chrome trace JSON to.");
+
+DEFINE_uint64(
+    ticks_to_ns_numerator,
+    1,
+    "Numerator of the ratio to convert the ETDump's timestamps to "
+    "nanoseconds, as returned by et_pal_ticks_to_ns_multiplier() on the "
+    "device that recorded it.");
+
+DEFINE_uint64(
+    ticks_to_ns_denominator,
+    1,
+    "Denominator of the ratio to convert the ETDump's timestamps to "
+    "nanoseconds.");
+
+using executorch::etdump::ChromeTraceWriter;
+using executorch::runtime::Error;
+
+int main(int argc, char** argv) {
+  executorch::runtime::runtime_init();
+
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  if (argc != 1) {
+    std::string msg = "Extra commandline args:";
+    for (int i = 1 /* skip argv[0] (program name) */; i < argc; i++) {
+      msg += std::string(" ") + argv[i];
+    }
+    ET_LOG(Error, "%s", msg.c_str());
+    return 1;
+  }
+  if (FLAGS_ticks_to_ns_denominator == 0) {
+    ET_LOG(Error, "--ticks_to_ns_denominator must be nonzero");
+    return 1;
+  }
+
+  std::ifstream in(FLAGS_etdump_path, std::ios::binary | std::ios::ate);
+  if (!in) {
+    ET_LOG(Error, "Could not open '%s'", FLAGS_etdump_path.c_str());
+    return 1;
+  }
+  const size_t nbytes = in.tellg();
+  in.seekg(0, std::ios::beg);
+  std::vector<uint8_t> etdump(nbytes);
+  if (!in.read(reinterpret_cast<char*>(etdump.data()), nbytes)) {
+    ET_LOG(Error, "Could not read '%s'", FLAGS_etdump_path.c_str());
+    return 1;
+  }
+
+  ChromeTraceWriter writer(
+      {FLAGS_ticks_to_ns_numerator, FLAGS_ticks_to_ns_denominator});
+  Error status = writer.add_etdump(etdump.data(), etdump.size());
+  if (status != Error::Ok) {
+    ET_LOG(
+        Error,
+        "Failed to parse ETDump '%s': 0x%x",
+        FLAGS_etdump_path.c_str(),
+        (unsigned int)status);
+    return 1;
+  }
+
+  std::ofstream out(FLAGS_trace_path, std::ios::binary);
+  out << writer.json();
+  if (!out) {
+    ET_LOG(Error, "Could not write '%s'", FLAGS_trace_path.c_str());
+    return 1;
+  }
+  ET_LOG(
+      Info,
+      "Wrote %zu events to %s",
+      writer.num_events(),
+      FLAGS_trace_path.c_str());
+  return 0;
+}
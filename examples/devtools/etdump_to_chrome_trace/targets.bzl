@@ -0,0 +1,25 @@
+load("@fbsource//xplat/executorch/build:runtime_wrapper.bzl", "get_oss_build_kwargs", "runtime")
+
+def define_common_targets():
+    """Defines targets that should be shared between fbcode and xplat.
+
+    The directory containing this targets.bzl file should also contain both
+    TARGETS and BUCK files that call this function.
+    """
+
+    # Converts ETDump files to Chrome trace JSON.
+    runtime.cxx_binary(
+        name = "etdump_to_chrome_trace",
+        srcs = [
+            "etdump_to_chrome_trace.cpp",
+        ],
+        deps = [
+            "//executorch/devtools/etdump:chrome_trace_exporter",
+            "//executorch/runtime/platform:platform",
+        ],
+        external_deps = [
+            "gflags",
+        ],
+        define_static_target = True,
+        **get_oss_build_kwargs()
+    )
@@ -57,9 +57,16 @@ from .source_transformation.quantize import (
 from .source_transformation.quantized_kv_cache import (
     replace_kv_cache_with_quantized_kv_cache,
 )
-from .source_transformation.rms_norm import replace_rms_norm_with_native_rms_norm
+from .source_transformation.feed_forward import replace_feed_forward_with_custom_op
+from .source_transformation.rms_norm import (
+    replace_rms_norm_with_custom_op,
+    replace_rms_norm_with_native_rms_norm,
+)
 
-from .source_transformation.rope import materialze_broadcast_of_rope_freq_cis
+from .source_transformation.rope import (
+    materialze_broadcast_of_rope_freq_cis,
+    replace_rope_with_custom_op,
+)
 from .source_transformation.sdpa import (
     replace_causal_mask,
     replace_kv_cache_with_coreml_kv_cache,
@@ -247,6 +254,12 @@ def build_args_parser() -> argparse.ArgumentParser:
         action="store_true",
         help="Whether to use sdpa_with_kv_cache update op when using kv cache",
     )
+    parser.add_argument(
+        "--use_custom_norm_and_activation",
+        default=False,
+        action="store_true",
+        help="Whether to use the fused llama::rms_norm and llama::silu_mul custom ops for RMSNorm and the SwiGLU feed forward activation",
+    )
     parser.add_argument(
         "--disable_dynamic_shape",
         dest="enable_dynamic_shape",
@@ -376,6 +389,13 @@ def build_args_parser() -> argparse.ArgumentParser:
         help="[Temp workaround] Expand sin/cos table in head dim to take vectorized path in optimized kernels.",
     )
 
+    parser.add_argument(
+        "--use_custom_rope",
+        default=False,
+        action="store_true",
+        help="Apply RoPE with the fused llama::apply_rotary_emb custom op instead of a chain of elementwise ops.",
+    )
+
     parser.add_argument(
         "--generate_etrecord",
         action="store_true",
@@ -1023,9 +1043,19 @@ def _get_source_transforms(  # noqa
     if args.expand_rope_table:
         transforms.append(materialze_broadcast_of_rope_freq_cis)
 
+    if args.use_custom_rope:
+        assert (
+            not args.expand_rope_table
+        ), "use_custom_rope does not support an expanded rope table"
+        transforms.append(replace_rope_with_custom_op)
+
     if args.use_sdpa_with_kv_cache:
         transforms.append(replace_sdpa_with_custom_op)
 
+    if args.use_custom_norm_and_activation:
+        transforms.append(replace_rms_norm_with_custom_op)
+        transforms.append(replace_feed_forward_with_custom_op)
+
     if args.quantize_kv_cache:
         assert args.use_kv_cache, "quantize_kv_cache requires use_kv_cache=True"
         transforms.append(replace_kv_cache_with_quantized_kv_cache)
@@ -41,6 +41,11 @@ DEFINE_int32(
 
 DEFINE_bool(warmup, false, "Whether to run a warmup run.");
 
+DEFINE_int32(
+    prompt_lookup_tokens,
+    0,
+    "Maximum number of tokens to propose per step by looking up the last tokens in the prompt and the output, verified in one model call. Needs a KV cache model exported with dynamic shapes and full logits. Defaults to 0, which disables prompt lookup decoding.");
+
 int32_t main(int32_t argc, char** argv) {
   gflags::ParseCommandLineFlags(&argc, &argv, true);
 
@@ -74,6 +79,7 @@ int32_t main(int32_t argc, char** argv) {
 #endif
   // create llama runner
   example::Runner runner(model_path, tokenizer_path, temperature);
+  runner.set_prompt_lookup(FLAGS_prompt_lookup_tokens);
 
   if (warmup) {
     runner.warmup(prompt, seq_len);
@@ -11,8 +11,12 @@
 
 #include <executorch/examples/models/llama/runner/runner.h>
 
+#include <algorithm>
 #include <ctime>
 
+#include <executorch/extension/data_loader/mmap_data_loader.h>
+#include <executorch/extension/llm/runner/kv_cache_snapshot.h>
+#include <executorch/extension/llm/runner/stateful_text_decoder_runner.h>
 #include <executorch/extension/llm/runner/util.h>
 
 #include <executorch/examples/models/llama/tokenizer/llama_tiktoken.h>
@@ -20,6 +24,7 @@
 
 namespace example {
 
+using ::executorch::extension::MmapDataLoader;
 using ::executorch::extension::Module;
 using ::executorch::runtime::Error;
 using ::executorch::runtime::Result;
@@ -34,6 +39,17 @@ static constexpr auto kMaxSeqLen = "get_max_seq_len";
 static constexpr auto kVocabSize = "get_vocab_size";
 static constexpr auto kUseKVCache = "use_kv_cache";
 static constexpr auto kUseSDPAWithKVCache = "use_sdpa_with_kv_cache";
+static constexpr auto kUseExplicitState = "use_explicit_state";
+
+std::unordered_map<std::string, int64_t> default_metadata() {
+  return {
+      {kEnableDynamicShape, false},
+      {kMaxSeqLen, 128},
+      {kUseKVCache, true},
+      {kUseSDPAWithKVCache, false},
+      {kUseExplicitState, false},
+  };
+}
 } // namespace
 
 Runner::Runner(
@@ -46,12 +62,7 @@ Runner::Runner(
     : temperature_(temperature),
       module_(std::make_unique<Module>(model_path, Module::LoadMode::File)),
       tokenizer_path_(tokenizer_path),
-      metadata_({
-          {kEnableDynamicShape, false},
-          {kMaxSeqLen, 128},
-          {kUseKVCache, true},
-          {kUseSDPAWithKVCache, false},
-      }) {
+      metadata_(default_metadata()) {
   ET_LOG(
       Info,
       "Creating LLaMa runner: model_path=%s, tokenizer_path=%s",
@@ -59,9 +70,25 @@ Runner::Runner(
       tokenizer_path.c_str());
 }
 
+Runner::Runner(
+    std::unique_ptr<llm::Tokenizer> tokenizer,
+    std::unique_ptr<llm::TextDecoderRunner> text_decoder_runner,
+    const std::unordered_map<std::string, int64_t>& metadata,
+    std::unique_ptr<std::unordered_set<uint64_t>> eos_ids)
+    : tokenizer_(std::move(tokenizer)),
+      metadata_(default_metadata()),
+      text_decoder_runner_(std::move(text_decoder_runner)) {
+  metadata_[kBosId] = tokenizer_->bos_tok();
+  metadata_[kVocabSize] = tokenizer_->vocab_size();
+  for (const auto& pair : metadata) {
+    metadata_[pair.first] = pair.second;
+  }
+  create_prefiller_and_generator(std::move(eos_ids));
+}
+
 bool Runner::is_loaded() const {
-  return module_->is_loaded() && tokenizer_ && text_decoder_runner_ &&
-      text_prefiller_ && text_token_generator_;
+  return (module_ == nullptr || module_->is_loaded()) && tokenizer_ &&
+      text_decoder_runner_ && text_prefiller_ && text_token_generator_;
 }
 
 Error Runner::load() {
@@ -120,24 +147,89 @@ Error Runner::load() {
       ET_LOG(Info, "eos_id = %" PRId64, value);
     }
   }
-  text_decoder_runner_ = std::make_unique<llm::TextDecoderRunner>(
-      module_.get(),
-      metadata_.at(kUseKVCache),
-      metadata_.at(kVocabSize),
-      temperature_);
+  // A model that takes and returns its state explicitly keeps its state in
+  // the decoder runner.
+  if (metadata_.at(kUseExplicitState)) {
+    text_decoder_runner_ = std::make_unique<llm::StatefulTextDecoderRunner>(
+        module_.get(), metadata_.at(kVocabSize), temperature_);
+  } else {
+    text_decoder_runner_ = std::make_unique<llm::TextDecoderRunner>(
+        module_.get(),
+        metadata_.at(kUseKVCache),
+        metadata_.at(kVocabSize),
+        temperature_);
+  }
+  create_prefiller_and_generator(std::move(eos_ids));
+
+  return Error::Ok;
+}
+
+void Runner::create_prefiller_and_generator(
+    std::unique_ptr<std::unordered_set<uint64_t>> eos_ids) {
+  // A model with an explicit state is fed only the new tokens like a model
+  // with a KV cache.
+  const bool feed_new_tokens_only =
+      metadata_.at(kUseKVCache) || metadata_.at(kUseExplicitState);
   text_prefiller_ = std::make_unique<llm::TextPrefiller>(
       text_decoder_runner_.get(),
-      metadata_.at(kUseKVCache),
-      metadata_.at(kEnableDynamicShape));
+      feed_new_tokens_only,
+      metadata_.at(kEnableDynamicShape),
+      &stats_);
 
   text_token_generator_ = std::make_unique<llm::TextTokenGenerator>(
       tokenizer_.get(),
       text_decoder_runner_.get(),
-      metadata_.at(kUseKVCache),
+      feed_new_tokens_only,
       std::move(eos_ids),
       &stats_);
+  apply_prompt_lookup();
+}
 
-  return Error::Ok;
+void Runner::apply_prompt_lookup() {
+  if (prompt_lookup_num_draft_tokens_ == 0) {
+    text_token_generator_->set_prompt_lookup(0);
+    return;
+  }
+  // The proposed tokens are fed after the current one and the rejected ones
+  // are overwritten later, which needs a KV cache indexed by position. An
+  // explicit state cannot be rolled back.
+  bool supported = module_ != nullptr && metadata_.at(kUseKVCache) &&
+      metadata_.at(kEnableDynamicShape) && !metadata_.at(kUseExplicitState);
+  if (supported) {
+    // Verifying the proposed tokens needs the logits of every input token.
+    auto method_meta = module_->method_meta("forward");
+    supported = method_meta.ok() && method_meta->num_outputs() > 0 &&
+        method_meta->output_tensor_meta(0).ok() &&
+        method_meta->output_tensor_meta(0)->sizes().size() == 3;
+  }
+  if (!supported) {
+    ET_LOG(
+        Info,
+        "Prompt lookup decoding needs a KV cache model exported with dynamic "
+        "shapes and full logits, disabling it");
+    text_token_generator_->set_prompt_lookup(0);
+    return;
+  }
+  text_token_generator_->set_prompt_lookup(
+      prompt_lookup_num_draft_tokens_, prompt_lookup_max_ngram_size_);
+}
+
+// Whether the prompt and generated tokens of a session stay in a KV cache
+// that the next generation can continue from. An explicit state lives in the
+// decoder runner and is not tracked by position, so it is never reused.
+bool Runner::uses_session_kv_cache() const {
+  return session_mode_ && metadata_.at(kUseKVCache) &&
+      !metadata_.at(kUseExplicitState);
+}
+
+void Runner::set_prompt_lookup(
+    int32_t num_draft_tokens,
+    int32_t max_ngram_size) {
+  prompt_lookup_num_draft_tokens_ = std::max(num_draft_tokens, 0);
+  prompt_lookup_max_ngram_size_ = std::max(max_ngram_size, 1);
+  if (is_loaded()) {
+    apply_prompt_lookup();
+  }
 }
 
 // Don't print with the same priority during warmup
@@ -228,8 +320,32 @@ Error Runner::generate(
   if (echo) {
     wrapped_callback(prompt);
   }
-  int64_t pos = 0;
-  auto prefill_res = text_prefiller_->prefill(prompt_tokens, pos);
+
+  // In session mode, keep the part of the KV cache that holds a prefix of
+  // this prompt and prefill only the rest. At least one token is prefilled
+  // to get the logits for the next token.
+  size_t num_reused_tokens = 0;
+  if (uses_session_kv_cache()) {
+    const size_t max_reuse = std::min<size_t>(
+        cached_tokens_.size(), static_cast<size_t>(num_prompt_tokens - 1));
+    while (num_reused_tokens < max_reuse &&
+           cached_tokens_[num_reused_tokens] ==
+               prompt_tokens[num_reused_tokens]) {
+      num_reused_tokens++;
+    }
+    RUNNER_ET_LOG(
+        warmup,
+        "Reusing %zu of %d prompt tokens from the KV cache",
+        num_reused_tokens,
+        num_prompt_tokens);
+  }
+  // The cache contents are unknown until generation succeeds.
+  cached_tokens_.clear();
+
+  int64_t pos = num_reused_tokens;
+  std::vector<uint64_t> prefill_tokens(
+      prompt_tokens.begin() + num_reused_tokens, prompt_tokens.end());
+  auto prefill_res = text_prefiller_->prefill(prefill_tokens, pos);
   stats_.first_token_ms = llm::time_in_ms();
   stats_.prompt_eval_end_ms = llm::time_in_ms();
   ET_CHECK_OK_OR_RETURN_ERROR(prefill_res.error());
@@ -244,8 +360,22 @@ Error Runner::generate(
 
   // start the main loop
   prompt_tokens.push_back(cur_token);
+  std::vector<uint64_t> generated_tokens;
   int64_t num_generated_tokens = ET_UNWRAP(text_token_generator_->generate(
-      prompt_tokens, num_prompt_tokens, seq_len, wrapped_callback));
+      prompt_tokens,
+      num_prompt_tokens,
+      seq_len,
+      wrapped_callback,
+      session_mode_ ? &generated_tokens : nullptr));
+
+  if (uses_session_kv_cache()) {
+    // The generation loop feeds the token from prefill and every generated
+    // token except the last one back into the model.
+    cached_tokens_ = std::move(prompt_tokens);
+    cached_tokens_.insert(
+        cached_tokens_.end(), generated_tokens.begin(), generated_tokens.end());
+    cached_tokens_.resize(num_prompt_tokens + num_generated_tokens);
+  }
 
   stats_.inference_end_ms = llm::time_in_ms();
   if (!warmup) {
@@ -288,6 +418,54 @@ Error Runner::warmup(const std::string& prompt, int32_t seq_len) {
   return err;
 }
 
+void Runner::set_session_mode(bool enabled) {
+  session_mode_ = enabled;
+  cached_tokens_.clear();
+}
+
+void Runner::reset_session() {
+  cached_tokens_.clear();
+}
+
+Error Runner::save_session(const std::string& path, bool compress_int8) {
+  ET_CHECK_OR_RETURN_ERROR(
+      uses_session_kv_cache() && module_ != nullptr,
+      InvalidState,
+      "Saving a session requires session mode and a KV cache model");
+  llm::KVCacheSnapshotInfo info;
+  info.pos = cached_tokens_.size();
+  info.tokens = cached_tokens_;
+  return llm::save_kv_cache_snapshot(
+      module_.get(), "forward", path, info, compress_int8);
+}
+
+Error Runner::load_session(const std::string& path) {
+  if (!is_loaded()) {
+    ET_CHECK_OK_OR_RETURN_ERROR(load());
+  }
+  ET_CHECK_OR_RETURN_ERROR(
+      uses_session_kv_cache() && module_ != nullptr,
+      InvalidState,
+      "Loading a session requires session mode and a KV cache model");
+  auto data_loader = ET_UNWRAP(MmapDataLoader::from(
+      path.c_str(), MmapDataLoader::MlockConfig::NoMlock));
+  auto info = ET_UNWRAP(
+      llm::load_kv_cache_snapshot(module_.get(), "forward", &data_loader));
+  // The saved state overwrote the cache, so forget what was in it even if the
+  // snapshot turns out to be unusable.
+  cached_tokens_.clear();
+  ET_CHECK_OR_RETURN_ERROR(
+      info.pos == static_cast<int64_t>(info.tokens.size()) &&
+          info.pos < metadata_.at(kMaxSeqLen),
+      InvalidArgument,
+      "Session snapshot holds %" PRId64 " positions for %zu tokens",
+      info.pos,
+      info.tokens.size());
+  cached_tokens_ = std::move(info.tokens);
+  ET_LOG(Info, "Restored a session of %zu tokens", cached_tokens_.size());
+  return Error::Ok;
+}
+
 void Runner::stop() {
   if (is_loaded()) {
     text_token_generator_->stop();
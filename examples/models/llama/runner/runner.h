@@ -16,6 +16,8 @@
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 #include <executorch/extension/llm/runner/irunner.h>
 #include <executorch/extension/llm/runner/stats.h>
@@ -34,6 +36,20 @@ class ET_EXPERIMENTAL Runner : public executorch::extension::llm::IRunner {
       const std::string& tokenizer_path,
       const float temperature = 0.8f);
 
+  /**
+   * Creates a runner from components that are already loaded instead of
+   * from files, e.g. to run it on a fake model in tests. `metadata` takes
+   * the place of the values load() reads from the model; missing entries
+   * keep their defaults. Such a runner has no module, so prompt lookup
+   * decoding is disabled and sessions cannot be saved or loaded.
+   */
+  Runner(
+      std::unique_ptr<::executorch::extension::llm::Tokenizer> tokenizer,
+      std::unique_ptr<::executorch::extension::llm::TextDecoderRunner>
+          text_decoder_runner,
+      const std::unordered_map<std::string, int64_t>& metadata,
+      std::unique_ptr<std::unordered_set<uint64_t>> eos_ids);
+
   bool is_loaded() const;
   ::executorch::runtime::Error load();
   ::executorch::runtime::Error generate(
@@ -49,10 +65,70 @@ class ET_EXPERIMENTAL Runner : public executorch::extension::llm::IRunner {
       int32_t seq_len = 128);
   void stop();
 
+  /**
+   * In session mode the runner remembers which tokens are in the model's KV
+   * cache after each generate() call. The next call then prefills only the
+   * part of its prompt after the longest prefix it shares with those
+   * tokens, which is what chat-style callers that resend the conversation
+   * on every turn need. Has no effect for models exported without a KV
+   * cache.
+   */
+  void set_session_mode(bool enabled);
+
+  /**
+   * Forgets the tokens in the KV cache, so that the next generate() call
+   * prefills its whole prompt.
+   */
+  void reset_session();
+
+  /**
+   * Saves the KV cache and the tokens in it to `path`, so that the session
+   * can be resumed with load_session(), possibly by another process. With
+   * `compress_int8` the cache is stored in about a quarter of the space at
+   * the cost of some precision. Requires session mode.
+   */
+  ::executorch::runtime::Error save_session(
+      const std::string& path,
+      bool compress_int8 = false);
+
+  /**
+   * Restores a KV cache saved by save_session() for the same model, so that
+   * the next generate() call only prefills the part of its prompt after the
+   * saved tokens. The file is mmapped, which keeps loading pre-built
+   * snapshots of common prompts cheap. Requires session mode.
+   */
+  ::executorch::runtime::Error load_session(const std::string& path);
+
+  /**
+   * Enables prompt lookup decoding, which proposes the tokens that followed
+   * the latest earlier occurrence of the last tokens and verifies them in one
+   * model call, so that text copied from the prompt or from earlier output
+   * takes fewer calls. It needs a model with a KV cache exported with
+   * dynamic shapes and full logits, and is ignored for other models.
+   * @param num_draft_tokens The maximum number of tokens to propose per
+   * step, 0 to disable.
+   * @param max_ngram_size The longest run of last tokens to look up.
+   */
+  void set_prompt_lookup(int32_t num_draft_tokens, int32_t max_ngram_size = 3);
+
  private:
-  float temperature_;
+  void create_prefiller_and_generator(
+      std::unique_ptr<std::unordered_set<uint64_t>> eos_ids);
+  void apply_prompt_lookup();
+  bool uses_session_kv_cache() const;
+
+  float temperature_{0.8f};
   bool shouldStop_{false};
 
+  // session mode
+  bool session_mode_{false};
+  // Tokens whose keys and values are in the KV cache, by position.
+  std::vector<uint64_t> cached_tokens_;
+
+  // prompt lookup decoding
+  int32_t prompt_lookup_num_draft_tokens_{0};
+  int32_t prompt_lookup_max_ngram_size_{3};
+
   // model
   std::unique_ptr<::executorch::extension::Module> module_;
   std::string tokenizer_path_;
@@ -40,6 +40,8 @@ def define_common_targets():
             exported_deps = [
                 "//executorch/backends/xnnpack:xnnpack_backend",
                 "//executorch/extension/llm/runner:irunner",
+                "//executorch/extension/llm/runner:kv_cache_snapshot" + aten_suffix,
+                "//executorch/extension/llm/runner:stateful_text_decoder_runner" + aten_suffix,
                 "//executorch/extension/llm/runner:stats",
                 "//executorch/extension/llm/runner:text_decoder_runner" + aten_suffix,
                 "//executorch/extension/llm/runner:text_prefiller" + aten_suffix,
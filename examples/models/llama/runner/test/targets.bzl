@@ -0,0 +1,20 @@
+load("@fbsource//xplat/executorch/build:runtime_wrapper.bzl", "runtime")
+
+def define_common_targets():
+    """Defines targets that should be shared between fbcode and xplat.
+
+    The directory containing this targets.bzl file should also contain both
+    TARGETS and BUCK files that call this function.
+    """
+    runtime.cxx_test(
+        name = "test_runner",
+        srcs = [
+            "test_runner.cpp",
+        ],
+        deps = [
+            "//executorch/examples/models/llama/runner:runner",
+        ],
+        compiler_flags = [
+            "-Wno-error=deprecated-declarations",
+        ],
+    )
@@ -0,0 +1,247 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/examples/models/llama/runner/runner.h>
+
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include <executorch/runtime/platform/runtime.h>
+
+using namespace ::executorch::extension;
+using namespace ::executorch::extension::llm;
+using ::example::Runner;
+using ::executorch::runtime::Error;
+using ::executorch::runtime::Result;
+
+namespace {
+
+constexpr int32_t kVocabSize = 32;
+
+// A model with a KV cache whose next token depends on every token in the
+// cache up to its position, so that a wrong cache changes the output.
+class FakeTextDecoderRunner : public TextDecoderRunner {
+ public:
+  FakeTextDecoderRunner()
+      : TextDecoderRunner(nullptr, true, kVocabSize, 0.0f) {}
+
+  bool is_method_loaded() override {
+    return true;
+  }
+
+  Result<executorch::aten::Tensor> step(
+      TensorPtr& tokens,
+      TensorPtr& start_pos) override {
+    const int64_t pos = start_pos->const_data_ptr<int64_t>()[0];
+    const int64_t num_tokens = tokens->size(1);
+    start_positions.push_back(pos);
+    num_fed_tokens.push_back(num_tokens);
+    if (fail) {
+      return Error::Internal;
+    }
+
+    // Entries past the fed tokens stay in the cache, masked by position.
+    if (cache_.size() < static_cast<size_t>(pos + num_tokens)) {
+      cache_.resize(pos + num_tokens);
+    }
+    logits_.assign(num_tokens * kVocabSize, 0.0f);
+    for (int64_t i = 0; i < num_tokens; ++i) {
+      cache_[pos + i] = tokens->const_data_ptr<int64_t>()[i];
+      uint64_t hash = 0;
+      for (int64_t j = 0; j <= pos + i; ++j) {
+        hash = hash * 31 + cache_[j];
+      }
+      // A letter, see FakeTokenizer.
+      logits_[i * kVocabSize + hash % 26 + 1] = 1.0f;
+    }
+    logits_tensor_ = make_tensor_ptr(
+        {1, static_cast<executorch::aten::SizesType>(num_tokens), kVocabSize},
+        logits_.data());
+    return *logits_tensor_;
+  }
+
+  bool fail = false;
+  std::vector<int64_t> start_positions;
+  std::vector<int64_t> num_fed_tokens;
+
+ private:
+  std::vector<uint64_t> cache_;
+  std::vector<float> logits_;
+  TensorPtr logits_tensor_;
+};
+
+// One token per lowercase letter, 'a' being 1.
+class FakeTokenizer : public Tokenizer {
+ public:
+  FakeTokenizer() {
+    initialized_ = true;
+    vocab_size_ = kVocabSize;
+  }
+
+  Error load(const std::string&) override {
+    return Error::Ok;
+  }
+
+  Result<std::vector<uint64_t>>
+  encode(const std::string& input, int8_t, int8_t) const override {
+    std::vector<uint64_t> tokens;
+    for (char c : input) {
+      tokens.push_back(c - 'a' + 1);
+    }
+    return tokens;
+  }
+
+  Result<std::string> decode(uint64_t, uint64_t token) const override {
+    return std::string(1, 'a' + token - 1);
+  }
+};
+
+} // namespace
+
+class RunnerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    executorch::runtime::runtime_init();
+  }
+
+  // A runner on a fake model that prefills the whole prompt in one step.
+  static std::unique_ptr<Runner> make_runner(FakeTextDecoderRunner** model) {
+    auto text_decoder_runner = std::make_unique<FakeTextDecoderRunner>();
+    *model = text_decoder_runner.get();
+    return std::make_unique<Runner>(
+        std::make_unique<FakeTokenizer>(),
+        std::move(text_decoder_runner),
+        std::unordered_map<std::string, int64_t>{
+            {"enable_dynamic_shape", true},
+            {"get_max_seq_len", 64},
+            {"use_kv_cache", true},
+        },
+        std::make_unique<std::unordered_set<uint64_t>>(
+            std::unordered_set<uint64_t>{0}));
+  }
+
+  // Returns the generated text.
+  static std::string
+  generate(Runner& runner, const std::string& prompt, int32_t seq_len) {
+    std::string text;
+    EXPECT_EQ(
+        runner.generate(
+            prompt,
+            seq_len,
+            [&text](const std::string& piece) { text += piece; },
+            {},
+            /*echo=*/false),
+        Error::Ok);
+    return text;
+  }
+
+  // The text generated from a full prefill of `prompt`.
+  static std::string reference(const std::string& prompt, int32_t seq_len) {
+    FakeTextDecoderRunner* model;
+    auto runner = make_runner(&model);
+    return generate(*runner, prompt, seq_len);
+  }
+};
+
+TEST_F(RunnerTest, SessionPrefillsOnlyNewTokens) {
+  FakeTextDecoderRunner* model;
+  auto runner = make_runner(&model);
+  runner->set_session_mode(true);
+
+  const std::string first_prompt = "hello";
+  const std::string first_reply = generate(*runner, first_prompt, 10);
+  EXPECT_EQ(first_reply, reference(first_prompt, 10));
+  EXPECT_EQ(model->start_positions.front(), 0);
+  EXPECT_EQ(model->num_fed_tokens.front(), 5);
+
+  // The next turn resends the conversation. Every token of it but the last
+  // reply token, which was never fed to the model, is in the cache.
+  const std::string second_prompt = first_prompt + first_reply + "again";
+  const size_t num_cached_tokens =
+      first_prompt.size() + first_reply.size() - 1;
+  model->start_positions.clear();
+  model->num_fed_tokens.clear();
+  EXPECT_EQ(
+      generate(*runner, second_prompt, 30), reference(second_prompt, 30));
+  EXPECT_EQ(model->start_positions.front(), num_cached_tokens);
+  EXPECT_EQ(
+      model->num_fed_tokens.front(), second_prompt.size() - num_cached_tokens);
+}
+
+TEST_F(RunnerTest, SessionReusesCommonPrefixOnly) {
+  FakeTextDecoderRunner* model;
+  auto runner = make_runner(&model);
+  runner->set_session_mode(true);
+  generate(*runner, "abcdefgh", 12);
+
+  // The cache past the common prefix holds the old prompt until it is
+  // overwritten.
+  model->start_positions.clear();
+  model->num_fed_tokens.clear();
+  EXPECT_EQ(generate(*runner, "abcxyz", 12), reference("abcxyz", 12));
+  EXPECT_EQ(model->start_positions.front(), 3);
+  EXPECT_EQ(model->num_fed_tokens.front(), 3);
+}
+
+TEST_F(RunnerTest, SessionPrefillsAtLeastOneToken) {
+  FakeTextDecoderRunner* model;
+  auto runner = make_runner(&model);
+  runner->set_session_mode(true);
+  const std::string reply = generate(*runner, "abcdef", 12);
+
+  // All of the prompt is cached, but its last token is fed again for the
+  // logits of the first new token.
+  model->start_positions.clear();
+  model->num_fed_tokens.clear();
+  EXPECT_EQ(generate(*runner, "abcdef", 12), reply);
+  EXPECT_EQ(model->start_positions.front(), 5);
+  EXPECT_EQ(model->num_fed_tokens.front(), 1);
+}
+
+TEST_F(RunnerTest, PrefillsWholePromptOutsideSession) {
+  FakeTextDecoderRunner* model;
+  auto runner = make_runner(&model);
+  generate(*runner, "abcdef", 12);
+  model->start_positions.clear();
+  generate(*runner, "abcdefgh", 12);
+  EXPECT_EQ(model->start_positions.front(), 0);
+
+  runner->set_session_mode(true);
+  generate(*runner, "abcdef", 12);
+  runner->reset_session();
+  model->start_positions.clear();
+  generate(*runner, "abcdefgh", 12);
+  EXPECT_EQ(model->start_positions.front(), 0);
+}
+
+TEST_F(RunnerTest, FailedGenerationForgetsSession) {
+  FakeTextDecoderRunner* model;
+  auto runner = make_runner(&model);
+  runner->set_session_mode(true);
+  generate(*runner, "abcdef", 12);
+
+  model->fail = true;
+  EXPECT_EQ(runner->generate("abcdefgh", 12, {}, {}, false), Error::Internal);
+
+  // The failed prefill may have written part of the cache.
+  model->fail = false;
+  model->start_positions.clear();
+  EXPECT_EQ(generate(*runner, "abcdefgh", 12), reference("abcdefgh", 12));
+  EXPECT_EQ(model->start_positions.front(), 0);
+}
+
+TEST_F(RunnerTest, SessionsNeedAModule) {
+  FakeTextDecoderRunner* model;
+  auto runner = make_runner(&model);
+  runner->set_session_mode(true);
+  generate(*runner, "abcdef", 12);
+
+  EXPECT_EQ(runner->save_session("/dev/null"), Error::InvalidState);
+  EXPECT_EQ(runner->load_session("/dev/null"), Error::InvalidState);
+}
@@ -0,0 +1,41 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+# pyre-unsafe
+
+import torch
+from executorch.examples.models.llama.llama_transformer import FeedForward
+
+
+class FeedForwardCustom(torch.nn.Module):
+    """
+    SwiGLU feed forward layer whose activation, silu(w1(x)) * w3(x), is the
+    fused llama::silu_mul custom op.
+    """
+
+    def __init__(self, w1: torch.nn.Module, w2: torch.nn.Module, w3: torch.nn.Module):
+        super().__init__()
+        self.w1 = w1
+        self.w2 = w2
+        self.w3 = w3
+
+    def forward(self, x: torch.Tensor) -> torch.Tensor:
+        return self.w2(torch.ops.llama.silu_mul.default(self.w1(x), self.w3(x)))
+
+
+def _replace_feed_forward_with_custom_op(module: torch.nn.Module):
+    for name, child in module.named_children():
+        if isinstance(child, FeedForward):
+            setattr(module, name, FeedForwardCustom(child.w1, child.w2, child.w3))
+        else:
+            _replace_feed_forward_with_custom_op(child)
+
+
+def replace_feed_forward_with_custom_op(module: torch.nn.Module) -> torch.nn.Module:
+    from executorch.extension.llm.custom_ops import sdpa_with_kv_cache  # noqa
+
+    _replace_feed_forward_with_custom_op(module)
+    return module
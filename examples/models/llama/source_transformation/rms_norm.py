@@ -21,3 +21,31 @@ def replace_rms_norm_with_native_rms_norm(module: torch.nn.Module):
         else:
             replace_rms_norm_with_native_rms_norm(child)
     return module
+
+
+class RMSNormCustom(torch.nn.Module):
+    """RMSNorm that calls the fused llama::rms_norm custom op."""
+
+    def __init__(self, dim: int, eps: float, weight: torch.nn.Parameter):
+        super().__init__()
+        self.dim = dim
+        self.eps = eps
+        self.weight = weight
+
+    def forward(self, x: torch.Tensor) -> torch.Tensor:
+        return torch.ops.llama.rms_norm.default(x, self.weight.to(x.dtype), self.eps)
+
+
+def _replace_rms_norm_with_custom_op(module: torch.nn.Module):
+    for name, child in module.named_children():
+        if isinstance(child, RMSNorm):
+            setattr(module, name, RMSNormCustom(child.dim, child.eps, child.weight))
+        else:
+            _replace_rms_norm_with_custom_op(child)
+
+
+def replace_rms_norm_with_custom_op(module: torch.nn.Module) -> torch.nn.Module:
+    from executorch.extension.llm.custom_ops import sdpa_with_kv_cache  # noqa
+
+    _replace_rms_norm_with_custom_op(module)
+    return module
@@ -6,7 +6,8 @@
 
 import torch
 
-from ..llama_transformer import Transformer
+from ..llama_transformer import Attention, Transformer
+from ..rope import hf_apply_rotary_emb, RotaryEmbedding
 
 
 def materialze_broadcast_of_rope_freq_cis(
@@ -33,3 +34,54 @@ def materialze_broadcast_of_rope_freq_cis(
     module.freqs_sin = module.freqs_sin.view(dim0, 1, dim1)
     module.freqs_sin = module.freqs_sin.expand(dim0, num_heads, dim1).contiguous()
     return module
+
+
+class RotaryEmbeddingCustom(torch.nn.Module):
+    """
+    Applies RoPE to q and k with the fused llama::apply_rotary_emb custom op,
+    instead of the chain of slice, mul, sub, add and cat ops that
+    rope.py:apply_rotary_emb and hf_apply_rotary_emb export to.
+    """
+
+    def __init__(self, interleaved: bool):
+        super().__init__()
+        self.interleaved = interleaved
+
+    def forward(
+        self,
+        xq: torch.Tensor,
+        xk: torch.Tensor,
+        freqs_cos: torch.Tensor,
+        freqs_sin: torch.Tensor,
+    ):
+        freqs_cos = freqs_cos.float()
+        freqs_sin = freqs_sin.float()
+        xq_out = torch.ops.llama.apply_rotary_emb.default(
+            xq.float(), freqs_cos, freqs_sin, self.interleaved
+        )
+        xk_out = torch.ops.llama.apply_rotary_emb.default(
+            xk.float(), freqs_cos, freqs_sin, self.interleaved
+        )
+        return xq_out.type_as(xq), xk_out.type_as(xk)
+
+
+def _replace_rope_with_custom_op(module: torch.nn.Module):
+    for child in module.modules():
+        if not isinstance(child, Attention):
+            continue
+        if isinstance(child.apply_rotary_emb, RotaryEmbedding):
+            child.apply_rotary_emb = RotaryEmbeddingCustom(interleaved=True)
+        elif child.apply_rotary_emb is hf_apply_rotary_emb:
+            child.apply_rotary_emb = RotaryEmbeddingCustom(interleaved=False)
+
+
+def replace_rope_with_custom_op(module: torch.nn.Module) -> torch.nn.Module:
+    """
+    Replaces RoPE in every attention layer with the fused custom op. The op
+    expects [seq_len, rot_dim] frequency tables, so this cannot be combined
+    with materialze_broadcast_of_rope_freq_cis.
+    """
+    from executorch.extension.llm.custom_ops import sdpa_with_kv_cache  # noqa
+
+    _replace_rope_with_custom_op(module)
+    return module
@@ -7,13 +7,15 @@
  */
 
 #include <executorch/examples/models/llava/runner/llava_runner.h>
+#include <executorch/extension/llm/runner/image_preprocessor.h>
 #include <gflags/gflags.h>
 #ifndef LLAVA_NO_TORCH_DUMMY_IMAGE
 #include <torch/torch.h>
-#else
-#include <algorithm> // std::fill
 #endif
 
+#include <algorithm>
+#include <cmath>
+
 #if defined(ET_USE_THREADPOOL)
 #include <executorch/extension/threadpool/cpuinfo_utils.h>
 #include <executorch/extension/threadpool/threadpool.h>
@@ -31,7 +33,7 @@ DEFINE_string(prompt, "The answer to the ultimate question is", "Prompt.");
 DEFINE_string(
     image_path,
     "",
-    "The path to a .pt file, a serialized torch tensor for an image, longest edge resized to 336.");
+    "The path to a .pt file, a serialized torch tensor for a CHW uint8 image. It is resized so that its longest edge is 336 unless it already is; pre-resize images more than twice as large with image_util.py, since the runner does not antialias.");
 
 DEFINE_double(
     temperature,
@@ -48,7 +50,55 @@ DEFINE_int32(
     -1,
     "Number of CPU threads for inference. Defaults to -1, which implies we'll use a heuristic to derive the # of performant cores for a specific device.");
 
+DEFINE_int32(
+    image_embedding_cache_size,
+    0,
+    "Number of images whose image encoder outputs are cached, so that repeated images skip the encoder. Defaults to 0, which disables the cache.");
+
 using executorch::extension::llm::Image;
+using executorch::extension::llm::ImagePreprocessOptions;
+
+namespace {
+
+// Longest edge of the images the image encoder takes. The encoder pads them
+// to a square and normalizes them itself.
+constexpr int32_t kImageSize = 336;
+
+// Resizes a CHW image so that its longest edge is kImageSize, keeping its
+// aspect ratio like image_util.py does.
+Image resize_image(Image image) {
+  const int32_t longest_edge = std::max(image.width, image.height);
+  if (longest_edge == kImageSize) {
+    return image;
+  }
+  ImagePreprocessOptions options;
+  options.resize_height =
+      std::max(1, image.height * kImageSize / longest_edge);
+  options.resize_width = std::max(1, image.width * kImageSize / longest_edge);
+  options.channels_last = false;
+  options.rescale = 1.0f;
+  std::vector<float> resized(
+      static_cast<size_t>(image.channels) * options.resize_height *
+      options.resize_width);
+  ET_CHECK_MSG(
+      executorch::extension::llm::preprocess_image(
+          image, options, resized.data(), resized.size()) ==
+          executorch::runtime::Error::Ok,
+      "Failed to resize the image");
+
+  Image result{
+      std::vector<uint8_t>(resized.size()),
+      options.resize_width,
+      options.resize_height,
+      image.channels};
+  for (size_t i = 0; i < resized.size(); ++i) {
+    result.data[i] = static_cast<uint8_t>(
+        std::min(std::max(std::round(resized[i]), 0.0f), 255.0f));
+  }
+  return result;
+}
+
+} // namespace
 
 int32_t main(int32_t argc, char** argv) {
   gflags::ParseCommandLineFlags(&argc, &argv, true);
@@ -82,9 +132,14 @@ int32_t main(int32_t argc, char** argv) {
   }
 #endif
   // create llama runner
-  example::LlavaRunner runner(model_path, tokenizer_path, temperature);
-
-  // read image and resize the longest edge to 336
+  example::LlavaRunner runner(
+      model_path,
+      tokenizer_path,
+      temperature,
+      FLAGS_image_embedding_cache_size > 0 ? FLAGS_image_embedding_cache_size
+                                           : 0);
+
+  // read image, resized below so that its longest edge is 336
   std::vector<uint8_t> image_data;
 
 #ifdef LLAVA_NO_TORCH_DUMMY_IMAGE
@@ -92,8 +147,11 @@ int32_t main(int32_t argc, char** argv) {
   image_data.resize(3 * 240 * 336);
   std::fill(image_data.begin(), image_data.end(), 0); // black
   std::array<int32_t, 3> image_shape = {3, 240, 336};
-  std::vector<Image> images = {
-      {.data = image_data, .width = image_shape[2], .height = image_shape[1]}};
+  std::vector<Image> images = {resize_image(
+      {.data = image_data,
+       .width = image_shape[2],
+       .height = image_shape[1],
+       .channels = image_shape[0]})};
 #else //  LLAVA_NO_TORCH_DUMMY_IMAGE
   //   cv::Mat image = cv::imread(image_path, cv::IMREAD_COLOR);
   //   int longest_edge = std::max(image.rows, image.cols);
@@ -113,10 +171,11 @@ int32_t main(int32_t argc, char** argv) {
   image_data.assign(
       image_tensor.data_ptr<uint8_t>(),
       image_tensor.data_ptr<uint8_t>() + image_tensor.numel());
-  std::vector<Image> images = {
+  std::vector<Image> images = {resize_image(
       {.data = image_data,
        .width = static_cast<int32_t>(image_tensor.size(2)),
-       .height = static_cast<int32_t>(image_tensor.size(1))}};
+       .height = static_cast<int32_t>(image_tensor.size(1)),
+       .channels = static_cast<int32_t>(image_tensor.size(0))})};
 #endif // LLAVA_NO_TORCH_DUMMY_IMAGE
 
   // generate
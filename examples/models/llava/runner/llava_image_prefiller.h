@@ -10,6 +10,7 @@
 
 #pragma once
 
+#include <executorch/extension/llm/runner/image_embedding_cache.h>
 #include <executorch/extension/llm/runner/image_prefiller.h>
 #include <executorch/extension/tensor/tensor.h>
 
@@ -18,8 +19,16 @@ namespace example {
 class ET_EXPERIMENTAL LlavaImagePrefiller
     : public ::executorch::extension::llm::ImagePrefiller {
  public:
-  LlavaImagePrefiller(::executorch::extension::Module* module)
-      : ImagePrefiller(module){};
+  /**
+   * @param module The LLaVA Module.
+   * @param embedding_cache If not null, images whose embeddings are in it
+   * skip the image encoder, and the embeddings of other images are added.
+   */
+  LlavaImagePrefiller(
+      ::executorch::extension::Module* module,
+      ::executorch::extension::llm::ImageEmbeddingCache* embedding_cache =
+          nullptr)
+      : ImagePrefiller(module), embedding_cache_(embedding_cache){};
   /**
    * Prefill an LLM Module with the given image input.
    * @param image The image input to LLaVa.
@@ -29,28 +38,37 @@ class ET_EXPERIMENTAL LlavaImagePrefiller
   inline ::executorch::runtime::Result<exec_aten::Tensor> prefill(
       ::executorch::extension::llm::Image& image,
       int64_t& start_pos) override {
-    auto image_tensor = executorch::extension::from_blob(
-        image.data.data(),
-        {3, image.height, image.width},
-        ::executorch::aten::ScalarType::Byte);
-    // Run image encoder
-    auto image_encoder_outputs =
-        ET_UNWRAP(module_->execute(kImageEncoderMethod, image_tensor));
+    ::executorch::extension::TensorPtr embeddings =
+        embedding_cache_ ? embedding_cache_->get(image) : nullptr;
+    if (!embeddings) {
+      auto image_tensor = executorch::extension::from_blob(
+          image.data.data(),
+          {3, image.height, image.width},
+          ::executorch::aten::ScalarType::Byte);
+      // Run image encoder
+      auto image_encoder_outputs =
+          ET_UNWRAP(module_->execute(kImageEncoderMethod, image_tensor));
+      const auto& encoder_output = image_encoder_outputs[0].toTensor();
+      if (embedding_cache_) {
+        embedding_cache_->put(image, encoder_output);
+      }
+      embeddings = executorch::extension::make_tensor_ptr(encoder_output);
+    }
 
     // inputs:[start_pos, embeds]
     auto start_pos_tensor = executorch::extension::from_blob(
         &start_pos, {1}, ::executorch::aten::ScalarType::Long);
 
     // Run text model
-    auto outputs_res = ET_UNWRAP(module_->execute(
-        kTextModelMethod, {start_pos_tensor, image_encoder_outputs[0]}));
+    auto outputs_res = ET_UNWRAP(
+        module_->execute(kTextModelMethod, {start_pos_tensor, embeddings}));
     ET_CHECK_MSG(
         outputs_res[0].isTensor(),
         "Non Tensor Output returned from executing image prefill");
 
     // Update the start_pos, which is only available inside this function.
     // outputs_res can have only one logits.
-    start_pos += image_encoder_outputs[0].toTensor().size(1);
+    start_pos += embeddings->size(1);
 
     return outputs_res[0].toTensor();
   }
@@ -98,6 +116,9 @@ class ET_EXPERIMENTAL LlavaImagePrefiller
 
   inline static const std::string kImageEncoderMethod = "image_encoder";
   inline static const std::string kTextModelMethod = "text_model";
+
+ private:
+  ::executorch::extension::llm::ImageEmbeddingCache* embedding_cache_;
 };
 
 } // namespace example
@@ -55,10 +55,12 @@ Error LlavaRunner::load() {
   text_prefiller_ = std::make_unique<llm::TextPrefiller>(
       text_decoder_runner_.get(),
       /*use_kv_cache=*/true,
-      /*enable_parallel_prefill=*/true);
+      /*enable_parallel_prefill=*/true,
+      &stats_);
 
   // Load the image prefiller
-  image_prefiller_ = std::make_unique<LlavaImagePrefiller>(module_.get());
+  image_prefiller_ = std::make_unique<LlavaImagePrefiller>(
+      module_.get(), image_embedding_cache_.get());
   image_prefiller_->load();
 
   // Load the text token generator
@@ -24,11 +24,26 @@ namespace example {
 class ET_EXPERIMENTAL LlavaRunner
     : public ::executorch::extension::llm::MultimodalRunner {
  public:
+  /**
+   * @param model_path The path to the LLaVA model.
+   * @param tokenizer_path The path to the tokenizer.
+   * @param temperature The sampling temperature.
+   * @param image_embedding_cache_size The number of images whose encoder
+   * outputs are kept, so that sending them again skips the image encoder.
+   * 0 disables the cache.
+   */
   explicit LlavaRunner(
       const std::string& model_path,
       const std::string& tokenizer_path,
-      const float temperature = 0.8f)
-      : MultimodalRunner(model_path, tokenizer_path, temperature){};
+      const float temperature = 0.8f,
+      const size_t image_embedding_cache_size = 0)
+      : MultimodalRunner(model_path, tokenizer_path, temperature) {
+    if (image_embedding_cache_size > 0) {
+      image_embedding_cache_ =
+          std::make_unique<::executorch::extension::llm::ImageEmbeddingCache>(
+              image_embedding_cache_size);
+    }
+  }
   bool is_loaded();
   ::executorch::runtime::Error load();
   ::executorch::runtime::Error generate(
@@ -248,6 +248,55 @@ Result<FreeableBuffer> MmapDataLoader::load(
           static_cast<uintptr_t>(page_size_)));
 }
 
+Error MmapDataLoader::advise(const void* data, size_t size, AccessHint hint)
+    const {
+  ET_CHECK_OR_RETURN_ERROR(
+      // Probably had its value moved to another instance.
+      fd_ >= 0,
+      InvalidState,
+      "Uninitialized");
+  if (data == nullptr || size == 0) {
+    return Error::Ok;
+  }
+
+  int advice = MADV_NORMAL;
+  switch (hint) {
+    case AccessHint::Normal:
+      advice = MADV_NORMAL;
+      break;
+    case AccessHint::Sequential:
+      advice = MADV_SEQUENTIAL;
+      break;
+    case AccessHint::Random:
+      advice = MADV_RANDOM;
+      break;
+    case AccessHint::WillNeed:
+      advice = MADV_WILLNEED;
+      break;
+    case AccessHint::DontNeed:
+      advice = MADV_DONTNEED;
+      break;
+  }
+
+  // madvise() requires a page-aligned start address.
+  Range range = get_overlapping_pages(
+      reinterpret_cast<uintptr_t>(data), size, page_size_);
+  int err = ::madvise(reinterpret_cast<void*>(range.start), range.size, advice);
+  if (err < 0) {
+    ET_LOG(
+        Debug,
+        "File %s: madvise(0x%zx, %zu, %d) failed: %s (%d)",
+        file_name_,
+        (size_t)range.start,
+        range.size,
+        advice,
+        ::strerror(errno),
+        errno);
+    return Error::NotSupported;
+  }
+  return Error::Ok;
+}
+
 Result<size_t> MmapDataLoader::size() const {
   ET_CHECK_OR_RETURN_ERROR(
       // Probably had its value moved to another instance.
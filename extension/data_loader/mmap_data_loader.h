@@ -40,6 +40,26 @@ class MmapDataLoader final : public executorch::runtime::DataLoader {
     UseMlockIgnoreErrors,
   };
 
+  /**
+   * Describes the expected access pattern of a mapped region, passed to the OS
+   * as an `madvise()` hint by `advise()`.
+   */
+  enum class AccessHint {
+    /// No special treatment; undoes earlier hints.
+    Normal,
+    /// Pages will be read in order; read ahead aggressively and drop them
+    /// soon after they are read.
+    Sequential,
+    /// Pages will be read in no particular order; disable read-ahead.
+    Random,
+    /// Pages will be needed soon; start reading them in the background.
+    WillNeed,
+    /// Pages will not be needed soon; release them. Because mappings are
+    /// read-only, they will be transparently re-read from the file if touched
+    /// again.
+    DontNeed,
+  };
+
   /**
    * Creates a new MmapDataLoader that wraps the named file. Fails if
    * the file can't be opened for reading or if its size can't be found.
@@ -95,6 +115,26 @@ class MmapDataLoader final : public executorch::runtime::DataLoader {
 
   ET_NODISCARD executorch::runtime::Result<size_t> size() const override;
 
+  /**
+   * Advises the OS about how a region of data returned by `load()` will be
+   * accessed. The region is typically a whole segment, or a single constant
+   * tensor inside a segment. The hint is applied to every page that overlaps
+   * the region, so neighboring data that shares a page is affected too.
+   *
+   * Hints are best-effort: the OS may ignore them. Pages locked with `mlock()`
+   * cannot be released with `AccessHint::DontNeed`.
+   *
+   * @param[in] data Start of the region. Must point into a buffer returned by
+   *     `load()` on this instance that has not been freed.
+   * @param[in] size Size of the region in bytes.
+   * @param[in] hint How the region will be accessed.
+   *
+   * @retval Error::Ok The hint was applied, or the region was empty.
+   * @retval Error::NotSupported The OS rejected the hint.
+   */
+  ET_NODISCARD executorch::runtime::Error
+  advise(const void* data, size_t size, AccessHint hint) const;
+
  private:
   MmapDataLoader(
       int fd,
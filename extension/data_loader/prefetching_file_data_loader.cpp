@@ -0,0 +1,349 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/data_loader/prefetching_file_data_loader.h>
+
+#include <condition_variable>
+#include <deque>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include <executorch/runtime/core/error.h>
+#include <executorch/runtime/core/result.h>
+#include <executorch/runtime/platform/log.h>
+
+// Must match the detection in file_data_loader.cpp.
+#if defined(__xtensa__)
+#define ET_HAVE_PREAD 0
+#endif // defined(__xtensa__)
+
+#ifndef ET_HAVE_PREAD
+#define ET_HAVE_PREAD 1
+#endif // !ET_HAVE_PREAD
+
+using executorch::runtime::DataLoader;
+using executorch::runtime::Error;
+using executorch::runtime::FreeableBuffer;
+using executorch::runtime::Result;
+using executorch::runtime::Span;
+
+namespace executorch {
+namespace extension {
+
+namespace {
+
+/**
+ * A single prefetched range and the result of reading it.
+ */
+struct Entry {
+  enum class Status {
+    /// Waiting in the queue for a worker.
+    Queued,
+    /// A worker is reading it.
+    Reading,
+    /// The read finished; `error` and `buffer` are valid.
+    Done,
+  };
+
+  Entry(size_t offset_, size_t size_, const DataLoader::SegmentInfo& info)
+      : offset(offset_),
+        size(size_),
+        segment_type(info.segment_type),
+        segment_index(info.segment_index) {}
+
+  bool matches(
+      size_t offset_,
+      size_t size_,
+      const DataLoader::SegmentInfo& info) const {
+    return offset == offset_ && size == size_ &&
+        segment_type == info.segment_type &&
+        segment_index == info.segment_index;
+  }
+
+  const size_t offset;
+  const size_t size;
+  // The descriptor is not kept since the caller does not guarantee its
+  // lifetime, and FileDataLoader does not look at it.
+  const DataLoader::SegmentInfo::Type segment_type;
+  const size_t segment_index;
+
+  Status status = Status::Queued;
+  Error error = Error::Ok;
+  std::optional<FreeableBuffer> buffer;
+};
+
+} // namespace
+
+struct PrefetchingFileDataLoader::State {
+  explicit State(FileDataLoader&& loader_) : loader(std::move(loader_)) {}
+
+  void worker_loop() {
+    for (;;) {
+      Entry* entry = nullptr;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [this] { return stop || !queue.empty(); });
+        if (stop) {
+          return;
+        }
+        entry = queue.front();
+        queue.pop_front();
+        entry->status = Entry::Status::Reading;
+      }
+
+      // Read outside of the lock so that other workers can run concurrently.
+      Result<FreeableBuffer> result = read(
+          entry->offset,
+          entry->size,
+          DataLoader::SegmentInfo(entry->segment_type, entry->segment_index));
+
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (result.ok()) {
+          entry->buffer.emplace(std::move(result.get()));
+        } else {
+          entry->error = result.error();
+        }
+        entry->status = Entry::Status::Done;
+      }
+      cv.notify_all();
+    }
+  }
+
+  // Reads through `loader`. With pread() FileDataLoader::load() reads at an
+  // offset without moving a shared file position, so workers read in
+  // parallel. Its fallback seeks and reads, on a file it reopens for every
+  // read; there the reads take turns instead of relying on that, which also
+  // bounds the number of open files to one.
+  Result<FreeableBuffer> read(
+      size_t offset,
+      size_t size,
+      const DataLoader::SegmentInfo& segment_info) {
+#if ET_HAVE_PREAD
+    return loader.load(offset, size, segment_info);
+#else
+    std::lock_guard<std::mutex> lock(read_mutex);
+    return loader.load(offset, size, segment_info);
+#endif
+  }
+
+  FileDataLoader loader;
+#if !ET_HAVE_PREAD
+  // Serializes the reads of `loader`.
+  std::mutex read_mutex;
+#endif
+
+  // Guards everything below. `cv` is signaled both when work is queued and
+  // when a read completes.
+  std::mutex mutex;
+  std::condition_variable cv;
+  // Owns all unclaimed entries; std::list keeps their addresses stable.
+  std::list<Entry> entries;
+  // Entries that no worker has picked up yet, in issue order.
+  std::deque<Entry*> queue;
+  bool stop = false;
+
+  std::vector<std::thread> workers;
+};
+
+PrefetchingFileDataLoader::PrefetchingFileDataLoader(
+    std::unique_ptr<State> state)
+    : state_(std::move(state)) {}
+
+PrefetchingFileDataLoader::PrefetchingFileDataLoader(
+    PrefetchingFileDataLoader&& rhs) noexcept = default;
+
+PrefetchingFileDataLoader::~PrefetchingFileDataLoader() {
+  // state_ can be null if this instance was moved from.
+  if (state_ == nullptr) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    state_->stop = true;
+  }
+  state_->cv.notify_all();
+  for (auto& worker : state_->workers) {
+    worker.join();
+  }
+  // Any unclaimed buffers are freed when `state_` is destroyed.
+}
+
+Result<PrefetchingFileDataLoader> PrefetchingFileDataLoader::from(
+    const char* file_name,
+    size_t alignment,
+    size_t num_threads) {
+  ET_CHECK_OR_RETURN_ERROR(
+      num_threads > 0, InvalidArgument, "num_threads must be greater than 0");
+
+  Result<FileDataLoader> loader = FileDataLoader::from(file_name, alignment);
+  if (!loader.ok()) {
+    return loader.error();
+  }
+
+  std::unique_ptr<State> state(new (std::nothrow) State(std::move(*loader)));
+  if (state == nullptr) {
+    ET_LOG(Error, "Failed to allocate loader state for %s", file_name);
+    return Error::MemoryAllocationFailed;
+  }
+  state->workers.reserve(num_threads);
+  for (size_t i = 0; i < num_threads; ++i) {
+    State* raw_state = state.get();
+    state->workers.emplace_back([raw_state] { raw_state->worker_loop(); });
+  }
+  return PrefetchingFileDataLoader(std::move(state));
+}
+
+Error PrefetchingFileDataLoader::prefetch(Span<const SegmentRange> segments) {
+  ET_CHECK_OR_RETURN_ERROR(
+      // Probably had its value moved to another instance.
+      state_ != nullptr,
+      InvalidState,
+      "Uninitialized");
+  Result<size_t> file_size = state_->loader.size();
+  if (!file_size.ok()) {
+    return file_size.error();
+  }
+  // Validate everything up front so that a bad range doesn't leave a partial
+  // set of reads queued.
+  for (const SegmentRange& segment : segments) {
+    ET_CHECK_OR_RETURN_ERROR(
+        segment.size <= *file_size &&
+            segment.offset <= *file_size - segment.size,
+        InvalidArgument,
+        "Prefetch offset %zu + size %zu > file_size %zu",
+        segment.offset,
+        segment.size,
+        *file_size);
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    for (const SegmentRange& segment : segments) {
+      if (segment.size == 0) {
+        // load() doesn't allocate for empty segments, so there's nothing to
+        // read ahead of time.
+        continue;
+      }
+      state_->entries.emplace_back(
+          segment.offset, segment.size, segment.segment_info);
+      state_->queue.push_back(&state_->entries.back());
+    }
+  }
+  state_->cv.notify_all();
+  return Error::Ok;
+}
+
+Error PrefetchingFileDataLoader::prefetch_method(
+    const executorch::runtime::Program& program,
+    const char* method_name) {
+  Result<size_t> num_segments =
+      program.get_method_segments(method_name, nullptr, 0);
+  if (!num_segments.ok()) {
+    return num_segments.error();
+  }
+  std::vector<SegmentRange> segments(*num_segments);
+  Result<size_t> written = program.get_method_segments(
+      method_name, segments.data(), segments.size());
+  if (!written.ok()) {
+    return written.error();
+  }
+  return prefetch({segments.data(), segments.size()});
+}
+
+Result<FreeableBuffer> PrefetchingFileDataLoader::load(
+    size_t offset,
+    size_t size,
+    const DataLoader::SegmentInfo& segment_info) const {
+  ET_CHECK_OR_RETURN_ERROR(
+      // Probably had its value moved to another instance.
+      state_ != nullptr,
+      InvalidState,
+      "Uninitialized");
+
+  std::unique_lock<std::mutex> lock(state_->mutex);
+  for (;;) {
+    auto it = state_->entries.begin();
+    for (; it != state_->entries.end(); ++it) {
+      if (it->matches(offset, size, segment_info)) {
+        break;
+      }
+    }
+    if (it == state_->entries.end()) {
+      // Not prefetched, or already claimed by another caller.
+      break;
+    }
+
+    if (it->status == Entry::Status::Queued) {
+      // No worker has started on it yet; reading it on this thread is faster
+      // than waiting behind the rest of the queue.
+      for (auto qit = state_->queue.begin(); qit != state_->queue.end();
+           ++qit) {
+        if (*qit == &*it) {
+          state_->queue.erase(qit);
+          break;
+        }
+      }
+      state_->entries.erase(it);
+      break;
+    }
+
+    if (it->status == Entry::Status::Reading) {
+      // The entry may be claimed by another caller while we wait, so look it
+      // up again afterwards.
+      state_->cv.wait(lock);
+      continue;
+    }
+
+    // Done. Hand over ownership of the buffer.
+    if (it->error != Error::Ok) {
+      Error error = it->error;
+      state_->entries.erase(it);
+      return error;
+    }
+    FreeableBuffer buffer(std::move(*it->buffer));
+    state_->entries.erase(it);
+    return buffer;
+  }
+  lock.unlock();
+
+  return state_->read(offset, size, segment_info);
+}
+
+Result<size_t> PrefetchingFileDataLoader::size() const {
+  ET_CHECK_OR_RETURN_ERROR(
+      // Probably had its value moved to another instance.
+      state_ != nullptr,
+      InvalidState,
+      "Uninitialized");
+  return state_->loader.size();
+}
+
+ET_NODISCARD Error PrefetchingFileDataLoader::load_into(
+    size_t offset,
+    size_t size,
+    const SegmentInfo& segment_info,
+    void* buffer) const {
+  ET_CHECK_OR_RETURN_ERROR(
+      // Probably had its value moved to another instance.
+      state_ != nullptr,
+      InvalidState,
+      "Uninitialized");
+  // The destination buffer belongs to the caller, so there is nothing to gain
+  // from reading ahead; delegate directly.
+#if !ET_HAVE_PREAD
+  std::lock_guard<std::mutex> lock(state_->read_mutex);
+#endif
+  return state_->loader.load_into(offset, size, segment_info, buffer);
+}
+
+} // namespace extension
+} // namespace executorch
@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+#include <executorch/extension/data_loader/file_data_loader.h>
+#include <executorch/runtime/core/data_loader.h>
+#include <executorch/runtime/core/result.h>
+#include <executorch/runtime/core/span.h>
+#include <executorch/runtime/executor/program.h>
+#include <executorch/runtime/platform/compiler.h>
+
+namespace executorch {
+namespace extension {
+
+/**
+ * A DataLoader that reads a known set of segments from a file in parallel,
+ * ahead of the `load()` calls that will consume them.
+ *
+ * `FileDataLoader::load()` performs one blocking read per segment, so a
+ * program with many delegate and constant segments keeps at most one request
+ * in flight. Callers that know which segments a method will need can pass
+ * them to `prefetch()`; a small pool of worker threads then reads them
+ * concurrently into aligned buffers. A later `load()` for the same range
+ * hands over the prefetched buffer, waiting only if the read is still in
+ * flight. Ranges that were never prefetched are read synchronously, exactly
+ * like `FileDataLoader`.
+ *
+ * Each prefetched buffer is handed out at most once; it is owned by the
+ * loader until then, and freed when the loader is destroyed if never claimed.
+ *
+ * Typical use loads the Program through this loader, then calls
+ * `prefetch_method()` right before `Program::load_method()`:
+ *
+ *   auto loader = PrefetchingFileDataLoader::from(path);
+ *   auto program = Program::load(&loader.get());
+ *   loader->prefetch_method(*program, "forward");
+ *   auto method = program->load_method("forward", &memory_manager);
+ */
+class PrefetchingFileDataLoader final : public executorch::runtime::DataLoader {
+ public:
+  /**
+   * Describes a range of the file that will be loaded later, and the
+   * SegmentInfo that the matching `load()` call will pass.
+   */
+  using SegmentRange = executorch::runtime::Program::SegmentRange;
+
+  /**
+   * Creates a new PrefetchingFileDataLoader that wraps the named file.
+   *
+   * @param[in] file_name Path to the file to read from.
+   * @param[in] alignment Alignment in bytes of pointers returned by this
+   *     instance. Must be a power of two.
+   * @param[in] num_threads Number of worker threads used to service
+   *     prefetches, i.e. the maximum number of reads in flight. Must be
+   *     greater than zero.
+   *
+   * @returns A new PrefetchingFileDataLoader on success.
+   * @retval Error::InvalidArgument `alignment` is not a power of two, or
+   *     `num_threads` is zero.
+   * @retval Error::AccessFailed `file_name` could not be opened, or its size
+   *     could not be found.
+   * @retval Error::MemoryAllocationFailed Internal memory allocation failure.
+   */
+  static executorch::runtime::Result<PrefetchingFileDataLoader> from(
+      const char* file_name,
+      size_t alignment = alignof(std::max_align_t),
+      size_t num_threads = 4);
+
+  // Movable to be compatible with Result.
+  PrefetchingFileDataLoader(PrefetchingFileDataLoader&& rhs) noexcept;
+
+  ~PrefetchingFileDataLoader() override;
+
+  /**
+   * Queues the provided ranges to be read in the background. Returns
+   * immediately; read errors are reported by the matching `load()` call.
+   *
+   * Ranges are issued in the order provided, so callers should list the
+   * segments that are needed first at the front.
+   *
+   * @param[in] segments The ranges to read. The array is not retained.
+   *
+   * @retval Error::Ok All ranges were queued.
+   * @retval Error::InvalidState The loader was moved from.
+   * @retval Error::InvalidArgument A range extends past the end of the file.
+   *     No ranges are queued in this case.
+   */
+  ET_NODISCARD executorch::runtime::Error prefetch(
+      executorch::runtime::Span<const SegmentRange> segments);
+
+  /**
+   * Queues the segments that `program.load_method(method_name)` will read,
+   * as listed by `Program::get_method_segments()`. `program` must have been
+   * loaded through this loader.
+   *
+   * @retval Error::Ok All segments were queued. Methods without delegate
+   *     segments queue nothing.
+   * @retval Error::InvalidArgument There is no method with that name.
+   */
+  ET_NODISCARD executorch::runtime::Error prefetch_method(
+      const executorch::runtime::Program& program,
+      const char* method_name);
+
+  ET_NODISCARD
+  executorch::runtime::Result<executorch::runtime::FreeableBuffer> load(
+      size_t offset,
+      size_t size,
+      const DataLoader::SegmentInfo& segment_info) const override;
+
+  ET_NODISCARD executorch::runtime::Result<size_t> size() const override;
+
+  ET_NODISCARD executorch::runtime::Error load_into(
+      size_t offset,
+      size_t size,
+      const SegmentInfo& segment_info,
+      void* buffer) const override;
+
+ private:
+  struct State;
+
+  explicit PrefetchingFileDataLoader(std::unique_ptr<State> state);
+
+  // Not safely copyable.
+  PrefetchingFileDataLoader(const PrefetchingFileDataLoader&) = delete;
+  PrefetchingFileDataLoader& operator=(const PrefetchingFileDataLoader&) =
+      delete;
+  PrefetchingFileDataLoader& operator=(PrefetchingFileDataLoader&&) = delete;
+
+  // Heap-allocated so that the worker threads can hold a stable pointer to it
+  // even when this instance is moved. Null if this instance was moved from.
+  std::unique_ptr<State> state_;
+};
+
+} // namespace extension
+} // namespace executorch
@@ -52,6 +52,23 @@ def define_common_targets():
         ],
     )
 
+    runtime.cxx_library(
+        name = "prefetching_file_data_loader",
+        srcs = ["prefetching_file_data_loader.cpp"],
+        exported_headers = ["prefetching_file_data_loader.h"],
+        visibility = [
+            "//executorch/test/...",
+            "//executorch/runtime/executor/test/...",
+            "//executorch/extension/data_loader/test/...",
+            "@EXECUTORCH_CLIENTS",
+        ],
+        exported_deps = [
+            ":file_data_loader",
+            "//executorch/runtime/core:core",
+            "//executorch/runtime/executor:program_no_prim_ops",
+        ],
+    )
+
     runtime.cxx_library(
         name = "file_descriptor_data_loader",
         srcs = ["file_descriptor_data_loader.cpp"],
@@ -324,6 +324,52 @@ TEST_F(MmapDataLoaderTest, FromMissingFileFails) {
   EXPECT_NE(mdl.error(), Error::Ok);
 }
 
+TEST_F(MmapDataLoaderTest, AdviseKeepsDataReadable) {
+  // Create a file containing multiple pages' worth of data.
+  const size_t contents_size = 4 * page_size_;
+  auto contents = std::make_unique<uint8_t[]>(contents_size);
+  for (size_t i = 0; i < contents_size; ++i) {
+    contents[i] = static_cast<uint8_t>(i * 3);
+  }
+  TempFile tf(contents.get(), contents_size);
+
+  Result<MmapDataLoader> mdl = MmapDataLoader::from(
+      tf.path().c_str(), MmapDataLoader::MlockConfig::NoMlock);
+  ASSERT_EQ(mdl.error(), Error::Ok);
+
+  Result<FreeableBuffer> fb = mdl->load(
+      /*offset=*/0,
+      contents_size,
+      DataLoader::SegmentInfo(DataLoader::SegmentInfo::Type::Constant));
+  ASSERT_EQ(fb.error(), Error::Ok);
+  const uint8_t* data = static_cast<const uint8_t*>(fb->data());
+
+  // Hints on unaligned sub-regions should be widened to whole pages.
+  EXPECT_EQ(
+      mdl->advise(data + 10, page_size_, MmapDataLoader::AccessHint::WillNeed),
+      Error::Ok);
+  EXPECT_EQ(
+      mdl->advise(data, contents_size, MmapDataLoader::AccessHint::Sequential),
+      Error::Ok);
+  EXPECT_EQ(
+      mdl->advise(data, contents_size, MmapDataLoader::AccessHint::Random),
+      Error::Ok);
+  EXPECT_EQ(
+      mdl->advise(data, contents_size, MmapDataLoader::AccessHint::Normal),
+      Error::Ok);
+  // Empty regions are a no-op.
+  EXPECT_EQ(
+      mdl->advise(data, 0, MmapDataLoader::AccessHint::WillNeed), Error::Ok);
+
+  // Released pages should be transparently re-read from the file.
+  EXPECT_EQ(0, std::memcmp(data, contents.get(), contents_size));
+  EXPECT_EQ(
+      mdl->advise(
+          data + page_size_, page_size_, MmapDataLoader::AccessHint::DontNeed),
+      Error::Ok);
+  EXPECT_EQ(0, std::memcmp(data, contents.get(), contents_size));
+}
+
 // Tests that the move ctor works.
 TEST_F(MmapDataLoaderTest, MoveCtor) {
   // Create a loader.
@@ -345,6 +391,10 @@ TEST_F(MmapDataLoaderTest, MoveCtor) {
           .error(),
       Error::InvalidState);
   EXPECT_EQ(mdl->size().error(), Error::InvalidState);
+  EXPECT_EQ(
+      mdl->advise(
+          contents.data(), contents.size(), MmapDataLoader::AccessHint::Normal),
+      Error::InvalidState);
 
   // New loader should point to the file.
   EXPECT_EQ(mdl2.size().get(), contents.size());
@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/data_loader/prefetching_file_data_loader.h>
+
+#include <cstring>
+#include <limits>
+
+#include <gtest/gtest.h>
+
+#include <executorch/extension/testing_util/temp_file.h>
+#include <executorch/runtime/core/result.h>
+#include <executorch/runtime/platform/runtime.h>
+#include <executorch/test/utils/alignment.h>
+
+using namespace ::testing;
+using executorch::extension::PrefetchingFileDataLoader;
+using executorch::extension::testing::TempFile;
+using executorch::runtime::DataLoader;
+using executorch::runtime::Error;
+using executorch::runtime::FreeableBuffer;
+using executorch::runtime::Result;
+using executorch::runtime::Span;
+
+using SegmentRange = PrefetchingFileDataLoader::SegmentRange;
+
+class PrefetchingFileDataLoaderTest : public ::testing::TestWithParam<size_t> {
+ protected:
+  void SetUp() override {
+    // Since these tests cause ET_LOG to be called, the PAL must be initialized
+    // first.
+    executorch::runtime::runtime_init();
+
+    for (int i = 0; i < sizeof(data_); ++i) {
+      data_[i] = static_cast<uint8_t>(i * 7);
+    }
+  }
+
+  // The number of worker threads that tests should use. The values are set by
+  // the list in the INSTANTIATE_TEST_SUITE_P call below.
+  size_t num_threads() const {
+    return GetParam();
+  }
+
+  uint8_t data_[4096];
+};
+
+TEST_P(PrefetchingFileDataLoaderTest, PrefetchedLoadsSucceed) {
+  TempFile tf(data_, sizeof(data_));
+
+  Result<PrefetchingFileDataLoader> loader = PrefetchingFileDataLoader::from(
+      tf.path().c_str(), /*alignment=*/64, num_threads());
+  ASSERT_EQ(loader.error(), Error::Ok);
+
+  SegmentRange segments[] = {
+      {0, 100, DataLoader::SegmentInfo(DataLoader::SegmentInfo::Type::Backend, 0)},
+      {100, 1000, DataLoader::SegmentInfo(DataLoader::SegmentInfo::Type::Backend, 1)},
+      {1100, 2996, DataLoader::SegmentInfo(DataLoader::SegmentInfo::Type::Constant, 0)},
+  };
+  ASSERT_EQ(
+      loader->prefetch(Span<const SegmentRange>(segments, 3)), Error::Ok);
+
+  // Claim them in a different order than they were issued.
+  for (int i : {2, 0, 1}) {
+    Result<FreeableBuffer> fb = loader->load(
+        segments[i].offset, segments[i].size, segments[i].segment_info);
+    ASSERT_EQ(fb.error(), Error::Ok);
+    EXPECT_ALIGNED(fb->data(), 64);
+    ASSERT_EQ(fb->size(), segments[i].size);
+    EXPECT_EQ(
+        0, std::memcmp(fb->data(), &data_[segments[i].offset], fb->size()));
+  }
+}
+
+TEST_P(PrefetchingFileDataLoaderTest, RepeatedAndUnprefetchedLoadsSucceed) {
+  TempFile tf(data_, sizeof(data_));
+
+  Result<PrefetchingFileDataLoader> loader = PrefetchingFileDataLoader::from(
+      tf.path().c_str(), alignof(std::max_align_t), num_threads());
+  ASSERT_EQ(loader.error(), Error::Ok);
+
+  SegmentRange segment = {
+      16, 32, DataLoader::SegmentInfo(DataLoader::SegmentInfo::Type::Backend)};
+  ASSERT_EQ(
+      loader->prefetch(Span<const SegmentRange>(&segment, 1)), Error::Ok);
+
+  // The second load of the same range, and a load of a range that was never
+  // prefetched, fall back to a synchronous read.
+  for (int i = 0; i < 2; ++i) {
+    Result<FreeableBuffer> fb =
+        loader->load(segment.offset, segment.size, segment.segment_info);
+    ASSERT_EQ(fb.error(), Error::Ok);
+    ASSERT_EQ(fb->size(), segment.size);
+    EXPECT_EQ(0, std::memcmp(fb->data(), &data_[16], fb->size()));
+  }
+  Result<FreeableBuffer> fb = loader->load(
+      200, 8, DataLoader::SegmentInfo(DataLoader::SegmentInfo::Type::Program));
+  ASSERT_EQ(fb.error(), Error::Ok);
+  EXPECT_EQ(0, std::memcmp(fb->data(), &data_[200], fb->size()));
+}
+
+TEST_P(PrefetchingFileDataLoaderTest, UnclaimedPrefetchesAreFreed) {
+  TempFile tf(data_, sizeof(data_));
+
+  Result<PrefetchingFileDataLoader> loader = PrefetchingFileDataLoader::from(
+      tf.path().c_str(), alignof(std::max_align_t), num_threads());
+  ASSERT_EQ(loader.error(), Error::Ok);
+
+  SegmentRange segments[] = {
+      {0, 2048, DataLoader::SegmentInfo(DataLoader::SegmentInfo::Type::Constant)},
+      {2048, 2048, DataLoader::SegmentInfo(DataLoader::SegmentInfo::Type::Backend)},
+  };
+  ASSERT_EQ(
+      loader->prefetch(Span<const SegmentRange>(segments, 2)), Error::Ok);
+  // Destroying the loader without claiming the buffers should not leak or
+  // crash; ASAN builds will catch the former.
+}
+
+TEST_P(PrefetchingFileDataLoaderTest, OutOfBoundsPrefetchFails) {
+  TempFile tf(data_, sizeof(data_));
+
+  Result<PrefetchingFileDataLoader> loader = PrefetchingFileDataLoader::from(
+      tf.path().c_str(), alignof(std::max_align_t), num_threads());
+  ASSERT_EQ(loader.error(), Error::Ok);
+
+  SegmentRange segments[] = {
+      {0, 8, DataLoader::SegmentInfo(DataLoader::SegmentInfo::Type::Backend)},
+      {sizeof(data_) - 4,
+       8,
+       DataLoader::SegmentInfo(DataLoader::SegmentInfo::Type::Backend)},
+  };
+  EXPECT_EQ(
+      loader->prefetch(Span<const SegmentRange>(segments, 2)),
+      Error::InvalidArgument);
+
+  // The end of a range far past the file wraps around to a small value.
+  SegmentRange wrapping[] = {
+      {std::numeric_limits<size_t>::max() - 4,
+       8,
+       DataLoader::SegmentInfo(DataLoader::SegmentInfo::Type::Backend)},
+  };
+  EXPECT_EQ(
+      loader->prefetch(Span<const SegmentRange>(wrapping, 1)),
+      Error::InvalidArgument);
+}
+
+TEST_P(PrefetchingFileDataLoaderTest, BadArgumentsFail) {
+  TempFile tf(data_, sizeof(data_));
+
+  Result<PrefetchingFileDataLoader> no_threads =
+      PrefetchingFileDataLoader::from(
+          tf.path().c_str(), alignof(std::max_align_t), /*num_threads=*/0);
+  EXPECT_EQ(no_threads.error(), Error::InvalidArgument);
+
+  Result<PrefetchingFileDataLoader> bad_alignment =
+      PrefetchingFileDataLoader::from(
+          tf.path().c_str(), /*alignment=*/3, num_threads());
+  EXPECT_EQ(bad_alignment.error(), Error::InvalidArgument);
+
+  Result<PrefetchingFileDataLoader> missing = PrefetchingFileDataLoader::from(
+      "/tmp/FILE_DOES_NOT_EXIST_EXECUTORCH_MUST_NOT_CREATE",
+      alignof(std::max_align_t),
+      num_threads());
+  EXPECT_EQ(missing.error(), Error::AccessFailed);
+}
+
+TEST_P(PrefetchingFileDataLoaderTest, MoveCtor) {
+  TempFile tf(data_, sizeof(data_));
+
+  Result<PrefetchingFileDataLoader> loader = PrefetchingFileDataLoader::from(
+      tf.path().c_str(), alignof(std::max_align_t), num_threads());
+  ASSERT_EQ(loader.error(), Error::Ok);
+
+  SegmentRange segment = {
+      0, 64, DataLoader::SegmentInfo(DataLoader::SegmentInfo::Type::Backend)};
+  ASSERT_EQ(
+      loader->prefetch(Span<const SegmentRange>(&segment, 1)), Error::Ok);
+
+  // Move it into another instance; in-flight reads should survive the move.
+  PrefetchingFileDataLoader loader2(std::move(*loader));
+
+  // The old loader should now be invalid.
+  EXPECT_EQ(
+      loader->load(0, 64, segment.segment_info).error(), Error::InvalidState);
+  EXPECT_EQ(loader->size().error(), Error::InvalidState);
+
+  Result<FreeableBuffer> fb = loader2.load(0, 64, segment.segment_info);
+  ASSERT_EQ(fb.error(), Error::Ok);
+  EXPECT_EQ(0, std::memcmp(fb->data(), data_, fb->size()));
+}
+
+// Run all PrefetchingFileDataLoaderTests multiple times, varying the return
+// value of `GetParam()` based on the `testing::Values` list. The tests will
+// interpret the value as "num_threads".
+INSTANTIATE_TEST_SUITE_P(
+    VariedThreads,
+    PrefetchingFileDataLoaderTest,
+    testing::Values(1, 2, 8));
@@ -0,0 +1,298 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <algorithm>
+#include <random>
+
+#include <executorch/extension/llm/custom_ops/op_sdpa.h> // Declares the operator
+#include <executorch/extension/llm/runner/paged_kv_cache_allocator.h>
+#include <executorch/kernels/test/TestUtil.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
+
+#include <gtest/gtest.h>
+
+using namespace ::testing;
+using exec_aten::ScalarType;
+using exec_aten::Tensor;
+using executorch::extension::llm::PagedKVCacheAllocator;
+using executorch::runtime::Error;
+using executorch::runtime::testing::TensorFactory;
+
+namespace {
+
+constexpr int32_t kBatch = 2;
+constexpr int32_t kHeads = 4;
+constexpr int32_t kKVHeads = 2;
+constexpr int32_t kHeadDim = 8;
+constexpr int32_t kMaxSeqLen = 64;
+constexpr int32_t kPageSize = 4;
+constexpr int32_t kNumPages = kBatch * kMaxSeqLen / kPageSize;
+
+Tensor op_sdpa_with_kv_cache(
+    const Tensor& query,
+    const Tensor& key,
+    const Tensor& value,
+    Tensor& key_cache,
+    Tensor& value_cache,
+    const int64_t start_pos,
+    const int64_t seq_len,
+    Tensor& out) {
+  executorch::runtime::KernelRuntimeContext context{};
+  return torch::executor::native::sdpa_with_kv_cache_out(
+      context,
+      query,
+      key,
+      value,
+      key_cache,
+      value_cache,
+      start_pos,
+      seq_len,
+      {},
+      0.0,
+      true,
+      {},
+      out);
+}
+
+std::vector<float> random_values(std::mt19937& gen, size_t size) {
+  std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+  std::vector<float> data(size);
+  for (auto& x : data) {
+    x = dist(gen);
+  }
+  return data;
+}
+
+// Pages of both sequences, interleaved and out of order.
+std::vector<int64_t> shuffled_block_table() {
+  std::vector<int64_t> pages(kNumPages);
+  for (int32_t i = 0; i < kNumPages; ++i) {
+    pages[i] = i;
+  }
+  std::shuffle(pages.begin(), pages.end(), std::mt19937(7));
+  return pages;
+}
+
+} // namespace
+
+class OpPagedSdpaWithKVCacheTest : public OperatorTest {
+ protected:
+  Tensor& op_paged_sdpa_with_kv_cache(
+      const Tensor& query,
+      const Tensor& key,
+      const Tensor& value,
+      Tensor& key_cache,
+      Tensor& value_cache,
+      const Tensor& block_table,
+      const Tensor& start_pos,
+      const Tensor& seq_lens,
+      Tensor& out) {
+    return torch::executor::native::paged_sdpa_with_kv_cache_out(
+        context_,
+        query,
+        key,
+        value,
+        key_cache,
+        value_cache,
+        block_table,
+        start_pos,
+        seq_lens,
+        {},
+        0.0,
+        true,
+        {},
+        out);
+  }
+
+  void expect_invalid_page_fails(int64_t start_pos, int64_t seq_len = 1) {
+    TensorFactory<ScalarType::Float> tf;
+    TensorFactory<ScalarType::Long> tf_long;
+
+    Tensor q = tf.ones({1, 1, kHeads, kHeadDim});
+    Tensor k = tf.ones({1, 1, kKVHeads, kHeadDim});
+    Tensor v = tf.ones({1, 1, kKVHeads, kHeadDim});
+    Tensor key_pool = tf.zeros({2, kPageSize, kKVHeads, kHeadDim});
+    Tensor value_pool = tf.zeros({2, kPageSize, kKVHeads, kHeadDim});
+    Tensor block_table = tf_long.make({1, 2}, {0, 2});
+    Tensor out = tf.zeros({1, 1, kHeads, kHeadDim});
+
+    ET_EXPECT_KERNEL_FAILURE(
+        context_,
+        op_paged_sdpa_with_kv_cache(
+            q,
+            k,
+            v,
+            key_pool,
+            value_pool,
+            block_table,
+            tf_long.make({1}, {start_pos}),
+            tf_long.make({1}, {seq_len}),
+            out));
+  }
+};
+
+// Prefills that cross page boundaries and span several query blocks,
+// followed by single-token decode steps, must match the contiguous cache.
+TEST_F(OpPagedSdpaWithKVCacheTest, MatchesContiguousCache) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Long> tf_long;
+  std::mt19937 gen(0);
+
+  Tensor key_cache = tf.zeros({kBatch, kMaxSeqLen, kKVHeads, kHeadDim});
+  Tensor value_cache = tf.zeros({kBatch, kMaxSeqLen, kKVHeads, kHeadDim});
+  Tensor key_pool = tf.zeros({kNumPages, kPageSize, kKVHeads, kHeadDim});
+  Tensor value_pool = tf.zeros({kNumPages, kPageSize, kKVHeads, kHeadDim});
+  Tensor block_table = tf_long.make(
+      {kBatch, kMaxSeqLen / kPageSize}, shuffled_block_table());
+
+  int64_t start_pos = 0;
+  for (int32_t seq_len : {3, 38, 1, 1, 1, 6, 1}) {
+    Tensor q = tf.make(
+        {kBatch, seq_len, kHeads, kHeadDim},
+        random_values(gen, kBatch * seq_len * kHeads * kHeadDim));
+    Tensor k = tf.make(
+        {kBatch, seq_len, kKVHeads, kHeadDim},
+        random_values(gen, kBatch * seq_len * kKVHeads * kHeadDim));
+    Tensor v = tf.make(
+        {kBatch, seq_len, kKVHeads, kHeadDim},
+        random_values(gen, kBatch * seq_len * kKVHeads * kHeadDim));
+
+    Tensor expected = tf.zeros({kBatch, seq_len, kHeads, kHeadDim});
+    op_sdpa_with_kv_cache(
+        q, k, v, key_cache, value_cache, start_pos, seq_len, expected);
+
+    Tensor out = tf.zeros({kBatch, seq_len, kHeads, kHeadDim});
+    op_paged_sdpa_with_kv_cache(
+        q,
+        k,
+        v,
+        key_pool,
+        value_pool,
+        block_table,
+        tf_long.make({kBatch}, {start_pos, start_pos}),
+        tf_long.make({kBatch}, {seq_len, seq_len}),
+        out);
+    EXPECT_TENSOR_CLOSE_WITH_TOL(out, expected, 1e-4, 1e-4);
+
+    start_pos += seq_len;
+  }
+}
+
+// Position kPageSize is on the second page, which is not in the pool.
+TEST_F(OpPagedSdpaWithKVCacheTest, InvalidPageDies) {
+  expect_invalid_page_fails(kPageSize);
+}
+
+// Positions past the end of the block table.
+TEST_F(OpPagedSdpaWithKVCacheTest, PositionPastBlockTableDies) {
+  expect_invalid_page_fails(2 * kPageSize);
+}
+
+// More positions than query rows.
+TEST_F(OpPagedSdpaWithKVCacheTest, SeqLenPastQueryDies) {
+  expect_invalid_page_fails(0, 2);
+}
+
+// Sequences at different positions, with chunks of different lengths padded
+// to the longest one and an idle slot, as a batched generator runs them, on
+// the block table of a PagedKVCacheAllocator. Each sequence must match a
+// contiguous cache of its own.
+TEST_F(OpPagedSdpaWithKVCacheTest, MixedSequencesMatchContiguousCaches) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Long> tf_long;
+  std::mt19937 gen(0);
+  constexpr int32_t kSlots = 3;
+
+  PagedKVCacheAllocator allocator(
+      kNumPages, kPageSize, kSlots, kMaxSeqLen / kPageSize);
+  auto block_table = allocator.block_table();
+  Tensor key_pool = tf.zeros({kNumPages, kPageSize, kKVHeads, kHeadDim});
+  Tensor value_pool = tf.zeros({kNumPages, kPageSize, kKVHeads, kHeadDim});
+  std::vector<Tensor> key_caches;
+  std::vector<Tensor> value_caches;
+  for (int32_t slot = 0; slot < kSlots; ++slot) {
+    key_caches.push_back(tf.zeros({1, kMaxSeqLen, kKVHeads, kHeadDim}));
+    value_caches.push_back(tf.zeros({1, kMaxSeqLen, kKVHeads, kHeadDim}));
+  }
+
+  // New tokens of each slot per step. Slot 1 stays idle, its block table
+  // row all -1, until its prompt is prefilled alongside decode steps.
+  const std::vector<std::vector<int64_t>> steps = {
+      {5, 0, 9}, {1, 0, 1}, {1, 7, 1}, {6, 1, 1}, {1, 1, 0}, {1, 1, 1}};
+  std::vector<int64_t> positions(kSlots, 0);
+  for (const auto& seq_lens : steps) {
+    const int32_t seq_len = static_cast<int32_t>(
+        *std::max_element(seq_lens.begin(), seq_lens.end()));
+    for (int32_t slot = 0; slot < kSlots; ++slot) {
+      ASSERT_EQ(
+          allocator.reserve(slot, positions[slot] + seq_lens[slot]),
+          Error::Ok);
+    }
+    const int32_t row_numel = seq_len * kHeads * kHeadDim;
+    const int32_t kv_row_numel = seq_len * kKVHeads * kHeadDim;
+    Tensor q = tf.make(
+        {kSlots, seq_len, kHeads, kHeadDim},
+        random_values(gen, kSlots * row_numel));
+    Tensor k = tf.make(
+        {kSlots, seq_len, kKVHeads, kHeadDim},
+        random_values(gen, kSlots * kv_row_numel));
+    Tensor v = tf.make(
+        {kSlots, seq_len, kKVHeads, kHeadDim},
+        random_values(gen, kSlots * kv_row_numel));
+
+    Tensor out = tf.ones({kSlots, seq_len, kHeads, kHeadDim});
+    op_paged_sdpa_with_kv_cache(
+        q,
+        k,
+        v,
+        key_pool,
+        value_pool,
+        *block_table,
+        tf_long.make({kSlots}, positions),
+        tf_long.make({kSlots}, seq_lens),
+        out);
+
+    for (int32_t slot = 0; slot < kSlots; ++slot) {
+      const int32_t len = seq_lens[slot];
+      const float* out_row = out.const_data_ptr<float>() + slot * row_numel;
+      if (len > 0) {
+        const auto slice = [&](const Tensor& t, int32_t heads) {
+          const int32_t numel = seq_len * heads * kHeadDim;
+          const float* begin = t.const_data_ptr<float>() + slot * numel;
+          return tf.make(
+              {1, len, heads, kHeadDim},
+              std::vector<float>(begin, begin + len * heads * kHeadDim));
+        };
+        Tensor expected = tf.zeros({1, len, kHeads, kHeadDim});
+        op_sdpa_with_kv_cache(
+            slice(q, kHeads),
+            slice(k, kKVHeads),
+            slice(v, kKVHeads),
+            key_caches[slot],
+            value_caches[slot],
+            positions[slot],
+            len,
+            expected);
+        EXPECT_TENSOR_CLOSE_WITH_TOL(
+            tf.make(
+                {1, len, kHeads, kHeadDim},
+                std::vector<float>(
+                    out_row, out_row + len * kHeads * kHeadDim)),
+            expected,
+            1e-4,
+            1e-4);
+      }
+      // Padding rows are zeroed.
+      for (int32_t i = len * kHeads * kHeadDim; i < row_numel; ++i) {
+        EXPECT_EQ(out_row[i], 0.0f);
+      }
+      positions[slot] += len;
+    }
+  }
+}
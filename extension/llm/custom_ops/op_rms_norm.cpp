@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/llm/custom_ops/op_rms_norm.h>
+
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+
+#include <executorch/extension/kernel_util/make_boxed_from_unboxed_functor.h>
+#include <executorch/extension/parallel/thread_parallel.h>
+#include <executorch/kernels/optimized/vec/functional.h>
+#include <executorch/kernels/optimized/vec/vec.h>
+#include <executorch/runtime/core/exec_aten/util/dim_order_util.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+namespace {
+
+bool validate_rms_norm_args(
+    const Tensor& input,
+    const Tensor& weight,
+    const Tensor& out) {
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      input.dim() >= 1, "input must have at least one dimension");
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(weight.dim() == 1, "weight must be 1-D");
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      weight.size(0) == input.size(input.dim() - 1),
+      "weight must match the last dimension of input");
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      input.scalar_type() == weight.scalar_type() &&
+          input.scalar_type() == out.scalar_type(),
+      "input, weight and out must have the same dtype");
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      is_contiguous_dim_order(input.dim_order().data(), input.dim()),
+      "input must be in contiguous dim order");
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      is_contiguous_dim_order(out.dim_order().data(), out.dim()),
+      "out must be in contiguous dim order");
+  return true;
+}
+
+template <typename CTYPE>
+void rms_norm_row(
+    const CTYPE* __restrict__ input,
+    const CTYPE* __restrict__ weight,
+    CTYPE* __restrict__ output,
+    int64_t dim,
+    double eps) {
+  if constexpr (std::is_floating_point_v<CTYPE>) {
+    using Vec = ::executorch::vec::Vectorized<CTYPE>;
+    const CTYPE sum_sq = ::executorch::vec::map_reduce_all<CTYPE>(
+        [](Vec x) { return x * x; },
+        [](Vec x, Vec y) { return x + y; },
+        input,
+        dim);
+    const Vec scale(
+        CTYPE(1) / std::sqrt(sum_sq / static_cast<CTYPE>(dim) + CTYPE(eps)));
+    ::executorch::vec::map2<CTYPE>(
+        [scale](Vec x, Vec w) { return x * scale * w; },
+        output,
+        input,
+        weight,
+        dim);
+  } else {
+    // Reduced-precision types have no Vectorized specialization; accumulate
+    // in float.
+    float sum_sq = 0;
+    for (int64_t i = 0; i < dim; ++i) {
+      const float x = static_cast<float>(input[i]);
+      sum_sq += x * x;
+    }
+    const float scale = 1.0f /
+        std::sqrt(sum_sq / static_cast<float>(dim) + static_cast<float>(eps));
+    for (int64_t i = 0; i < dim; ++i) {
+      output[i] = static_cast<CTYPE>(
+          static_cast<float>(input[i]) * scale *
+          static_cast<float>(weight[i]));
+    }
+  }
+}
+
+} // namespace
+
+Tensor& rms_norm_out(
+    RuntimeContext& ctx,
+    const Tensor& input,
+    const Tensor& weight,
+    const double eps,
+    Tensor& out) {
+  ET_KERNEL_CHECK(
+      ctx,
+      validate_rms_norm_args(input, weight, out),
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      resize_tensor(out, input.sizes()) == Error::Ok,
+      InvalidArgument,
+      out,
+      "Failed to resize output tensor.");
+
+  if (input.numel() == 0) {
+    return out;
+  }
+
+  const int64_t dim = input.size(input.dim() - 1);
+  const int64_t num_rows = input.numel() / dim;
+
+  ET_SWITCH_FLOATH_TYPES(input.scalar_type(), ctx, "rms_norm.out", CTYPE, [&] {
+    const CTYPE* const input_data = input.const_data_ptr<CTYPE>();
+    const CTYPE* const weight_data = weight.const_data_ptr<CTYPE>();
+    CTYPE* const out_data = out.mutable_data_ptr<CTYPE>();
+    // Give each task enough rows to amortize the threadpool overhead during
+    // decode, where there is a single row per call.
+    const int64_t grain_size = std::max<int64_t>(1, 16384 / dim);
+    torch::executor::parallel_for(
+        0, num_rows, grain_size, [&](int64_t begin, int64_t end) {
+          for (int64_t row = begin; row < end; ++row) {
+            rms_norm_row(
+                input_data + row * dim,
+                weight_data,
+                out_data + row * dim,
+                dim,
+                eps);
+          }
+        });
+  });
+  return out;
+}
+} // namespace native
+} // namespace executor
+} // namespace torch
+
+EXECUTORCH_LIBRARY(
+    llama,
+    "rms_norm.out",
+    torch::executor::native::rms_norm_out);
@@ -0,0 +1,33 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch {
+namespace executor {
+
+namespace native {
+
+// Root mean square layer normalization
+// (https://arxiv.org/abs/1910.07467) over the last dimension of `input`,
+// fused with the elementwise multiply by `weight`:
+//
+//   out = input * rsqrt(mean(input^2, dim=-1) + eps) * weight
+//
+// `weight` must be 1-D with as many elements as the last dimension of `input`.
+Tensor& rms_norm_out(
+    RuntimeContext& ctx,
+    const Tensor& input,
+    const Tensor& weight,
+    const double eps,
+    Tensor& out);
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/llm/custom_ops/op_rms_norm.h>
+#include <executorch/kernels/test/TestUtil.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+using namespace ::testing;
+using exec_aten::ScalarType;
+using exec_aten::Tensor;
+using executorch::runtime::testing::TensorFactory;
+
+class OpRmsNormOutTest : public OperatorTest {
+ protected:
+  Tensor& op_rms_norm_out(
+      const Tensor& input,
+      const Tensor& weight,
+      double eps,
+      Tensor& out) {
+    return torch::executor::native::rms_norm_out(
+        context_, input, weight, eps, out);
+  }
+
+  // Reference: input * rsqrt(mean(input^2) + eps) * weight, row by row.
+  std::vector<float> reference(
+      const std::vector<float>& input,
+      const std::vector<float>& weight,
+      double eps) {
+    const size_t dim = weight.size();
+    std::vector<float> expected(input.size());
+    for (size_t row = 0; row < input.size() / dim; ++row) {
+      double sum_sq = 0;
+      for (size_t i = 0; i < dim; ++i) {
+        sum_sq += input[row * dim + i] * input[row * dim + i];
+      }
+      const double scale = 1.0 / std::sqrt(sum_sq / dim + eps);
+      for (size_t i = 0; i < dim; ++i) {
+        expected[row * dim + i] = input[row * dim + i] * scale * weight[i];
+      }
+    }
+    return expected;
+  }
+};
+
+TEST_F(OpRmsNormOutTest, SmokeTest) {
+  TensorFactory<ScalarType::Float> tf;
+  Tensor input = tf.make({2, 2}, {3, 4, 1, -1});
+  Tensor weight = tf.make({2}, {1, 2});
+  Tensor out = tf.zeros({2, 2});
+
+  Tensor& ret = op_rms_norm_out(input, weight, 0.0, out);
+  EXPECT_TENSOR_EQ(ret, out);
+
+  // Row RMS values are sqrt(12.5) and 1.
+  const float inv_rms = 1.0f / std::sqrt(12.5f);
+  EXPECT_TENSOR_CLOSE(
+      out, tf.make({2, 2}, {3 * inv_rms, 8 * inv_rms, 1, -2}));
+}
+
+TEST_F(OpRmsNormOutTest, MatchesReferenceAcrossVectorTails) {
+  TensorFactory<ScalarType::Float> tf;
+  // 37 is not a multiple of any vector width, so every row has a tail.
+  for (int32_t dim : {1, 8, 37, 256}) {
+    const int32_t rows = 5;
+    std::vector<float> input_data(rows * dim);
+    std::vector<float> weight_data(dim);
+    for (size_t i = 0; i < input_data.size(); ++i) {
+      input_data[i] = std::sin(0.37f * i) * 3.0f;
+    }
+    for (size_t i = 0; i < weight_data.size(); ++i) {
+      weight_data[i] = 0.5f + 0.01f * i;
+    }
+    Tensor input = tf.make({rows, dim}, input_data);
+    Tensor weight = tf.make({dim}, weight_data);
+    Tensor out = tf.zeros({rows, dim});
+
+    op_rms_norm_out(input, weight, 1e-5, out);
+    EXPECT_TENSOR_CLOSE(
+        out, tf.make({rows, dim}, reference(input_data, weight_data, 1e-5)));
+  }
+}
+
+TEST_F(OpRmsNormOutTest, HalfSupport) {
+  TensorFactory<ScalarType::Half> tf;
+  Tensor input = tf.make({1, 4}, {2, -2, 2, -2});
+  Tensor weight = tf.make({4}, {1, 1, 0.5, 0.5});
+  Tensor out = tf.zeros({1, 4});
+
+  op_rms_norm_out(input, weight, 0.0, out);
+  EXPECT_TENSOR_CLOSE(out, tf.make({1, 4}, {1, -1, 0.5, -0.5}));
+}
+
+TEST_F(OpRmsNormOutTest, MismatchedWeightDies) {
+  TensorFactory<ScalarType::Float> tf;
+  Tensor input = tf.ones({2, 4});
+  Tensor weight = tf.ones({3});
+  Tensor out = tf.zeros({2, 4});
+
+  ET_EXPECT_KERNEL_FAILURE(context_, op_rms_norm_out(input, weight, 0.0, out));
+}
+
+TEST_F(OpRmsNormOutTest, MismatchedDtypeDies) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Double> tf_double;
+  Tensor input = tf.ones({2, 4});
+  Tensor weight = tf_double.ones({4});
+  Tensor out = tf.zeros({2, 4});
+
+  ET_EXPECT_KERNEL_FAILURE(context_, op_rms_norm_out(input, weight, 0.0, out));
+}
@@ -0,0 +1,193 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/llm/custom_ops/op_rope.h>
+
+#include <algorithm>
+
+#include <executorch/extension/kernel_util/make_boxed_from_unboxed_functor.h>
+#include <executorch/extension/parallel/thread_parallel.h>
+#include <executorch/kernels/optimized/vec/functional.h>
+#include <executorch/kernels/optimized/vec/vec.h>
+#include <executorch/runtime/core/exec_aten/util/dim_order_util.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+namespace {
+
+bool validate_rope_args(
+    const Tensor& x,
+    const Tensor& freqs_cos,
+    const Tensor& freqs_sin,
+    const bool interleaved,
+    const Tensor& out) {
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      x.dim() == 4, "x must be [batch, seq_len, n_heads, head_dim]");
+  const auto seq_len = x.size(1);
+  const auto head_dim = x.size(3);
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(head_dim % 2 == 0, "head_dim must be even");
+  const auto rot_dim = interleaved ? head_dim / 2 : head_dim;
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      freqs_cos.dim() == 2 && freqs_cos.size(0) == seq_len &&
+          freqs_cos.size(1) == rot_dim,
+      "freqs_cos must be [seq_len, %zd]",
+      static_cast<ssize_t>(rot_dim));
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      tensors_have_same_shape(freqs_cos, freqs_sin),
+      "freqs_cos and freqs_sin must have the same shape");
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      x.scalar_type() == freqs_cos.scalar_type() &&
+          x.scalar_type() == freqs_sin.scalar_type() &&
+          x.scalar_type() == out.scalar_type(),
+      "x, freqs_cos, freqs_sin and out must have the same dtype");
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      is_contiguous_dim_order(x.dim_order().data(), x.dim()) &&
+          is_contiguous_dim_order(
+              freqs_cos.dim_order().data(), freqs_cos.dim()) &&
+          is_contiguous_dim_order(
+              freqs_sin.dim_order().data(), freqs_sin.dim()) &&
+          is_contiguous_dim_order(out.dim_order().data(), out.dim()),
+      "all tensors must be in contiguous dim order");
+  return true;
+}
+
+// Rotates the pairs (x[2i], x[2i + 1]) of one head. Each vector iteration
+// deinterleaves 2 * Vec::size() elements into real and imaginary parts.
+template <typename T>
+void rope_interleaved_row(
+    const T* x,
+    const T* cos,
+    const T* sin,
+    T* out,
+    int64_t half_dim) {
+  using Vec = ::executorch::vec::Vectorized<T>;
+  int64_t i = 0;
+  for (; i + Vec::size() <= half_dim; i += Vec::size()) {
+    auto [x_r, x_i] = ::executorch::vec::deinterleave2(
+        Vec::loadu(x + 2 * i), Vec::loadu(x + 2 * i + Vec::size()));
+    const Vec c = Vec::loadu(cos + i);
+    const Vec s = Vec::loadu(sin + i);
+    auto [lo, hi] =
+        ::executorch::vec::interleave2(x_r * c - x_i * s, x_r * s + x_i * c);
+    lo.store(out + 2 * i);
+    hi.store(out + 2 * i + Vec::size());
+  }
+  for (; i < half_dim; ++i) {
+    const T x_r = x[2 * i];
+    const T x_i = x[2 * i + 1];
+    out[2 * i] = x_r * cos[i] - x_i * sin[i];
+    out[2 * i + 1] = x_r * sin[i] + x_i * cos[i];
+  }
+}
+
+// Rotates the pairs (x[i], x[i + head_dim / 2]) of one head, where the first
+// half is multiplied by -sin, as in rotate_half.
+template <typename T>
+void rope_half_row(
+    const T* x,
+    const T* cos,
+    const T* sin,
+    T* out,
+    int64_t half_dim) {
+  using Vec = ::executorch::vec::Vectorized<T>;
+  int64_t i = 0;
+  for (; i + Vec::size() <= half_dim; i += Vec::size()) {
+    const Vec x1 = Vec::loadu(x + i);
+    const Vec x2 = Vec::loadu(x + half_dim + i);
+    const Vec out1 = x1 * Vec::loadu(cos + i) - x2 * Vec::loadu(sin + i);
+    const Vec out2 = x2 * Vec::loadu(cos + half_dim + i) +
+        x1 * Vec::loadu(sin + half_dim + i);
+    out1.store(out + i);
+    out2.store(out + half_dim + i);
+  }
+  for (; i < half_dim; ++i) {
+    const T x1 = x[i];
+    const T x2 = x[half_dim + i];
+    out[i] = x1 * cos[i] - x2 * sin[i];
+    out[half_dim + i] = x2 * cos[half_dim + i] + x1 * sin[half_dim + i];
+  }
+}
+
+} // namespace
+
+Tensor& apply_rotary_emb_out(
+    RuntimeContext& ctx,
+    const Tensor& x,
+    const Tensor& freqs_cos,
+    const Tensor& freqs_sin,
+    const bool interleaved,
+    Tensor& out) {
+  ET_KERNEL_CHECK(
+      ctx,
+      validate_rope_args(x, freqs_cos, freqs_sin, interleaved, out),
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      resize_tensor(out, x.sizes()) == Error::Ok,
+      InvalidArgument,
+      out,
+      "Failed to resize output tensor.");
+
+  if (x.numel() == 0) {
+    return out;
+  }
+
+  const int64_t seq_len = x.size(1);
+  const int64_t n_heads = x.size(2);
+  const int64_t head_dim = x.size(3);
+  const int64_t half_dim = head_dim / 2;
+  const int64_t rot_dim = freqs_cos.size(1);
+  const int64_t num_rows = x.numel() / head_dim;
+
+  ET_SWITCH_FLOAT_TYPES(
+      x.scalar_type(), ctx, "apply_rotary_emb.out", CTYPE, [&] {
+        const CTYPE* const x_data = x.const_data_ptr<CTYPE>();
+        const CTYPE* const cos_data = freqs_cos.const_data_ptr<CTYPE>();
+        const CTYPE* const sin_data = freqs_sin.const_data_ptr<CTYPE>();
+        CTYPE* const out_data = out.mutable_data_ptr<CTYPE>();
+        // A row is one head of one token. Each row reads all of its inputs
+        // before writing, so out may alias x.
+        const int64_t grain_size = std::max<int64_t>(1, 4096 / head_dim);
+        torch::executor::parallel_for(
+            0, num_rows, grain_size, [&](int64_t begin, int64_t end) {
+              for (int64_t row = begin; row < end; ++row) {
+                const int64_t pos = (row / n_heads) % seq_len;
+                const CTYPE* cos = cos_data + pos * rot_dim;
+                const CTYPE* sin = sin_data + pos * rot_dim;
+                if (interleaved) {
+                  rope_interleaved_row(
+                      x_data + row * head_dim,
+                      cos,
+                      sin,
+                      out_data + row * head_dim,
+                      half_dim);
+                } else {
+                  rope_half_row(
+                      x_data + row * head_dim,
+                      cos,
+                      sin,
+                      out_data + row * head_dim,
+                      half_dim);
+                }
+              }
+            });
+      });
+  return out;
+}
+} // namespace native
+} // namespace executor
+} // namespace torch
+
+EXECUTORCH_LIBRARY(
+    llama,
+    "apply_rotary_emb.out",
+    torch::executor::native::apply_rotary_emb_out);
@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch {
+namespace executor {
+
+namespace native {
+
+// Rotary position embedding (https://arxiv.org/abs/2104.09864) of `x`, with
+// shape [batch, seq_len, n_heads, head_dim], in a single pass.
+//
+// If `interleaved` is true, adjacent elements (x[2i], x[2i + 1]) are rotated
+// by the angle whose cosine and sine are freqs_cos[s][i] and freqs_sin[s][i],
+// as in examples/models/llama/rope.py:apply_rotary_emb. The tables have shape
+// [seq_len, head_dim / 2].
+//
+// Otherwise the two halves of each head are rotated against each other,
+// (x[i], x[i + head_dim / 2]), as in HuggingFace's rotate_half
+// (rope.py:hf_apply_rotary_emb). The tables have shape [seq_len, head_dim].
+//
+// `out` may alias `x`, so that the rotation is applied in place.
+Tensor& apply_rotary_emb_out(
+    RuntimeContext& ctx,
+    const Tensor& x,
+    const Tensor& freqs_cos,
+    const Tensor& freqs_sin,
+    const bool interleaved,
+    Tensor& out);
+} // namespace native
+} // namespace executor
+} // namespace torch
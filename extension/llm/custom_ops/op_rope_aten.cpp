@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/aten_util/make_aten_functor_from_et_functor.h>
+#include <executorch/extension/llm/custom_ops/op_rope.h>
+
+#include <torch/library.h>
+
+namespace torch::executor::native {
+namespace {
+Tensor& apply_rotary_emb_out_no_context(
+    const Tensor& x,
+    const Tensor& freqs_cos,
+    const Tensor& freqs_sin,
+    const bool interleaved,
+    Tensor& out) {
+  exec_aten::RuntimeContext context;
+  return apply_rotary_emb_out(
+      context, x, freqs_cos, freqs_sin, interleaved, out);
+}
+at::Tensor apply_rotary_emb_aten(
+    const at::Tensor& x,
+    const at::Tensor& freqs_cos,
+    const at::Tensor& freqs_sin,
+    const bool interleaved) {
+  auto out = at::empty_like(x);
+  WRAP_TO_ATEN(apply_rotary_emb_out_no_context, 4)
+  (x, freqs_cos, freqs_sin, interleaved, out);
+  return out;
+}
+} // namespace
+} // namespace torch::executor::native
+
+TORCH_LIBRARY_FRAGMENT(llama, m) {
+  m.def(
+      "apply_rotary_emb(Tensor x, Tensor freqs_cos, Tensor freqs_sin, "
+      "bool interleaved=True) -> Tensor");
+  m.def(
+      "apply_rotary_emb.out(Tensor x, Tensor freqs_cos, Tensor freqs_sin, "
+      "bool interleaved=True, *, Tensor(a!) out) -> Tensor(a!)");
+}
+
+TORCH_LIBRARY_IMPL(llama, CompositeExplicitAutograd, m) {
+  m.impl("apply_rotary_emb", torch::executor::native::apply_rotary_emb_aten);
+  m.impl(
+      "apply_rotary_emb.out",
+      WRAP_TO_ATEN(
+          torch::executor::native::apply_rotary_emb_out_no_context, 4));
+}
@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/llm/custom_ops/op_rope.h>
+#include <executorch/kernels/test/TestUtil.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+using namespace ::testing;
+using exec_aten::ScalarType;
+using exec_aten::Tensor;
+using executorch::runtime::testing::TensorFactory;
+
+class OpApplyRotaryEmbOutTest : public OperatorTest {
+ protected:
+  Tensor& op_apply_rotary_emb_out(
+      const Tensor& x,
+      const Tensor& freqs_cos,
+      const Tensor& freqs_sin,
+      bool interleaved,
+      Tensor& out) {
+    return torch::executor::native::apply_rotary_emb_out(
+        context_, x, freqs_cos, freqs_sin, interleaved, out);
+  }
+
+  // Checks the kernel against a scalar version of rope.py for a
+  // [batch, seq_len, n_heads, head_dim] input.
+  void test_matches_reference(
+      int32_t batch,
+      int32_t seq_len,
+      int32_t n_heads,
+      int32_t head_dim,
+      bool interleaved) {
+    TensorFactory<ScalarType::Float> tf;
+    const int32_t half_dim = head_dim / 2;
+    const int32_t rot_dim = interleaved ? half_dim : head_dim;
+    std::vector<float> x(batch * seq_len * n_heads * head_dim);
+    for (size_t i = 0; i < x.size(); ++i) {
+      x[i] = std::sin(0.1f * i + 0.3f);
+    }
+    std::vector<float> cos(seq_len * rot_dim);
+    std::vector<float> sin(seq_len * rot_dim);
+    for (int32_t s = 0; s < seq_len; ++s) {
+      for (int32_t i = 0; i < rot_dim; ++i) {
+        const float angle =
+            s * std::pow(10000.0f, -2.0f * (i % half_dim) / head_dim);
+        cos[s * rot_dim + i] = std::cos(angle);
+        sin[s * rot_dim + i] = std::sin(angle);
+      }
+    }
+
+    std::vector<float> expected(x.size());
+    for (size_t row = 0; row < x.size() / head_dim; ++row) {
+      const int32_t s = (row / n_heads) % seq_len;
+      const float* xr = x.data() + row * head_dim;
+      float* er = expected.data() + row * head_dim;
+      const float* c = cos.data() + s * rot_dim;
+      const float* sn = sin.data() + s * rot_dim;
+      for (int32_t i = 0; i < half_dim; ++i) {
+        if (interleaved) {
+          er[2 * i] = xr[2 * i] * c[i] - xr[2 * i + 1] * sn[i];
+          er[2 * i + 1] = xr[2 * i] * sn[i] + xr[2 * i + 1] * c[i];
+        } else {
+          er[i] = xr[i] * c[i] - xr[i + half_dim] * sn[i];
+          er[i + half_dim] =
+              xr[i + half_dim] * c[i + half_dim] + xr[i] * sn[i + half_dim];
+        }
+      }
+    }
+
+    const std::vector<int32_t> sizes = {batch, seq_len, n_heads, head_dim};
+    Tensor out = tf.zeros(sizes);
+    Tensor& ret = op_apply_rotary_emb_out(
+        tf.make(sizes, x),
+        tf.make({seq_len, rot_dim}, cos),
+        tf.make({seq_len, rot_dim}, sin),
+        interleaved,
+        out);
+    EXPECT_TENSOR_EQ(ret, out);
+    EXPECT_TENSOR_CLOSE(out, tf.make(sizes, expected));
+  }
+};
+
+TEST_F(OpApplyRotaryEmbOutTest, InterleavedSmokeTest) {
+  TensorFactory<ScalarType::Float> tf;
+  // Rotating (1, 0) by 90 degrees and (0, 2) by 180 degrees.
+  Tensor x = tf.make({1, 1, 1, 4}, {1, 0, 0, 2});
+  Tensor cos = tf.make({1, 2}, {0, -1});
+  Tensor sin = tf.make({1, 2}, {1, 0});
+  Tensor out = tf.zeros({1, 1, 1, 4});
+
+  op_apply_rotary_emb_out(x, cos, sin, /*interleaved=*/true, out);
+  EXPECT_TENSOR_CLOSE(out, tf.make({1, 1, 1, 4}, {0, 1, 0, -2}));
+}
+
+TEST_F(OpApplyRotaryEmbOutTest, InterleavedMatchesReference) {
+  // head_dim 6 is narrower than a vector, 128 is the llama head size, and 70
+  // leaves a tail.
+  for (int32_t head_dim : {6, 70, 128}) {
+    test_matches_reference(2, 3, 4, head_dim, /*interleaved=*/true);
+  }
+}
+
+TEST_F(OpApplyRotaryEmbOutTest, RotateHalfMatchesReference) {
+  for (int32_t head_dim : {6, 70, 128}) {
+    test_matches_reference(2, 3, 4, head_dim, /*interleaved=*/false);
+  }
+}
+
+TEST_F(OpApplyRotaryEmbOutTest, InPlace) {
+  TensorFactory<ScalarType::Float> tf;
+  Tensor x = tf.make({1, 2, 1, 2}, {1, 0, 0, 1});
+  Tensor cos = tf.make({2, 1}, {0, 0});
+  Tensor sin = tf.make({2, 1}, {1, -1});
+
+  op_apply_rotary_emb_out(x, cos, sin, /*interleaved=*/true, x);
+  EXPECT_TENSOR_CLOSE(x, tf.make({1, 2, 1, 2}, {0, 1, 1, 0}));
+}
+
+TEST_F(OpApplyRotaryEmbOutTest, MismatchedFreqsDies) {
+  TensorFactory<ScalarType::Float> tf;
+  Tensor x = tf.ones({1, 2, 1, 4});
+  // Interleaved tables have head_dim / 2 columns.
+  Tensor cos = tf.ones({2, 4});
+  Tensor sin = tf.ones({2, 4});
+  Tensor out = tf.zeros({1, 2, 1, 4});
+
+  ET_EXPECT_KERNEL_FAILURE(
+      context_,
+      op_apply_rotary_emb_out(x, cos, sin, /*interleaved=*/true, out));
+}
+
+TEST_F(OpApplyRotaryEmbOutTest, OddHeadDimDies) {
+  TensorFactory<ScalarType::Float> tf;
+  Tensor x = tf.ones({1, 1, 1, 3});
+  Tensor cos = tf.ones({1, 3});
+  Tensor sin = tf.ones({1, 3});
+  Tensor out = tf.zeros({1, 1, 1, 3});
+
+  ET_EXPECT_KERNEL_FAILURE(
+      context_,
+      op_apply_rotary_emb_out(x, cos, sin, /*interleaved=*/false, out));
+}
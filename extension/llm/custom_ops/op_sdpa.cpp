@@ -11,6 +11,7 @@
 #include <executorch/kernels/optimized/blas/CPUBlas.h>
 #include <executorch/kernels/optimized/vec/functional.h>
 #include <executorch/kernels/optimized/vec/vec.h>
+#include <executorch/kernels/optimized/vec/vec_math.h>
 #include <executorch/runtime/core/exec_aten/util/dim_order_util.h>
 // @lint-ignore CLANGTIDY facebook-unused-include-check
 #include <executorch/runtime/core/exec_aten/util/scalar_type_util.h>
@@ -95,9 +96,7 @@ _exp_reduce_sum_fusion_kernel(T1* a, const int& size, T2* out, T1& val) {
   for (int i = 0; i < vec_size * (size / vec_size); i += vec_size) {
     auto tmp0 = vec::Vectorized<T1>::loadu(a + i);
     auto tmp1 = tmp0 - vec_max;
-    // Replace with exp_u20 later
-    // auto tmp2 = tmp1.exp_u20();
-    auto tmp2 = tmp1.exp();
+    auto tmp2 = vec::vec_exp(tmp1);
     vec_tmp_sum += tmp2;
     util::_store(out + i, tmp2);
   }
@@ -213,6 +212,25 @@ sdpa_with_kv_cache does not use attn_mask.
 
 TODO: Just handle conversion of bool mask to float
 */
+
+/*
+A KV cache stored as a pool of fixed-size pages, as in paged attention.
+key and value are then [num_pages, page_size, num heads, head dim] pools,
+and position p of batch entry b lives at row p % page_size of page
+block_table[b * block_table_stride + p / page_size]. Attention is computed
+one page at a time, so that each q @ k.T block reads contiguous keys.
+Every batch entry has its own position and number of queries.
+*/
+struct PagedKVCache {
+  const int64_t* block_table;
+  int64_t block_table_stride;
+  int64_t page_size;
+  // Position of the first query of each batch entry.
+  const int64_t* start_pos;
+  // Number of queries of each batch entry. Later rows are padding.
+  const int64_t* seq_lens;
+};
+
 template <typename scalar_t, int64_t q_split_size, int64_t kv_split_size>
 void cpu_flash_attention(
     Tensor& output,
@@ -224,7 +242,8 @@ void cpu_flash_attention(
     const optional<Tensor>& attn_mask,
     const optional<double>& scale,
     bool is_seq_at_dim_1 = false,
-    const int64_t start_pos = 0) {
+    const int64_t start_pos = 0,
+    const PagedKVCache* paged_kv_cache = nullptr) {
   (void)dropout_p;
   // Query (Batch x Num_heads  x Q_seq_len  x Dim_per_head)
   // Key   (Batch x Num_heads  x KV_seq_len x Dim_per_head)
@@ -270,7 +289,6 @@ void cpu_flash_attention(
     qSize = query.size(1);
     kvSize = value.size(1);
   }
-
   ET_CHECK_MSG(
       num_heads_kv <= num_head,
       "FlashAttention does not support num kv heads > num query heads.Got num query heads=%" PRId64
@@ -363,6 +381,9 @@ void cpu_flash_attention(
 
   int64_t qSplitSize = q_split_size > qSize ? qSize : q_split_size;
   int64_t kvSplitSize = kv_split_size > kvSize ? kvSize : kv_split_size;
+  if (paged_kv_cache != nullptr) {
+    kvSplitSize = paged_kv_cache->page_size;
+  }
   int64_t qSlice = (qSize - 1) / qSplitSize + 1;
 #ifdef ET_USE_THREADPOOL
   int64_t num_thread =
@@ -419,7 +440,28 @@ void cpu_flash_attention(
 
     for (int64_t z = begin; z < end; z++) {
       int64_t m = k * qSplitSize;
-      int64_t qBlockSize = std::min(qSplitSize, qSize - m);
+      int64_t seq_start_pos = start_pos;
+      int64_t seq_q_size = qSize;
+      int64_t seq_kv_size = kvSize;
+      if (paged_kv_cache != nullptr) {
+        seq_start_pos = paged_kv_cache->start_pos[i];
+        seq_q_size = paged_kv_cache->seq_lens[i];
+        seq_kv_size = seq_start_pos + seq_q_size;
+      }
+      // Rows past the queries of this batch entry are padding.
+      for (int64_t row = std::max(m, seq_q_size);
+           row < std::min(m + qSplitSize, qSize);
+           ++row) {
+        fill_stub(
+            out_data + i * oStrideB + j * oStrideH + row * oStrideM,
+            static_cast<scalar_t>(0),
+            headSize);
+      }
+      if (m >= seq_q_size) {
+        util::data_index_step(i, batchSize, j, num_head, k, qSlice);
+        continue;
+      }
+      int64_t qBlockSize = std::min(qSplitSize, seq_q_size - m);
       // Initialize max and sum
       fill_stub(
           qk_max_data, -std::numeric_limits<accum_t>::infinity(), qBlockSize);
@@ -450,11 +492,25 @@ void cpu_flash_attention(
       // but that requires storing attention mask in float as the current
       // code doesnt support bool attention mask.
       // However, lets just fix that as well.
-      int64_t num_keys =
-          is_causal ? std::min(m + start_pos + qBlockSize, kvSize) : kvSize;
+      int64_t num_keys = is_causal
+          ? std::min(m + seq_start_pos + qBlockSize, seq_kv_size)
+          : seq_kv_size;
       auto j_kv = j / num_reps;
       for (int64_t n = 0; n < num_keys; n += kvSplitSize) {
-        int64_t kvBlockSize = std::min(kvSplitSize, kvSize - n);
+        int64_t kvBlockSize = std::min(kvSplitSize, seq_kv_size - n);
+        const scalar_t* k_block;
+        const scalar_t* v_block;
+        if (paged_kv_cache != nullptr) {
+          // Each split is one page of the pool.
+          const int64_t page = paged_kv_cache->block_table
+                                   [i * paged_kv_cache->block_table_stride +
+                                    n / kvSplitSize];
+          k_block = k_data + page * kStrideB + j_kv * kStrideH;
+          v_block = v_data + page * vStrideB + j_kv * vStrideH;
+        } else {
+          k_block = k_data + i * kStrideB + j_kv * kStrideH + n * kStrideN;
+          v_block = v_data + i * vStrideB + j_kv * vStrideH + n * vStrideN;
+        }
         // Calculate scale * q @ k.T
         fill_stub(qk_data, static_cast<accum_t>(0), qSplitSize * kvSplitSize);
         ::executorch::cpublas::gemm(
@@ -464,7 +520,7 @@ void cpu_flash_attention(
             qBlockSize,
             headSize,
             static_cast<accum_t>(1),
-            k_data + i * kStrideB + j_kv * kStrideH + n * kStrideN,
+            k_block,
             kStrideN,
             q_data + i * qStrideB + j * qStrideH + m * qStrideM,
             qStrideM,
@@ -479,21 +535,24 @@ void cpu_flash_attention(
         // Then for causal mask, the entries that needs to be
         // ignored are
         // [8, 9:31], [9, 10:31], [10, 10:31], [11, 11:31]
-        // Following condition says that num_keys = 8 + 4 =12
-        // (num_keys - n) <= kvSplitSize
-        // num_keys <= n + kvSplitSize
-        // If n + kvSplitSize is larger than 12, then some
-        // entries need masked out. In our example n = 4
-        // will qualify for that
-        if (is_causal && num_keys - n <= kvSplitSize) {
-          // For this fn to work k_split_size > q_split_size
+        // The first row may attend to keys up to m + start_pos, so any
+        // block that extends past that holds masked entries. In our
+        // example that is every block with n + kvBlockSize > 9.
+        // Rows can be masked out entirely in blocks after the first one,
+        // e.g. when kvSplitSize is smaller than qSplitSize. Their running
+        // max then comes from an earlier block, so exp() stays finite.
+        if (is_causal && n + kvBlockSize > m + seq_start_pos + 1) {
           for (int32_t row = 0; row < qBlockSize; ++row) {
-            int64_t last_col = m + (row + start_pos) - n;
+            int64_t first_masked_col =
+                std::max<int64_t>(m + (row + seq_start_pos) - n + 1, 0);
+            if (first_masked_col >= kvBlockSize) {
+              continue;
+            }
             accum_t* row_ptr = qk_data + row * kvBlockSize;
             fill_stub(
-                row_ptr + last_col + 1,
+                row_ptr + first_masked_col,
                 -std::numeric_limits<accum_t>::infinity(),
-                kvBlockSize - last_col - 1);
+                kvBlockSize - first_masked_col);
           }
         }
         // Update attention weights with attention mask
@@ -562,7 +621,7 @@ void cpu_flash_attention(
             qBlockSize,
             kvBlockSize,
             static_cast<accum_t>(1),
-            v_data + i * vStrideB + j_kv * vStrideH + n * vStrideN,
+            v_block,
             vStrideN,
             conditional_data_ptr(qk_data, qk_reduced_data),
             kvBlockSize,
@@ -753,6 +812,321 @@ void update_cache(
   }
 }
 
+bool validate_paged_cache_params(
+    const Tensor& q_projected,
+    const Tensor& k_projected,
+    const Tensor& v_projected,
+    const Tensor& key_cache,
+    const Tensor& value_cache,
+    const Tensor& block_table,
+    const Tensor& start_pos,
+    const Tensor& seq_lens) {
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      q_projected.dim() == 4 && k_projected.dim() == 4 &&
+          v_projected.dim() == 4,
+      "query, key and value must be 4D tensors");
+
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      key_cache.dim() == 4 && value_cache.dim() == 4,
+      "key and value caches must be 4D tensors");
+
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      key_cache.sizes() == value_cache.sizes(),
+      "key and value caches must have the same shape");
+
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      k_projected.size(2) == key_cache.size(2) &&
+          k_projected.size(3) == key_cache.size(3) &&
+          v_projected.size(2) == value_cache.size(2) &&
+          v_projected.size(3) == value_cache.size(3),
+      "key and value must have the number of heads and head dim of the "
+      "caches");
+
+  const int64_t seq_length = q_projected.size(1);
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      seq_length > 0 && k_projected.size(1) == seq_length &&
+          v_projected.size(1) == seq_length,
+      "query, key and value must hold the same number of positions");
+
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      k_projected.scalar_type() == key_cache.scalar_type() &&
+          v_projected.scalar_type() == value_cache.scalar_type(),
+      "key and value must have the data type of the caches");
+
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      is_contiguous_dim_order(key_cache.dim_order().data(), key_cache.dim()) &&
+          is_contiguous_dim_order(
+              value_cache.dim_order().data(), value_cache.dim()) &&
+          is_contiguous_dim_order(
+              k_projected.dim_order().data(), k_projected.dim()) &&
+          is_contiguous_dim_order(
+              v_projected.dim_order().data(), v_projected.dim()),
+      "key, value and caches must be in contiguous dim order");
+
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      block_table.dim() == 2 && block_table.scalar_type() == ScalarType::Long,
+      "block_table must be a 2D Long tensor");
+
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      is_contiguous_dim_order(
+          block_table.dim_order().data(), block_table.dim()),
+      "block_table must be in contiguous dim order");
+
+  const int64_t batch_size = q_projected.size(0);
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      block_table.size(0) == batch_size && k_projected.size(0) == batch_size &&
+          v_projected.size(0) == batch_size,
+      "block_table, query, key and value must have the same batch size");
+
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      start_pos.dim() == 1 && seq_lens.dim() == 1 &&
+          start_pos.scalar_type() == ScalarType::Long &&
+          seq_lens.scalar_type() == ScalarType::Long &&
+          start_pos.size(0) == batch_size && seq_lens.size(0) == batch_size,
+      "start_pos and seq_lens must be Long tensors of the batch size");
+
+  const int64_t page_size = key_cache.size(1);
+  const int64_t num_pages = key_cache.size(0);
+  const int64_t* start_pos_data = start_pos.const_data_ptr<int64_t>();
+  const int64_t* seq_lens_data = seq_lens.const_data_ptr<int64_t>();
+  const int64_t* block_table_data = block_table.const_data_ptr<int64_t>();
+  for (int64_t batch = 0; batch < batch_size; ++batch) {
+    ET_LOG_MSG_AND_RETURN_IF_FALSE(
+        start_pos_data[batch] >= 0 && seq_lens_data[batch] >= 0 &&
+            seq_lens_data[batch] <= seq_length,
+        "Invalid start_pos %" PRId64 " or seq_len %" PRId64
+        " of batch entry %" PRId64,
+        start_pos_data[batch],
+        seq_lens_data[batch],
+        batch);
+    // The pages of an idle batch entry, or past its positions, are not
+    // read, and may be -1.
+    const int64_t num_used_pages =
+        (start_pos_data[batch] + seq_lens_data[batch] + page_size - 1) /
+        page_size;
+    ET_LOG_MSG_AND_RETURN_IF_FALSE(
+        num_used_pages <= block_table.size(1),
+        "start_pos + seq_len = %" PRId64 " of batch entry %" PRId64
+        " exceeds the %zd pages of %" PRId64 " positions in block_table",
+        start_pos_data[batch] + seq_lens_data[batch],
+        batch,
+        block_table.size(1),
+        page_size);
+    for (int64_t index = 0; index < num_used_pages; ++index) {
+      const int64_t page =
+          block_table_data[batch * block_table.size(1) + index];
+      ET_LOG_MSG_AND_RETURN_IF_FALSE(
+          page >= 0 && page < num_pages,
+          "block_table[%" PRId64 "][%" PRId64 "] = %" PRId64
+          " is not one of the %" PRId64 " pages of the cache",
+          batch,
+          index,
+          page,
+          num_pages);
+    }
+  }
+
+  return true;
+}
+
+/*
+Writes the first seq_lens[b] positions of batch entry b of projected_value
+[bs, seq_len, num heads, head dim] to positions
+start_pos[b]...start_pos[b] + seq_lens[b] - 1 of a paged cache
+[num_pages, page_size, num heads, head dim], one run of positions per page.
+*/
+void update_paged_cache(
+    const Tensor& projected_value,
+    const Tensor& cache,
+    const Tensor& block_table,
+    const Tensor& start_pos,
+    const Tensor& seq_lens) {
+  const int64_t page_size = cache.size(1);
+  const size_t row_bytes = projected_value.strides()[1] * cache.element_size();
+  const int64_t* block_table_data = block_table.const_data_ptr<int64_t>();
+  const uint8_t* value_data =
+      static_cast<const uint8_t*>(projected_value.const_data_ptr());
+  uint8_t* cache_data = static_cast<uint8_t*>(cache.mutable_data_ptr());
+  const size_t page_bytes = cache.strides()[0] * cache.element_size();
+
+  for (int64_t batch = 0; batch < projected_value.size(0); ++batch) {
+    const uint8_t* src = value_data +
+        batch * projected_value.strides()[0] * cache.element_size();
+    const int64_t seq_len = seq_lens.const_data_ptr<int64_t>()[batch];
+    for (int64_t t = 0; t < seq_len;) {
+      const int64_t pos = start_pos.const_data_ptr<int64_t>()[batch] + t;
+      const int64_t page =
+          block_table_data[batch * block_table.size(1) + pos / page_size];
+      const int64_t row = pos % page_size;
+      const int64_t num_rows = std::min(page_size - row, seq_len - t);
+      std::memcpy(
+          cache_data + page * page_bytes + row * row_bytes,
+          src + t * row_bytes,
+          num_rows * row_bytes);
+      t += num_rows;
+    }
+  }
+}
+
+/*
+A KV cache used as a ring buffer, so that generation can go on past the
+number of positions in the cache, as in StreamingLLM. The first
+num_sink_tokens slots keep the first positions of the sequence, the
+attention sinks, and the other slots hold a sliding window of the most
+recent positions. Position p of the sequence lives at slot p while
+p < num_sink_tokens and at slot
+num_sink_tokens + (p - num_sink_tokens) % window_size after that.
+*/
+int64_t ring_cache_slot(
+    int64_t pos,
+    int64_t num_sink_tokens,
+    int64_t cache_size) {
+  if (pos < num_sink_tokens) {
+    return pos;
+  }
+  return num_sink_tokens +
+      (pos - num_sink_tokens) % (cache_size - num_sink_tokens);
+}
+
+bool validate_ring_cache_params(
+    const Tensor& q_projected,
+    const Tensor& k_projected,
+    const Tensor& v_projected,
+    const Tensor& key_cache,
+    const Tensor& value_cache,
+    int64_t start_pos,
+    int64_t seq_length,
+    int64_t num_sink_tokens) {
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      q_projected.dim() == 4 && k_projected.dim() == 4 &&
+          v_projected.dim() == 4,
+      "query, key and value must be 4D tensors");
+
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      key_cache.dim() == 4 && value_cache.dim() == 4,
+      "key and value caches must be 4D tensors");
+
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      key_cache.sizes() == value_cache.sizes(),
+      "key and value caches must have the same shape");
+
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      k_projected.size(0) == key_cache.size(0) &&
+          k_projected.size(2) == key_cache.size(2) &&
+          k_projected.size(3) == key_cache.size(3) &&
+          v_projected.sizes() == k_projected.sizes(),
+      "key and value must have the batch size, number of heads and head "
+      "dim of the caches");
+
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      k_projected.size(1) == seq_length,
+      "key and value must hold seq_len positions");
+
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      k_projected.element_size() == key_cache.element_size() &&
+          v_projected.element_size() == value_cache.element_size(),
+      "key and value must have the data type size of the caches");
+
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      is_contiguous_dim_order(key_cache.dim_order().data(), key_cache.dim()) &&
+          is_contiguous_dim_order(
+              value_cache.dim_order().data(), value_cache.dim()) &&
+          is_contiguous_dim_order(
+              k_projected.dim_order().data(), k_projected.dim()) &&
+          is_contiguous_dim_order(
+              v_projected.dim_order().data(), v_projected.dim()),
+      "key, value and caches must be in contiguous dim order");
+
+  const int64_t cache_size = key_cache.size(1);
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      num_sink_tokens >= 0 && num_sink_tokens < cache_size,
+      "num_sink_tokens %" PRId64 " must be less than the cache size %" PRId64,
+      num_sink_tokens,
+      cache_size);
+
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      start_pos >= 0 && seq_length > 0, "Invalid start_pos or seq_len");
+
+  // Once the ring wraps around, the keys of a call must not overwrite each
+  // other.
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      start_pos + seq_length <= cache_size ||
+          seq_length <= cache_size - num_sink_tokens,
+      "seq_len %" PRId64 " exceeds the sliding window of %" PRId64
+      " positions",
+      seq_length,
+      cache_size - num_sink_tokens);
+
+  return true;
+}
+
+/*
+Writes projected_value [bs, seq_len, num heads, head dim] to the slots of
+positions start_pos...start_pos + seq_len - 1 of a ring cache
+[bs, cache_size, num heads, head dim], one run of slots at a time.
+*/
+void update_ring_cache(
+    const Tensor& projected_value,
+    const Tensor& cache,
+    int64_t start_pos,
+    int64_t num_sink_tokens) {
+  const int64_t cache_size = cache.size(1);
+  const int64_t seq_len = projected_value.size(1);
+  const size_t row_bytes = cache.strides()[1] * cache.element_size();
+  const uint8_t* value_data =
+      static_cast<const uint8_t*>(projected_value.const_data_ptr());
+  uint8_t* cache_data = static_cast<uint8_t*>(cache.mutable_data_ptr());
+
+  for (int64_t batch = 0; batch < projected_value.size(0); ++batch) {
+    const uint8_t* src = value_data +
+        batch * projected_value.strides()[0] * cache.element_size();
+    uint8_t* dst =
+        cache_data + batch * cache.strides()[0] * cache.element_size();
+    for (int64_t t = 0; t < seq_len;) {
+      const int64_t slot =
+          ring_cache_slot(start_pos + t, num_sink_tokens, cache_size);
+      const int64_t run_end =
+          slot < num_sink_tokens ? num_sink_tokens : cache_size;
+      const int64_t num_rows = std::min(run_end - slot, seq_len - t);
+      std::memcpy(
+          dst + slot * row_bytes, src + t * row_bytes, num_rows * row_bytes);
+      t += num_rows;
+    }
+  }
+}
+
+/*
+Fills the [seq_len, cache_size] attention mask of a ring cache whose slots
+are all in use, after the keys of positions start_pos...start_pos + seq_len
+- 1 were written. A query attends to the slots that hold its own position
+or an earlier one. Masked entries get a large finite negative value rather
+than -inf, so that flash attention stays finite for a query whose visible
+slots all come after the first block of keys.
+*/
+template <typename scalar_t>
+void fill_ring_attention_mask(
+    scalar_t* mask,
+    int64_t start_pos,
+    int64_t seq_len,
+    int64_t num_sink_tokens,
+    int64_t cache_size) {
+  const int64_t window_size = cache_size - num_sink_tokens;
+  const int64_t last_pos = start_pos + seq_len - 1;
+  const int64_t last_slot =
+      ring_cache_slot(last_pos, num_sink_tokens, cache_size);
+  const scalar_t masked = -std::numeric_limits<scalar_t>::max() / 2;
+  for (int64_t row = 0; row < seq_len; ++row) {
+    scalar_t* row_ptr = mask + row * cache_size;
+    // Sinks precede every query, since the ring wrapped around.
+    std::fill(row_ptr, row_ptr + num_sink_tokens, static_cast<scalar_t>(0));
+    for (int64_t slot = num_sink_tokens; slot < cache_size; ++slot) {
+      const int64_t pos =
+          last_pos - (last_slot - slot + window_size) % window_size;
+      row_ptr[slot] = pos <= start_pos + row ? 0 : masked;
+    }
+  }
+}
+
 } // anonymous namespace
 
 Tensor& flash_attention_kernel_out(
@@ -1024,6 +1398,274 @@ Tensor& sdpa_with_kv_cache_out(
 
   return output;
 }
+
+/*
+  Paged variant of sdpa_with_kv_cache. The caches are pools of pages shared
+  by all sequences, and block_table maps the positions of each sequence to
+  pages, so that a sequence only holds the pages it has written to. Every
+  sequence of the batch has its own position and number of new tokens, so
+  that sequences at different steps, e.g. some decoding one token and some
+  prefilling a chunk of their prompt, run in one call.
+
+  @param[in] key_cache, value_cache Pools of pages.
+  Format [num_pages, page_size, num heads, head dim]
+  @param[in] block_table Pages of each sequence, in order of position.
+  Format [batch size, max pages per sequence], Long. Only the entries for
+  positions before start_pos[b] + seq_lens[b] are read, so the others may
+  be -1.
+  @param[in] start_pos Position of the first new token of each sequence.
+  Format [batch size], Long.
+  @param[in] seq_lens Number of new tokens of each sequence, at most the
+  seq_len of the query. The later query rows are padding: they are not
+  written to the caches and their output is 0. 0 for an idle sequence.
+  Format [batch size], Long.
+  Only attention without attn_mask is supported. Other params are as in
+  sdpa_with_kv_cache.
+*/
+Tensor& paged_sdpa_with_kv_cache_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& q_projected,
+    const Tensor& k_projected,
+    const Tensor& v_projected,
+    Tensor& key_cache,
+    Tensor& value_cache,
+    const Tensor& block_table,
+    const Tensor& start_pos,
+    const Tensor& seq_lens,
+    const optional<Tensor>& attn_mask,
+    const double dropout_p,
+    const bool is_causal,
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const optional<double> scale,
+    Tensor& output) {
+  ET_KERNEL_CHECK(
+      ctx,
+      validate_paged_cache_params(
+          q_projected,
+          k_projected,
+          v_projected,
+          key_cache,
+          value_cache,
+          block_table,
+          start_pos,
+          seq_lens),
+      InvalidArgument,
+      output);
+
+  // A mask would need one row per sequence and position.
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      !attn_mask.has_value(),
+      InvalidArgument,
+      output,
+      "paged_sdpa_with_kv_cache does not support attn_mask");
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(output, q_projected.sizes()) == Error::Ok,
+      InvalidArgument,
+      output);
+
+  update_paged_cache(
+      k_projected, key_cache, block_table, start_pos, seq_lens);
+  update_paged_cache(
+      v_projected, value_cache, block_table, start_pos, seq_lens);
+
+  const PagedKVCache paged_kv_cache{
+      block_table.const_data_ptr<int64_t>(),
+      block_table.size(1),
+      key_cache.size(1),
+      start_pos.const_data_ptr<int64_t>(),
+      seq_lens.const_data_ptr<int64_t>()};
+
+  const auto q_seq_len = q_projected.size(1);
+  ET_SWITCH_FLOAT_TYPES(
+      q_projected.scalar_type(), ctx, "flash_attention", CTYPE, [&] {
+        if (q_seq_len >= 768) {
+          cpu_flash_attention<CTYPE, 256, 512>(
+              output,
+              q_projected,
+              key_cache,
+              value_cache,
+              dropout_p,
+              is_causal,
+              attn_mask,
+              scale,
+              true, /* is_seq_at_dim_1 */
+              0, /* start_pos, per sequence in paged_kv_cache */
+              &paged_kv_cache);
+        } else if (q_seq_len >= 192) {
+          cpu_flash_attention<CTYPE, 64, 512>(
+              output,
+              q_projected,
+              key_cache,
+              value_cache,
+              dropout_p,
+              is_causal,
+              attn_mask,
+              scale,
+              true, /* is_seq_at_dim_1 */
+              0, /* start_pos, per sequence in paged_kv_cache */
+              &paged_kv_cache);
+        } else {
+          cpu_flash_attention<CTYPE, 32, 512>(
+              output,
+              q_projected,
+              key_cache,
+              value_cache,
+              dropout_p,
+              is_causal,
+              attn_mask,
+              scale,
+              true, /* is_seq_at_dim_1 */
+              0, /* start_pos, per sequence in paged_kv_cache */
+              &paged_kv_cache);
+        }
+      });
+  return output;
+}
+
+/*
+  Ring buffer variant of sdpa_with_kv_cache, for generating past the size of
+  the cache at a constant cost per token. The caches keep the first
+  num_sink_tokens positions and a sliding window of the most recent ones,
+  and start_pos may exceed the cache size. Until the cache is full this is
+  sdpa_with_kv_cache. After that, each query attends to the sinks and to the
+  window up to its own position.
+
+  @param[in] num_sink_tokens Number of first positions that stay in the
+  caches, less than max_seq_len.
+  Only causal attention without attn_mask is supported. Other params are as
+  in sdpa_with_kv_cache.
+*/
+Tensor& sdpa_with_ring_kv_cache_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& q_projected,
+    const Tensor& k_projected,
+    const Tensor& v_projected,
+    Tensor& key_cache,
+    Tensor& value_cache,
+    const int64_t start_pos,
+    const int64_t seq_len,
+    const int64_t num_sink_tokens,
+    const optional<Tensor>& attn_mask,
+    const double dropout_p,
+    const bool is_causal,
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const optional<double> scale,
+    Tensor& output) {
+  ET_KERNEL_CHECK(
+      ctx,
+      validate_ring_cache_params(
+          q_projected,
+          k_projected,
+          v_projected,
+          key_cache,
+          value_cache,
+          start_pos,
+          seq_len,
+          num_sink_tokens),
+      InvalidArgument,
+      output);
+
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      is_causal && !attn_mask.has_value(),
+      InvalidArgument,
+      output,
+      "sdpa_with_ring_kv_cache only supports causal attention without "
+      "attn_mask");
+
+  const int64_t cache_size = key_cache.size(1);
+  if (start_pos + seq_len <= cache_size) {
+    // The ring has not wrapped around yet, so slots are positions.
+    return sdpa_with_kv_cache_out(
+        ctx,
+        q_projected,
+        k_projected,
+        v_projected,
+        key_cache,
+        value_cache,
+        start_pos,
+        seq_len,
+        attn_mask,
+        dropout_p,
+        is_causal,
+        scale,
+        output);
+  }
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(output, q_projected.sizes()) == Error::Ok,
+      InvalidArgument,
+      output);
+
+  update_ring_cache(k_projected, key_cache, start_pos, num_sink_tokens);
+  update_ring_cache(v_projected, value_cache, start_pos, num_sink_tokens);
+
+  // Slots are not in position order anymore, so causality is expressed as
+  // a mask over all slots instead.
+  const auto q_seq_len = q_projected.size(1);
+  ET_SWITCH_FLOAT_TYPES(
+      q_projected.scalar_type(), ctx, "flash_attention", CTYPE, [&] {
+        std::vector<CTYPE> mask_data(seq_len * cache_size);
+        fill_ring_attention_mask(
+            mask_data.data(), start_pos, seq_len, num_sink_tokens, cache_size);
+        std::array<exec_aten::SizesType, 2> mask_sizes{
+            static_cast<exec_aten::SizesType>(seq_len),
+            static_cast<exec_aten::SizesType>(cache_size)};
+        std::array<exec_aten::DimOrderType, 2> mask_dim_order{0, 1};
+        std::array<exec_aten::StridesType, 2> mask_strides{
+            static_cast<exec_aten::StridesType>(cache_size), 1};
+        TensorImpl mask_impl = TensorImpl(
+            q_projected.scalar_type(),
+            2,
+            mask_sizes.data(),
+            mask_data.data(),
+            mask_dim_order.data(),
+            mask_strides.data(),
+            TensorShapeDynamism::STATIC);
+        Tensor mask(&mask_impl);
+        const optional<Tensor> ring_mask(mask);
+
+        if (q_seq_len >= 768) {
+          cpu_flash_attention<CTYPE, 256, 512>(
+              output,
+              q_projected,
+              key_cache,
+              value_cache,
+              dropout_p,
+              false, /* is_causal */
+              ring_mask,
+              scale,
+              true /* is_seq_at_dim_1 */);
+        } else if (q_seq_len >= 192) {
+          cpu_flash_attention<CTYPE, 64, 512>(
+              output,
+              q_projected,
+              key_cache,
+              value_cache,
+              dropout_p,
+              false, /* is_causal */
+              ring_mask,
+              scale,
+              true /* is_seq_at_dim_1 */);
+        } else {
+          cpu_flash_attention<CTYPE, 32, 512>(
+              output,
+              q_projected,
+              key_cache,
+              value_cache,
+              dropout_p,
+              false, /* is_causal */
+              ring_mask,
+              scale,
+              true /* is_seq_at_dim_1 */);
+        }
+      });
+  return output;
+}
 } // namespace native
 } // namespace executor
 } // namespace torch
@@ -1037,3 +1679,13 @@ EXECUTORCH_LIBRARY(
     llama,
     "custom_sdpa.out",
     torch::executor::native::custom_sdpa_out);
+
+EXECUTORCH_LIBRARY(
+    llama,
+    "paged_sdpa_with_kv_cache.out",
+    torch::executor::native::paged_sdpa_with_kv_cache_out);
+
+EXECUTORCH_LIBRARY(
+    llama,
+    "sdpa_with_ring_kv_cache.out",
+    torch::executor::native::sdpa_with_ring_kv_cache_out);
@@ -6,7 +6,10 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <algorithm>
+#include <cmath>
 #include <limits>
+#include <random>
 
 #include <executorch/extension/llm/custom_ops/op_sdpa.h> // Declares the operator
 #include <executorch/kernels/test/TestUtil.h>
@@ -985,3 +988,102 @@ TEST(OpScaledDotProductAttentionTest, SequenceTest) {
       out);
   EXPECT_TENSOR_CLOSE_WITH_TOL(ret, ret_expected_3, 1e-4, 1e-4);
 }
+
+// A prefill at start_pos > 0 whose keys cross the 512-key blocks of the
+// flash attention. Every query must attend to the keys up to its own
+// position only, in the first key block as in the last one.
+TEST(OpScaledDotProductAttentionTest, CausalPrefillAcrossKeyBlocks) {
+  constexpr int32_t kHeads = 2;
+  constexpr int32_t kHeadDim = 4;
+  constexpr int32_t kMaxSeqLen = 576;
+  constexpr int64_t kStartPos = 490;
+  constexpr int64_t kSeqLen = 40;
+  TensorFactory<exec_aten::ScalarType::Float> tfFloat;
+  std::mt19937 gen(0);
+  std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+  const auto random_values = [&](size_t size) {
+    std::vector<float> values(size);
+    for (auto& value : values) {
+      value = dist(gen);
+    }
+    return values;
+  };
+
+  // The cache holds the keys and values before start_pos, and garbage after
+  // the new ones that must be masked out.
+  const int32_t row_size = kHeads * kHeadDim;
+  std::vector<float> key_cache_data = random_values(kMaxSeqLen * row_size);
+  std::vector<float> value_cache_data = random_values(kMaxSeqLen * row_size);
+  const std::vector<float> q_data = random_values(kSeqLen * row_size);
+  const std::vector<float> k_data = random_values(kSeqLen * row_size);
+  const std::vector<float> v_data = random_values(kSeqLen * row_size);
+
+  exec_aten::Tensor query =
+      tfFloat.make({1, kSeqLen, kHeads, kHeadDim}, q_data);
+  exec_aten::Tensor key = tfFloat.make({1, kSeqLen, kHeads, kHeadDim}, k_data);
+  exec_aten::Tensor value =
+      tfFloat.make({1, kSeqLen, kHeads, kHeadDim}, v_data);
+  exec_aten::Tensor key_cache =
+      tfFloat.make({1, kMaxSeqLen, kHeads, kHeadDim}, key_cache_data);
+  exec_aten::Tensor value_cache =
+      tfFloat.make({1, kMaxSeqLen, kHeads, kHeadDim}, value_cache_data);
+  exec_aten::Tensor out = tfFloat.zeros({1, kSeqLen, kHeads, kHeadDim});
+  op_sdpa_with_kv_cache(
+      query,
+      key,
+      value,
+      key_cache,
+      value_cache,
+      kStartPos,
+      kSeqLen,
+      {},
+      0.0,
+      true,
+      {},
+      out);
+
+  // Causal attention over the updated cache, one query at a time.
+  std::copy(
+      k_data.begin(),
+      k_data.end(),
+      key_cache_data.begin() + kStartPos * row_size);
+  std::copy(
+      v_data.begin(),
+      v_data.end(),
+      value_cache_data.begin() + kStartPos * row_size);
+  const float scale = 1.0f / std::sqrt(static_cast<float>(kHeadDim));
+  std::vector<float> expected(kSeqLen * row_size, 0.0f);
+  for (int64_t i = 0; i < kSeqLen; ++i) {
+    const int64_t num_keys = kStartPos + i + 1;
+    for (int32_t h = 0; h < kHeads; ++h) {
+      const float* q_row = q_data.data() + i * row_size + h * kHeadDim;
+      std::vector<float> weights(num_keys);
+      float max_score = -std::numeric_limits<float>::infinity();
+      for (int64_t j = 0; j < num_keys; ++j) {
+        const float* k_row =
+            key_cache_data.data() + j * row_size + h * kHeadDim;
+        float score = 0.0f;
+        for (int32_t d = 0; d < kHeadDim; ++d) {
+          score += q_row[d] * k_row[d];
+        }
+        weights[j] = score * scale;
+        max_score = std::max(max_score, weights[j]);
+      }
+      float sum = 0.0f;
+      for (auto& weight : weights) {
+        weight = std::exp(weight - max_score);
+        sum += weight;
+      }
+      float* out_row = expected.data() + i * row_size + h * kHeadDim;
+      for (int64_t j = 0; j < num_keys; ++j) {
+        const float* v_row =
+            value_cache_data.data() + j * row_size + h * kHeadDim;
+        for (int32_t d = 0; d < kHeadDim; ++d) {
+          out_row[d] += weights[j] / sum * v_row[d];
+        }
+      }
+    }
+  }
+  EXPECT_TENSOR_CLOSE_WITH_TOL(
+      out, tfFloat.make({1, kSeqLen, kHeads, kHeadDim}, expected), 1e-4, 1e-4);
+}
@@ -0,0 +1,205 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <cmath>
+#include <random>
+
+#include <executorch/extension/llm/custom_ops/op_sdpa.h> // Declares the operator
+#include <executorch/kernels/test/TestUtil.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
+
+#include <gtest/gtest.h>
+
+using namespace ::testing;
+using exec_aten::ScalarType;
+using exec_aten::Tensor;
+using executorch::runtime::testing::TensorFactory;
+
+namespace {
+
+constexpr int32_t kBatch = 2;
+constexpr int32_t kHeads = 4;
+constexpr int32_t kKVHeads = 2;
+constexpr int32_t kHeadDim = 8;
+constexpr int32_t kCacheSize = 16;
+constexpr int32_t kNumSinkTokens = 2;
+constexpr int32_t kWindowSize = kCacheSize - kNumSinkTokens;
+
+std::vector<float> random_values(std::mt19937& gen, size_t size) {
+  std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+  std::vector<float> data(size);
+  for (auto& x : data) {
+    x = dist(gen);
+  }
+  return data;
+}
+
+/*
+Attention of q [bs, seq_len, heads, dim] over the keys and values of all
+positions so far, [bs, positions, kv heads, dim], restricted to the sink
+tokens and the positions that are still in the sliding window.
+*/
+std::vector<float> reference_attention(
+    const std::vector<float>& q,
+    const std::vector<float>& keys,
+    const std::vector<float>& values,
+    int64_t num_positions,
+    int64_t start_pos,
+    int64_t seq_len) {
+  const int64_t last_pos = start_pos + seq_len - 1;
+  const float scale = 1.0f / std::sqrt(static_cast<float>(kHeadDim));
+  std::vector<float> out(kBatch * seq_len * kHeads * kHeadDim, 0.0f);
+  for (int64_t b = 0; b < kBatch; ++b) {
+    for (int64_t row = 0; row < seq_len; ++row) {
+      for (int64_t h = 0; h < kHeads; ++h) {
+        const int64_t h_kv = h / (kHeads / kKVHeads);
+        const float* q_row =
+            q.data() + ((b * seq_len + row) * kHeads + h) * kHeadDim;
+        std::vector<float> weights;
+        std::vector<int64_t> visible;
+        float max = -INFINITY;
+        for (int64_t pos = 0; pos <= start_pos + row; ++pos) {
+          if (pos >= kNumSinkTokens && pos <= last_pos - kWindowSize) {
+            continue;
+          }
+          const float* k_row = keys.data() +
+              ((b * num_positions + pos) * kKVHeads + h_kv) * kHeadDim;
+          float dot = 0;
+          for (int64_t d = 0; d < kHeadDim; ++d) {
+            dot += q_row[d] * k_row[d];
+          }
+          weights.push_back(dot * scale);
+          visible.push_back(pos);
+          max = std::max(max, dot * scale);
+        }
+        float sum = 0;
+        for (auto& w : weights) {
+          w = std::exp(w - max);
+          sum += w;
+        }
+        float* out_row =
+            out.data() + ((b * seq_len + row) * kHeads + h) * kHeadDim;
+        for (size_t i = 0; i < visible.size(); ++i) {
+          const float* v_row = values.data() +
+              ((b * num_positions + visible[i]) * kKVHeads + h_kv) * kHeadDim;
+          for (int64_t d = 0; d < kHeadDim; ++d) {
+            out_row[d] += weights[i] / sum * v_row[d];
+          }
+        }
+      }
+    }
+  }
+  return out;
+}
+
+} // namespace
+
+class OpSdpaWithRingKVCacheTest : public OperatorTest {
+ protected:
+  Tensor& op_sdpa_with_ring_kv_cache(
+      const Tensor& query,
+      const Tensor& key,
+      const Tensor& value,
+      Tensor& key_cache,
+      Tensor& value_cache,
+      const int64_t start_pos,
+      const int64_t seq_len,
+      Tensor& out) {
+    return torch::executor::native::sdpa_with_ring_kv_cache_out(
+        context_,
+        query,
+        key,
+        value,
+        key_cache,
+        value_cache,
+        start_pos,
+        seq_len,
+        kNumSinkTokens,
+        {},
+        0.0,
+        true,
+        {},
+        out);
+  }
+};
+
+// A prefill and decode steps that fill the cache, followed by decode steps
+// and a multi-token chunk after the ring wrapped around several times.
+TEST_F(OpSdpaWithRingKVCacheTest, KeepsSinksAndSlidingWindow) {
+  TensorFactory<ScalarType::Float> tf;
+  std::mt19937 gen(0);
+
+  const std::vector<int32_t> seq_lens = {
+      10, 1, 1, 1, 1, 1, 1, 1, 5, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 3, 1};
+  int64_t total_positions = 0;
+  for (int32_t seq_len : seq_lens) {
+    total_positions += seq_len;
+  }
+  ASSERT_GT(total_positions, 2 * kCacheSize);
+
+  // Keys and values of every position, in position order.
+  const size_t kv_row = kKVHeads * kHeadDim;
+  std::vector<float> all_keys(kBatch * total_positions * kv_row);
+  std::vector<float> all_values(kBatch * total_positions * kv_row);
+
+  Tensor key_cache = tf.zeros({kBatch, kCacheSize, kKVHeads, kHeadDim});
+  Tensor value_cache = tf.zeros({kBatch, kCacheSize, kKVHeads, kHeadDim});
+
+  int64_t start_pos = 0;
+  for (int32_t seq_len : seq_lens) {
+    std::vector<float> q_data =
+        random_values(gen, kBatch * seq_len * kHeads * kHeadDim);
+    std::vector<float> k_data = random_values(gen, kBatch * seq_len * kv_row);
+    std::vector<float> v_data = random_values(gen, kBatch * seq_len * kv_row);
+    for (int64_t b = 0; b < kBatch; ++b) {
+      std::copy_n(
+          k_data.begin() + b * seq_len * kv_row,
+          seq_len * kv_row,
+          all_keys.begin() + (b * total_positions + start_pos) * kv_row);
+      std::copy_n(
+          v_data.begin() + b * seq_len * kv_row,
+          seq_len * kv_row,
+          all_values.begin() + (b * total_positions + start_pos) * kv_row);
+    }
+
+    Tensor q = tf.make({kBatch, seq_len, kHeads, kHeadDim}, q_data);
+    Tensor k = tf.make({kBatch, seq_len, kKVHeads, kHeadDim}, k_data);
+    Tensor v = tf.make({kBatch, seq_len, kKVHeads, kHeadDim}, v_data);
+    Tensor out = tf.zeros({kBatch, seq_len, kHeads, kHeadDim});
+    op_sdpa_with_ring_kv_cache(
+        q, k, v, key_cache, value_cache, start_pos, seq_len, out);
+
+    Tensor expected = tf.make(
+        {kBatch, seq_len, kHeads, kHeadDim},
+        reference_attention(
+            q_data, all_keys, all_values, total_positions, start_pos, seq_len));
+    EXPECT_TENSOR_CLOSE_WITH_TOL(out, expected, 1e-4, 1e-4);
+
+    start_pos += seq_len;
+  }
+}
+
+// After the ring wrapped around, a call may not write more positions than
+// the sliding window holds.
+TEST_F(OpSdpaWithRingKVCacheTest, ChunkLargerThanWindowDies) {
+  TensorFactory<ScalarType::Float> tf;
+  constexpr int32_t kSeqLen = kWindowSize + 1;
+
+  Tensor q = tf.ones({1, kSeqLen, kHeads, kHeadDim});
+  Tensor k = tf.ones({1, kSeqLen, kKVHeads, kHeadDim});
+  Tensor v = tf.ones({1, kSeqLen, kKVHeads, kHeadDim});
+  Tensor key_cache = tf.zeros({1, kCacheSize, kKVHeads, kHeadDim});
+  Tensor value_cache = tf.zeros({1, kCacheSize, kKVHeads, kHeadDim});
+  Tensor out = tf.zeros({1, kSeqLen, kHeads, kHeadDim});
+
+  ET_EXPECT_KERNEL_FAILURE(
+      context_,
+      op_sdpa_with_ring_kv_cache(
+          q, k, v, key_cache, value_cache, kCacheSize, kSeqLen, out));
+}
@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/llm/custom_ops/op_silu_mul.h>
+
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+
+#include <executorch/extension/kernel_util/make_boxed_from_unboxed_functor.h>
+#include <executorch/extension/parallel/thread_parallel.h>
+#include <executorch/kernels/optimized/vec/functional.h>
+#include <executorch/kernels/optimized/vec/vec.h>
+#include <executorch/kernels/optimized/vec/vec_math.h>
+#include <executorch/runtime/core/exec_aten/util/dim_order_util.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+namespace {
+
+bool validate_silu_mul_args(
+    const Tensor& gate,
+    const Tensor& up,
+    const Tensor& out) {
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      tensors_have_same_shape(gate, up),
+      "gate and up must have the same shape");
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      gate.scalar_type() == up.scalar_type() &&
+          gate.scalar_type() == out.scalar_type(),
+      "gate, up and out must have the same dtype");
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      is_contiguous_dim_order(gate.dim_order().data(), gate.dim()) &&
+          is_contiguous_dim_order(up.dim_order().data(), up.dim()) &&
+          is_contiguous_dim_order(out.dim_order().data(), out.dim()),
+      "gate, up and out must be in contiguous dim order");
+  return true;
+}
+
+template <typename CTYPE>
+void silu_mul_chunk(
+    const CTYPE* __restrict__ gate,
+    const CTYPE* __restrict__ up,
+    CTYPE* __restrict__ output,
+    int64_t size) {
+  if constexpr (std::is_floating_point_v<CTYPE>) {
+    using Vec = ::executorch::vec::Vectorized<CTYPE>;
+    ::executorch::vec::map2<CTYPE>(
+        [](Vec g, Vec u) {
+          return g * ::executorch::vec::vec_sigmoid(g) * u;
+        },
+        output,
+        gate,
+        up,
+        size);
+  } else {
+    for (int64_t i = 0; i < size; ++i) {
+      const float g = static_cast<float>(gate[i]);
+      output[i] = static_cast<CTYPE>(
+          g / (1.0f + std::exp(-g)) * static_cast<float>(up[i]));
+    }
+  }
+}
+
+} // namespace
+
+Tensor& silu_mul_out(
+    RuntimeContext& ctx,
+    const Tensor& gate,
+    const Tensor& up,
+    Tensor& out) {
+  ET_KERNEL_CHECK(
+      ctx, validate_silu_mul_args(gate, up, out), InvalidArgument, out);
+
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      resize_tensor(out, gate.sizes()) == Error::Ok,
+      InvalidArgument,
+      out,
+      "Failed to resize output tensor.");
+
+  const int64_t numel = gate.numel();
+  if (numel == 0) {
+    return out;
+  }
+
+  ET_SWITCH_FLOATH_TYPES(gate.scalar_type(), ctx, "silu_mul.out", CTYPE, [&] {
+    const CTYPE* const gate_data = gate.const_data_ptr<CTYPE>();
+    const CTYPE* const up_data = up.const_data_ptr<CTYPE>();
+    CTYPE* const out_data = out.mutable_data_ptr<CTYPE>();
+    torch::executor::parallel_for(
+        0, numel, /*grain_size=*/16384, [&](int64_t begin, int64_t end) {
+          silu_mul_chunk(
+              gate_data + begin,
+              up_data + begin,
+              out_data + begin,
+              end - begin);
+        });
+  });
+  return out;
+}
+} // namespace native
+} // namespace executor
+} // namespace torch
+
+EXECUTORCH_LIBRARY(
+    llama,
+    "silu_mul.out",
+    torch::executor::native::silu_mul_out);
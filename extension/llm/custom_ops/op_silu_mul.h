@@ -0,0 +1,30 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch {
+namespace executor {
+
+namespace native {
+
+// SiLU-gated multiply, the activation of a SwiGLU feed forward layer:
+//
+//   out = silu(gate) * up = gate * sigmoid(gate) * up
+//
+// `gate` and `up` must have the same shape.
+Tensor& silu_mul_out(
+    RuntimeContext& ctx,
+    const Tensor& gate,
+    const Tensor& up,
+    Tensor& out);
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/aten_util/make_aten_functor_from_et_functor.h>
+#include <executorch/extension/llm/custom_ops/op_silu_mul.h>
+
+#include <torch/library.h>
+
+namespace torch::executor::native {
+namespace {
+Tensor&
+silu_mul_out_no_context(const Tensor& gate, const Tensor& up, Tensor& out) {
+  exec_aten::RuntimeContext context;
+  return silu_mul_out(context, gate, up, out);
+}
+at::Tensor silu_mul_aten(const at::Tensor& gate, const at::Tensor& up) {
+  auto out = at::empty_like(gate);
+  WRAP_TO_ATEN(silu_mul_out_no_context, 2)
+  (gate, up, out);
+  return out;
+}
+} // namespace
+} // namespace torch::executor::native
+
+TORCH_LIBRARY_FRAGMENT(llama, m) {
+  m.def("silu_mul(Tensor gate, Tensor up) -> Tensor");
+  m.def(
+      "silu_mul.out(Tensor gate, Tensor up, *, Tensor(a!) out) -> Tensor(a!)");
+}
+
+TORCH_LIBRARY_IMPL(llama, CompositeExplicitAutograd, m) {
+  m.impl("silu_mul", torch::executor::native::silu_mul_aten);
+  m.impl(
+      "silu_mul.out",
+      WRAP_TO_ATEN(torch::executor::native::silu_mul_out_no_context, 2));
+}
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/llm/custom_ops/op_silu_mul.h>
+#include <executorch/kernels/test/TestUtil.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+using namespace ::testing;
+using exec_aten::ScalarType;
+using exec_aten::Tensor;
+using executorch::runtime::testing::TensorFactory;
+
+class OpSiluMulOutTest : public OperatorTest {
+ protected:
+  Tensor& op_silu_mul_out(const Tensor& gate, const Tensor& up, Tensor& out) {
+    return torch::executor::native::silu_mul_out(context_, gate, up, out);
+  }
+
+  template <ScalarType DTYPE>
+  void test_matches_reference() {
+    TensorFactory<DTYPE> tf;
+    using CTYPE = typename TensorFactory<DTYPE>::ctype;
+    // 67 elements leave a partial vector at every vector width.
+    const std::vector<int32_t> sizes = {67};
+    std::vector<CTYPE> gate_data(67);
+    std::vector<CTYPE> up_data(67);
+    std::vector<CTYPE> expected_data(67);
+    for (size_t i = 0; i < gate_data.size(); ++i) {
+      const double g = -8.0 + 0.25 * i;
+      const double u = std::cos(0.5 * i);
+      gate_data[i] = g;
+      up_data[i] = u;
+      expected_data[i] = g / (1.0 + std::exp(-g)) * u;
+    }
+    Tensor out = tf.zeros(sizes);
+
+    op_silu_mul_out(tf.make(sizes, gate_data), tf.make(sizes, up_data), out);
+    EXPECT_TENSOR_CLOSE(out, tf.make(sizes, expected_data));
+  }
+};
+
+TEST_F(OpSiluMulOutTest, SmokeTest) {
+  TensorFactory<ScalarType::Float> tf;
+  Tensor gate = tf.make({1, 3}, {0, 1, -1});
+  Tensor up = tf.make({1, 3}, {5, 2, 2});
+  Tensor out = tf.zeros({1, 3});
+
+  Tensor& ret = op_silu_mul_out(gate, up, out);
+  EXPECT_TENSOR_EQ(ret, out);
+  EXPECT_TENSOR_CLOSE(out, tf.make({1, 3}, {0, 1.4621172, -0.5378828}));
+}
+
+TEST_F(OpSiluMulOutTest, FloatMatchesReference) {
+  test_matches_reference<ScalarType::Float>();
+}
+
+TEST_F(OpSiluMulOutTest, DoubleMatchesReference) {
+  test_matches_reference<ScalarType::Double>();
+}
+
+TEST_F(OpSiluMulOutTest, MismatchedShapeDies) {
+  TensorFactory<ScalarType::Float> tf;
+  Tensor gate = tf.ones({2, 4});
+  Tensor up = tf.ones({4, 2});
+  Tensor out = tf.zeros({2, 4});
+
+  ET_EXPECT_KERNEL_FAILURE(context_, op_silu_mul_out(gate, up, out));
+}
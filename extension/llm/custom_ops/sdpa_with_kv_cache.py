@@ -133,6 +133,93 @@ def sdpa_with_kv_cache_meta(
     return torch.empty_like(query)
 
 
+@impl(custom_ops_lib, "paged_sdpa_with_kv_cache", "Meta")
+def paged_sdpa_with_kv_cache_meta(
+    query,
+    key,
+    value,
+    key_cache,
+    value_cache,
+    block_table,
+    start_pos,
+    seq_lens,
+    attn_mask=None,
+    drpout_p=0.0,
+    is_causal=False,
+    scale=None,
+):
+    _validate_params(
+        query,
+        key,
+        value,
+        key_cache,
+        value_cache,
+        start_pos,
+        seq_lens,
+        attn_mask,
+        drpout_p,
+        is_causal,
+        scale,
+    )
+    assert (
+        block_table.dim() == 2
+    ), f"Expected block_table to be 2 dimensional but got {block_table.dim()} dimensions."
+    assert (
+        block_table.dtype == torch.int64
+    ), f"Expected block_table to be int64 but got {block_table.dtype}"
+    assert block_table.size(0) == query.size(
+        0
+    ), f"Expected block_table to have {query.size(0)} rows but got {block_table.size(0)}"
+    for name, tensor in (("start_pos", start_pos), ("seq_lens", seq_lens)):
+        assert tensor.dim() == 1 and tensor.size(0) == query.size(
+            0
+        ), f"Expected {name} to have shape [{query.size(0)}] but got {list(tensor.shape)}"
+        assert (
+            tensor.dtype == torch.int64
+        ), f"Expected {name} to be int64 but got {tensor.dtype}"
+    assert attn_mask is None, "paged_sdpa_with_kv_cache does not support attn_mask"
+
+    return torch.empty_like(query)
+
+
+@impl(custom_ops_lib, "sdpa_with_ring_kv_cache", "Meta")
+def sdpa_with_ring_kv_cache_meta(
+    query,
+    key,
+    value,
+    key_cache,
+    value_cache,
+    start_pos,
+    seq_len,
+    num_sink_tokens,
+    attn_mask=None,
+    drpout_p=0.0,
+    is_causal=False,
+    scale=None,
+):
+    _validate_params(
+        query,
+        key,
+        value,
+        key_cache,
+        value_cache,
+        start_pos,
+        seq_len,
+        attn_mask,
+        drpout_p,
+        is_causal,
+        scale,
+    )
+    assert (
+        0 <= num_sink_tokens < key_cache.size(1)
+    ), f"Expected num_sink_tokens to be less than {key_cache.size(1)} but got {num_sink_tokens}"
+    assert (
+        is_causal and attn_mask is None
+    ), "sdpa_with_ring_kv_cache only supports causal attention without attn_mask"
+
+    return torch.empty_like(query)
+
+
 @impl(custom_ops_lib, "fast_hadamard_transform", "Meta")
 def fast_hadamard_transform_meta(mat):
     # assert(mat.strides[-1] == 1, "input matrix must be contiguous in the last dimension!")
@@ -141,6 +228,38 @@ def fast_hadamard_transform_meta(mat):
     return torch.empty_like(mat)
 
 
+@impl(custom_ops_lib, "rms_norm", "Meta")
+def rms_norm_meta(input, weight, eps):
+    assert weight.dim() == 1 and weight.size(0) == input.size(
+        -1
+    ), f"Expected weight of shape [{input.size(-1)}] but got {list(weight.shape)}"
+    return torch.empty_like(input)
+
+
+@impl(custom_ops_lib, "silu_mul", "Meta")
+def silu_mul_meta(gate, up):
+    assert (
+        gate.shape == up.shape
+    ), f"Expected gate and up to have the same shape but got {list(gate.shape)} and {list(up.shape)}"
+    return torch.empty_like(gate)
+
+
+@impl(custom_ops_lib, "apply_rotary_emb", "Meta")
+def apply_rotary_emb_meta(x, freqs_cos, freqs_sin, interleaved=True):
+    assert (
+        x.dim() == 4
+    ), f"Expected x to be [batch, seq_len, n_heads, head_dim] but got {list(x.shape)}"
+    rot_dim = x.size(-1) // 2 if interleaved else x.size(-1)
+    assert freqs_cos.shape == (
+        x.size(1),
+        rot_dim,
+    ), f"Expected freqs_cos of shape [{x.size(1)}, {rot_dim}] but got {list(freqs_cos.shape)}"
+    assert (
+        freqs_sin.shape == freqs_cos.shape
+    ), "freqs_cos and freqs_sin must have the same shape"
+    return torch.empty_like(x)
+
+
 @impl(custom_ops_lib, "custom_sdpa", "Meta")
 def custom_sdpa(
     query,
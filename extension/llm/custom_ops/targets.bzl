@@ -21,13 +21,19 @@ def define_common_targets():
             srcs = [
                 "op_fallback.cpp",
                 "op_fast_hadamard_transform.cpp",
+                "op_rms_norm.cpp",
+                "op_rope.cpp",
                 "op_sdpa.cpp",
+                "op_silu_mul.cpp",
                 "op_update_quantized_cache.cpp",
             ],
             exported_headers = [
                 "op_fallback.h",
                 "op_fast_hadamard_transform.h",
+                "op_rms_norm.h",
+                "op_rope.h",
                 "op_sdpa.h",
+                "op_silu_mul.h",
                 "op_update_quantized_cache.h",
             ],
             preprocessor_flags = get_vec_preprocessor_flags(),
@@ -59,7 +65,10 @@ def define_common_targets():
             name = "custom_ops_aot_lib" + mkl_dep,
             srcs = [
                 "op_fast_hadamard_transform_aten.cpp",
+                "op_rms_norm_aten.cpp",
+                "op_rope_aten.cpp",
                 "op_sdpa_aot.cpp",
+                "op_silu_mul_aten.cpp",
                 "op_tile_crop.cpp",
                 "op_tile_crop_aot.cpp",
             ],
@@ -106,6 +115,48 @@ def define_common_targets():
         ],
     )
 
+    runtime.cxx_test(
+        name = "op_rms_norm_test",
+        srcs = [
+            "op_rms_norm_test.cpp",
+        ],
+        visibility = ["//executorch/..."],
+        deps = [
+            "//executorch/runtime/core/exec_aten:lib",
+            "//executorch/runtime/core/exec_aten/testing_util:tensor_util",
+            "//executorch/kernels/test:test_util",
+            ":custom_ops",
+        ],
+    )
+
+    runtime.cxx_test(
+        name = "op_silu_mul_test",
+        srcs = [
+            "op_silu_mul_test.cpp",
+        ],
+        visibility = ["//executorch/..."],
+        deps = [
+            "//executorch/runtime/core/exec_aten:lib",
+            "//executorch/runtime/core/exec_aten/testing_util:tensor_util",
+            "//executorch/kernels/test:test_util",
+            ":custom_ops",
+        ],
+    )
+
+    runtime.cxx_test(
+        name = "op_rope_test",
+        srcs = [
+            "op_rope_test.cpp",
+        ],
+        visibility = ["//executorch/..."],
+        deps = [
+            "//executorch/runtime/core/exec_aten:lib",
+            "//executorch/runtime/core/exec_aten/testing_util:tensor_util",
+            "//executorch/kernels/test:test_util",
+            ":custom_ops",
+        ],
+    )
+
     runtime.cxx_test(
         name = "op_sdpa_with_kv_cache_test",
         srcs = [
@@ -120,6 +171,35 @@ def define_common_targets():
         ],
     )
 
+    runtime.cxx_test(
+        name = "op_paged_sdpa_with_kv_cache_test",
+        srcs = [
+            "op_paged_sdpa_with_kv_cache_test.cpp",
+        ],
+        visibility = ["//executorch/..."],
+        deps = [
+            "//executorch/extension/llm/runner:paged_kv_cache_allocator",
+            "//executorch/runtime/core/exec_aten:lib",
+            "//executorch/runtime/core/exec_aten/testing_util:tensor_util",
+            "//executorch/kernels/test:test_util",
+            ":custom_ops",
+        ],
+    )
+
+    runtime.cxx_test(
+        name = "op_sdpa_with_ring_kv_cache_test",
+        srcs = [
+            "op_sdpa_with_ring_kv_cache_test.cpp",
+        ],
+        visibility = ["//executorch/..."],
+        deps = [
+            "//executorch/runtime/core/exec_aten:lib",
+            "//executorch/runtime/core/exec_aten/testing_util:tensor_util",
+            "//executorch/kernels/test:test_util",
+            ":custom_ops",
+        ],
+    )
+
     ## For preprocess
     runtime.python_library(
         name = "preprocess_custom_ops_py",
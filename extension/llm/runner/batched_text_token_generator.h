@@ -0,0 +1,324 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Generate tokens for several independent sequences at once.
+#pragma once
+
+#include <executorch/extension/llm/runner/stats.h>
+#include <executorch/extension/llm/runner/text_decoder_runner.h>
+#include <executorch/extension/llm/tokenizer/tokenizer.h>
+#include <executorch/extension/tensor/tensor.h>
+
+#include <algorithm>
+
+namespace executorch {
+namespace extension {
+namespace llm {
+
+/**
+ * Decodes up to `batch_size` sequences with one forward call per token,
+ * which shares the cost of reading the weights between the sequences.
+ *
+ * The model must be exported with a KV cache whose batch dimension holds
+ * one sequence per slot, each at its own position, and take three inputs
+ * (see TextDecoderRunner::batched_step()): tokens of shape
+ * [batch_size, num_tokens], the position of the first token of each slot
+ * and the number of tokens of each slot, both of shape [batch_size]. Tokens
+ * past that number are padding, and free slots have none. It returns logits
+ * of shape [batch_size, vocab_size], for the last token of each slot, or
+ * [batch_size, num_tokens, vocab_size].
+ *
+ * llama::paged_sdpa_with_kv_cache takes the same positions and numbers of
+ * tokens, with the block table of a PagedKVCacheAllocator, but no export in
+ * this tree uses it yet: the llama export takes tokens of shape
+ * [1, seq_len] with a single start_pos.
+ *
+ * Sequences are admitted into free slots and retired between steps, so new
+ * requests do not wait for the whole batch to finish. A newly admitted
+ * sequence prefills its prompt in chunks of up to `prefill_chunk_size`
+ * tokens per step next to the sequences that are already generating, and
+ * starts sampling after its last prompt token.
+ */
+class ET_EXPERIMENTAL BatchedTextTokenGenerator {
+ public:
+  BatchedTextTokenGenerator(
+      Tokenizer* tokenizer,
+      TextDecoderRunner* text_decoder_runner,
+      int32_t batch_size,
+      std::unique_ptr<std::unordered_set<uint64_t>>&& eos_ids,
+      Stats* stats,
+      int32_t prefill_chunk_size = 1)
+      : tokenizer_(tokenizer),
+        text_decoder_runner_(text_decoder_runner),
+        eos_ids_(std::move(eos_ids)),
+        prefill_chunk_size_(prefill_chunk_size),
+        slots_(batch_size),
+        token_data_(static_cast<size_t>(batch_size) * prefill_chunk_size),
+        pos_data_(batch_size),
+        num_tokens_data_(batch_size),
+        stats_(stats) {
+    ET_CHECK_MSG(
+        batch_size > 0 && prefill_chunk_size > 0,
+        "Invalid batch size %" PRId32 " or prefill chunk size %" PRId32,
+        batch_size,
+        prefill_chunk_size);
+  }
+
+  /**
+   * Admits a sequence into a free slot.
+   * @param prompt_tokens the prompt tokens of the sequence, not empty.
+   * @param seq_len the total sequence length, including the prompt tokens.
+   * @param token_callback what to do after a token of this sequence is
+   * generated.
+   * @param done_callback if set, called with the number of generated tokens
+   * when the sequence is retired.
+   * @return the slot of the sequence, or InvalidState if there is no free
+   * slot.
+   */
+  inline ::executorch::runtime::Result<int32_t> add_sequence(
+      std::vector<uint64_t> prompt_tokens,
+      int32_t seq_len,
+      std::function<void(const std::string&)> token_callback,
+      std::function<void(int64_t)> done_callback = {}) {
+    ET_CHECK_OR_RETURN_ERROR(
+        !prompt_tokens.empty() &&
+            static_cast<int64_t>(prompt_tokens.size()) < seq_len,
+        InvalidArgument,
+        "Sequence length %" PRId32 " must exceed the %zu prompt tokens",
+        seq_len,
+        prompt_tokens.size());
+    for (int32_t slot = 0; slot < batch_size(); ++slot) {
+      Sequence& sequence = slots_[slot];
+      if (!sequence.active) {
+        sequence.active = true;
+        sequence.in_step = false;
+        sequence.prompt_tokens = std::move(prompt_tokens);
+        sequence.pos = 0;
+        sequence.seq_len = seq_len;
+        sequence.num_generated = 0;
+        sequence.cur_token = sequence.prompt_tokens[0];
+        sequence.token_callback = std::move(token_callback);
+        sequence.done_callback = std::move(done_callback);
+        return slot;
+      }
+    }
+    ET_LOG(Error, "All %" PRId32 " slots are in use", batch_size());
+    return ::executorch::runtime::Error::InvalidState;
+  }
+
+  /**
+   * Retires the sequence in `slot` before it finishes, e.g. when its client
+   * went away. Its done callback is not called. Must not be called from the
+   * callbacks of that sequence.
+   */
+  inline void remove_sequence(int32_t slot) {
+    ET_CHECK_MSG(slot >= 0 && slot < batch_size(), "Invalid slot %d", slot);
+    slots_[slot] = Sequence();
+  }
+
+  /**
+   * Runs one forward call over all slots: feeds every active sequence its
+   * next chunk of prompt tokens or its last generated token, samples the
+   * next token of each sequence that is past its prompt, and retires the
+   * sequences that reach an EOS token or their sequence length. If the
+   * forward call, sampling or detokenizing fails, no sequence is updated and
+   * no callback is called, so the step can be retried.
+   * @return the error code.
+   */
+  inline ::executorch::runtime::Error step() {
+    // The tokens are as wide as the longest chunk of this step.
+    int32_t num_tokens = 1;
+    for (int32_t slot = 0; slot < batch_size(); ++slot) {
+      Sequence& sequence = slots_[slot];
+      sequence.in_step = sequence.active;
+      sequence.num_fed = 0;
+      if (sequence.active) {
+        const int64_t num_prompt_left =
+            static_cast<int64_t>(sequence.prompt_tokens.size()) - sequence.pos;
+        sequence.num_fed = static_cast<int32_t>(std::max<int64_t>(
+            1, std::min<int64_t>(prefill_chunk_size_, num_prompt_left)));
+        num_tokens = std::max(num_tokens, sequence.num_fed);
+      }
+    }
+    std::fill(token_data_.begin(), token_data_.end(), 0);
+    for (int32_t slot = 0; slot < batch_size(); ++slot) {
+      const Sequence& sequence = slots_[slot];
+      int64_t* tokens = token_data_.data() + slot * num_tokens;
+      if (sequence.num_fed > 0) {
+        // cur_token is the prompt token at pos while prefilling.
+        tokens[0] = sequence.cur_token;
+        for (int32_t i = 1; i < sequence.num_fed; ++i) {
+          tokens[i] = sequence.prompt_tokens[sequence.pos + i];
+        }
+      }
+      pos_data_[slot] = sequence.active ? sequence.pos : 0;
+      num_tokens_data_[slot] = sequence.num_fed;
+    }
+    auto tokens_managed = from_blob(
+        token_data_.data(),
+        {batch_size(), num_tokens},
+        executorch::aten::ScalarType::Long);
+    auto start_pos_managed = from_blob(
+        pos_data_.data(), {batch_size()}, executorch::aten::ScalarType::Long);
+    auto num_tokens_managed = from_blob(
+        num_tokens_data_.data(),
+        {batch_size()},
+        executorch::aten::ScalarType::Long);
+
+    stats_->on_decode_step_begin();
+    auto logits_res = text_decoder_runner_->batched_step(
+        tokens_managed, start_pos_managed, num_tokens_managed);
+    stats_->on_decode_step_end();
+    ET_CHECK_OK_OR_RETURN_ERROR(logits_res.error());
+    executorch::aten::Tensor& logits_tensor = logits_res.get();
+    ET_CHECK_OR_RETURN_ERROR(
+        (logits_tensor.dim() == 2 ||
+         (logits_tensor.dim() == 3 && logits_tensor.size(1) == num_tokens)) &&
+            logits_tensor.size(0) == batch_size(),
+        InvalidArgument,
+        "Expected logits for %" PRId32 " sequences of %" PRId32 " tokens",
+        batch_size(),
+        num_tokens);
+
+    // Sample and detokenize the next token of every sequence before updating
+    // any of them, so that an error leaves all sequences as they were before
+    // the step, and the step can be retried.
+    for (int32_t slot = 0; slot < batch_size(); ++slot) {
+      Sequence& sequence = slots_[slot];
+      if (!sequence.in_step) {
+        continue;
+      }
+      const int64_t next_pos = sequence.pos + sequence.num_fed;
+      if (next_pos < static_cast<int64_t>(sequence.prompt_tokens.size())) {
+        // Still feeding the prompt.
+        sequence.next_token = sequence.prompt_tokens[next_pos];
+        continue;
+      }
+
+      // Sample after the last token fed in this slot.
+      stats_->on_sampling_begin();
+      sequence.next_token = text_decoder_runner_->logits_to_token(
+          logits_tensor, slot, sequence.num_fed - 1);
+      stats_->on_sampling_end();
+
+      stats_->on_detokenize_begin();
+      auto piece_res = tokenizer_->decode(
+          token_data_[slot * num_tokens + sequence.num_fed - 1],
+          sequence.next_token);
+      stats_->on_detokenize_end();
+      ET_CHECK_OK_OR_RETURN_ERROR(piece_res.error());
+      sequence.next_piece = std::move(piece_res.get());
+    }
+
+    for (int32_t slot = 0; slot < batch_size(); ++slot) {
+      Sequence& sequence = slots_[slot];
+      // Skip sequences admitted or removed by a callback during this step.
+      if (!sequence.in_step) {
+        continue;
+      }
+      sequence.in_step = false;
+      sequence.pos += sequence.num_fed;
+      sequence.cur_token = sequence.next_token;
+      if (sequence.pos < static_cast<int64_t>(sequence.prompt_tokens.size())) {
+        continue;
+      }
+      sequence.num_generated++;
+
+      stats_->on_callback_begin();
+      sequence.token_callback(sequence.next_piece);
+      stats_->on_callback_end();
+
+      if (sequence.pos >= sequence.seq_len - 1 ||
+          eos_ids_->find(sequence.cur_token) != eos_ids_->end()) {
+        auto done_callback = std::move(sequence.done_callback);
+        const int64_t num_generated = sequence.num_generated;
+        remove_sequence(slot);
+        if (done_callback) {
+          done_callback(num_generated);
+        }
+      }
+    }
+    return ::executorch::runtime::Error::Ok;
+  }
+
+  /**
+   * Steps until no sequence is active or stop() is called. Callbacks can
+   * admit new sequences, which join from the next step.
+   * @return the error code.
+   */
+  inline ::executorch::runtime::Error generate() {
+    should_stop_ = false;
+    while (num_active() > 0 && !should_stop_) {
+      ET_CHECK_OK_OR_RETURN_ERROR(step());
+    }
+    return ::executorch::runtime::Error::Ok;
+  }
+
+  /**
+   * Stop the generation loop.
+   */
+  inline void stop() {
+    should_stop_ = true;
+  }
+
+  inline int32_t batch_size() const {
+    return static_cast<int32_t>(slots_.size());
+  }
+
+  inline int32_t num_active() const {
+    int32_t count = 0;
+    for (const auto& sequence : slots_) {
+      count += sequence.active;
+    }
+    return count;
+  }
+
+ private:
+  struct Sequence {
+    bool active = false;
+    // Whether the sequence was fed to the model in the current step.
+    bool in_step = false;
+    // Number of tokens fed to the model in the current step.
+    int32_t num_fed = 0;
+    std::vector<uint64_t> prompt_tokens;
+    // Position in the KV cache slot of cur_token.
+    int64_t pos = 0;
+    int32_t seq_len = 0;
+    int64_t num_generated = 0;
+    // The token to feed to the model in the next step.
+    uint64_t cur_token = 0;
+    // The token that follows cur_token and the text of that token, held
+    // during a step until all sequences have been sampled.
+    uint64_t next_token = 0;
+    std::string next_piece;
+    std::function<void(const std::string&)> token_callback;
+    std::function<void(int64_t)> done_callback;
+  };
+
+  Tokenizer* tokenizer_;
+  TextDecoderRunner* text_decoder_runner_;
+  std::unique_ptr<std::unordered_set<uint64_t>> eos_ids_;
+  int32_t prefill_chunk_size_;
+  std::vector<Sequence> slots_;
+
+  // input tensor data: up to prefill_chunk_size_ tokens, a position and a
+  // number of tokens per slot
+  std::vector<int64_t> token_data_;
+  std::vector<int64_t> pos_data_;
+  std::vector<int64_t> num_tokens_data_;
+
+  // state machine
+  bool should_stop_ = false;
+
+  // stats
+  Stats* stats_;
+};
+
+} // namespace llm
+} // namespace extension
+} // namespace executorch
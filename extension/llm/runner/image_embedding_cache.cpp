@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Caches the image encoder outputs of recently seen images.
+
+#include <executorch/extension/llm/runner/image_embedding_cache.h>
+
+#include <cstring>
+
+namespace executorch {
+namespace extension {
+namespace llm {
+
+namespace {
+constexpr uint64_t kFnvOffsetBasis = 0xcbf29ce484222325ULL;
+constexpr uint64_t kFnvPrime = 0x100000001b3ULL;
+
+inline uint64_t mix(uint64_t hash, uint64_t value) {
+  return (hash ^ value) * kFnvPrime;
+}
+} // namespace
+
+ImageEmbeddingCache::ImageEmbeddingCache(size_t max_entries)
+    : max_entries_(max_entries) {
+  ET_CHECK_MSG(max_entries > 0, "Image embedding cache cannot be empty");
+}
+
+uint64_t ImageEmbeddingCache::hash(const Image& image) {
+  // FNV-1a over 8-byte words rather than bytes, which keeps hashing a large
+  // image well below a millisecond.
+  uint64_t hash = kFnvOffsetBasis;
+  hash = mix(hash, static_cast<uint32_t>(image.width));
+  hash = mix(hash, static_cast<uint32_t>(image.height));
+  hash = mix(hash, static_cast<uint32_t>(image.channels));
+  const uint8_t* data = image.data.data();
+  const size_t size = image.data.size();
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+    uint64_t word;
+    std::memcpy(&word, data + i, sizeof(word));
+    hash = mix(hash, word);
+  }
+  for (; i < size; ++i) {
+    hash = mix(hash, data[i]);
+  }
+  return mix(hash, size);
+}
+
+bool ImageEmbeddingCache::same_image(const Image& a, const Image& b) {
+  return a.width == b.width && a.height == b.height &&
+      a.channels == b.channels && a.data == b.data;
+}
+
+TensorPtr ImageEmbeddingCache::get(const Image& image) {
+  auto it = index_.find(hash(image));
+  if (it == index_.end() || !same_image(it->second->image, image)) {
+    num_misses_++;
+    return nullptr;
+  }
+  entries_.splice(entries_.begin(), entries_, it->second);
+  num_hits_++;
+  return it->second->embeddings;
+}
+
+void ImageEmbeddingCache::put(
+    const Image& image,
+    const executorch::aten::Tensor& embeddings) {
+  const uint64_t key = hash(image);
+  auto it = index_.find(key);
+  if (it != index_.end()) {
+    // The same image again, or a different one with the same hash, which
+    // replaces the old one.
+    entries_.erase(it->second);
+    index_.erase(it);
+  } else if (entries_.size() >= max_entries_) {
+    index_.erase(entries_.back().hash);
+    entries_.pop_back();
+  }
+  entries_.push_front({key, image, clone_tensor_ptr(embeddings)});
+  index_[key] = entries_.begin();
+}
+
+void ImageEmbeddingCache::clear() {
+  entries_.clear();
+  index_.clear();
+}
+
+} // namespace llm
+} // namespace extension
+} // namespace executorch
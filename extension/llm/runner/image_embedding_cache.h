@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Caches the image encoder outputs of recently seen images.
+
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+
+#include <executorch/extension/llm/runner/image.h>
+#include <executorch/extension/tensor/tensor.h>
+
+namespace executorch {
+namespace extension {
+namespace llm {
+
+/**
+ * An LRU cache from image contents to the embeddings the image encoder
+ * produced for them, so that an image that is sent again does not run
+ * through the encoder.
+ *
+ * Images are looked up by a hash of their pixels and shape, and a hit is
+ * confirmed by comparing the pixels, so a hash collision is a miss rather
+ * than wrong embeddings. The cache owns copies of the embeddings, since the
+ * encoder outputs are overwritten by its next execution.
+ */
+class ET_EXPERIMENTAL ImageEmbeddingCache {
+ public:
+  /**
+   * @param max_entries The number of images to keep embeddings for. The
+   * least recently used one is evicted to make room for a new one.
+   */
+  explicit ImageEmbeddingCache(size_t max_entries);
+
+  /**
+   * The cached embeddings of `image`, or nullptr if there are none. A hit
+   * makes the image the most recently used one.
+   */
+  TensorPtr get(const Image& image);
+
+  /**
+   * Caches a copy of `embeddings` as the encoder output for `image`.
+   */
+  void put(const Image& image, const executorch::aten::Tensor& embeddings);
+
+  void clear();
+
+  size_t size() const {
+    return entries_.size();
+  }
+
+  int64_t num_hits() const {
+    return num_hits_;
+  }
+
+  int64_t num_misses() const {
+    return num_misses_;
+  }
+
+  /**
+   * A 64-bit hash of the pixels and shape of `image`.
+   */
+  static uint64_t hash(const Image& image);
+
+ private:
+  struct Entry {
+    uint64_t hash;
+    Image image;
+    TensorPtr embeddings;
+  };
+
+  static bool same_image(const Image& a, const Image& b);
+
+  size_t max_entries_;
+  // Most recently used first.
+  std::list<Entry> entries_;
+  std::unordered_map<uint64_t, std::list<Entry>::iterator> index_;
+  int64_t num_hits_ = 0;
+  int64_t num_misses_ = 0;
+};
+
+} // namespace llm
+} // namespace extension
+} // namespace executorch
@@ -0,0 +1,324 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Turns a raw image into the float input of an image encoder.
+
+#include <executorch/extension/llm/runner/image_preprocessor.h>
+
+#include <algorithm>
+#include <cinttypes>
+#include <cmath>
+
+#include <executorch/kernels/optimized/vec/vec.h>
+
+#ifdef ET_USE_THREADPOOL
+#include <executorch/extension/parallel/thread_parallel.h>
+#endif
+
+namespace executorch {
+namespace extension {
+namespace llm {
+
+using ::executorch::runtime::Error;
+
+namespace {
+
+// Coefficient of the cubic convolution kernel, as in PyTorch and OpenCV.
+constexpr float kCubicA = -0.75f;
+
+// The source pixels and weights that every output pixel along one axis
+// interpolates, `num_taps` per output pixel. Stored tap by tap, i.e. tap i
+// of output pixel `out` is at [i * out_size + out], so that the taps of
+// consecutive output pixels can be loaded as one vector.
+struct ResizeTaps {
+  int32_t num_taps;
+  int32_t out_size;
+  std::vector<int32_t> index;
+  std::vector<float> weight;
+};
+
+void cubic_weights(float t, float* weights) {
+  const float t1 = t + 1.0f;
+  const float u = 1.0f - t;
+  weights[0] = ((kCubicA * t1 - 5.0f * kCubicA) * t1 + 8.0f * kCubicA) * t1 -
+      4.0f * kCubicA;
+  weights[1] = ((kCubicA + 2.0f) * t - (kCubicA + 3.0f)) * t * t + 1.0f;
+  weights[2] = ((kCubicA + 2.0f) * u - (kCubicA + 3.0f)) * u * u + 1.0f;
+  weights[3] = 1.0f - weights[0] - weights[1] - weights[2];
+}
+
+// Taps with half pixel centers, i.e. align_corners=False, clamping the
+// source pixels to the border.
+ResizeTaps
+compute_taps(int32_t in_size, int32_t out_size, ResizeFilter filter) {
+  ResizeTaps taps;
+  taps.num_taps = filter == ResizeFilter::Bicubic ? 4 : 2;
+  taps.out_size = out_size;
+  taps.index.resize(static_cast<size_t>(out_size) * taps.num_taps);
+  taps.weight.resize(static_cast<size_t>(out_size) * taps.num_taps);
+  const float scale = static_cast<float>(in_size) / out_size;
+  for (int32_t out = 0; out < out_size; ++out) {
+    float src = (out + 0.5f) * scale - 0.5f;
+    if (filter == ResizeFilter::Bilinear) {
+      // Linear interpolation does not extrapolate past the first pixel.
+      src = std::max(src, 0.0f);
+    }
+    const int32_t first = static_cast<int32_t>(std::floor(src));
+    const float t = src - first;
+    float weight[4];
+    int32_t index[4];
+    if (filter == ResizeFilter::Bicubic) {
+      cubic_weights(t, weight);
+      for (int32_t tap = 0; tap < 4; ++tap) {
+        index[tap] = std::min(std::max(first - 1 + tap, 0), in_size - 1);
+      }
+    } else {
+      weight[0] = 1.0f - t;
+      weight[1] = t;
+      index[0] = std::min(first, in_size - 1);
+      index[1] = std::min(first + 1, in_size - 1);
+    }
+    for (int32_t tap = 0; tap < taps.num_taps; ++tap) {
+      taps.index[tap * out_size + out] = index[tap];
+      taps.weight[tap * out_size + out] = weight[tap];
+    }
+  }
+  return taps;
+}
+
+struct Geometry {
+  int32_t channels;
+  int32_t canvas_height;
+  int32_t canvas_width;
+  int32_t tile_height;
+  int32_t tile_width;
+};
+
+Error validate(
+    const Image& image,
+    const ImagePreprocessOptions& options,
+    Geometry& geometry) {
+  ET_CHECK_OR_RETURN_ERROR(
+      image.width > 0 && image.height > 0 && image.channels > 0,
+      InvalidArgument,
+      "Invalid image size %" PRId32 "x%" PRId32 "x%" PRId32,
+      image.channels,
+      image.height,
+      image.width);
+  ET_CHECK_OR_RETURN_ERROR(
+      image.data.size() ==
+          static_cast<size_t>(image.channels) * image.height * image.width,
+      InvalidArgument,
+      "Image has %zu bytes for %" PRId32 "x%" PRId32 "x%" PRId32 " pixels",
+      image.data.size(),
+      image.channels,
+      image.height,
+      image.width);
+  ET_CHECK_OR_RETURN_ERROR(
+      options.resize_height > 0 && options.resize_width > 0,
+      InvalidArgument,
+      "Invalid resize size %" PRId32 "x%" PRId32,
+      options.resize_height,
+      options.resize_width);
+
+  geometry.channels = image.channels;
+  geometry.canvas_height = options.canvas_height > 0 ? options.canvas_height
+                                                     : options.resize_height;
+  geometry.canvas_width =
+      options.canvas_width > 0 ? options.canvas_width : options.resize_width;
+  ET_CHECK_OR_RETURN_ERROR(
+      geometry.canvas_height >= options.resize_height &&
+          geometry.canvas_width >= options.resize_width,
+      InvalidArgument,
+      "Canvas %" PRId32 "x%" PRId32 " is smaller than the resized image",
+      geometry.canvas_height,
+      geometry.canvas_width);
+
+  ET_CHECK_OR_RETURN_ERROR(
+      options.mean.size() == options.std.size() &&
+          (options.mean.empty() ||
+           options.mean.size() == static_cast<size_t>(image.channels)),
+      InvalidArgument,
+      "Expected a mean and std for each of the %" PRId32 " channels",
+      image.channels);
+  for (float std : options.std) {
+    ET_CHECK_OR_RETURN_ERROR(
+        std != 0.0f, InvalidArgument, "Standard deviation cannot be 0");
+  }
+
+  ET_CHECK_OR_RETURN_ERROR(
+      options.tile_size >= 0 &&
+          (options.tile_size == 0 ||
+           (geometry.canvas_height % options.tile_size == 0 &&
+            geometry.canvas_width % options.tile_size == 0)),
+      InvalidArgument,
+      "Tile size %" PRId32 " does not divide the canvas %" PRId32 "x%" PRId32,
+      options.tile_size,
+      geometry.canvas_height,
+      geometry.canvas_width);
+  geometry.tile_height =
+      options.tile_size > 0 ? options.tile_size : geometry.canvas_height;
+  geometry.tile_width =
+      options.tile_size > 0 ? options.tile_size : geometry.canvas_width;
+  return Error::Ok;
+}
+
+} // namespace
+
+std::vector<executorch::aten::SizesType> preprocessed_image_sizes(
+    const Image& image,
+    const ImagePreprocessOptions& options) {
+  Geometry geometry;
+  if (validate(image, options, geometry) != Error::Ok) {
+    return {};
+  }
+  if (options.tile_size == 0) {
+    return {
+        geometry.channels, geometry.canvas_height, geometry.canvas_width};
+  }
+  const int32_t num_tiles = (geometry.canvas_height / options.tile_size) *
+      (geometry.canvas_width / options.tile_size);
+  return {num_tiles, geometry.channels, options.tile_size, options.tile_size};
+}
+
+Error preprocess_image(
+    const Image& image,
+    const ImagePreprocessOptions& options,
+    float* out,
+    size_t out_numel) {
+  Geometry geometry;
+  ET_CHECK_OK_OR_RETURN_ERROR(validate(image, options, geometry));
+  const int32_t channels = geometry.channels;
+  const int32_t canvas_height = geometry.canvas_height;
+  const int32_t canvas_width = geometry.canvas_width;
+  ET_CHECK_OR_RETURN_ERROR(
+      out_numel == static_cast<size_t>(channels) * canvas_height * canvas_width,
+      InvalidArgument,
+      "Output has %zu elements, expected %zu",
+      out_numel,
+      static_cast<size_t>(channels) * canvas_height * canvas_width);
+
+  // Fold the rescale and normalization into out = pixel * scale + bias.
+  std::vector<float> scale(channels, options.rescale);
+  std::vector<float> bias(channels, 0.0f);
+  for (size_t c = 0; c < options.mean.size(); ++c) {
+    scale[c] = options.rescale / options.std[c];
+    bias[c] = -options.mean[c] / options.std[c];
+  }
+
+  const ResizeTaps rows =
+      compute_taps(image.height, options.resize_height, options.filter);
+  const ResizeTaps columns =
+      compute_taps(image.width, options.resize_width, options.filter);
+  const int32_t column_stride = options.channels_last ? channels : 1;
+  const int64_t row_stride = options.channels_last
+      ? static_cast<int64_t>(image.width) * channels
+      : image.width;
+  const int64_t channel_stride = options.channels_last
+      ? 1
+      : static_cast<int64_t>(image.height) * image.width;
+
+  const int32_t tile_height = geometry.tile_height;
+  const int32_t tile_width = geometry.tile_width;
+  const int32_t tiles_per_row = canvas_width / tile_width;
+  const int64_t tile_numel = static_cast<int64_t>(tile_height) * tile_width;
+  const uint8_t* const pixels = image.data.data();
+
+  // One output row is one channel of one row of the canvas. It is first
+  // interpolated vertically into one float row of the image, then
+  // horizontally, a vector of output columns at a time.
+  const auto run = [&](int64_t begin, int64_t end) {
+    using Vec = executorch::vec::Vectorized<float>;
+    using IndexVec = executorch::vec::Vectorized<int32_t>;
+    std::vector<float> image_row(image.width);
+    for (int64_t output_row = begin; output_row < end; ++output_row) {
+      const int32_t c = output_row / canvas_height;
+      const int32_t y = output_row % canvas_height;
+      const float pad = bias[c];
+      if (y < options.resize_height) {
+        const uint8_t* const channel_pixels = pixels + c * channel_stride;
+        std::fill(image_row.begin(), image_row.end(), 0.0f);
+        for (int32_t i = 0; i < rows.num_taps; ++i) {
+          const float weight = rows.weight[i * rows.out_size + y];
+          const uint8_t* const src =
+              channel_pixels + rows.index[i * rows.out_size + y] * row_stride;
+          for (int32_t x = 0; x < image.width; ++x) {
+            image_row[x] += weight * src[x * column_stride];
+          }
+        }
+      }
+
+      // The row is split across the tiles of its row of tiles.
+      for (int32_t tile_x = 0; tile_x < tiles_per_row; ++tile_x) {
+        const int64_t tile =
+            static_cast<int64_t>(y / tile_height) * tiles_per_row + tile_x;
+        float* const dst = out + (tile * channels + c) * tile_numel +
+            static_cast<int64_t>(y % tile_height) * tile_width;
+        const int32_t x_begin = tile_x * tile_width;
+        const int32_t x_resized_end =
+            y < options.resize_height
+            ? std::min(x_begin + tile_width, options.resize_width)
+            : x_begin;
+
+        int32_t x = x_begin;
+        for (; x + Vec::size() <= x_resized_end; x += Vec::size()) {
+          Vec value(0.0f);
+          for (int32_t j = 0; j < columns.num_taps; ++j) {
+            const int32_t tap = j * columns.out_size + x;
+            const Vec source = executorch::vec::gather<sizeof(float)>(
+                image_row.data(),
+                IndexVec::loadu(columns.index.data() + tap));
+            value = executorch::vec::fmadd(
+                Vec::loadu(columns.weight.data() + tap), source, value);
+          }
+          executorch::vec::fmadd(value, Vec(scale[c]), Vec(bias[c]))
+              .store(dst + x - x_begin);
+        }
+        for (; x < x_resized_end; ++x) {
+          float value = 0.0f;
+          for (int32_t j = 0; j < columns.num_taps; ++j) {
+            const int32_t tap = j * columns.out_size + x;
+            value += columns.weight[tap] * image_row[columns.index[tap]];
+          }
+          dst[x - x_begin] = value * scale[c] + bias[c];
+        }
+        std::fill(
+            dst + std::max(x_resized_end - x_begin, 0),
+            dst + tile_width,
+            pad);
+      }
+    }
+  };
+
+  const int64_t num_output_rows =
+      static_cast<int64_t>(channels) * canvas_height;
+#ifdef ET_USE_THREADPOOL
+  const int64_t grain_size =
+      std::max<int64_t>(1, kMinElementsPerTask / canvas_width);
+  ::executorch::extension::parallel_for(0, num_output_rows, grain_size, run);
+#else
+  run(0, num_output_rows);
+#endif
+  return Error::Ok;
+}
+
+Error preprocess_image(
+    const Image& image,
+    const ImagePreprocessOptions& options,
+    executorch::aten::Tensor& out) {
+  ET_CHECK_OR_RETURN_ERROR(
+      out.scalar_type() == executorch::aten::ScalarType::Float,
+      InvalidArgument,
+      "Preprocessed image must be Float");
+  return preprocess_image(
+      image, options, out.mutable_data_ptr<float>(), out.numel());
+}
+
+} // namespace llm
+} // namespace extension
+} // namespace executorch
@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Turns a raw image into the float input of an image encoder.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <executorch/extension/llm/runner/image.h>
+#include <executorch/runtime/core/error.h>
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+
+namespace executorch {
+namespace extension {
+namespace llm {
+
+enum class ResizeFilter {
+  // Linear interpolation between the 2x2 nearest pixels.
+  Bilinear,
+  // Cubic convolution over the 4x4 nearest pixels, with a = -0.75.
+  Bicubic,
+};
+
+struct ET_EXPERIMENTAL ImagePreprocessOptions {
+  // Size the image is resized to.
+  int32_t resize_height = 0;
+  int32_t resize_width = 0;
+  // Size of the canvas the resized image is placed in, at the top left. The
+  // rest of the canvas is padded with zeros before normalization. 0 means
+  // the resize size.
+  int32_t canvas_height = 0;
+  int32_t canvas_width = 0;
+  ResizeFilter filter = ResizeFilter::Bilinear;
+  // Whether Image::data is interleaved HWC rather than planar CHW.
+  bool channels_last = true;
+  // Factor from uint8 to float values before normalization.
+  float rescale = 1.0f / 255.0f;
+  // Per channel mean and standard deviation of the normalization
+  // (x * rescale - mean) / std. Both empty for no normalization.
+  std::vector<float> mean;
+  std::vector<float> std;
+  // Size of the square tiles the canvas is cut into, as by
+  // preprocess::tile_crop. 0 for no tiling.
+  int32_t tile_size = 0;
+};
+
+/**
+ * The sizes of the output of preprocess_image(): [channels, height, width]
+ * of the canvas, or [num_tiles, channels, tile_size, tile_size] if tiling.
+ */
+ET_EXPERIMENTAL std::vector<executorch::aten::SizesType>
+preprocessed_image_sizes(
+    const Image& image,
+    const ImagePreprocessOptions& options);
+
+/**
+ * Converts `image` to float, resizes, pads, normalizes and tile-crops it in a
+ * single pass over the output, spread over the threadpool when there is one.
+ * Each output row is interpolated from the uint8 pixels through a single
+ * float row of the image, so there are no intermediate images.
+ *
+ * Unlike PIL and torchvision with antialias, downscaling does not low-pass
+ * filter the image, so it should not shrink an image by much more than 2x.
+ *
+ * @param image The image, with width, height and channels set.
+ * @param options How to preprocess the image.
+ * @param out Where to write the output, e.g. the input buffer of the image
+ * encoder. It must hold exactly numel(preprocessed_image_sizes()) floats.
+ * @param out_numel The number of floats at `out`.
+ * @return InvalidArgument if the image or the options are invalid.
+ */
+ET_EXPERIMENTAL ::executorch::runtime::Error preprocess_image(
+    const Image& image,
+    const ImagePreprocessOptions& options,
+    float* out,
+    size_t out_numel);
+
+/**
+ * Same as above, writing into `out`, which must be a Float tensor with as
+ * many elements as the output. Only the element count is checked, so `out`
+ * may have any shape of that size.
+ */
+ET_EXPERIMENTAL ::executorch::runtime::Error preprocess_image(
+    const Image& image,
+    const ImagePreprocessOptions& options,
+    executorch::aten::Tensor& out);
+
+} // namespace llm
+} // namespace extension
+} // namespace executorch
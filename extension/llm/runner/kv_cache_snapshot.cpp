@@ -0,0 +1,375 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Saves the KV cache of a LLM to a file and restores it later, so that a
+// session can resume without prefilling its tokens again.
+
+#include <executorch/extension/llm/runner/kv_cache_snapshot.h>
+
+#include <algorithm>
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+namespace executorch {
+namespace extension {
+namespace llm {
+
+using ::executorch::runtime::DataLoader;
+using ::executorch::runtime::Error;
+using ::executorch::runtime::Result;
+using ::executorch::runtime::Span;
+
+namespace {
+
+// File layout, in native byte order:
+//
+//   SnapshotHeader
+//   uint64_t tokens[num_tokens]
+//   for each of the num_buffers buffers:
+//     uint64_t size
+//     for each block of up to kKVCacheSnapshotBlockBytes bytes:
+//       uint8_t encoding, followed by
+//         kZeroBlock:  nothing
+//         kRawBlock:   the block's bytes
+//         kInt8Block:  float scale, then one int8 per float32 of the block
+constexpr char kMagic[4] = {'E', 'T', 'K', 'V'};
+constexpr uint32_t kVersion = 1;
+
+struct SnapshotHeader {
+  char magic[4];
+  uint32_t version;
+  uint32_t block_bytes;
+  uint32_t num_buffers;
+  int64_t pos;
+  uint64_t num_tokens;
+};
+
+enum BlockEncoding : uint8_t {
+  kZeroBlock = 0,
+  kRawBlock = 1,
+  kInt8Block = 2,
+};
+
+bool is_zero(const uint8_t* data, size_t size) {
+  return std::all_of(data, data + size, [](uint8_t b) { return b == 0; });
+}
+
+/**
+ * Returns the largest magnitude of `values`, or a negative number if one of
+ * them is not finite.
+ */
+float abs_max(const float* values, size_t count) {
+  float result = 0;
+  for (size_t i = 0; i < count; ++i) {
+    if (!std::isfinite(values[i])) {
+      return -1;
+    }
+    result = std::max(result, std::abs(values[i]));
+  }
+  return result;
+}
+
+void write_block(
+    std::ofstream& file,
+    const uint8_t* data,
+    size_t size,
+    bool compress_int8) {
+  if (is_zero(data, size)) {
+    file.put(kZeroBlock);
+    return;
+  }
+  if (compress_int8 && size == kKVCacheSnapshotBlockBytes) {
+    float values[kKVCacheSnapshotBlockBytes / sizeof(float)];
+    std::memcpy(values, data, size);
+    const size_t count = size / sizeof(float);
+    const float max = abs_max(values, count);
+    if (max > 0) {
+      const float scale = max / 127;
+      int8_t quantized[kKVCacheSnapshotBlockBytes / sizeof(float)];
+      for (size_t i = 0; i < count; ++i) {
+        quantized[i] = static_cast<int8_t>(std::nearbyint(values[i] / scale));
+      }
+      file.put(kInt8Block);
+      file.write(reinterpret_cast<const char*>(&scale), sizeof(scale));
+      file.write(reinterpret_cast<const char*>(quantized), count);
+      return;
+    }
+  }
+  file.put(kRawBlock);
+  file.write(reinterpret_cast<const char*>(data), size);
+}
+
+/**
+ * Returns, for each block of each of the method's memory-planned buffers,
+ * whether every tensor the memory plan places in it is float32, so that it
+ * can be stored as int8. Blocks that no tensor covers are not float32.
+ */
+Result<std::vector<std::vector<bool>>> float32_blocks(
+    Module* module,
+    const std::string& method_name,
+    const std::vector<Span<uint8_t>>& spans) {
+  enum BlockType : uint8_t { kUnused, kFloat32, kOther };
+  std::vector<std::vector<BlockType>> types(spans.size());
+  for (size_t i = 0; i < spans.size(); ++i) {
+    types[i].assign(
+        (spans[i].size() + kKVCacheSnapshotBlockBytes - 1) /
+            kKVCacheSnapshotBlockBytes,
+        kUnused);
+  }
+  for (const auto& tensor :
+       ET_UNWRAP(module->memory_planned_tensors(method_name))) {
+    const uint8_t* begin = static_cast<const uint8_t*>(tensor.data);
+    for (size_t i = 0; i < spans.size() && tensor.nbytes > 0; ++i) {
+      // Inputs may have been redirected to memory outside the buffers.
+      if (begin < spans[i].data() ||
+          begin + tensor.nbytes > spans[i].data() + spans[i].size()) {
+        continue;
+      }
+      const size_t offset = begin - spans[i].data();
+      const size_t first = offset / kKVCacheSnapshotBlockBytes;
+      const size_t last =
+          (offset + tensor.nbytes - 1) / kKVCacheSnapshotBlockBytes;
+      for (size_t block = first; block <= last; ++block) {
+        if (tensor.scalar_type != executorch::aten::ScalarType::Float) {
+          types[i][block] = kOther;
+        } else if (types[i][block] == kUnused) {
+          types[i][block] = kFloat32;
+        }
+      }
+      break;
+    }
+  }
+
+  std::vector<std::vector<bool>> result(spans.size());
+  for (size_t i = 0; i < spans.size(); ++i) {
+    result[i].reserve(types[i].size());
+    for (const auto type : types[i]) {
+      result[i].push_back(type == kFloat32);
+    }
+  }
+  return result;
+}
+
+/**
+ * Decodes the buffers of a snapshot starting at `data`. Only checks that
+ * they fit `spans` and the end of the snapshot unless `apply` is set, in
+ * which case it also writes them into `spans`.
+ */
+Error decode_buffers(
+    const uint8_t* data,
+    const uint8_t* end,
+    const std::vector<Span<uint8_t>>& spans,
+    bool apply) {
+  for (const auto& span : spans) {
+    uint64_t size;
+    ET_CHECK_OR_RETURN_ERROR(
+        end - data >= static_cast<ptrdiff_t>(sizeof(size)),
+        InvalidProgram,
+        "Truncated KV cache snapshot");
+    std::memcpy(&size, data, sizeof(size));
+    data += sizeof(size);
+    ET_CHECK_OR_RETURN_ERROR(
+        size == span.size(),
+        InvalidArgument,
+        "Snapshot buffer of %" PRIu64 " bytes does not match the method's "
+        "buffer of %zu bytes",
+        size,
+        span.size());
+
+    for (size_t offset = 0; offset < span.size();
+         offset += kKVCacheSnapshotBlockBytes) {
+      const size_t block_size =
+          std::min(kKVCacheSnapshotBlockBytes, span.size() - offset);
+      uint8_t* dest = span.data() + offset;
+      ET_CHECK_OR_RETURN_ERROR(
+          data < end, InvalidProgram, "Truncated KV cache snapshot");
+      const uint8_t encoding = *data++;
+      switch (encoding) {
+        case kZeroBlock:
+          if (apply) {
+            std::memset(dest, 0, block_size);
+          }
+          break;
+        case kRawBlock:
+          ET_CHECK_OR_RETURN_ERROR(
+              end - data >= static_cast<ptrdiff_t>(block_size),
+              InvalidProgram,
+              "Truncated KV cache snapshot");
+          if (apply) {
+            std::memcpy(dest, data, block_size);
+          }
+          data += block_size;
+          break;
+        case kInt8Block: {
+          const size_t count = block_size / sizeof(float);
+          ET_CHECK_OR_RETURN_ERROR(
+              block_size == kKVCacheSnapshotBlockBytes &&
+                  end - data >= static_cast<ptrdiff_t>(sizeof(float) + count),
+              InvalidProgram,
+              "Truncated KV cache snapshot");
+          if (apply) {
+            float scale;
+            std::memcpy(&scale, data, sizeof(scale));
+            const int8_t* quantized =
+                reinterpret_cast<const int8_t*>(data + sizeof(scale));
+            float values[kKVCacheSnapshotBlockBytes / sizeof(float)];
+            for (size_t i = 0; i < count; ++i) {
+              values[i] = quantized[i] * scale;
+            }
+            std::memcpy(dest, values, block_size);
+          }
+          data += sizeof(float) + count;
+          break;
+        }
+        default:
+          ET_LOG(
+              Error, "Unknown KV cache snapshot block encoding %u", encoding);
+          return Error::InvalidProgram;
+      }
+    }
+  }
+  ET_CHECK_OR_RETURN_ERROR(
+      data == end, InvalidProgram, "Trailing data in KV cache snapshot");
+  return Error::Ok;
+}
+
+} // namespace
+
+Error save_kv_cache_snapshot(
+    Module* module,
+    const std::string& method_name,
+    const std::string& path,
+    const KVCacheSnapshotInfo& info,
+    bool compress_int8) {
+  const auto spans = ET_UNWRAP(module->memory_planned_buffers(method_name));
+  // Only blocks known to hold float32 values are stored as int8, so that
+  // state of another type is never corrupted. If there are none, fail rather
+  // than silently store everything uncompressed.
+  std::vector<std::vector<bool>> compressible(spans.size());
+  if (compress_int8) {
+    compressible = ET_UNWRAP(float32_blocks(module, method_name, spans));
+    ET_CHECK_OR_RETURN_ERROR(
+        std::any_of(
+            compressible.begin(),
+            compressible.end(),
+            [](const std::vector<bool>& blocks) {
+              return std::find(blocks.begin(), blocks.end(), true) !=
+                  blocks.end();
+            }),
+        NotSupported,
+        "Int8 compression needs float32 state, but %s has no float32 "
+        "memory-planned tensors",
+        method_name.c_str());
+  }
+
+  const std::string temp_path = path + ".tmp";
+  std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+  ET_CHECK_OR_RETURN_ERROR(
+      file.is_open(),
+      AccessFailed,
+      "Failed to open %s for writing",
+      temp_path.c_str());
+
+  SnapshotHeader header;
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.block_bytes = kKVCacheSnapshotBlockBytes;
+  header.num_buffers = spans.size();
+  header.pos = info.pos;
+  header.num_tokens = info.tokens.size();
+  file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  file.write(
+      reinterpret_cast<const char*>(info.tokens.data()),
+      info.tokens.size() * sizeof(uint64_t));
+
+  for (size_t i = 0; i < spans.size(); ++i) {
+    const auto& span = spans[i];
+    const uint64_t size = span.size();
+    file.write(reinterpret_cast<const char*>(&size), sizeof(size));
+    for (size_t offset = 0; offset < span.size();
+         offset += kKVCacheSnapshotBlockBytes) {
+      write_block(
+          file,
+          span.data() + offset,
+          std::min(kKVCacheSnapshotBlockBytes, span.size() - offset),
+          compress_int8 &&
+              compressible[i][offset / kKVCacheSnapshotBlockBytes]);
+    }
+  }
+
+  file.close();
+  if (!file) {
+    std::remove(temp_path.c_str());
+    ET_LOG(Error, "Failed to write %s", temp_path.c_str());
+    return Error::AccessFailed;
+  }
+  if (std::rename(temp_path.c_str(), path.c_str()) != 0) {
+    std::remove(temp_path.c_str());
+    ET_LOG(Error, "Failed to rename %s to %s", temp_path.c_str(), path.c_str());
+    return Error::AccessFailed;
+  }
+  return Error::Ok;
+}
+
+Result<KVCacheSnapshotInfo> load_kv_cache_snapshot(
+    Module* module,
+    const std::string& method_name,
+    DataLoader* data_loader) {
+  const auto spans = ET_UNWRAP(module->memory_planned_buffers(method_name));
+
+  const size_t file_size = ET_UNWRAP(data_loader->size());
+  ET_CHECK_OR_RETURN_ERROR(
+      file_size >= sizeof(SnapshotHeader),
+      InvalidProgram,
+      "KV cache snapshot is too small");
+  auto buffer = ET_UNWRAP(data_loader->load(
+      0,
+      file_size,
+      DataLoader::SegmentInfo(DataLoader::SegmentInfo::Type::Mutable)));
+  const uint8_t* data = static_cast<const uint8_t*>(buffer.data());
+  const uint8_t* end = data + file_size;
+
+  SnapshotHeader header;
+  std::memcpy(&header, data, sizeof(header));
+  data += sizeof(header);
+  ET_CHECK_OR_RETURN_ERROR(
+      std::memcmp(header.magic, kMagic, sizeof(kMagic)) == 0 &&
+          header.version == kVersion &&
+          header.block_bytes == kKVCacheSnapshotBlockBytes,
+      InvalidProgram,
+      "Not a KV cache snapshot, or one from an incompatible version");
+  ET_CHECK_OR_RETURN_ERROR(
+      header.num_buffers == spans.size(),
+      InvalidArgument,
+      "Snapshot has %" PRIu32 " buffers but the method has %zu",
+      header.num_buffers,
+      spans.size());
+  ET_CHECK_OR_RETURN_ERROR(
+      header.num_tokens <= (end - data) / sizeof(uint64_t),
+      InvalidProgram,
+      "Truncated KV cache snapshot");
+
+  KVCacheSnapshotInfo info;
+  info.pos = header.pos;
+  info.tokens.resize(header.num_tokens);
+  std::memcpy(
+      info.tokens.data(), data, header.num_tokens * sizeof(uint64_t));
+  data += header.num_tokens * sizeof(uint64_t);
+
+  ET_CHECK_OK_OR_RETURN_ERROR(
+      decode_buffers(data, end, spans, /*apply=*/false));
+  ET_CHECK_OK_OR_RETURN_ERROR(decode_buffers(data, end, spans, /*apply=*/true));
+  return info;
+}
+
+} // namespace llm
+} // namespace extension
+} // namespace executorch
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Saves the KV cache of a LLM to a file and restores it later, so that a
+// session can resume without prefilling its tokens again.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <executorch/extension/module/module.h>
+#include <executorch/runtime/core/data_loader.h>
+
+namespace executorch {
+namespace extension {
+namespace llm {
+
+/// The granularity at which zero blocks are skipped and int8 scales apply.
+constexpr size_t kKVCacheSnapshotBlockBytes = 1024;
+
+/**
+ * The position and tokens stored in a KV cache snapshot along with the
+ * cache contents.
+ */
+struct KVCacheSnapshotInfo {
+  /// The position in the KV cache of the next token to feed to the model.
+  int64_t pos = 0;
+  /// The tokens whose keys and values are in the KV cache, by position.
+  std::vector<uint64_t> tokens;
+};
+
+/**
+ * Writes the memory-planned buffers of a method to `path`, together with
+ * `info`. The KV cache of an exported LLM lives in these buffers as mutable
+ * state; everything else in them is scratch space between executions.
+ *
+ * The buffers are stored in blocks of kKVCacheSnapshotBlockBytes. Blocks of
+ * zeros, such as the part of the cache past the last position, take one
+ * byte. With `compress_int8`, blocks of finite float32 values are stored as
+ * int8 with one scale per block, which is a quarter of the size at the cost
+ * of some precision. Only blocks where the memory plan places nothing but
+ * float32 tensors are compressed; the others are stored as they are.
+ *
+ * The file is written next to `path` and renamed into place, so a reader
+ * never sees a partial snapshot. It is in native byte order.
+ *
+ * @param[in] module The Module that owns the method.
+ * @param[in] method_name The method whose state to save.
+ * @param[in] path The file to write.
+ * @param[in] info The position and tokens to store with the cache.
+ * @param[in] compress_int8 Whether to store float32 blocks as int8.
+ *
+ * @returns An Error to indicate success or failure. NotSupported if
+ * `compress_int8` is set but the method has no float32 state.
+ */
+ET_EXPERIMENTAL ::executorch::runtime::Error save_kv_cache_snapshot(
+    Module* module,
+    const std::string& method_name,
+    const std::string& path,
+    const KVCacheSnapshotInfo& info,
+    bool compress_int8 = false);
+
+/**
+ * Reads a snapshot written by save_kv_cache_snapshot() for the same program
+ * back into the memory-planned buffers of a method. The whole snapshot is
+ * validated before any buffer is written, so on error the method's state is
+ * unchanged. Pass an MmapDataLoader to read pre-built snapshots, e.g. of a
+ * common system prompt, without copying them into memory first.
+ *
+ * @param[in] module The Module that owns the method.
+ * @param[in] method_name The method whose state to restore.
+ * @param[in] data_loader The loader to read the snapshot from.
+ *
+ * @returns The position and tokens stored with the cache, or an error.
+ */
+ET_EXPERIMENTAL ::executorch::runtime::Result<KVCacheSnapshotInfo>
+load_kv_cache_snapshot(
+    Module* module,
+    const std::string& method_name,
+    ::executorch::runtime::DataLoader* data_loader);
+
+} // namespace llm
+} // namespace extension
+} // namespace executorch
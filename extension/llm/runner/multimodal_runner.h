@@ -20,6 +20,7 @@
 #include <unordered_map>
 
 #include <executorch/extension/llm/runner/image.h>
+#include <executorch/extension/llm/runner/image_embedding_cache.h>
 #include <executorch/extension/llm/runner/image_prefiller.h>
 #include <executorch/extension/llm/runner/stats.h>
 #include <executorch/extension/llm/runner/text_decoder_runner.h>
@@ -127,6 +128,8 @@ class ET_EXPERIMENTAL MultimodalRunner {
   std::unique_ptr<TextDecoderRunner> text_decoder_runner_;
   std::unique_ptr<TextPrefiller> text_prefiller_;
   std::unique_ptr<ImagePrefiller> image_prefiller_;
+  // Encoder outputs of recent images, if enabled.
+  std::unique_ptr<ImageEmbeddingCache> image_embedding_cache_;
   std::unique_ptr<TextTokenGenerator> text_token_generator_;
   std::string tokenizer_path_;
   std::unique_ptr<Tokenizer> tokenizer_;
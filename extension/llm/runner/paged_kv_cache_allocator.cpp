@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Hands out the pages of a paged KV cache to sequences as they grow.
+
+#include <executorch/extension/llm/runner/paged_kv_cache_allocator.h>
+
+#include <cinttypes>
+
+namespace executorch {
+namespace extension {
+namespace llm {
+
+using ::executorch::runtime::Error;
+
+PagedKVCacheAllocator::PagedKVCacheAllocator(
+    int64_t num_pages,
+    int64_t page_size,
+    int32_t max_sequences,
+    int64_t max_pages_per_sequence)
+    : page_size_(page_size),
+      max_sequences_(max_sequences),
+      max_pages_per_sequence_(max_pages_per_sequence),
+      num_sequence_pages_(max_sequences, 0),
+      block_table_(max_sequences * max_pages_per_sequence, -1) {
+  ET_CHECK_MSG(
+      num_pages > 0 && page_size > 0 && max_sequences > 0 &&
+          max_pages_per_sequence > 0,
+      "Invalid paged KV cache dimensions");
+  free_pages_.reserve(num_pages);
+  // Hand out the pages in increasing order at first.
+  for (int64_t page = num_pages - 1; page >= 0; --page) {
+    free_pages_.push_back(page);
+  }
+}
+
+Error PagedKVCacheAllocator::reserve(int32_t sequence, int64_t num_tokens) {
+  ET_CHECK_OR_RETURN_ERROR(
+      sequence >= 0 && sequence < max_sequences_,
+      InvalidArgument,
+      "Invalid sequence %" PRId32,
+      sequence);
+  const int64_t num_pages = (num_tokens + page_size_ - 1) / page_size_;
+  ET_CHECK_OR_RETURN_ERROR(
+      num_pages <= max_pages_per_sequence_,
+      InvalidArgument,
+      "%" PRId64 " positions exceed the %" PRId64
+      " pages of %" PRId64 " positions of a sequence",
+      num_tokens,
+      max_pages_per_sequence_,
+      page_size_);
+
+  int64_t& num_held = num_sequence_pages_[sequence];
+  const int64_t num_missing = num_pages - num_held;
+  if (num_missing <= 0) {
+    return Error::Ok;
+  }
+  ET_CHECK_OR_RETURN_ERROR(
+      num_missing <= num_free_pages(),
+      MemoryAllocationFailed,
+      "Sequence %" PRId32 " needs %" PRId64 " more pages but only %" PRId64
+      " are free",
+      sequence,
+      num_missing,
+      num_free_pages());
+
+  int64_t* row = block_table_.data() + sequence * max_pages_per_sequence_;
+  for (; num_held < num_pages; ++num_held) {
+    row[num_held] = free_pages_.back();
+    free_pages_.pop_back();
+  }
+  return Error::Ok;
+}
+
+void PagedKVCacheAllocator::release(int32_t sequence) {
+  ET_CHECK_MSG(
+      sequence >= 0 && sequence < max_sequences_,
+      "Invalid sequence %" PRId32,
+      sequence);
+  int64_t* row = block_table_.data() + sequence * max_pages_per_sequence_;
+  // Push the last page first, so that the first one is reused first.
+  for (int64_t index = num_sequence_pages_[sequence] - 1; index >= 0;
+       --index) {
+    free_pages_.push_back(row[index]);
+    row[index] = -1;
+  }
+  num_sequence_pages_[sequence] = 0;
+}
+
+int64_t PagedKVCacheAllocator::capacity(int32_t sequence) const {
+  ET_CHECK_MSG(
+      sequence >= 0 && sequence < max_sequences_,
+      "Invalid sequence %" PRId32,
+      sequence);
+  return num_sequence_pages_[sequence] * page_size_;
+}
+
+TensorPtr PagedKVCacheAllocator::block_table() {
+  return from_blob(
+      block_table_.data(),
+      {max_sequences_,
+       static_cast<executorch::aten::SizesType>(max_pages_per_sequence_)},
+      executorch::aten::ScalarType::Long);
+}
+
+} // namespace llm
+} // namespace extension
+} // namespace executorch
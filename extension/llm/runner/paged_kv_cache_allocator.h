@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Hands out the pages of a paged KV cache to sequences as they grow.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <executorch/extension/tensor/tensor.h>
+#include <executorch/runtime/core/error.h>
+#include <executorch/runtime/platform/assert.h>
+
+namespace executorch {
+namespace extension {
+namespace llm {
+
+/**
+ * Manages the block table of a model that uses llama::paged_sdpa_with_kv_cache,
+ * whose KV cache is a pool of `num_pages` pages of `page_size` positions
+ * shared by all sequences.
+ *
+ * A sequence only holds the pages for the positions it has reserved, so the
+ * memory of the pool scales with the number of tokens in flight rather than
+ * with the maximum sequence length times the number of sequences. Released
+ * pages are handed out again most recently used first, while they are still
+ * likely to be in cache.
+ *
+ * The block table has one row per sequence slot and one column per page of
+ * a sequence. Entries past the reserved pages of a sequence are -1.
+ */
+class ET_EXPERIMENTAL PagedKVCacheAllocator {
+ public:
+  PagedKVCacheAllocator(
+      int64_t num_pages,
+      int64_t page_size,
+      int32_t max_sequences,
+      int64_t max_pages_per_sequence);
+
+  /**
+   * Makes sure that positions 0...num_tokens - 1 of `sequence` have pages,
+   * allocating the missing ones. Either all missing pages are allocated or,
+   * on error, none are.
+   * @param sequence The slot of the sequence, i.e. its row in the block
+   * table.
+   * @param num_tokens The number of positions that the sequence will have
+   * written after the next forward call, i.e. start_pos + seq_len.
+   * @return InvalidArgument if the sequence cannot hold that many positions,
+   * MemoryAllocationFailed if the pool does not have enough free pages.
+   */
+  ::executorch::runtime::Error reserve(int32_t sequence, int64_t num_tokens);
+
+  /**
+   * Returns all pages of `sequence` to the pool.
+   */
+  void release(int32_t sequence);
+
+  /**
+   * The number of positions that `sequence` can write without reserving.
+   */
+  int64_t capacity(int32_t sequence) const;
+
+  int64_t num_free_pages() const {
+    return static_cast<int64_t>(free_pages_.size());
+  }
+
+  int64_t page_size() const {
+    return page_size_;
+  }
+
+  /**
+   * The block table to pass to the model, of shape
+   * [max_sequences, max_pages_per_sequence] and type Long. It aliases the
+   * allocator's memory and reflects later calls to reserve() and release().
+   */
+  TensorPtr block_table();
+
+ private:
+  int64_t page_size_;
+  int32_t max_sequences_;
+  int64_t max_pages_per_sequence_;
+  // Used as a stack, so that the most recently released page is reused first.
+  std::vector<int64_t> free_pages_;
+  // Number of pages held by each sequence.
+  std::vector<int64_t> num_sequence_pages_;
+  std::vector<int64_t> block_table_;
+};
+
+} // namespace llm
+} // namespace extension
+} // namespace executorch
@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Run a text decoder that takes its state, e.g. a KV cache or a recurrent
+// state, as explicit inputs and returns the updated state as outputs.
+
+#include <executorch/extension/llm/runner/stateful_text_decoder_runner.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace executorch {
+namespace extension {
+namespace llm {
+
+using ::executorch::runtime::Error;
+using ::executorch::runtime::EValue;
+using ::executorch::runtime::Result;
+using ::executorch::runtime::Tag;
+
+namespace {
+// Inputs before the state inputs, and outputs before the state outputs.
+constexpr size_t kNumNonStateInputs = 2; // tokens, start_pos
+constexpr size_t kNumNonStateOutputs = 1; // logits
+} // namespace
+
+StatefulTextDecoderRunner::StatefulTextDecoderRunner(
+    Module* module,
+    int32_t vocab_size,
+    float temperature)
+    : TextDecoderRunner(
+          module,
+          /*use_kv_cache=*/true,
+          vocab_size,
+          temperature) {}
+
+Error StatefulTextDecoderRunner::load() {
+  ET_CHECK_OK_OR_RETURN_ERROR(TextDecoderRunner::load());
+  return allocate_states();
+}
+
+Error StatefulTextDecoderRunner::allocate_states() {
+  if (allocated_) {
+    return Error::Ok;
+  }
+  const auto method_meta = ET_UNWRAP(module_->method_meta("forward"));
+  ET_CHECK_OR_RETURN_ERROR(
+      method_meta.num_inputs() >= kNumNonStateInputs &&
+          method_meta.num_inputs() - kNumNonStateInputs ==
+              method_meta.num_outputs() - kNumNonStateOutputs,
+      InvalidProgram,
+      "Expected forward to take tokens, start_pos and as many states as it "
+      "returns after the logits, but it has %zu inputs and %zu outputs",
+      method_meta.num_inputs(),
+      method_meta.num_outputs());
+
+  const size_t num_states = method_meta.num_inputs() - kNumNonStateInputs;
+  states_.clear();
+  states_.resize(num_states);
+  for (size_t i = 0; i < num_states; ++i) {
+    const size_t input_index = kNumNonStateInputs + i;
+    const size_t output_index = kNumNonStateOutputs + i;
+    ET_CHECK_OR_RETURN_ERROR(
+        ET_UNWRAP(method_meta.input_tag(input_index)) == Tag::Tensor &&
+            ET_UNWRAP(method_meta.output_tag(output_index)) == Tag::Tensor,
+        InvalidProgram,
+        "State %zu is not a tensor",
+        i);
+    const auto input_meta =
+        ET_UNWRAP(method_meta.input_tensor_meta(input_index));
+    const auto output_meta =
+        ET_UNWRAP(method_meta.output_tensor_meta(output_index));
+    ET_CHECK_OR_RETURN_ERROR(
+        input_meta.nbytes() == output_meta.nbytes() &&
+            input_meta.scalar_type() == output_meta.scalar_type(),
+        InvalidProgram,
+        "State %zu is returned with a different size or type than it is "
+        "passed in",
+        i);
+
+    State& state = states_[i];
+    const auto sizes = input_meta.sizes();
+    const auto dim_order = input_meta.dim_order();
+    for (size_t b = 0; b < 2; ++b) {
+      state.buffers[b].assign(input_meta.nbytes(), 0);
+      state.tensors[b] = make_tensor_ptr(
+          {sizes.begin(), sizes.end()},
+          state.buffers[b].data(),
+          {dim_order.begin(), dim_order.end()},
+          {},
+          input_meta.scalar_type());
+    }
+    state.output_settable = !output_meta.is_memory_planned();
+  }
+  current_ = 0;
+  allocated_ = true;
+  return Error::Ok;
+}
+
+void StatefulTextDecoderRunner::reset_state() {
+  for (auto& state : states_) {
+    std::fill(
+        state.buffers[current_].begin(), state.buffers[current_].end(), 0);
+  }
+}
+
+Result<executorch::aten::Tensor> StatefulTextDecoderRunner::step(
+    TensorPtr& tokens,
+    TensorPtr& start_pos) {
+  ET_CHECK_OK_OR_RETURN_ERROR(allocate_states());
+  if (start_pos->const_data_ptr<int64_t>()[0] == 0) {
+    reset_state();
+  }
+
+  const size_t next = 1 - current_;
+  std::vector<EValue> inputs;
+  inputs.reserve(kNumNonStateInputs + states_.size());
+  inputs.emplace_back(tokens);
+  inputs.emplace_back(start_pos);
+  for (size_t i = 0; i < states_.size(); ++i) {
+    State& state = states_[i];
+    inputs.emplace_back(state.tensors[current_]);
+    if (state.output_settable) {
+      ET_CHECK_OK_OR_RETURN_ERROR(
+          module_->set_output(state.tensors[next], kNumNonStateOutputs + i));
+    }
+  }
+
+  auto outputs = ET_UNWRAP(module_->forward(inputs));
+  ET_CHECK_OR_RETURN_ERROR(
+      outputs.size() == kNumNonStateOutputs + states_.size() &&
+          outputs[0].isTensor(),
+      InvalidProgram,
+      "Expected the logits and %zu states from executing LLM",
+      states_.size());
+
+  for (size_t i = 0; i < states_.size(); ++i) {
+    State& state = states_[i];
+    if (!state.output_settable) {
+      const auto& output = outputs[kNumNonStateOutputs + i].toTensor();
+      std::memcpy(
+          state.buffers[next].data(),
+          output.const_data_ptr(),
+          state.buffers[next].size());
+    }
+  }
+  current_ = next;
+
+  // Return the logits tensor
+  return outputs[0].toTensor();
+}
+
+} // namespace llm
+} // namespace extension
+} // namespace executorch
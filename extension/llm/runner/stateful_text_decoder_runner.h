@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Run a text decoder that takes its state, e.g. a KV cache or a recurrent
+// state, as explicit inputs and returns the updated state as outputs.
+
+#pragma once
+
+#include <executorch/extension/llm/runner/text_decoder_runner.h>
+
+namespace executorch {
+namespace extension {
+namespace llm {
+
+/**
+ * Runs models whose forward method has the signature
+ *
+ *   forward(tokens, start_pos, state_0, ..., state_n-1)
+ *       -> (logits, new_state_0, ..., new_state_n-1)
+ *
+ * which is how models that cannot use the SDPA KV cache op, or that keep
+ * some other state between tokens, are exported. The runner owns the state,
+ * so like a model with a KV cache, such a model only needs to be fed the new
+ * tokens of each step.
+ *
+ * Every state has two buffers: one is passed as the input, and the model
+ * writes the new state straight into the other, which becomes the input of
+ * the next step. No state is copied as long as the state inputs and outputs
+ * are not memory planned at export time; otherwise the runtime copies the
+ * input in and the runner copies the output out.
+ *
+ * The state is reset to zeros whenever a step starts at position 0.
+ */
+class ET_EXPERIMENTAL StatefulTextDecoderRunner : public TextDecoderRunner {
+ public:
+  StatefulTextDecoderRunner(
+      Module* module,
+      int32_t vocab_size,
+      float temperature);
+
+  /**
+   * Run the text decoder on `tokens` at `start_pos` and the current state,
+   * and keep the state it returns for the next step.
+   * @param tokens The new tokens.
+   * @param start_pos The position of the first new token.
+   * @return The logits tensor.
+   */
+  ::executorch::runtime::Result<executorch::aten::Tensor> step(
+      TensorPtr& tokens,
+      TensorPtr& start_pos) override;
+
+  /**
+   * Load the forward method and allocate the state buffers.
+   * @return The error code.
+   */
+  ::executorch::runtime::Error load() override;
+
+  /**
+   * Reset the state to zeros.
+   */
+  void reset_state();
+
+ private:
+  struct State {
+    std::vector<uint8_t> buffers[2];
+    TensorPtr tensors[2];
+    // Whether the model writes its output into tensors[next] directly.
+    bool output_settable;
+  };
+
+  ::executorch::runtime::Error allocate_states();
+
+  std::vector<State> states_;
+  // Which of the two buffers holds the current state.
+  size_t current_ = 0;
+  bool allocated_ = false;
+};
+
+} // namespace llm
+} // namespace extension
+} // namespace executorch
@@ -10,6 +10,7 @@
 #pragma once
 #include <executorch/extension/llm/runner/util.h>
 #include <executorch/runtime/platform/log.h>
+#include <algorithm>
 #include <cinttypes>
 #include <sstream>
 #include <string>
@@ -18,6 +19,58 @@ namespace executorch {
 namespace extension {
 namespace llm {
 
+// Distribution of latencies in microseconds over fixed power-of-two buckets:
+// bucket 0 counts latencies below 1 us, bucket i latencies in
+// [2^(i - 1), 2^i) us, and the last bucket everything from 2^(kNumBuckets - 2)
+// us (about 16.8 s) up. Recording is constant time and allocation free, so it
+// can be done for every token.
+struct ET_EXPERIMENTAL LatencyHistogram {
+  static constexpr size_t kNumBuckets = 26;
+  int64_t buckets[kNumBuckets] = {};
+  int64_t count = 0;
+  int64_t total_us = 0;
+  int64_t min_us = 0;
+  int64_t max_us = 0;
+
+  inline void record(int64_t latency_us) {
+    size_t bucket = 0;
+    for (int64_t rest = latency_us; rest > 0 && bucket < kNumBuckets - 1;
+         rest >>= 1) {
+      bucket++;
+    }
+    buckets[bucket]++;
+    min_us = count == 0 ? latency_us : std::min(min_us, latency_us);
+    max_us = count == 0 ? latency_us : std::max(max_us, latency_us);
+    total_us += latency_us;
+    count++;
+  }
+
+  // Upper bound of the latency below which a fraction `p` of the recorded
+  // latencies fall, exact up to the width of a bucket. 0 if nothing was
+  // recorded.
+  inline int64_t percentile_us(double p) const {
+    const int64_t rank = std::max<int64_t>(
+        1, static_cast<int64_t>(p * static_cast<double>(count) + 0.5));
+    int64_t seen = 0;
+    for (size_t bucket = 0; bucket < kNumBuckets - 1; ++bucket) {
+      seen += buckets[bucket];
+      if (seen >= rank) {
+        const int64_t bucket_max_us = (int64_t{1} << bucket) - 1;
+        return std::min(bucket_max_us, max_us);
+      }
+    }
+    return max_us;
+  }
+
+  inline void reset() {
+    std::fill(buckets, buckets + kNumBuckets, 0);
+    count = 0;
+    total_us = 0;
+    min_us = 0;
+    max_us = 0;
+  }
+};
+
 struct ET_EXPERIMENTAL Stats {
   // Scaling factor for timestamps - in this case, we use ms.
   const long SCALING_FACTOR_UNITS_PER_SECOND = 1000;
@@ -49,13 +102,50 @@ struct ET_EXPERIMENTAL Stats {
   int64_t num_prompt_tokens;
   // Token count from generated (total - prompt)
   int64_t num_generated_tokens;
+  // Per call latencies of every model execution during prefill, which may
+  // take a chunk of the prompt or a single token.
+  LatencyHistogram prefill_chunk_latency;
+  // Per call latencies of every model execution during generation.
+  LatencyHistogram decode_step_latency;
+  // Per token latencies of turning logits into the next token.
+  LatencyHistogram sampling_latency;
+  // Per token latencies of turning the next token into text.
+  LatencyHistogram detokenize_latency;
+  // Per token latencies of the token callback.
+  LatencyHistogram callback_latency;
   inline void on_sampling_begin() {
     aggregate_sampling_timer_start_timestamp = time_in_ms();
+    sampling_timer_start_us = time_in_us();
   }
   inline void on_sampling_end() {
     aggregate_sampling_time_ms +=
         time_in_ms() - aggregate_sampling_timer_start_timestamp;
     aggregate_sampling_timer_start_timestamp = 0;
+    sampling_latency.record(time_in_us() - sampling_timer_start_us);
+  }
+  inline void on_prefill_chunk_begin() {
+    prefill_chunk_timer_start_us = time_in_us();
+  }
+  inline void on_prefill_chunk_end() {
+    prefill_chunk_latency.record(time_in_us() - prefill_chunk_timer_start_us);
+  }
+  inline void on_decode_step_begin() {
+    decode_step_timer_start_us = time_in_us();
+  }
+  inline void on_decode_step_end() {
+    decode_step_latency.record(time_in_us() - decode_step_timer_start_us);
+  }
+  inline void on_detokenize_begin() {
+    detokenize_timer_start_us = time_in_us();
+  }
+  inline void on_detokenize_end() {
+    detokenize_latency.record(time_in_us() - detokenize_timer_start_us);
+  }
+  inline void on_callback_begin() {
+    callback_timer_start_us = time_in_us();
+  }
+  inline void on_callback_end() {
+    callback_latency.record(time_in_us() - callback_timer_start_us);
   }
 
   void reset(bool all_stats = false) {
@@ -76,14 +166,42 @@ struct ET_EXPERIMENTAL Stats {
     num_prompt_tokens = 0;
     num_generated_tokens = 0;
     aggregate_sampling_timer_start_timestamp = 0;
+    prefill_chunk_latency.reset();
+    decode_step_latency.reset();
+    sampling_latency.reset();
+    detokenize_latency.reset();
+    callback_latency.reset();
   }
 
  private:
   long aggregate_sampling_timer_start_timestamp = 0;
+  int64_t sampling_timer_start_us = 0;
+  int64_t prefill_chunk_timer_start_us = 0;
+  int64_t decode_step_timer_start_us = 0;
+  int64_t detokenize_timer_start_us = 0;
+  int64_t callback_timer_start_us = 0;
 };
 
 static constexpr auto kTopp = 0.9f;
 
+inline std::string latency_histogram_to_json_string(
+    const LatencyHistogram& histogram) {
+  std::stringstream ss;
+  ss << "{\"count\":" << histogram.count << ","
+     << "\"total_us\":" << histogram.total_us << ","
+     << "\"min_us\":" << histogram.min_us << ","
+     << "\"max_us\":" << histogram.max_us << ","
+     << "\"p50_us\":" << histogram.percentile_us(0.5) << ","
+     << "\"p90_us\":" << histogram.percentile_us(0.9) << ","
+     << "\"p99_us\":" << histogram.percentile_us(0.99) << ","
+     << "\"buckets\":[";
+  for (size_t bucket = 0; bucket < LatencyHistogram::kNumBuckets; ++bucket) {
+    ss << (bucket > 0 ? "," : "") << histogram.buckets[bucket];
+  }
+  ss << "]}";
+  return ss.str();
+}
+
 inline std::string stats_to_json_string(const Stats& stats) {
   std::stringstream ss;
   ss << "{\"prompt_tokens\":" << stats.num_prompt_tokens << ","
@@ -95,7 +213,17 @@ inline std::string stats_to_json_string(const Stats& stats) {
      << "\"prompt_eval_end_ms\":" << stats.prompt_eval_end_ms << ","
      << "\"first_token_ms\":" << stats.first_token_ms << ","
      << "\"aggregate_sampling_time_ms\":" << stats.aggregate_sampling_time_ms
-     << "," << "\"SCALING_FACTOR_UNITS_PER_SECOND\":"
+     << "," << "\"prefill_chunk_latency\":"
+     << latency_histogram_to_json_string(stats.prefill_chunk_latency) << ","
+     << "\"decode_step_latency\":"
+     << latency_histogram_to_json_string(stats.decode_step_latency) << ","
+     << "\"sampling_latency\":"
+     << latency_histogram_to_json_string(stats.sampling_latency) << ","
+     << "\"detokenize_latency\":"
+     << latency_histogram_to_json_string(stats.detokenize_latency) << ","
+     << "\"callback_latency\":"
+     << latency_histogram_to_json_string(stats.callback_latency) << ","
+     << "\"SCALING_FACTOR_UNITS_PER_SECOND\":"
      << stats.SCALING_FACTOR_UNITS_PER_SECOND << "}";
   return ss.str();
 }
@@ -158,6 +286,19 @@ inline void print_report(const Stats& stats) {
       stats.num_prompt_tokens + stats.num_generated_tokens,
       (double)stats.aggregate_sampling_time_ms /
           stats.SCALING_FACTOR_UNITS_PER_SECOND);
+
+  const LatencyHistogram& decode = stats.decode_step_latency;
+  if (decode.count > 0) {
+    ET_LOG(
+        Info,
+        "\tDecode step latency over %" PRId64
+        " steps:\tp50 %ld, p90 %ld, p99 %ld, max %ld (microseconds)",
+        decode.count,
+        decode.percentile_us(0.5),
+        decode.percentile_us(0.9),
+        decode.percentile_us(0.99),
+        decode.max_us);
+  }
 }
 
 } // namespace llm
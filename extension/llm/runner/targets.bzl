@@ -1,5 +1,19 @@
 load("@fbsource//xplat/executorch/build:runtime_wrapper.bzl", "runtime")
 
+def use_threadpool():
+    return native.read_config("executorch", "llm_runner_use_threadpool", "true") == "true"
+
+def get_threadpool_deps(aten_suffix):
+    # The threadpool defines ET_USE_THREADPOOL, which splits image
+    # preprocessing across threads. Targets without one set
+    # executorch.llm_runner_use_threadpool=false.
+    if use_threadpool():
+        return [
+            "//executorch/extension/parallel:thread_parallel" + aten_suffix,
+            "//executorch/extension/threadpool:threadpool",
+        ]
+    return []
+
 def define_common_targets():
     runtime.cxx_library(
         name = "irunner",
@@ -40,6 +54,18 @@ def define_common_targets():
             ],
         )
 
+        runtime.cxx_library(
+            name = "stateful_text_decoder_runner" + aten_suffix,
+            exported_headers = ["stateful_text_decoder_runner.h"],
+            srcs = ["stateful_text_decoder_runner.cpp"],
+            visibility = [
+                "@EXECUTORCH_CLIENTS",
+            ],
+            exported_deps = [
+                ":text_decoder_runner" + aten_suffix,
+            ],
+        )
+
         runtime.cxx_library(
             name = "text_prefiller" + aten_suffix,
             exported_headers = ["text_prefiller.h"],
@@ -69,6 +95,36 @@ def define_common_targets():
             ],
         )
 
+        runtime.cxx_library(
+            name = "batched_text_token_generator" + aten_suffix,
+            exported_headers = ["batched_text_token_generator.h"],
+            visibility = [
+                "@EXECUTORCH_CLIENTS",
+            ],
+            exported_deps = [
+                ":text_decoder_runner" + aten_suffix,
+                "//executorch/extension/llm/tokenizer:tokenizer_header",
+                "//executorch/extension/module:module" + aten_suffix,
+                "//executorch/extension/tensor:tensor" + aten_suffix,
+            ],
+        )
+
+        runtime.cxx_library(
+            name = "image_preprocessor" + aten_suffix,
+            exported_headers = ["image_preprocessor.h"],
+            srcs = ["image_preprocessor.cpp"],
+            visibility = [
+                "@EXECUTORCH_CLIENTS",
+            ],
+            deps = [
+                "//executorch/kernels/optimized:libvec",
+            ] + get_threadpool_deps(aten_suffix),
+            exported_deps = [
+                ":image_prefiller" + aten_suffix,
+                "//executorch/runtime/core/exec_aten:lib" + aten_suffix,
+            ],
+        )
+
         runtime.cxx_library(
             name = "image_prefiller" + aten_suffix,
             exported_headers = ["image_prefiller.h", "image.h"],
@@ -80,6 +136,43 @@ def define_common_targets():
             ],
         )
 
+        runtime.cxx_library(
+            name = "image_embedding_cache" + aten_suffix,
+            exported_headers = ["image_embedding_cache.h"],
+            srcs = ["image_embedding_cache.cpp"],
+            visibility = [
+                "@EXECUTORCH_CLIENTS",
+            ],
+            exported_deps = [
+                ":image_prefiller" + aten_suffix,
+                "//executorch/extension/tensor:tensor" + aten_suffix,
+            ],
+        )
+
+        runtime.cxx_library(
+            name = "kv_cache_snapshot" + aten_suffix,
+            exported_headers = ["kv_cache_snapshot.h"],
+            srcs = ["kv_cache_snapshot.cpp"],
+            visibility = [
+                "@EXECUTORCH_CLIENTS",
+            ],
+            exported_deps = [
+                "//executorch/extension/module:module" + aten_suffix,
+            ],
+        )
+
+        runtime.cxx_library(
+            name = "paged_kv_cache_allocator" + aten_suffix,
+            exported_headers = ["paged_kv_cache_allocator.h"],
+            srcs = ["paged_kv_cache_allocator.cpp"],
+            visibility = [
+                "@EXECUTORCH_CLIENTS",
+            ],
+            exported_deps = [
+                "//executorch/extension/tensor:tensor" + aten_suffix,
+            ],
+        )
+
         runtime.cxx_library(
             name = "runner_lib" + aten_suffix,
             exported_headers = [
@@ -89,7 +182,13 @@ def define_common_targets():
                 "@EXECUTORCH_CLIENTS",
             ],
             exported_deps = [
+                ":batched_text_token_generator" + aten_suffix,
+                ":image_embedding_cache" + aten_suffix,
                 ":image_prefiller" + aten_suffix,
+                ":image_preprocessor" + aten_suffix,
+                ":kv_cache_snapshot" + aten_suffix,
+                ":paged_kv_cache_allocator" + aten_suffix,
+                ":stateful_text_decoder_runner" + aten_suffix,
                 ":text_decoder_runner" + aten_suffix,
                 ":text_prefiller" + aten_suffix,
                 ":text_token_generator" + aten_suffix,
@@ -0,0 +1,145 @@
+load("@fbsource//xplat/executorch/build:runtime_wrapper.bzl", "runtime")
+
+def define_common_targets(is_fbcode = False):
+    """Defines targets that should be shared between fbcode and xplat.
+
+    The directory containing this targets.bzl file should also contain both
+    TARGETS and BUCK files that call this function.
+    """
+
+    runtime.cxx_test(
+        name = "test_batched_text_token_generator",
+        srcs = [
+            "test_batched_text_token_generator.cpp",
+        ],
+        deps = [
+            "//executorch/extension/llm/runner:batched_text_token_generator",
+        ],
+        compiler_flags = [
+            "-Wno-error=deprecated-declarations",
+        ],
+    )
+
+    runtime.cxx_test(
+        name = "test_image_embedding_cache",
+        srcs = [
+            "test_image_embedding_cache.cpp",
+        ],
+        deps = [
+            "//executorch/extension/llm/runner:image_embedding_cache",
+        ],
+        compiler_flags = [
+            "-Wno-error=deprecated-declarations",
+        ],
+    )
+
+    runtime.cxx_test(
+        name = "test_image_preprocessor",
+        srcs = [
+            "test_image_preprocessor.cpp",
+        ],
+        deps = [
+            "//executorch/extension/llm/runner:image_preprocessor",
+        ],
+        compiler_flags = [
+            "-Wno-error=deprecated-declarations",
+        ],
+    )
+
+    runtime.cxx_test(
+        name = "test_paged_kv_cache_allocator",
+        srcs = [
+            "test_paged_kv_cache_allocator.cpp",
+        ],
+        deps = [
+            "//executorch/extension/llm/runner:paged_kv_cache_allocator",
+        ],
+        compiler_flags = [
+            "-Wno-error=deprecated-declarations",
+        ],
+    )
+
+    runtime.cxx_test(
+        name = "test_stats",
+        srcs = [
+            "test_stats.cpp",
+        ],
+        deps = [
+            "//executorch/extension/llm/runner:stats",
+        ],
+        compiler_flags = [
+            "-Wno-error=deprecated-declarations",
+        ],
+    )
+
+    runtime.cxx_test(
+        name = "test_text_decoder_runner",
+        srcs = [
+            "test_text_decoder_runner.cpp",
+        ],
+        deps = [
+            "//executorch/extension/llm/runner:text_decoder_runner",
+        ],
+        compiler_flags = [
+            "-Wno-error=deprecated-declarations",
+        ],
+    )
+
+    runtime.cxx_test(
+        name = "test_text_token_generator",
+        srcs = [
+            "test_text_token_generator.cpp",
+        ],
+        deps = [
+            "//executorch/extension/llm/runner:text_token_generator",
+        ],
+        compiler_flags = [
+            "-Wno-error=deprecated-declarations",
+        ],
+    )
+
+    # TODO(dbort): Find a way to make these run for ANDROID/APPLE in xplat. The
+    # android and ios test determinators don't like the reference to the model
+    # file in fbcode. See https://fburl.com/9esapdmd
+    if not runtime.is_oss and is_fbcode:
+        modules_env = {
+            # The tests use this var to find the program file to load. This uses
+            # an fbcode target path because the authoring/export tools
+            # intentionally don't work in xplat (since they're host-only tools).
+            "ET_MODULE_ADD_HALF_PATH": "$(location fbcode//executorch/test/models:exported_programs[ModuleAddHalf.pte])",
+            "ET_MODULE_ADD_LARGE_PATH": "$(location fbcode//executorch/test/models:exported_programs[ModuleAddLarge.pte])",
+            "ET_MODULE_ADD_PATH": "$(location fbcode//executorch/test/models:exported_programs[ModuleAdd.pte])",
+            "ET_MODULE_LINEAR_PATH": "$(location fbcode//executorch/test/models:exported_programs[ModuleLinear.pte])",
+            "ET_MODULE_STATEFUL_PATH": "$(location fbcode//executorch/test/models:exported_programs[ModuleStateful.pte])",
+        }
+
+        runtime.cxx_test(
+            name = "test_kv_cache_snapshot",
+            srcs = [
+                "test_kv_cache_snapshot.cpp",
+            ],
+            deps = [
+                "//executorch/extension/data_loader:file_data_loader",
+                "//executorch/extension/llm/runner:kv_cache_snapshot",
+                "//executorch/kernels/portable:generated_lib",
+            ],
+            env = modules_env,
+            compiler_flags = [
+                "-Wno-error=deprecated-declarations",
+            ],
+        )
+
+        runtime.cxx_test(
+            name = "test_stateful_text_decoder_runner",
+            srcs = [
+                "test_stateful_text_decoder_runner.cpp",
+            ],
+            deps = [
+                "//executorch/extension/llm/runner:stateful_text_decoder_runner",
+                "//executorch/kernels/portable:generated_lib",
+            ],
+            env = modules_env,
+            compiler_flags = [
+                "-Wno-error=deprecated-declarations",
+            ],
+        )
@@ -0,0 +1,260 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/llm/runner/batched_text_token_generator.h>
+
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include <executorch/runtime/platform/runtime.h>
+
+using namespace ::executorch::extension;
+using namespace ::executorch::extension::llm;
+using ::executorch::runtime::Error;
+using ::executorch::runtime::Result;
+
+namespace {
+
+constexpr int32_t kBatchSize = 2;
+constexpr int32_t kVocabSize = 16;
+constexpr uint64_t kEosToken = 15;
+
+// A model whose next token is the fed token plus one, for every token.
+class FakeTextDecoderRunner : public TextDecoderRunner {
+ public:
+  FakeTextDecoderRunner()
+      : TextDecoderRunner(nullptr, true, kVocabSize, 0.0f) {}
+
+  Result<executorch::aten::Tensor> batched_step(
+      TensorPtr& tokens,
+      TensorPtr& start_pos,
+      TensorPtr& num_tokens) override {
+    const auto num_fed = tokens->numel();
+    const auto* token_data = tokens->const_data_ptr<int64_t>();
+    const auto* pos_data = start_pos->const_data_ptr<int64_t>();
+    const auto* num_tokens_data = num_tokens->const_data_ptr<int64_t>();
+    fed_tokens.emplace_back(token_data, token_data + num_fed);
+    fed_positions.emplace_back(pos_data, pos_data + kBatchSize);
+    fed_num_tokens.emplace_back(
+        num_tokens_data, num_tokens_data + kBatchSize);
+    if (fail) {
+      return Error::Internal;
+    }
+
+    logits_.assign(num_fed * kVocabSize, 0.0f);
+    for (int64_t i = 0; i < num_fed; ++i) {
+      logits_[i * kVocabSize + (token_data[i] + 1) % kVocabSize] = 1.0f;
+    }
+    logits_tensor_ = make_tensor_ptr(
+        {kBatchSize,
+         static_cast<executorch::aten::SizesType>(tokens->size(1)),
+         kVocabSize},
+        logits_.data());
+    return *logits_tensor_;
+  }
+
+  bool fail = false;
+  // The tokens of every step, flattened.
+  std::vector<std::vector<int64_t>> fed_tokens;
+  std::vector<std::vector<int64_t>> fed_positions;
+  std::vector<std::vector<int64_t>> fed_num_tokens;
+
+ private:
+  std::vector<float> logits_;
+  TensorPtr logits_tensor_;
+};
+
+class FakeTokenizer : public Tokenizer {
+ public:
+  Error load(const std::string&) override {
+    return Error::Ok;
+  }
+
+  Result<std::vector<uint64_t>> encode(const std::string&, int8_t, int8_t)
+      const override {
+    return std::vector<uint64_t>();
+  }
+
+  Result<std::string> decode(uint64_t, uint64_t token) const override {
+    if (token == failing_token) {
+      return Error::InvalidArgument;
+    }
+    return std::to_string(token) + " ";
+  }
+
+  // Never sampled by default.
+  uint64_t failing_token = kVocabSize;
+};
+
+} // namespace
+
+class BatchedTextTokenGeneratorTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    executorch::runtime::runtime_init();
+    make_generator(1);
+  }
+
+  void make_generator(int32_t prefill_chunk_size) {
+    generator_ = std::make_unique<BatchedTextTokenGenerator>(
+        &tokenizer_,
+        &runner_,
+        kBatchSize,
+        std::make_unique<std::unordered_set<uint64_t>>(
+            std::unordered_set<uint64_t>{kEosToken}),
+        &stats_,
+        prefill_chunk_size);
+  }
+
+  // Admits a sequence whose text and number of generated tokens go to
+  // texts_[id] and num_generated_[id].
+  Result<int32_t> add_sequence(
+      int32_t id,
+      std::vector<uint64_t> prompt_tokens,
+      int32_t seq_len) {
+    return generator_->add_sequence(
+        std::move(prompt_tokens),
+        seq_len,
+        [this, id](const std::string& piece) { texts_[id] += piece; },
+        [this, id](int64_t num_generated) {
+          num_generated_[id] = num_generated;
+        });
+  }
+
+  FakeTokenizer tokenizer_;
+  FakeTextDecoderRunner runner_;
+  Stats stats_;
+  std::unique_ptr<BatchedTextTokenGenerator> generator_;
+  std::string texts_[3];
+  int64_t num_generated_[3] = {-1, -1, -1};
+};
+
+TEST_F(BatchedTextTokenGeneratorTest, FeedsPromptThenGenerates) {
+  ASSERT_EQ(add_sequence(0, {1, 2, 3}, 6).get(), 0);
+  ASSERT_EQ(generator_->generate(), Error::Ok);
+
+  EXPECT_EQ(texts_[0], "4 5 6 ");
+  EXPECT_EQ(num_generated_[0], 3);
+  EXPECT_EQ(generator_->num_active(), 0);
+  // One prompt token per step, then the generated tokens. The free slot is
+  // fed no token.
+  EXPECT_EQ(
+      runner_.fed_tokens,
+      std::vector<std::vector<int64_t>>(
+          {{1, 0}, {2, 0}, {3, 0}, {4, 0}, {5, 0}}));
+  EXPECT_EQ(
+      runner_.fed_positions,
+      std::vector<std::vector<int64_t>>(
+          {{0, 0}, {1, 0}, {2, 0}, {3, 0}, {4, 0}}));
+  EXPECT_EQ(
+      runner_.fed_num_tokens,
+      std::vector<std::vector<int64_t>>(5, std::vector<int64_t>({1, 0})));
+}
+
+TEST_F(BatchedTextTokenGeneratorTest, PrefillsInChunks) {
+  make_generator(3);
+  ASSERT_EQ(add_sequence(0, {1, 2, 3, 4}, 8).get(), 0);
+  ASSERT_EQ(generator_->step(), Error::Ok);
+  EXPECT_EQ(texts_[0], "");
+
+  // Sequence 1 prefills three tokens next to the last prompt token of
+  // sequence 0, which samples from the logits of its only token.
+  ASSERT_EQ(add_sequence(1, {10, 11, 12, 13}, 8).get(), 1);
+  ASSERT_EQ(generator_->step(), Error::Ok);
+  EXPECT_EQ(texts_[0], "5 ");
+  EXPECT_EQ(texts_[1], "");
+  ASSERT_EQ(generator_->step(), Error::Ok);
+  EXPECT_EQ(texts_[0], "5 6 ");
+  EXPECT_EQ(texts_[1], "14 ");
+
+  EXPECT_EQ(
+      runner_.fed_tokens,
+      std::vector<std::vector<int64_t>>(
+          {{1, 2, 3, 0, 0, 0}, {4, 0, 0, 10, 11, 12}, {5, 13}}));
+  EXPECT_EQ(
+      runner_.fed_positions,
+      std::vector<std::vector<int64_t>>({{0, 0}, {3, 0}, {4, 3}}));
+  EXPECT_EQ(
+      runner_.fed_num_tokens,
+      std::vector<std::vector<int64_t>>({{3, 0}, {1, 3}, {1, 1}}));
+}
+
+TEST_F(BatchedTextTokenGeneratorTest, AdmitsSequencesBetweenSteps) {
+  ASSERT_EQ(add_sequence(0, {1}, 8).get(), 0);
+  ASSERT_EQ(generator_->step(), Error::Ok);
+  ASSERT_EQ(generator_->step(), Error::Ok);
+
+  // Sequence 1 stops at the EOS token, which frees its slot for sequence 2.
+  ASSERT_EQ(add_sequence(1, {12, 13}, 8).get(), 1);
+  EXPECT_EQ(add_sequence(2, {1}, 8).error(), Error::InvalidState);
+  ASSERT_EQ(generator_->step(), Error::Ok);
+  ASSERT_EQ(generator_->step(), Error::Ok);
+  ASSERT_EQ(generator_->step(), Error::Ok);
+  EXPECT_EQ(texts_[1], "14 15 ");
+  EXPECT_EQ(num_generated_[1], 2);
+  EXPECT_EQ(generator_->num_active(), 1);
+
+  ASSERT_EQ(add_sequence(2, {7}, 3).get(), 1);
+  ASSERT_EQ(generator_->generate(), Error::Ok);
+  EXPECT_EQ(texts_[0], "2 3 4 5 6 7 8 ");
+  EXPECT_EQ(num_generated_[0], 7);
+  EXPECT_EQ(texts_[2], "8 9 ");
+  EXPECT_EQ(num_generated_[2], 2);
+
+  // Each slot keeps its own positions.
+  EXPECT_EQ(runner_.fed_positions[2], std::vector<int64_t>({2, 0}));
+  EXPECT_EQ(runner_.fed_positions[4], std::vector<int64_t>({4, 2}));
+  EXPECT_EQ(runner_.fed_positions[5], std::vector<int64_t>({5, 0}));
+}
+
+TEST_F(BatchedTextTokenGeneratorTest, RejectsInvalidSequences) {
+  EXPECT_EQ(add_sequence(0, {}, 8).error(), Error::InvalidArgument);
+  EXPECT_EQ(add_sequence(0, {1, 2}, 2).error(), Error::InvalidArgument);
+  EXPECT_EQ(generator_->num_active(), 0);
+}
+
+TEST_F(BatchedTextTokenGeneratorTest, DecodeErrorLeavesSequencesUnchanged) {
+  ASSERT_EQ(add_sequence(0, {1}, 8).get(), 0);
+  ASSERT_EQ(add_sequence(1, {3}, 8).get(), 1);
+  ASSERT_EQ(generator_->step(), Error::Ok);
+  EXPECT_EQ(texts_[0], "2 ");
+  EXPECT_EQ(texts_[1], "4 ");
+
+  // Sequence 0 samples 3 before sequence 1 fails to decode 5.
+  tokenizer_.failing_token = 5;
+  EXPECT_EQ(generator_->step(), Error::InvalidArgument);
+  EXPECT_EQ(texts_[0], "2 ");
+  EXPECT_EQ(texts_[1], "4 ");
+
+  // Retrying feeds the same tokens at the same positions.
+  tokenizer_.failing_token = kVocabSize;
+  ASSERT_EQ(generator_->step(), Error::Ok);
+  EXPECT_EQ(runner_.fed_tokens[2], runner_.fed_tokens[1]);
+  EXPECT_EQ(runner_.fed_positions[2], runner_.fed_positions[1]);
+  EXPECT_EQ(texts_[0], "2 3 ");
+  EXPECT_EQ(texts_[1], "4 5 ");
+}
+
+TEST_F(BatchedTextTokenGeneratorTest, ModelErrorLeavesSequencesUnchanged) {
+  ASSERT_EQ(add_sequence(0, {1, 2}, 8).get(), 0);
+  ASSERT_EQ(add_sequence(1, {3}, 8).get(), 1);
+  ASSERT_EQ(generator_->step(), Error::Ok);
+
+  runner_.fail = true;
+  EXPECT_EQ(generator_->generate(), Error::Internal);
+  EXPECT_EQ(texts_[0], "");
+  EXPECT_EQ(texts_[1], "4 ");
+
+  runner_.fail = false;
+  ASSERT_EQ(generator_->step(), Error::Ok);
+  EXPECT_EQ(runner_.fed_tokens[2], runner_.fed_tokens[1]);
+  EXPECT_EQ(runner_.fed_positions[2], runner_.fed_positions[1]);
+  EXPECT_EQ(texts_[0], "3 ");
+  EXPECT_EQ(texts_[1], "4 5 ");
+}
@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/llm/runner/image_embedding_cache.h>
+
+#include <gtest/gtest.h>
+
+#include <executorch/runtime/platform/runtime.h>
+
+using namespace ::executorch::extension;
+using namespace ::executorch::extension::llm;
+
+class ImageEmbeddingCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    executorch::runtime::runtime_init();
+  }
+
+  // A 3x3 single channel image whose first pixel is `first_pixel`.
+  static Image make_image(uint8_t first_pixel) {
+    return {{first_pixel, 2, 3, 4, 5, 6, 7, 8, 9}, 3, 3, 1};
+  }
+
+  static TensorPtr make_embeddings(float value) {
+    return make_tensor_ptr({1, 2}, std::vector<float>{value, value + 1});
+  }
+
+  static float first_value(const TensorPtr& embeddings) {
+    return embeddings->const_data_ptr<float>()[0];
+  }
+};
+
+TEST_F(ImageEmbeddingCacheTest, HitsAndMisses) {
+  ImageEmbeddingCache cache(2);
+  const Image image = make_image(1);
+
+  EXPECT_EQ(cache.get(image), nullptr);
+  EXPECT_EQ(cache.num_misses(), 1);
+
+  cache.put(image, *make_embeddings(1.0f));
+  EXPECT_EQ(cache.size(), 1);
+  auto embeddings = cache.get(image);
+  ASSERT_NE(embeddings, nullptr);
+  EXPECT_EQ(embeddings->size(0), 1);
+  EXPECT_EQ(embeddings->size(1), 2);
+  EXPECT_EQ(first_value(embeddings), 1.0f);
+  EXPECT_EQ(cache.num_hits(), 1);
+
+  // An equal copy of the image hits too.
+  const Image copy = make_image(1);
+  EXPECT_NE(cache.get(copy), nullptr);
+  EXPECT_EQ(cache.num_hits(), 2);
+
+  // A change in a single pixel or in the shape misses.
+  Image changed_pixel = make_image(1);
+  changed_pixel.data.back() = 0;
+  EXPECT_EQ(cache.get(changed_pixel), nullptr);
+  Image changed_shape = make_image(1);
+  changed_shape.width = 9;
+  changed_shape.height = 1;
+  EXPECT_EQ(cache.get(changed_shape), nullptr);
+  EXPECT_EQ(cache.num_misses(), 3);
+}
+
+TEST_F(ImageEmbeddingCacheTest, CopiesEmbeddings) {
+  ImageEmbeddingCache cache(2);
+  const Image image = make_image(1);
+  auto encoder_output = make_embeddings(1.0f);
+  cache.put(image, *encoder_output);
+
+  // The next execution of the encoder overwrites its output.
+  encoder_output->mutable_data_ptr<float>()[0] = 100.0f;
+  EXPECT_EQ(first_value(cache.get(image)), 1.0f);
+}
+
+TEST_F(ImageEmbeddingCacheTest, EvictsLeastRecentlyUsed) {
+  ImageEmbeddingCache cache(2);
+  const Image a = make_image(1);
+  const Image b = make_image(2);
+  const Image c = make_image(3);
+  cache.put(a, *make_embeddings(1.0f));
+  cache.put(b, *make_embeddings(2.0f));
+
+  // Using `a` makes `b` the least recently used image.
+  EXPECT_NE(cache.get(a), nullptr);
+  cache.put(c, *make_embeddings(3.0f));
+  EXPECT_EQ(cache.size(), 2);
+  EXPECT_EQ(cache.get(b), nullptr);
+  EXPECT_EQ(first_value(cache.get(a)), 1.0f);
+  EXPECT_EQ(first_value(cache.get(c)), 3.0f);
+
+  // Now `a` is the least recently used one.
+  cache.put(b, *make_embeddings(2.0f));
+  EXPECT_EQ(cache.get(a), nullptr);
+  EXPECT_NE(cache.get(b), nullptr);
+  EXPECT_NE(cache.get(c), nullptr);
+}
+
+TEST_F(ImageEmbeddingCacheTest, PutReplacesEntry) {
+  ImageEmbeddingCache cache(2);
+  const Image a = make_image(1);
+  const Image b = make_image(2);
+  cache.put(a, *make_embeddings(1.0f));
+  cache.put(b, *make_embeddings(2.0f));
+
+  // Putting the same image again neither grows the cache nor evicts.
+  cache.put(a, *make_embeddings(10.0f));
+  EXPECT_EQ(cache.size(), 2);
+  EXPECT_EQ(first_value(cache.get(a)), 10.0f);
+  EXPECT_EQ(first_value(cache.get(b)), 2.0f);
+}
+
+TEST_F(ImageEmbeddingCacheTest, Clear) {
+  ImageEmbeddingCache cache(2);
+  const Image image = make_image(1);
+  cache.put(image, *make_embeddings(1.0f));
+  cache.clear();
+
+  EXPECT_EQ(cache.size(), 0);
+  EXPECT_EQ(cache.get(image), nullptr);
+  cache.put(image, *make_embeddings(2.0f));
+  EXPECT_EQ(first_value(cache.get(image)), 2.0f);
+}
+
+TEST_F(ImageEmbeddingCacheTest, HashDependsOnPixelsAndShape) {
+  const Image image = make_image(1);
+  EXPECT_EQ(
+      ImageEmbeddingCache::hash(image),
+      ImageEmbeddingCache::hash(make_image(1)));
+  EXPECT_NE(
+      ImageEmbeddingCache::hash(image),
+      ImageEmbeddingCache::hash(make_image(2)));
+  Image reshaped = image;
+  reshaped.channels = 3;
+  reshaped.height = 1;
+  EXPECT_NE(
+      ImageEmbeddingCache::hash(image), ImageEmbeddingCache::hash(reshaped));
+}
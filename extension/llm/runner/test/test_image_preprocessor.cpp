@@ -0,0 +1,293 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/llm/runner/image_preprocessor.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include <executorch/extension/tensor/tensor.h>
+#include <executorch/runtime/platform/runtime.h>
+
+using namespace ::executorch::extension;
+using namespace ::executorch::extension::llm;
+using ::executorch::runtime::Error;
+
+namespace {
+
+// The cubic convolution kernel with a = -0.75, as in PyTorch.
+double cubic(double x) {
+  constexpr double a = -0.75;
+  x = std::fabs(x);
+  if (x <= 1) {
+    return ((a + 2) * x - (a + 3)) * x * x + 1;
+  }
+  if (x < 2) {
+    return ((a * x - 5 * a) * x + 8 * a) * x - 4 * a;
+  }
+  return 0;
+}
+
+// The pixel at (y, x) of channel c, clamping the coordinates to the image.
+double pixel(const Image& image, bool channels_last, int c, int y, int x) {
+  y = std::min(std::max(y, 0), image.height - 1);
+  x = std::min(std::max(x, 0), image.width - 1);
+  return channels_last ? image.data[(y * image.width + x) * image.channels + c]
+                       : image.data[(c * image.height + y) * image.width + x];
+}
+
+// Resizes with F.interpolate(align_corners=False, antialias=False), pads,
+// normalizes and tile-crops one step at a time, in double.
+std::vector<float> reference_preprocess(
+    const Image& image,
+    const ImagePreprocessOptions& options) {
+  const int channels = image.channels;
+  const int canvas_height = options.canvas_height > 0 ? options.canvas_height
+                                                      : options.resize_height;
+  const int canvas_width =
+      options.canvas_width > 0 ? options.canvas_width : options.resize_width;
+  const bool hwc = options.channels_last;
+
+  std::vector<float> canvas(channels * canvas_height * canvas_width);
+  for (int c = 0; c < channels; ++c) {
+    for (int y = 0; y < canvas_height; ++y) {
+      for (int x = 0; x < canvas_width; ++x) {
+        double value = 0;
+        if (y < options.resize_height && x < options.resize_width) {
+          double src_y =
+              (y + 0.5) * image.height / options.resize_height - 0.5;
+          double src_x = (x + 0.5) * image.width / options.resize_width - 0.5;
+          if (options.filter == ResizeFilter::Bilinear) {
+            src_y = std::max(src_y, 0.0);
+            src_x = std::max(src_x, 0.0);
+            const int y0 = std::floor(src_y);
+            const int x0 = std::floor(src_x);
+            const double ty = src_y - y0;
+            const double tx = src_x - x0;
+            value = (1 - ty) *
+                    ((1 - tx) * pixel(image, hwc, c, y0, x0) +
+                     tx * pixel(image, hwc, c, y0, x0 + 1)) +
+                ty *
+                    ((1 - tx) * pixel(image, hwc, c, y0 + 1, x0) +
+                     tx * pixel(image, hwc, c, y0 + 1, x0 + 1));
+          } else {
+            const int y0 = std::floor(src_y);
+            const int x0 = std::floor(src_x);
+            for (int i = -1; i < 3; ++i) {
+              for (int j = -1; j < 3; ++j) {
+                value += cubic(src_y - (y0 + i)) * cubic(src_x - (x0 + j)) *
+                    pixel(image, hwc, c, y0 + i, x0 + j);
+              }
+            }
+          }
+          value *= options.rescale;
+        }
+        if (!options.mean.empty()) {
+          value = (value - options.mean[c]) / options.std[c];
+        }
+        canvas[(c * canvas_height + y) * canvas_width + x] = value;
+      }
+    }
+  }
+  if (options.tile_size == 0) {
+    return canvas;
+  }
+
+  // [num_tiles, channels, tile_size, tile_size], tiles in row major order.
+  const int tile = options.tile_size;
+  std::vector<float> tiles;
+  for (int tile_y = 0; tile_y < canvas_height / tile; ++tile_y) {
+    for (int tile_x = 0; tile_x < canvas_width / tile; ++tile_x) {
+      for (int c = 0; c < channels; ++c) {
+        for (int y = 0; y < tile; ++y) {
+          for (int x = 0; x < tile; ++x) {
+            tiles.push_back(
+                canvas
+                    [(c * canvas_height + tile_y * tile + y) * canvas_width +
+                     tile_x * tile + x]);
+          }
+        }
+      }
+    }
+  }
+  return tiles;
+}
+
+size_t numel(const std::vector<executorch::aten::SizesType>& sizes) {
+  size_t result = 1;
+  for (auto size : sizes) {
+    result *= size;
+  }
+  return result;
+}
+
+} // namespace
+
+class ImagePreprocessorTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    executorch::runtime::runtime_init();
+  }
+
+  static Image random_image(int32_t channels, int32_t height, int32_t width) {
+    std::mt19937 gen(0);
+    Image image{{}, width, height, channels};
+    image.data.resize(channels * height * width);
+    for (auto& value : image.data) {
+      value = gen() % 256;
+    }
+    return image;
+  }
+};
+
+TEST_F(ImagePreprocessorTest, MatchesReference) {
+  const Image image = random_image(3, 37, 53);
+  // Downscaling, the same size and upscaling.
+  const int32_t resize_heights[] = {20, 37, 70};
+  const int32_t resize_widths[] = {30, 53, 90};
+
+  for (auto filter : {ResizeFilter::Bilinear, ResizeFilter::Bicubic}) {
+    for (bool channels_last : {false, true}) {
+      for (bool tile : {false, true}) {
+        for (int size = 0; size < 3; ++size) {
+          SCOPED_TRACE(
+              ::testing::Message()
+              << "bicubic " << (filter == ResizeFilter::Bicubic)
+              << " channels_last " << channels_last << " tile " << tile
+              << " size " << size);
+          ImagePreprocessOptions options;
+          options.filter = filter;
+          options.channels_last = channels_last;
+          options.resize_height = resize_heights[size];
+          options.resize_width = resize_widths[size];
+          if (tile) {
+            // Pad to whole tiles, and one more column of tiles.
+            options.tile_size = 16;
+            options.canvas_height = (options.resize_height + 15) / 16 * 16;
+            options.canvas_width = (options.resize_width + 15) / 16 * 16 + 16;
+          }
+          if (size != 1) {
+            options.mean = {0.48f, 0.45f, 0.4f};
+            options.std = {0.26f, 0.26f, 0.27f};
+          }
+
+          const auto expected = reference_preprocess(image, options);
+          ASSERT_EQ(
+              numel(preprocessed_image_sizes(image, options)),
+              expected.size());
+          std::vector<float> out(expected.size(), 1e9f);
+          ASSERT_EQ(
+              preprocess_image(image, options, out.data(), out.size()),
+              Error::Ok);
+          for (size_t i = 0; i < out.size(); ++i) {
+            ASSERT_NEAR(out[i], expected[i], 1e-3f) << "at " << i;
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST_F(ImagePreprocessorTest, PadsWithNormalizedZeros) {
+  // A white 2x2 image on a 3x4 canvas.
+  const Image image{std::vector<uint8_t>(2 * 2 * 2, 255), 2, 2, 2};
+  ImagePreprocessOptions options;
+  options.resize_height = 2;
+  options.resize_width = 2;
+  options.canvas_height = 3;
+  options.canvas_width = 4;
+  options.mean = {0.5f, 0.25f};
+  options.std = {0.5f, 0.25f};
+
+  EXPECT_EQ(
+      preprocessed_image_sizes(image, options),
+      std::vector<executorch::aten::SizesType>({2, 3, 4}));
+  auto out = make_tensor_ptr({2, 3, 4}, std::vector<float>(24, 1e9f));
+  ASSERT_EQ(preprocess_image(image, options, *out), Error::Ok);
+
+  // (1 - mean) / std in the image, and (0 - mean) / std around it.
+  const std::vector<float> expected = {
+      1, 1, -1, -1, 1, 1, -1, -1, -1, -1, -1, -1,
+      3, 3, -1, -1, 3, 3, -1, -1, -1, -1, -1, -1};
+  const float* data = out->const_data_ptr<float>();
+  for (size_t i = 0; i < expected.size(); ++i) {
+    EXPECT_FLOAT_EQ(data[i], expected[i]) << "at " << i;
+  }
+}
+
+TEST_F(ImagePreprocessorTest, CutsTilesInRowMajorOrder) {
+  // A 4x4 image resized to its own size keeps its pixels.
+  Image image{std::vector<uint8_t>(16), 4, 4, 1};
+  for (int i = 0; i < 16; ++i) {
+    image.data[i] = i;
+  }
+  ImagePreprocessOptions options;
+  options.resize_height = 4;
+  options.resize_width = 4;
+  options.rescale = 1.0f;
+  options.tile_size = 2;
+
+  EXPECT_EQ(
+      preprocessed_image_sizes(image, options),
+      std::vector<executorch::aten::SizesType>({4, 1, 2, 2}));
+  std::vector<float> out(16);
+  ASSERT_EQ(
+      preprocess_image(image, options, out.data(), out.size()), Error::Ok);
+  EXPECT_EQ(
+      out,
+      std::vector<float>(
+          {0, 1, 4, 5, 2, 3, 6, 7, 8, 9, 12, 13, 10, 11, 14, 15}));
+}
+
+TEST_F(ImagePreprocessorTest, RejectsInvalidArguments) {
+  const Image image = random_image(3, 4, 4);
+  ImagePreprocessOptions options;
+  options.resize_height = 4;
+  options.resize_width = 4;
+  std::vector<float> out(3 * 4 * 4);
+  ASSERT_EQ(
+      preprocess_image(image, options, out.data(), out.size()), Error::Ok);
+
+  // The output must have exactly the right size.
+  EXPECT_EQ(
+      preprocess_image(image, options, out.data(), out.size() - 1),
+      Error::InvalidArgument);
+  auto int_out = make_tensor_ptr({3, 4, 4}, std::vector<int32_t>(48));
+  EXPECT_EQ(preprocess_image(image, options, *int_out), Error::InvalidArgument);
+
+  Image truncated = image;
+  truncated.data.pop_back();
+  EXPECT_EQ(
+      preprocess_image(truncated, options, out.data(), out.size()),
+      Error::InvalidArgument);
+  EXPECT_TRUE(preprocessed_image_sizes(truncated, options).empty());
+
+  const auto expect_invalid = [&](const ImagePreprocessOptions& invalid) {
+    EXPECT_EQ(
+        preprocess_image(image, invalid, out.data(), out.size()),
+        Error::InvalidArgument);
+  };
+  ImagePreprocessOptions small_canvas = options;
+  small_canvas.canvas_height = 2;
+  expect_invalid(small_canvas);
+  ImagePreprocessOptions uneven_tiles = options;
+  uneven_tiles.tile_size = 3;
+  expect_invalid(uneven_tiles);
+  ImagePreprocessOptions missing_std = options;
+  missing_std.mean = {0.5f, 0.5f, 0.5f};
+  expect_invalid(missing_std);
+  ImagePreprocessOptions zero_std = missing_std;
+  zero_std.std = {1.0f, 0.0f, 1.0f};
+  expect_invalid(zero_std);
+  ImagePreprocessOptions no_resize = options;
+  no_resize.resize_width = 0;
+  expect_invalid(no_resize);
+}
@@ -0,0 +1,222 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/llm/runner/kv_cache_snapshot.h>
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#include <gtest/gtest.h>
+
+#include <executorch/extension/data_loader/file_data_loader.h>
+#include <executorch/runtime/platform/runtime.h>
+
+using namespace ::executorch::extension;
+using namespace ::executorch::extension::llm;
+using ::executorch::runtime::Error;
+using ::executorch::runtime::Span;
+
+class KVCacheSnapshotTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    executorch::runtime::runtime_init();
+    // ModuleAddLarge has only float32 tensors, over many blocks.
+    module_ = std::make_unique<Module>(std::getenv("ET_MODULE_ADD_LARGE_PATH"));
+    path_ = ::testing::TempDir() + "kv_cache_snapshot_test.bin";
+
+    auto buffers = module_->memory_planned_buffers("forward");
+    ASSERT_EQ(buffers.error(), Error::Ok);
+    buffers_ = *buffers;
+    ASSERT_FALSE(buffers_.empty());
+    ASSERT_GT(buffers_[0].size(), 4 * kKVCacheSnapshotBlockBytes);
+  }
+
+  void TearDown() override {
+    std::remove(path_.c_str());
+  }
+
+  // Fills the buffers with a mix of zero blocks and float values, and
+  // returns a copy of their contents.
+  std::vector<std::vector<uint8_t>> fill_buffers() {
+    std::vector<std::vector<uint8_t>> contents;
+    for (const auto& buffer : buffers_) {
+      std::vector<float> values(buffer.size() / sizeof(float));
+      for (size_t i = 0; i < values.size(); ++i) {
+        // Every third block is zero, like the unused part of a KV cache.
+        const size_t block = i * sizeof(float) / kKVCacheSnapshotBlockBytes;
+        values[i] = block % 3 == 1 ? 0.0f : std::sin(0.01f * i) * 4.0f;
+      }
+      std::memcpy(buffer.data(), values.data(), values.size() * sizeof(float));
+      contents.emplace_back(buffer.begin(), buffer.end());
+    }
+    return contents;
+  }
+
+  void clobber_buffers() {
+    for (const auto& buffer : buffers_) {
+      std::memset(buffer.data(), 0x5a, buffer.size());
+    }
+  }
+
+  ::executorch::runtime::Result<KVCacheSnapshotInfo> load() {
+    auto loader = FileDataLoader::from(path_.c_str());
+    if (!loader.ok()) {
+      return loader.error();
+    }
+    return load_kv_cache_snapshot(module_.get(), "forward", &loader.get());
+  }
+
+  std::vector<char> read_file() {
+    std::ifstream file(path_, std::ios::binary);
+    return {std::istreambuf_iterator<char>(file), {}};
+  }
+
+  void write_file(const std::vector<char>& data) {
+    std::ofstream file(path_, std::ios::binary | std::ios::trunc);
+    file.write(data.data(), data.size());
+  }
+
+  std::unique_ptr<Module> module_;
+  std::vector<Span<uint8_t>> buffers_;
+  std::string path_;
+};
+
+TEST_F(KVCacheSnapshotTest, RoundTrip) {
+  const auto contents = fill_buffers();
+  KVCacheSnapshotInfo info;
+  info.pos = 3;
+  info.tokens = {1, 2, 3};
+  ASSERT_EQ(
+      save_kv_cache_snapshot(module_.get(), "forward", path_, info),
+      Error::Ok);
+
+  clobber_buffers();
+  const auto loaded = load();
+  ASSERT_EQ(loaded.error(), Error::Ok);
+  EXPECT_EQ(loaded->pos, 3);
+  EXPECT_EQ(loaded->tokens, info.tokens);
+  for (size_t i = 0; i < buffers_.size(); ++i) {
+    EXPECT_EQ(
+        std::memcmp(buffers_[i].data(), contents[i].data(), contents[i].size()),
+        0);
+  }
+}
+
+TEST_F(KVCacheSnapshotTest, ZeroBlocksAreSmall) {
+  for (const auto& buffer : buffers_) {
+    std::memset(buffer.data(), 0, buffer.size());
+  }
+  ASSERT_EQ(
+      save_kv_cache_snapshot(module_.get(), "forward", path_, {}), Error::Ok);
+  size_t total_size = 0;
+  for (const auto& buffer : buffers_) {
+    total_size += buffer.size();
+  }
+  EXPECT_LT(read_file().size(), total_size / 100);
+
+  clobber_buffers();
+  ASSERT_EQ(load().error(), Error::Ok);
+  for (const auto& buffer : buffers_) {
+    for (size_t i = 0; i < buffer.size(); ++i) {
+      ASSERT_EQ(buffer[i], 0);
+    }
+  }
+}
+
+TEST_F(KVCacheSnapshotTest, Int8RoundTrip) {
+  const auto contents = fill_buffers();
+  ASSERT_EQ(
+      save_kv_cache_snapshot(
+          module_.get(), "forward", path_, {}, /*compress_int8=*/true),
+      Error::Ok);
+
+  clobber_buffers();
+  ASSERT_EQ(load().error(), Error::Ok);
+  for (size_t i = 0; i < buffers_.size(); ++i) {
+    const float* expected = reinterpret_cast<const float*>(contents[i].data());
+    const float* actual = reinterpret_cast<const float*>(buffers_[i].data());
+    for (size_t j = 0; j < contents[i].size() / sizeof(float); ++j) {
+      // Zero blocks stay exact; the values are within 4, so int8 blocks are
+      // within half a step of 4 / 127.
+      if (expected[j] == 0.0f) {
+        EXPECT_EQ(actual[j], 0.0f);
+      } else {
+        EXPECT_NEAR(actual[j], expected[j], 4.0f / 127 / 2 + 1e-6f);
+      }
+    }
+  }
+}
+
+TEST_F(KVCacheSnapshotTest, Int8IsSmaller) {
+  fill_buffers();
+  ASSERT_EQ(
+      save_kv_cache_snapshot(module_.get(), "forward", path_, {}), Error::Ok);
+  const size_t raw_size = read_file().size();
+  ASSERT_EQ(
+      save_kv_cache_snapshot(
+          module_.get(), "forward", path_, {}, /*compress_int8=*/true),
+      Error::Ok);
+  EXPECT_LT(read_file().size(), raw_size / 2);
+}
+
+TEST_F(KVCacheSnapshotTest, Int8RequiresFloatState) {
+  // ModuleAddHalf has only float16 tensors.
+  Module module(std::getenv("ET_MODULE_ADD_HALF_PATH"));
+  EXPECT_EQ(
+      save_kv_cache_snapshot(
+          &module, "forward", path_, {}, /*compress_int8=*/true),
+      Error::NotSupported);
+  EXPECT_EQ(
+      save_kv_cache_snapshot(&module, "forward", path_, {}), Error::Ok);
+}
+
+TEST_F(KVCacheSnapshotTest, TruncatedLeavesStateUnchanged) {
+  fill_buffers();
+  ASSERT_EQ(
+      save_kv_cache_snapshot(module_.get(), "forward", path_, {}), Error::Ok);
+  auto data = read_file();
+  data.resize(data.size() - 1);
+  write_file(data);
+
+  clobber_buffers();
+  EXPECT_EQ(load().error(), Error::InvalidProgram);
+  // The snapshot is validated before anything is written.
+  for (const auto& buffer : buffers_) {
+    for (size_t i = 0; i < buffer.size(); ++i) {
+      ASSERT_EQ(buffer[i], 0x5a);
+    }
+  }
+
+  data.resize(8);
+  write_file(data);
+  EXPECT_EQ(load().error(), Error::InvalidProgram);
+}
+
+TEST_F(KVCacheSnapshotTest, RejectsOtherMethods) {
+  // ModuleAdd has much smaller buffers.
+  Module module(std::getenv("ET_MODULE_ADD_PATH"));
+  ASSERT_EQ(
+      save_kv_cache_snapshot(&module, "forward", path_, {}), Error::Ok);
+  EXPECT_EQ(load().error(), Error::InvalidArgument);
+
+  // A snapshot with a different number of buffers. The count is after the
+  // magic, the version and the block size.
+  ASSERT_EQ(
+      save_kv_cache_snapshot(module_.get(), "forward", path_, {}), Error::Ok);
+  auto data = read_file();
+  uint32_t num_buffers;
+  std::memcpy(&num_buffers, data.data() + 12, sizeof(num_buffers));
+  ASSERT_EQ(num_buffers, buffers_.size());
+  num_buffers++;
+  std::memcpy(data.data() + 12, &num_buffers, sizeof(num_buffers));
+  write_file(data);
+  EXPECT_EQ(load().error(), Error::InvalidArgument);
+}
@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/llm/runner/paged_kv_cache_allocator.h>
+
+#include <gtest/gtest.h>
+
+#include <executorch/runtime/platform/runtime.h>
+
+using namespace ::executorch::extension;
+using namespace ::executorch::extension::llm;
+using ::executorch::runtime::Error;
+
+// Fewer pages than both sequences could hold.
+constexpr int64_t kNumPages = 5;
+constexpr int64_t kPageSize = 4;
+constexpr int32_t kMaxSequences = 2;
+constexpr int64_t kMaxPagesPerSequence = 3;
+
+class PagedKVCacheAllocatorTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    executorch::runtime::runtime_init();
+    block_table_ = allocator_.block_table();
+  }
+
+  // The pages of `sequence` in the block table.
+  std::vector<int64_t> pages(int32_t sequence) {
+    const int64_t* row = block_table_->const_data_ptr<int64_t>() +
+        sequence * kMaxPagesPerSequence;
+    return {row, row + kMaxPagesPerSequence};
+  }
+
+  PagedKVCacheAllocator allocator_{
+      kNumPages,
+      kPageSize,
+      kMaxSequences,
+      kMaxPagesPerSequence};
+  TensorPtr block_table_;
+};
+
+TEST_F(PagedKVCacheAllocatorTest, BlockTable) {
+  EXPECT_EQ(block_table_->dim(), 2);
+  EXPECT_EQ(block_table_->size(0), kMaxSequences);
+  EXPECT_EQ(block_table_->size(1), kMaxPagesPerSequence);
+  EXPECT_EQ(block_table_->scalar_type(), executorch::aten::ScalarType::Long);
+  EXPECT_EQ(pages(0), std::vector<int64_t>({-1, -1, -1}));
+  EXPECT_EQ(pages(1), std::vector<int64_t>({-1, -1, -1}));
+  EXPECT_EQ(allocator_.num_free_pages(), kNumPages);
+  EXPECT_EQ(allocator_.page_size(), kPageSize);
+}
+
+TEST_F(PagedKVCacheAllocatorTest, ReservesPagesAsSequencesGrow) {
+  ASSERT_EQ(allocator_.reserve(0, 1), Error::Ok);
+  EXPECT_EQ(allocator_.capacity(0), kPageSize);
+  EXPECT_EQ(pages(0), std::vector<int64_t>({0, -1, -1}));
+
+  // Positions within the reserved pages need no new ones.
+  ASSERT_EQ(allocator_.reserve(0, kPageSize), Error::Ok);
+  EXPECT_EQ(allocator_.num_free_pages(), kNumPages - 1);
+
+  ASSERT_EQ(allocator_.reserve(1, 2 * kPageSize + 1), Error::Ok);
+  EXPECT_EQ(allocator_.capacity(1), 3 * kPageSize);
+  EXPECT_EQ(pages(1), std::vector<int64_t>({1, 2, 3}));
+
+  ASSERT_EQ(allocator_.reserve(0, kPageSize + 1), Error::Ok);
+  EXPECT_EQ(allocator_.capacity(0), 2 * kPageSize);
+  EXPECT_EQ(pages(0), std::vector<int64_t>({0, 4, -1}));
+  EXPECT_EQ(allocator_.num_free_pages(), 0);
+
+  // Reserving fewer positions than held keeps the pages.
+  ASSERT_EQ(allocator_.reserve(0, 1), Error::Ok);
+  EXPECT_EQ(pages(0), std::vector<int64_t>({0, 4, -1}));
+}
+
+TEST_F(PagedKVCacheAllocatorTest, ReleaseReturnsPages) {
+  ASSERT_EQ(allocator_.reserve(0, 2 * kPageSize), Error::Ok);
+  ASSERT_EQ(allocator_.reserve(1, kPageSize), Error::Ok);
+  EXPECT_EQ(pages(0), std::vector<int64_t>({0, 1, -1}));
+  EXPECT_EQ(pages(1), std::vector<int64_t>({2, -1, -1}));
+
+  allocator_.release(0);
+  EXPECT_EQ(allocator_.capacity(0), 0);
+  EXPECT_EQ(pages(0), std::vector<int64_t>({-1, -1, -1}));
+  EXPECT_EQ(pages(1), std::vector<int64_t>({2, -1, -1}));
+  EXPECT_EQ(allocator_.num_free_pages(), kNumPages - 1);
+
+  // The released pages are reused first, in their order in the sequence.
+  ASSERT_EQ(allocator_.reserve(1, 3 * kPageSize), Error::Ok);
+  EXPECT_EQ(pages(1), std::vector<int64_t>({2, 0, 1}));
+
+  // Releasing an empty sequence does nothing.
+  allocator_.release(0);
+  EXPECT_EQ(allocator_.num_free_pages(), kNumPages - 3);
+}
+
+TEST_F(PagedKVCacheAllocatorTest, ExhaustionAllocatesNothing) {
+  ASSERT_EQ(allocator_.reserve(0, 3 * kPageSize), Error::Ok);
+  ASSERT_EQ(allocator_.reserve(1, kPageSize), Error::Ok);
+  ASSERT_EQ(allocator_.num_free_pages(), 1);
+
+  // Sequence 1 needs 2 more pages, but only 1 is free.
+  EXPECT_EQ(
+      allocator_.reserve(1, 3 * kPageSize), Error::MemoryAllocationFailed);
+  EXPECT_EQ(allocator_.capacity(1), kPageSize);
+  EXPECT_EQ(pages(1), std::vector<int64_t>({3, -1, -1}));
+  EXPECT_EQ(allocator_.num_free_pages(), 1);
+
+  // It fits once sequence 0 is done.
+  allocator_.release(0);
+  ASSERT_EQ(allocator_.reserve(1, 3 * kPageSize), Error::Ok);
+  EXPECT_EQ(pages(1), std::vector<int64_t>({3, 0, 1}));
+}
+
+TEST_F(PagedKVCacheAllocatorTest, RejectsInvalidReservations) {
+  // More positions than the block table has pages for a sequence.
+  EXPECT_EQ(
+      allocator_.reserve(0, kMaxPagesPerSequence * kPageSize + 1),
+      Error::InvalidArgument);
+  EXPECT_EQ(allocator_.reserve(-1, 1), Error::InvalidArgument);
+  EXPECT_EQ(allocator_.reserve(kMaxSequences, 1), Error::InvalidArgument);
+  EXPECT_EQ(allocator_.num_free_pages(), kNumPages);
+  EXPECT_EQ(pages(0), std::vector<int64_t>({-1, -1, -1}));
+}
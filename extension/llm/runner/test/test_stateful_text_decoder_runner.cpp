@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/llm/runner/stateful_text_decoder_runner.h>
+
+#include <cstdlib>
+
+#include <gtest/gtest.h>
+
+#include <executorch/runtime/platform/runtime.h>
+
+using namespace ::executorch::extension;
+using namespace ::executorch::extension::llm;
+using ::executorch::runtime::Error;
+
+// ModuleStateful returns its state, the sum of the tokens so far, as the new
+// state and twice that as the logits of each of its 4 tokens.
+constexpr int32_t kVocabSize = 4;
+
+class StatefulTextDecoderRunnerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    executorch::runtime::runtime_init();
+    module_ = std::make_unique<Module>(std::getenv("ET_MODULE_STATEFUL_PATH"));
+    runner_ = std::make_unique<StatefulTextDecoderRunner>(
+        module_.get(), kVocabSize, /*temperature=*/0.0f);
+  }
+
+  // Runs one token at `pos` and returns the first logit.
+  float step(int64_t token, int64_t pos) {
+    auto tokens = make_tensor_ptr({1, 1}, std::vector<int64_t>{token});
+    auto start_pos = make_tensor_ptr({1}, std::vector<int64_t>{pos});
+    auto logits = runner_->step(tokens, start_pos);
+    EXPECT_EQ(logits.error(), Error::Ok);
+    if (!logits.ok()) {
+      return -1.0f;
+    }
+    EXPECT_EQ(logits->numel(), kVocabSize);
+    return logits->const_data_ptr<float>()[0];
+  }
+
+  std::unique_ptr<Module> module_;
+  std::unique_ptr<StatefulTextDecoderRunner> runner_;
+};
+
+TEST_F(StatefulTextDecoderRunnerTest, KeepsStateBetweenSteps) {
+  ASSERT_EQ(runner_->load(), Error::Ok);
+  EXPECT_TRUE(runner_->is_method_loaded());
+
+  EXPECT_EQ(step(3, 0), 6.0f);
+  EXPECT_EQ(step(2, 1), 10.0f);
+  EXPECT_EQ(step(1, 2), 12.0f);
+}
+
+TEST_F(StatefulTextDecoderRunnerTest, ResetsStateAtStart) {
+  ASSERT_EQ(runner_->load(), Error::Ok);
+
+  EXPECT_EQ(step(3, 0), 6.0f);
+  EXPECT_EQ(step(2, 1), 10.0f);
+  // Starting over at position 0 drops the state of the previous sequence.
+  EXPECT_EQ(step(1, 0), 2.0f);
+  EXPECT_EQ(step(1, 1), 4.0f);
+}
+
+TEST_F(StatefulTextDecoderRunnerTest, ResetState) {
+  ASSERT_EQ(runner_->load(), Error::Ok);
+
+  EXPECT_EQ(step(3, 0), 6.0f);
+  runner_->reset_state();
+  EXPECT_EQ(step(2, 1), 4.0f);
+}
+
+TEST_F(StatefulTextDecoderRunnerTest, LoadsOnFirstStep) {
+  // The state buffers are allocated on the first step without load().
+  EXPECT_EQ(step(3, 0), 6.0f);
+  EXPECT_EQ(step(2, 1), 10.0f);
+}
+
+TEST_F(StatefulTextDecoderRunnerTest, RejectsModelWithoutState) {
+  // ModuleLinear takes a single input, so it has no tokens and start_pos.
+  Module module(std::getenv("ET_MODULE_LINEAR_PATH"));
+  StatefulTextDecoderRunner runner(&module, kVocabSize, 0.0f);
+
+  EXPECT_EQ(runner.load(), Error::InvalidProgram);
+}
@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/llm/runner/stats.h>
+
+#include <gtest/gtest.h>
+
+#include <executorch/runtime/platform/runtime.h>
+
+using namespace ::executorch::extension::llm;
+
+class StatsTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    executorch::runtime::runtime_init();
+  }
+};
+
+TEST_F(StatsTest, RecordsPowerOfTwoBuckets) {
+  LatencyHistogram histogram;
+  for (int64_t latency_us : {0, 1, 2, 3, 4, 7, 8, 1000}) {
+    histogram.record(latency_us);
+  }
+  // Bucket i holds [2^(i - 1), 2^i).
+  EXPECT_EQ(histogram.buckets[0], 1);
+  EXPECT_EQ(histogram.buckets[1], 1);
+  EXPECT_EQ(histogram.buckets[2], 2);
+  EXPECT_EQ(histogram.buckets[3], 2);
+  EXPECT_EQ(histogram.buckets[4], 1);
+  EXPECT_EQ(histogram.buckets[10], 1);
+  EXPECT_EQ(histogram.count, 8);
+  EXPECT_EQ(histogram.total_us, 1025);
+  EXPECT_EQ(histogram.min_us, 0);
+  EXPECT_EQ(histogram.max_us, 1000);
+
+  // The last bucket holds everything from about 16.8 s up.
+  const size_t last = LatencyHistogram::kNumBuckets - 1;
+  histogram.record(int64_t{1} << (last - 1));
+  histogram.record(int64_t{1} << 40);
+  EXPECT_EQ(histogram.buckets[last - 1], 0);
+  EXPECT_EQ(histogram.buckets[last], 2);
+  EXPECT_EQ(histogram.max_us, int64_t{1} << 40);
+}
+
+TEST_F(StatsTest, PercentilesAreBucketUpperBounds) {
+  LatencyHistogram histogram;
+  EXPECT_EQ(histogram.percentile_us(0.5), 0);
+
+  for (int i = 0; i < 90; ++i) {
+    histogram.record(1000);
+  }
+  for (int i = 0; i < 10; ++i) {
+    histogram.record(100000);
+  }
+  // 1000 us is in [512, 1024).
+  EXPECT_EQ(histogram.percentile_us(0.0), 1023);
+  EXPECT_EQ(histogram.percentile_us(0.5), 1023);
+  EXPECT_EQ(histogram.percentile_us(0.9), 1023);
+  // 100000 us is in [65536, 131072), but no latency exceeds the maximum.
+  EXPECT_EQ(histogram.percentile_us(0.91), 100000);
+  EXPECT_EQ(histogram.percentile_us(0.99), 100000);
+  EXPECT_EQ(histogram.percentile_us(1.0), 100000);
+
+  histogram.record(int64_t{1} << 40);
+  EXPECT_EQ(histogram.percentile_us(1.0), int64_t{1} << 40);
+}
+
+TEST_F(StatsTest, Reset) {
+  LatencyHistogram histogram;
+  histogram.record(5);
+  histogram.record(500);
+  histogram.reset();
+
+  EXPECT_EQ(histogram.count, 0);
+  EXPECT_EQ(histogram.total_us, 0);
+  EXPECT_EQ(histogram.min_us, 0);
+  EXPECT_EQ(histogram.max_us, 0);
+  for (size_t bucket = 0; bucket < LatencyHistogram::kNumBuckets; ++bucket) {
+    EXPECT_EQ(histogram.buckets[bucket], 0);
+  }
+  histogram.record(5);
+  EXPECT_EQ(histogram.min_us, 5);
+}
+
+TEST_F(StatsTest, HooksRecordLatencies) {
+  Stats stats;
+  stats.reset(true);
+  for (int i = 0; i < 3; ++i) {
+    stats.on_decode_step_begin();
+    stats.on_decode_step_end();
+    stats.on_sampling_begin();
+    stats.on_sampling_end();
+  }
+  stats.on_callback_begin();
+  stats.on_callback_end();
+
+  EXPECT_EQ(stats.decode_step_latency.count, 3);
+  EXPECT_EQ(stats.sampling_latency.count, 3);
+  EXPECT_EQ(stats.callback_latency.count, 1);
+  EXPECT_EQ(stats.prefill_chunk_latency.count, 0);
+  EXPECT_EQ(stats.detokenize_latency.count, 0);
+  EXPECT_NE(
+      stats_to_json_string(stats).find("\"decode_step_latency\":{\"count\":3,"),
+      std::string::npos);
+
+  stats.reset();
+  EXPECT_EQ(stats.decode_step_latency.count, 0);
+  EXPECT_EQ(stats.sampling_latency.count, 0);
+  EXPECT_EQ(stats.callback_latency.count, 0);
+}
+
+TEST_F(StatsTest, HistogramToJson) {
+  LatencyHistogram histogram;
+  histogram.record(3);
+  EXPECT_EQ(
+      latency_histogram_to_json_string(histogram),
+      "{\"count\":1,\"total_us\":3,\"min_us\":3,\"max_us\":3,\"p50_us\":3,"
+      "\"p90_us\":3,\"p99_us\":3,\"buckets\":[0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,"
+      "0,0,0,0,0,0,0,0,0,0,0]}");
+}
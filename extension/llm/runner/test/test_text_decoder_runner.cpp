@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/llm/runner/text_decoder_runner.h>
+
+#include <gtest/gtest.h>
+
+#include <executorch/runtime/platform/runtime.h>
+
+using namespace ::executorch::extension;
+using namespace ::executorch::extension::llm;
+using executorch::aten::ScalarType;
+
+constexpr int32_t kVocabSize = 8;
+
+class TextDecoderRunnerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    executorch::runtime::runtime_init();
+  }
+
+  // Logits whose row `i` peaks at token `tokens[i]`.
+  static std::vector<float> one_hot_logits(
+      const std::vector<int32_t>& tokens) {
+    std::vector<float> logits(tokens.size() * kVocabSize, 0.0f);
+    for (size_t i = 0; i < tokens.size(); ++i) {
+      logits[i * kVocabSize + tokens[i]] = 1.0f;
+    }
+    return logits;
+  }
+
+  // Greedy sampling, so the sampled token is the one with the largest logit.
+  TextDecoderRunner runner_{nullptr, true, kVocabSize, 0.0f};
+};
+
+TEST_F(TextDecoderRunnerTest, LogitsToTokenSamplesLastTokenOfSequence) {
+  // Logits of a batch of 2 sequences of 3 tokens.
+  auto logits = make_tensor_ptr(
+      {2, 3, kVocabSize}, one_hot_logits({1, 2, 3, 4, 5, 6}));
+
+  EXPECT_EQ(runner_.logits_to_token(*logits), 3);
+  EXPECT_EQ(runner_.logits_to_token(*logits, 0), 3);
+  EXPECT_EQ(runner_.logits_to_token(*logits, 1), 6);
+}
+
+TEST_F(TextDecoderRunnerTest, LogitsToTokenWithLastLogitsOnly) {
+  auto logits = make_tensor_ptr({2, kVocabSize}, one_hot_logits({7, 2}));
+
+  EXPECT_EQ(runner_.logits_to_token(*logits), 7);
+  EXPECT_EQ(runner_.logits_to_token(*logits, 1), 2);
+}
+
+TEST_F(TextDecoderRunnerTest, LogitsToTokenAtSamplesEveryToken) {
+  auto logits =
+      make_tensor_ptr({1, 4, kVocabSize}, one_hot_logits({4, 0, 6, 1}));
+
+  EXPECT_EQ(runner_.logits_to_token_at(*logits, 0), 4);
+  EXPECT_EQ(runner_.logits_to_token_at(*logits, 1), 0);
+  EXPECT_EQ(runner_.logits_to_token_at(*logits, 2), 6);
+  EXPECT_EQ(runner_.logits_to_token_at(*logits, 3), 1);
+  // The last token is the one logits_to_token samples.
+  EXPECT_EQ(runner_.logits_to_token(*logits), 1);
+}
+
+TEST_F(TextDecoderRunnerTest, LogitsToTokenWithHalfLogits) {
+  const auto float_logits = one_hot_logits({3, 5});
+  std::vector<executorch::aten::Half> half_logits(
+      float_logits.begin(), float_logits.end());
+  auto logits = make_tensor_ptr({1, 2, kVocabSize}, std::move(half_logits));
+  ASSERT_EQ(logits->scalar_type(), ScalarType::Half);
+
+  EXPECT_EQ(runner_.logits_to_token(*logits), 5);
+  EXPECT_EQ(runner_.logits_to_token_at(*logits, 0), 3);
+}
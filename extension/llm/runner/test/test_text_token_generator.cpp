@@ -0,0 +1,249 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/llm/runner/text_token_generator.h>
+
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include <executorch/runtime/platform/runtime.h>
+
+using namespace ::executorch::extension;
+using namespace ::executorch::extension::llm;
+using ::executorch::runtime::Error;
+using ::executorch::runtime::Result;
+
+namespace {
+
+constexpr int32_t kVocabSize = 16;
+// Never part of the text, so the fake model samples it after a wrong token.
+constexpr uint64_t kWrongToken = 15;
+
+// A text that repeats spans of its prompt, with changes.
+const std::vector<uint64_t> kPrompt = {1, 2, 3, 4, 5, 6, 7, 8, 1, 2, 3, 4, 5};
+const std::vector<uint64_t> kContinuation = {
+    9,  10, 1,  2,  3,  4,  5,  6,  7,  8,  11, 12, 13, 1,  2,  3,  4, 5,
+    6,  7,  8,  9,  10, 11, 12, 13, 14, 3,  4,  5,  6,  7,  8,  9,  10, 11,
+    12, 13, 14, 1,  2,  3,  4,  5,  6,  7,  8,  9,  10, 11, 12, 13, 14};
+
+// A model with a KV cache and full logits that continues a fixed text: the
+// token after position p is text[p + 1], as long as the tokens up to p are
+// those of the text.
+class FakeTextDecoderRunner : public TextDecoderRunner {
+ public:
+  explicit FakeTextDecoderRunner(std::vector<uint64_t> text)
+      : TextDecoderRunner(nullptr, true, kVocabSize, 0.0f),
+        text_(std::move(text)) {}
+
+  Result<executorch::aten::Tensor> step(
+      TensorPtr& tokens,
+      TensorPtr& start_pos) override {
+    const int64_t pos = start_pos->const_data_ptr<int64_t>()[0];
+    const int64_t num_tokens = tokens->size(1);
+    start_positions.push_back(pos);
+    num_fed_tokens.push_back(num_tokens);
+    max_position = std::max(max_position, pos + num_tokens - 1);
+
+    // Rejected tokens stay in the cache until they are overwritten.
+    if (cache_.size() < static_cast<size_t>(pos + num_tokens)) {
+      cache_.resize(pos + num_tokens);
+    }
+    for (int64_t i = 0; i < num_tokens; ++i) {
+      cache_[pos + i] = tokens->const_data_ptr<int64_t>()[i];
+    }
+    bool matches = std::equal(
+        cache_.begin(), cache_.begin() + pos, text_.begin());
+    logits_.assign(num_tokens * kVocabSize, 0.0f);
+    for (int64_t i = 0; i < num_tokens; ++i) {
+      matches = matches && cache_[pos + i] == text_[pos + i];
+      const uint64_t next = matches ? text_[pos + i + 1] : kWrongToken;
+      logits_[i * kVocabSize + next] = 1.0f;
+    }
+    logits_tensor_ = make_tensor_ptr(
+        {1, static_cast<executorch::aten::SizesType>(num_tokens), kVocabSize},
+        logits_.data());
+    return *logits_tensor_;
+  }
+
+  // As if the prompt had been prefilled.
+  void prefill(const std::vector<uint64_t>& prompt) {
+    cache_ = prompt;
+  }
+
+  std::vector<int64_t> start_positions;
+  std::vector<int64_t> num_fed_tokens;
+  int64_t max_position = -1;
+
+ private:
+  std::vector<uint64_t> text_;
+  std::vector<uint64_t> cache_;
+  std::vector<float> logits_;
+  TensorPtr logits_tensor_;
+};
+
+class FakeTokenizer : public Tokenizer {
+ public:
+  Error load(const std::string&) override {
+    return Error::Ok;
+  }
+
+  Result<std::vector<uint64_t>> encode(const std::string&, int8_t, int8_t)
+      const override {
+    return std::vector<uint64_t>();
+  }
+
+  Result<std::string> decode(uint64_t, uint64_t token) const override {
+    return std::to_string(token) + " ";
+  }
+};
+
+} // namespace
+
+class TextTokenGeneratorTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    executorch::runtime::runtime_init();
+    text_ = kPrompt;
+    text_.insert(text_.end(), kContinuation.begin(), kContinuation.end());
+  }
+
+  // Generates up to `seq_len` positions after prefilling the prompt, and
+  // returns the generated tokens.
+  std::vector<uint64_t> generate(
+      FakeTextDecoderRunner& runner,
+      int32_t num_draft_tokens,
+      int32_t seq_len,
+      std::unordered_set<uint64_t> eos_ids = {0}) {
+    FakeTokenizer tokenizer;
+    Stats stats;
+    TextTokenGenerator generator(
+        &tokenizer,
+        &runner,
+        /*use_kv_cache=*/true,
+        std::make_unique<std::unordered_set<uint64_t>>(std::move(eos_ids)),
+        &stats);
+    generator.set_prompt_lookup(num_draft_tokens);
+
+    runner.prefill(kPrompt);
+    // The prompt and the token sampled by the prefill.
+    std::vector<uint64_t> tokens = kPrompt;
+    tokens.push_back(text_[kPrompt.size()]);
+    std::vector<uint64_t> generated;
+    std::string text;
+    auto num_generated = generator.generate(
+        tokens,
+        kPrompt.size(),
+        seq_len,
+        [&](const std::string& piece) { text += piece; },
+        &generated);
+    EXPECT_EQ(num_generated.error(), Error::Ok);
+    if (num_generated.ok()) {
+      EXPECT_EQ(num_generated.get(), generated.size());
+    }
+    return generated;
+  }
+
+  // The text after the prompt and the token sampled by the prefill.
+  std::vector<uint64_t> expected(size_t size) {
+    const auto begin = text_.begin() + kPrompt.size() + 1;
+    return {begin, begin + size};
+  }
+
+  std::vector<uint64_t> text_;
+};
+
+TEST_F(TextTokenGeneratorTest, GeneratesOneTokenPerStep) {
+  FakeTextDecoderRunner runner(text_);
+  const int32_t seq_len = text_.size();
+  const auto generated = generate(runner, 0, seq_len);
+
+  EXPECT_EQ(generated, expected(seq_len - kPrompt.size() - 1));
+  EXPECT_EQ(runner.num_fed_tokens.size(), generated.size());
+  for (size_t i = 0; i < runner.start_positions.size(); ++i) {
+    EXPECT_EQ(runner.start_positions[i], kPrompt.size() + i);
+    EXPECT_EQ(runner.num_fed_tokens[i], 1);
+  }
+}
+
+TEST_F(TextTokenGeneratorTest, PromptLookupMatchesGreedyDecoding) {
+  const int32_t seq_len = text_.size();
+  FakeTextDecoderRunner greedy_runner(text_);
+  const auto greedy = generate(greedy_runner, 0, seq_len);
+
+  for (int32_t num_draft_tokens : {1, 4, 8}) {
+    FakeTextDecoderRunner runner(text_);
+    EXPECT_EQ(generate(runner, num_draft_tokens, seq_len), greedy);
+    EXPECT_LT(runner.num_fed_tokens.size(), greedy.size());
+  }
+}
+
+TEST_F(TextTokenGeneratorTest, PromptLookupAcceptsAndRejects) {
+  FakeTextDecoderRunner runner(text_);
+  const int32_t seq_len = text_.size();
+  const auto generated = generate(runner, 4, seq_len);
+  EXPECT_EQ(generated, expected(seq_len - kPrompt.size() - 1));
+
+  // Each step continues after the proposed tokens it accepted, so the next
+  // one overwrites the rejected tokens.
+  bool accepted_all = false;
+  bool rejected = false;
+  for (size_t i = 0; i + 1 < runner.start_positions.size(); ++i) {
+    const int64_t num_generated =
+        runner.start_positions[i + 1] - runner.start_positions[i];
+    EXPECT_GE(num_generated, 1);
+    EXPECT_LE(num_generated, runner.num_fed_tokens[i]);
+    if (runner.num_fed_tokens[i] > 1) {
+      accepted_all |= num_generated == runner.num_fed_tokens[i];
+      rejected |= num_generated < runner.num_fed_tokens[i];
+    }
+  }
+  EXPECT_TRUE(accepted_all);
+  EXPECT_TRUE(rejected);
+}
+
+TEST_F(TextTokenGeneratorTest, PromptLookupStaysWithinSeqLen) {
+  // A text that the lookup always proposes more tokens of than fit.
+  const std::vector<uint64_t> repeated(64, 1);
+  for (int32_t seq_len = kPrompt.size() + 2; seq_len < 40; ++seq_len) {
+    FakeTextDecoderRunner runner(repeated);
+    FakeTokenizer tokenizer;
+    Stats stats;
+    TextTokenGenerator generator(
+        &tokenizer,
+        &runner,
+        /*use_kv_cache=*/true,
+        std::make_unique<std::unordered_set<uint64_t>>(
+            std::unordered_set<uint64_t>{0}),
+        &stats);
+    generator.set_prompt_lookup(8);
+    runner.prefill(std::vector<uint64_t>(kPrompt.size(), 1));
+
+    std::vector<uint64_t> tokens(kPrompt.size() + 1, 1);
+    auto num_generated = generator.generate(
+        tokens, kPrompt.size(), seq_len, [](const std::string&) {});
+    ASSERT_EQ(num_generated.error(), Error::Ok);
+    // Generation fills the sequence, without feeding past its end.
+    EXPECT_EQ(num_generated.get(), seq_len - 1 - kPrompt.size());
+    EXPECT_EQ(runner.max_position, seq_len - 2);
+  }
+}
+
+TEST_F(TextTokenGeneratorTest, PromptLookupStopsAtEos) {
+  // 11 is first generated in the middle of a span the lookup proposes.
+  const int32_t seq_len = text_.size();
+  FakeTextDecoderRunner greedy_runner(text_);
+  const auto greedy = generate(greedy_runner, 0, seq_len, {11});
+  ASSERT_EQ(greedy.back(), 11);
+  ASSERT_LT(greedy.size(), seq_len - kPrompt.size() - 1);
+
+  for (int32_t num_draft_tokens : {1, 4, 8}) {
+    FakeTextDecoderRunner runner(text_);
+    EXPECT_EQ(generate(runner, num_draft_tokens, seq_len, {11}), greedy);
+  }
+}
@@ -70,6 +70,28 @@ TextDecoderRunner::TextDecoderRunner(
   }
 }
 
+::executorch::runtime::Result<exec_aten::Tensor>
+TextDecoderRunner::batched_step(
+    TensorPtr& tokens,
+    TensorPtr& start_pos,
+    TensorPtr& num_tokens) {
+  ET_CHECK_OR_RETURN_ERROR(
+      use_kv_cache_,
+      NotSupported,
+      "Batched decoding needs a KV cache with one batch row per sequence");
+  auto outputs_res = module_->forward({tokens, start_pos, num_tokens});
+  ET_CHECK_OK_OR_RETURN_ERROR(outputs_res.error());
+  ET_CHECK_MSG(
+      outputs_res.get().size() == 1,
+      "More then one output returned from executing LLM.");
+  ET_CHECK_MSG(
+      outputs_res.get()[0].isTensor(),
+      "Non Tensor Output returned from executing LLM");
+
+  // Return the logits tensor
+  return outputs_res.get()[0].toTensor();
+}
+
 } // namespace llm
 } // namespace extension
 } // namespace executorch
@@ -41,6 +41,19 @@ class ET_EXPERIMENTAL TextDecoderRunner {
       TensorPtr& input,
       TensorPtr& start_pos);
 
+  /**
+   * Run LLM text decoder on a batch of sequences, each at its own position in
+   * its batch row of the KV cache.
+   * @param tokens The tokens of every sequence, of shape [batch, seq_length].
+   * @param start_pos The starting position in KV cache of the tokens of each
+   * sequence, of shape [batch].
+   * @param num_tokens The number of valid tokens of each sequence, of shape
+   * [batch]. The tokens past it are padding.
+   * @return The output of the LLM Module. This will be a tensor of logits.
+   */
+  virtual ::executorch::runtime::Result<executorch::aten::Tensor>
+  batched_step(TensorPtr& tokens, TensorPtr& start_pos, TensorPtr& num_tokens);
+
   /**
    * Load the Module for text decode purpose.
    * @return The error code.
@@ -68,6 +81,76 @@ class ET_EXPERIMENTAL TextDecoderRunner {
    */
   inline int32_t logits_to_token(
       const executorch::aten::Tensor& logits_tensor) {
+    return logits_to_token(logits_tensor, 0);
+  }
+
+  /**
+   * Sample the next token of one sequence of a batch from the logits tensor.
+   * @param logits_tensor The logits tensor, of shape [batch, vocab_size] or
+   * [batch, seq_length, vocab_size].
+   * @param batch_index The sequence to sample for.
+   * @return The next token.
+   */
+  inline int32_t logits_to_token(
+      const executorch::aten::Tensor& logits_tensor,
+      int64_t batch_index) {
+    // If the logit_tensor rank is 3, the shape is [batch, seq_length,
+    // vocab_size], sample from the last logits of the sequence. Else the
+    // model outputs the last logits directly.
+    return logits_to_token(
+        logits_tensor,
+        batch_index,
+        logits_tensor.dim() == 3 ? logits_tensor.size(1) - 1 : 0);
+  }
+
+  /**
+   * Sample the next token of one sequence of a batch from the logits of one
+   * of its tokens.
+   * @param logits_tensor The logits tensor, of shape [batch, vocab_size],
+   * holding the logits of the last valid token of each sequence, or
+   * [batch, seq_length, vocab_size].
+   * @param batch_index The sequence to sample for.
+   * @param token_index The token of the sequence whose logits to sample
+   * from. Ignored for logits of rank 2.
+   * @return The next token.
+   */
+  inline int32_t logits_to_token(
+      const executorch::aten::Tensor& logits_tensor,
+      int64_t batch_index,
+      int64_t token_index) {
+    if (logits_tensor.dim() == 3) {
+      return sample_row(
+          logits_tensor, batch_index * logits_tensor.size(1) + token_index);
+    }
+    return sample_row(logits_tensor, batch_index);
+  }
+
+  /**
+   * Sample the token that follows one of several input tokens, from the
+   * logits of every input token.
+   * @param logits_tensor The logits tensor, of shape [1, seq_length,
+   * vocab_size], as returned by models exported with full logits.
+   * @param token_index The input token whose next token to sample.
+   * @return The next token.
+   */
+  inline int32_t logits_to_token_at(
+      const executorch::aten::Tensor& logits_tensor,
+      int64_t token_index) {
+    return sample_row(logits_tensor, token_index);
+  }
+
+ protected:
+  // TODO: use shared_ptr for module
+  Module* module_;
+  std::unique_ptr<Sampler> sampler_;
+  bool use_kv_cache_;
+  bool should_stop_{false};
+
+ private:
+  // Samples from row `row` of the logits, viewed as [rows, vocab_size].
+  inline int32_t sample_row(
+      const executorch::aten::Tensor& logits_tensor,
+      int64_t row) {
     int32_t result = 0;
     ET_SWITCH_THREE_TYPES(
         Float,
@@ -78,29 +161,12 @@ class ET_EXPERIMENTAL TextDecoderRunner {
         "logits_to_token",
         CTYPE,
         [&]() {
-          // If the logit_tensor rank is 3, the shape is [batch, seq_length,
-          // vocab_size], get the last logits, sample and return. Else the model
-          // outputs the last logit, directly sample and return.
           auto* logits = logits_tensor.mutable_data_ptr<CTYPE>();
-          if (logits_tensor.dim() == 3) {
-            auto num_tokens = logits_tensor.size(1);
-            auto vocab_size = logits_tensor.size(2);
-            auto* logits_last = logits;
-            logits_last += (num_tokens - 1) * vocab_size;
-            result = sampler_->sample(logits_last);
-          } else {
-            result = sampler_->sample(logits);
-          }
+          auto vocab_size = logits_tensor.size(logits_tensor.dim() - 1);
+          result = sampler_->sample(logits + row * vocab_size);
         });
     return result;
   }
-
- protected:
-  // TODO: use shared_ptr for module
-  Module* module_;
-  std::unique_ptr<Sampler> sampler_;
-  bool use_kv_cache_;
-  bool should_stop_{false};
 };
 
 } // namespace llm
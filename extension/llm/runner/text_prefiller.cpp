@@ -18,10 +18,25 @@ namespace llm {
 TextPrefiller::TextPrefiller(
     TextDecoderRunner* text_decoder_runner,
     bool use_kv_cache,
-    bool enable_parallel_prefill)
+    bool enable_parallel_prefill,
+    Stats* stats)
     : text_decoder_runner_(text_decoder_runner),
       use_kv_cache_(use_kv_cache),
-      enable_parallel_prefill_(enable_parallel_prefill) {}
+      enable_parallel_prefill_(enable_parallel_prefill),
+      stats_(stats) {}
+
+::executorch::runtime::Result<executorch::aten::Tensor> TextPrefiller::step(
+    TensorPtr& tokens,
+    TensorPtr& start_pos) {
+  if (stats_ != nullptr) {
+    stats_->on_prefill_chunk_begin();
+  }
+  auto outputs_res = text_decoder_runner_->step(tokens, start_pos);
+  if (stats_ != nullptr) {
+    stats_->on_prefill_chunk_end();
+  }
+  return outputs_res;
+}
 
 ::executorch::runtime::Result<uint64_t> TextPrefiller::prefill(
     std::vector<uint64_t>& prompt_tokens,
@@ -46,7 +61,7 @@ TextPrefiller::TextPrefiller(
     auto start_pos_tensor =
         from_blob(&start_pos, {1}, exec_aten::ScalarType::Long);
 
-    auto outputs_res = text_decoder_runner_->step(tokens, start_pos_tensor);
+    auto outputs_res = step(tokens, start_pos_tensor);
 
     ET_CHECK_OK_OR_RETURN_ERROR(outputs_res.error());
     ET_LOG(
@@ -67,8 +82,7 @@ TextPrefiller::TextPrefiller(
 
     // run the first token and get back logits tensor. Assuming the first token
     // is bos so don't callback.
-    auto logits_tensor =
-        ET_UNWRAP(text_decoder_runner_->step(tokens, start_pos_tensor));
+    auto logits_tensor = ET_UNWRAP(step(tokens, start_pos_tensor));
 
     pos += 1; // start the loop from index 1
     start_pos += 1;
@@ -78,8 +92,7 @@ TextPrefiller::TextPrefiller(
       // NOLINTNEXTLINE(facebook-hte-ParameterUncheckedArrayBounds)
       cur_token = prompt_tokens[pos];
 
-      logits_tensor =
-          ET_UNWRAP(text_decoder_runner_->step(tokens, start_pos_tensor));
+      logits_tensor = ET_UNWRAP(step(tokens, start_pos_tensor));
 
       pos++;
       start_pos++;
@@ -14,6 +14,9 @@
 #include <executorch/extension/llm/tokenizer/tokenizer.h>
 #include <executorch/extension/tensor/tensor.h>
 
+#include <algorithm>
+#include <cinttypes>
+
 namespace executorch {
 namespace extension {
 namespace llm {
@@ -32,6 +35,35 @@ class ET_EXPERIMENTAL TextTokenGenerator {
         use_kv_cache_(use_kv_cache),
         stats_(stats) {}
 
+  /**
+   * Enable prompt lookup decoding, which speeds up generating text that
+   * copies spans of the prompt or of earlier output. Each step looks up the
+   * latest earlier occurrence of the last tokens in the prompt and the
+   * generated tokens, and feeds the tokens that followed it to the model
+   * along with the current token. The model then checks all of them in one
+   * call, and every proposed token that matches what it samples is
+   * accepted, so a step can generate several tokens.
+   *
+   * The sampled tokens are the same as without lookup, only the number of
+   * model calls changes. It requires a model with a KV cache that is
+   * indexed by position, exported with dynamic shapes and full logits, since
+   * the rejected tokens stay in the cache until they are overwritten.
+   * @param num_draft_tokens the maximum number of proposed tokens per step,
+   * 0 to disable.
+   * @param max_ngram_size the longest run of last tokens to look up. Shorter
+   * runs are tried if it does not occur earlier.
+   */
+  inline void set_prompt_lookup(
+      int32_t num_draft_tokens,
+      int32_t max_ngram_size = 3) {
+    ET_CHECK_MSG(
+        num_draft_tokens == 0 || (use_kv_cache_ && max_ngram_size > 0),
+        "Prompt lookup decoding requires a KV cache and a positive n-gram "
+        "size");
+    num_draft_tokens_ = num_draft_tokens;
+    max_ngram_size_ = max_ngram_size;
+  }
+
   /**
    * Token generation loop.
    * @param tokens prompt tokens as well as the first token generated by
@@ -41,13 +73,16 @@ class ET_EXPERIMENTAL TextTokenGenerator {
    * @param seq_len the total sequence length, including the prompt tokens, next
    * token from prefill and new tokens.
    * @param token_callback what to do after a token is generated.
+   * @param generated_tokens if not null, every generated token is appended
+   * to it.
    * @return how many tokens are generated.
    */
   inline ::executorch::runtime::Result<int64_t> generate(
       std::vector<uint64_t> tokens,
       int64_t start_pos,
       int32_t seq_len,
-      std::function<void(const std::string&)> token_callback) {
+      std::function<void(const std::string&)> token_callback,
+      std::vector<uint64_t>* generated_tokens = nullptr) {
     ET_CHECK_MSG(
         !tokens.empty(), "Token generation loop shouldn't take empty tokens");
     int64_t pos = start_pos; // position in the sequence
@@ -59,11 +94,21 @@ class ET_EXPERIMENTAL TextTokenGenerator {
     uint64_t cur_token = tokens.back();
     uint64_t prev_token;
 
+    const bool use_prompt_lookup = num_draft_tokens_ > 0;
+    // With prompt lookup, `tokens` holds the prompt and everything generated
+    // so far, to look up proposed tokens in.
+    std::vector<uint64_t> draft_tokens;
+    int64_t num_proposed = 0;
+    int64_t num_accepted = 0;
+
     if (use_kv_cache_) {
       // hard code these to size 1 as kv cache is locked to static size right
       // now.
       token_data = {cur_token};
       token_shape = {1, 1};
+      // Room for the proposed tokens after the current one. The tokens tensor
+      // is created at full size, since it can shrink but not grow.
+      token_data.resize(1 + num_draft_tokens_);
     } else {
       token_data = tokens;
       token_shape = {1, static_cast<int>(tokens.size())};
@@ -74,25 +119,91 @@ class ET_EXPERIMENTAL TextTokenGenerator {
         token_data.data(), token_shape, executorch::aten::ScalarType::Long);
     auto start_pos_managed =
         from_blob(&pos, {1}, executorch::aten::ScalarType::Long);
+    if (use_prompt_lookup) {
+      tokens_managed = from_blob(
+          token_data.data(),
+          {1, static_cast<int>(token_data.size())},
+          executorch::aten::ScalarType::Long);
+    }
 
     should_stop_ = false;
 
     // Generate our tokens
     while (pos < seq_len - 1) {
+      if (use_prompt_lookup) {
+        // Leave room for the token sampled after the last proposed one.
+        const int64_t max_draft_tokens = std::min<int64_t>(
+            num_draft_tokens_, static_cast<int64_t>(seq_len) - 2 - pos);
+        lookup_draft_tokens(tokens, max_draft_tokens, draft_tokens);
+        num_proposed += draft_tokens.size();
+        std::copy(
+            draft_tokens.begin(), draft_tokens.end(), token_data.begin() + 1);
+        ET_CHECK_OK_OR_RETURN_ERROR(resize_tensor_ptr(
+            tokens_managed, {1, static_cast<int>(1 + draft_tokens.size())}));
+      }
+      const int64_t num_fed = use_prompt_lookup ? 1 + draft_tokens.size() : 1;
+
       // Run the model
+      stats_->on_decode_step_begin();
       auto logits_res =
           text_decoder_runner_->step(tokens_managed, start_pos_managed);
+      stats_->on_decode_step_end();
 
       ET_CHECK_OK_OR_RETURN_ERROR(logits_res.error());
       executorch::aten::Tensor& logits_tensor = logits_res.get();
+      ET_CHECK_OR_RETURN_ERROR(
+          num_fed == 1 ||
+              (logits_tensor.dim() == 3 && logits_tensor.size(1) == num_fed),
+          InvalidState,
+          "Prompt lookup decoding needs the logits of every input token; "
+          "export the model with full logits");
+
+      // Accept the proposed tokens up to the first one that differs from the
+      // sampled token, which is also accepted.
+      bool done = false;
+      for (int64_t i = 0; i < num_fed && !done; ++i) {
+        prev_token = cur_token;
 
-      prev_token = cur_token;
+        stats_->on_sampling_begin();
+        cur_token = num_fed > 1
+            ? text_decoder_runner_->logits_to_token_at(logits_tensor, i)
+            : text_decoder_runner_->logits_to_token(logits_tensor);
+        stats_->on_sampling_end();
 
-      stats_->on_sampling_begin();
-      cur_token = text_decoder_runner_->logits_to_token(logits_tensor);
-      stats_->on_sampling_end();
+        pos++;
 
-      pos++;
+        if (generated_tokens != nullptr) {
+          generated_tokens->push_back(cur_token);
+        }
+        if (use_prompt_lookup) {
+          tokens.push_back(cur_token);
+        }
+
+        // print the token as string, decode it with the Tokenizer object
+        stats_->on_detokenize_begin();
+        auto piece_res = tokenizer_->decode(prev_token, cur_token);
+        stats_->on_detokenize_end();
+        ET_CHECK_OK_OR_RETURN_ERROR(piece_res.error());
+
+        stats_->on_callback_begin();
+        token_callback(piece_res.get());
+        stats_->on_callback_end();
+
+        if (should_stop_) {
+          done = true;
+        } else if (eos_ids_->find(cur_token) != eos_ids_->end()) {
+          // data-dependent terminating condition: we have n_eos_ number of
+          // EOS
+          printf("\n");
+          ET_LOG(Info, "\nReached to the end of generation");
+          done = true;
+        } else if (i + 1 < num_fed) {
+          if (cur_token != draft_tokens[i]) {
+            break;
+          }
+          num_accepted++;
+        }
+      }
 
       if (use_kv_cache_) {
         // update the token tensor. token_data will not be empty.
@@ -105,20 +216,17 @@ class ET_EXPERIMENTAL TextTokenGenerator {
             tokens_managed, {1, static_cast<int>(token_data.size())}));
       }
 
-      // print the token as string, decode it with the Tokenizer object
-      token_callback(ET_UNWRAP(tokenizer_->decode(prev_token, cur_token)));
-
-      if (should_stop_) {
-        break;
-      }
-
-      // data-dependent terminating condition: we have n_eos_ number of EOS
-      if (eos_ids_->find(cur_token) != eos_ids_->end()) {
-        printf("\n");
-        ET_LOG(Info, "\nReached to the end of generation");
+      if (done) {
         break;
       }
     }
+    if (use_prompt_lookup) {
+      ET_LOG(
+          Info,
+          "Prompt lookup accepted %" PRId64 " of %" PRId64 " proposed tokens",
+          num_accepted,
+          num_proposed);
+    }
     return pos - start_pos;
   }
 
@@ -130,11 +238,45 @@ class ET_EXPERIMENTAL TextTokenGenerator {
   }
 
  private:
+  /**
+   * Finds the latest earlier occurrence in `history` of its last
+   * max_ngram_size_ tokens, or of fewer if there is none, and sets `draft` to
+   * at most `max_tokens` tokens that followed it. `draft` is empty if even
+   * the last token did not occur before.
+   */
+  inline void lookup_draft_tokens(
+      const std::vector<uint64_t>& history,
+      int64_t max_tokens,
+      std::vector<uint64_t>& draft) const {
+    draft.clear();
+    const int64_t size = history.size();
+    if (max_tokens <= 0) {
+      return;
+    }
+    for (int64_t ngram_size = std::min<int64_t>(max_ngram_size_, size - 1);
+         ngram_size > 0;
+         --ngram_size) {
+      const auto suffix = history.end() - ngram_size;
+      for (int64_t start = size - ngram_size - 1; start >= 0; --start) {
+        if (std::equal(suffix, history.end(), history.begin() + start)) {
+          const int64_t begin = start + ngram_size;
+          const int64_t end = std::min(size, begin + max_tokens);
+          draft.assign(history.begin() + begin, history.begin() + end);
+          return;
+        }
+      }
+    }
+  }
+
   Tokenizer* tokenizer_;
   TextDecoderRunner* text_decoder_runner_;
   std::unique_ptr<std::unordered_set<uint64_t>> eos_ids_;
   bool use_kv_cache_;
 
+  // prompt lookup decoding, disabled if num_draft_tokens_ is 0
+  int32_t num_draft_tokens_ = 0;
+  int32_t max_ngram_size_ = 0;
+
   // state machine
   bool should_stop_ = false;
 
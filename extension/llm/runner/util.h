@@ -11,6 +11,7 @@
 #include <stdio.h>
 #include <time.h>
 #include <cctype>
+#include <cstdint>
 #if defined(__linux__) || defined(__ANDROID__) || defined(__unix__)
 #include <sys/resource.h>
 #endif
@@ -48,6 +49,16 @@ ET_EXPERIMENTAL long inline time_in_ms() {
   return time.tv_sec * 1000 + time.tv_nsec / 1000000;
 }
 
+ET_EXPERIMENTAL int64_t inline time_in_us() {
+  // return monotonic time in microseconds, for measuring short latencies.
+  // Unlike time_in_ms(), it is not tied to the wall clock, so it can only be
+  // used for differences. 64 bits wide, since a long overflows in about 36
+  // minutes of uptime where it is 32 bits.
+  struct timespec time;
+  clock_gettime(CLOCK_MONOTONIC, &time);
+  return static_cast<int64_t>(time.tv_sec) * 1000000 + time.tv_nsec / 1000;
+}
+
 // ----------------------------------------------------------------------------
 // utilities: memory usage
 
@@ -8,9 +8,12 @@
 
 #include <executorch/extension/module/module.h>
 
+#include <algorithm>
+
 #include <executorch/extension/data_loader/file_data_loader.h>
 #include <executorch/extension/data_loader/mmap_data_loader.h>
 #include <executorch/extension/memory_allocator/malloc_memory_allocator.h>
+#include <executorch/extension/module/weight_streamer.h>
 #include <executorch/runtime/platform/runtime.h>
 
 /**
@@ -80,6 +83,12 @@ Module::Module(
   runtime::runtime_init();
 }
 
+Module::~Module() = default;
+
+Module::MethodHolder::MethodHolder() = default;
+Module::MethodHolder::MethodHolder(MethodHolder&&) = default;
+Module::MethodHolder::~MethodHolder() = default;
+
 runtime::Error Module::load(const runtime::Program::Verification verification) {
   if (!is_loaded()) {
     if (!data_loader_) {
@@ -102,6 +111,9 @@ runtime::Error Module::load(const runtime::Program::Verification verification) {
               MmapDataLoader::MlockConfig::UseMlockIgnoreErrors));
           break;
       }
+      if (load_mode_ != LoadMode::File) {
+        mmap_data_loader_ = static_cast<MmapDataLoader*>(data_loader_.get());
+      }
     };
     auto program = ET_UNWRAP_UNIQUE(
         runtime::Program::load(data_loader_.get(), verification));
@@ -186,7 +198,12 @@ runtime::Result<std::vector<runtime::EValue>> Module::execute(
   }
   ET_CHECK_OK_OR_RETURN_ERROR(method->set_inputs(
       exec_aten::ArrayRef<runtime::EValue>(inputs.data(), inputs.size())));
-  ET_CHECK_OK_OR_RETURN_ERROR(method->execute());
+  auto& weight_streamer = methods_.at(method_name).weight_streamer;
+  if (weight_streamer) {
+    ET_CHECK_OK_OR_RETURN_ERROR(weight_streamer->execute());
+  } else {
+    ET_CHECK_OK_OR_RETURN_ERROR(method->execute());
+  }
 
   const auto outputs_size = method->outputs_size();
   std::vector<runtime::EValue> outputs(outputs_size);
@@ -236,5 +253,88 @@ runtime::Error Module::set_output(
       output_tensor.mutable_data_ptr(), output_tensor.nbytes(), output_index);
 }
 
+runtime::Error Module::advise_weights(
+    const std::string& method_name,
+    size_t begin_instruction,
+    size_t end_instruction,
+    MmapDataLoader::AccessHint hint) {
+  ET_CHECK_OK_OR_RETURN_ERROR(load_method(method_name));
+  ET_CHECK_OR_RETURN_ERROR(
+      mmap_data_loader_ != nullptr,
+      NotSupported,
+      "Weight access hints require an Mmap load mode");
+  auto& method = methods_.at(method_name).method;
+  end_instruction = std::min(end_instruction, method->num_instructions());
+
+  std::vector<runtime::Method::ConstantData> constants;
+  // Neighboring instructions usually read weights that are adjacent in the
+  // constant segment, so coalesce them to save syscalls.
+  const uint8_t* pending_begin = nullptr;
+  const uint8_t* pending_end = nullptr;
+  for (size_t index = begin_instruction; index < end_instruction; ++index) {
+    auto num_constants =
+        ET_UNWRAP(method->get_constant_data(index, nullptr, 0));
+    constants.resize(num_constants);
+    ET_CHECK_OK_OR_RETURN_ERROR(
+        method->get_constant_data(index, constants.data(), num_constants)
+            .error());
+    for (const auto& constant : constants) {
+      const auto begin = static_cast<const uint8_t*>(constant.data);
+      const auto end = begin + constant.nbytes;
+      if (pending_begin != nullptr && begin <= pending_end &&
+          end >= pending_begin) {
+        pending_begin = std::min(pending_begin, begin);
+        pending_end = std::max(pending_end, end);
+        continue;
+      }
+      if (pending_begin != nullptr) {
+        ET_CHECK_OK_OR_RETURN_ERROR(mmap_data_loader_->advise(
+            pending_begin, pending_end - pending_begin, hint));
+      }
+      pending_begin = begin;
+      pending_end = end;
+    }
+  }
+  if (pending_begin != nullptr) {
+    ET_CHECK_OK_OR_RETURN_ERROR(mmap_data_loader_->advise(
+        pending_begin, pending_end - pending_begin, hint));
+  }
+  return runtime::Error::Ok;
+}
+
+runtime::Error Module::enable_weight_streaming(
+    const std::string& method_name,
+    size_t resident_weight_budget) {
+  ET_CHECK_OK_OR_RETURN_ERROR(load_method(method_name));
+  ET_CHECK_OR_RETURN_ERROR(
+      mmap_data_loader_ != nullptr && load_mode_ == LoadMode::Mmap,
+      NotSupported,
+      "Weight streaming requires LoadMode::Mmap");
+  auto& method_holder = methods_.at(method_name);
+  // Destroy any previous streamer first so that only one thread is active.
+  method_holder.weight_streamer.reset();
+  method_holder.weight_streamer = ET_UNWRAP(WeightStreamer::create(
+      method_holder.method.get(), mmap_data_loader_, resident_weight_budget));
+  return runtime::Error::Ok;
+}
+
+runtime::Result<std::vector<runtime::Span<uint8_t>>>
+Module::memory_planned_buffers(const std::string& method_name) {
+  ET_CHECK_OK_OR_RETURN_ERROR(load_method(method_name));
+  return methods_.at(method_name).planned_spans;
+}
+
+runtime::Result<std::vector<runtime::Method::PlannedTensorData>>
+Module::memory_planned_tensors(const std::string& method_name) {
+  ET_CHECK_OK_OR_RETURN_ERROR(load_method(method_name));
+  const auto& method = methods_.at(method_name).method;
+  std::vector<runtime::Method::PlannedTensorData> tensors(
+      ET_UNWRAP(method->get_memory_planned_tensors(nullptr, 0)));
+  ET_CHECK_OK_OR_RETURN_ERROR(
+      method->get_memory_planned_tensors(tensors.data(), tensors.size())
+          .error());
+  return tensors;
+}
+
 } // namespace extension
 } // namespace executorch
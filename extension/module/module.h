@@ -14,11 +14,14 @@
 #include <unordered_set>
 #include <vector>
 
+#include <executorch/extension/data_loader/mmap_data_loader.h>
 #include <executorch/runtime/executor/program.h>
 
 namespace executorch {
 namespace extension {
 
+class WeightStreamer;
+
 /**
  * A facade class for loading programs and executing methods within them.
  */
@@ -86,6 +89,7 @@ class Module {
   Module& operator=(const Module&) = delete;
   Module(Module&&) = delete;
   Module& operator=(Module&&) = delete;
+  ~Module();
 
   /**
    * Loads the program if needed.
@@ -411,6 +415,84 @@ class Module {
     return set_output("forward", std::move(output_value), output_index);
   }
 
+  /**
+   * EXPERIMENTAL: Advises the OS how the constant weights read by a range of
+   * a method's instructions will be accessed. Instructions are numbered in
+   * execution order, so for example passing `AccessHint::WillNeed` for
+   * `[0, N)` right after loading starts paging in the weights of the first N
+   * instructions before the first inference, and `AccessHint::DontNeed`
+   * releases weights of instructions that have already run.
+   *
+   * Only supported when the Module loads its program itself with one of the
+   * `Mmap` load modes. `AccessHint::DontNeed` requires `LoadMode::Mmap`,
+   * since locked pages cannot be released.
+   *
+   * @param[in] method_name The name of the method. Loaded if needed.
+   * @param[in] begin_instruction Index of the first instruction in the range.
+   * @param[in] end_instruction Index one past the last instruction in the
+   *     range. Clamped to the number of instructions in the method.
+   * @param[in] hint How the weights will be accessed.
+   *
+   * @returns An Error to indicate success or failure.
+   */
+  ET_EXPERIMENTAL ET_NODISCARD runtime::Error advise_weights(
+      const std::string& method_name,
+      size_t begin_instruction,
+      size_t end_instruction,
+      MmapDataLoader::AccessHint hint);
+
+  /**
+   * EXPERIMENTAL: Makes subsequent executions of a method stream its constant
+   * weights through a bounded resident window instead of keeping them all
+   * paged in. A background thread pages in the weights of upcoming
+   * instructions, in execution order, while weights of instructions that have
+   * run are released. This lets models whose weights exceed physical memory
+   * run with a smaller resident set, at the cost of re-reading weights from
+   * storage on every execution.
+   *
+   * The budget bounds how far ahead the prefetcher reads; it is not a cap on
+   * resident memory. Pages shared with neighbouring tensors are not released,
+   * and the kernel may keep or drop pages on its own.
+   *
+   * Requires `LoadMode::Mmap`.
+   *
+   * @param[in] method_name The name of the method. Loaded if needed.
+   * @param[in] resident_weight_budget Number of bytes of weights that the
+   *     prefetcher may page in ahead of execution.
+   *
+   * @returns An Error to indicate success or failure.
+   */
+  ET_EXPERIMENTAL ET_NODISCARD runtime::Error enable_weight_streaming(
+      const std::string& method_name,
+      size_t resident_weight_budget);
+
+  /**
+   * EXPERIMENTAL: Returns the memory-planned buffers of a method, in the
+   * order of its memory ids. The buffers hold the method's activations and
+   * its mutable state, such as KV caches, and stay valid until the Module is
+   * destroyed. Between executions only the mutable state is meaningful, so
+   * copying the buffers out and back in later saves and restores that state.
+   *
+   * @param[in] method_name The name of the method. Loaded if needed.
+   *
+   * @returns The buffers, or an error if the method failed to load.
+   */
+  ET_EXPERIMENTAL runtime::Result<std::vector<runtime::Span<uint8_t>>>
+  memory_planned_buffers(const std::string& method_name);
+
+  /**
+   * EXPERIMENTAL: Returns the tensors that the memory plan of a method places
+   * in its memory-planned buffers, with their types. Tensors that are not
+   * live at the same time may share memory.
+   *
+   * @param[in] method_name The name of the method. Loaded if needed.
+   *
+   * @returns The tensors, or an error if the method failed to load.
+   */
+  ET_EXPERIMENTAL
+  runtime::Result<std::vector<runtime::Method::PlannedTensorData>>
+  memory_planned_tensors(const std::string& method_name);
+
   /**
    * Retrieves the EventTracer instance being used by the Module.
    * EventTracer is used for tracking and logging events during the execution
@@ -425,12 +507,18 @@ class Module {
 
  private:
   struct MethodHolder {
+    // Defined out of line, where WeightStreamer is complete.
+    MethodHolder();
+    MethodHolder(MethodHolder&&);
+    ~MethodHolder();
+
     std::vector<std::vector<uint8_t>> planned_buffers;
     std::vector<runtime::Span<uint8_t>> planned_spans;
     std::unique_ptr<runtime::HierarchicalAllocator> planned_memory;
     std::unique_ptr<runtime::MemoryManager> memory_manager;
     std::unique_ptr<runtime::Method> method;
     std::vector<runtime::EValue> inputs;
+    std::unique_ptr<WeightStreamer> weight_streamer;
   };
 
  private:
@@ -438,6 +526,8 @@ class Module {
   LoadMode load_mode_{LoadMode::MmapUseMlock};
   std::shared_ptr<runtime::Program> program_;
   std::unique_ptr<runtime::DataLoader> data_loader_;
+  // Points to data_loader_ if the Module created it with an Mmap load mode.
+  MmapDataLoader* mmap_data_loader_{nullptr};
   std::unique_ptr<runtime::MemoryAllocator> memory_allocator_;
   std::unique_ptr<runtime::MemoryAllocator> temp_allocator_;
   std::unique_ptr<runtime::EventTracer> event_tracer_;
@@ -14,9 +14,11 @@ def define_common_targets():
             name = "module" + aten_suffix,
             srcs = [
                 "module.cpp",
+                "weight_streamer.cpp",
             ],
             exported_headers = [
                 "module.h",
+                "weight_streamer.h",
             ],
             visibility = [
                 "@EXECUTORCH_CLIENTS",
@@ -24,9 +26,9 @@ def define_common_targets():
             deps = [
                 "//executorch/extension/memory_allocator:malloc_memory_allocator",
                 "//executorch/extension/data_loader:file_data_loader",
-                "//executorch/extension/data_loader:mmap_data_loader",
             ],
             exported_deps = [
+                "//executorch/extension/data_loader:mmap_data_loader",
                 "//executorch/runtime/executor:program" + aten_suffix,
             ],
         )
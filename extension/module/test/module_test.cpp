@@ -435,3 +435,95 @@ TEST_F(ModuleTest, TestSetOutputInvalidType) {
 
   EXPECT_NE(module.set_output(EValue()), Error::Ok);
 }
+
+TEST_F(ModuleTest, TestAdviseWeights) {
+  Module module(model_path_, Module::LoadMode::Mmap);
+
+  EXPECT_EQ(
+      module.advise_weights(
+          "forward", 0, 16, MmapDataLoader::AccessHint::WillNeed),
+      Error::Ok);
+  // Out-of-range ends are clamped.
+  EXPECT_EQ(
+      module.advise_weights(
+          "forward", 0, SIZE_MAX, MmapDataLoader::AccessHint::DontNeed),
+      Error::Ok);
+
+  // Released weights are re-read transparently.
+  auto tensor = make_tensor_ptr({1.f});
+  const auto result = module.forward({tensor, tensor});
+  EXPECT_EQ(result.error(), Error::Ok);
+}
+
+TEST_F(ModuleTest, TestAdviseWeightsRequiresMmap) {
+  Module module(model_path_, Module::LoadMode::File);
+
+  EXPECT_EQ(
+      module.advise_weights(
+          "forward", 0, 16, MmapDataLoader::AccessHint::WillNeed),
+      Error::NotSupported);
+}
+
+TEST_F(ModuleTest, TestWeightStreaming) {
+  Module module(model_path_, Module::LoadMode::Mmap);
+
+  EXPECT_EQ(module.enable_weight_streaming("forward", 1), Error::Ok);
+
+  auto tensor = make_tensor_ptr({2.f});
+  // Run several times to exercise wrapping around the schedule.
+  for (int i = 0; i < 3; ++i) {
+    const auto result = module.forward({tensor, tensor});
+    ASSERT_EQ(result.error(), Error::Ok);
+
+    const auto data = result->at(0).toTensor().const_data_ptr<float>();
+    EXPECT_NEAR(data[0], 4, 1e-5);
+  }
+}
+
+TEST_F(ModuleTest, TestWeightStreamingRequiresMmap) {
+  Module module(model_path_, Module::LoadMode::MmapUseMlock);
+
+  EXPECT_EQ(
+      module.enable_weight_streaming("forward", 1 << 20), Error::NotSupported);
+}
+
+TEST_F(ModuleTest, TestMemoryPlannedBuffers) {
+  Module module(model_path_);
+
+  const auto buffers = module.memory_planned_buffers("forward");
+  ASSERT_EQ(buffers.error(), Error::Ok);
+
+  const auto meta = module.method_meta("forward");
+  ASSERT_EQ(meta.error(), Error::Ok);
+  ASSERT_EQ(buffers->size(), meta->num_memory_planned_buffers());
+  for (size_t index = 0; index < buffers->size(); ++index) {
+    EXPECT_EQ(
+        buffers->at(index).size(),
+        meta->memory_planned_buffer_size(index).get());
+  }
+
+  EXPECT_NE(module.memory_planned_buffers("backward").error(), Error::Ok);
+}
+
+TEST_F(ModuleTest, TestMemoryPlannedTensors) {
+  Module module(model_path_);
+
+  const auto tensors = module.memory_planned_tensors("forward");
+  ASSERT_EQ(tensors.error(), Error::Ok);
+  EXPECT_FALSE(tensors->empty());
+
+  const auto buffers = module.memory_planned_buffers("forward");
+  ASSERT_EQ(buffers.error(), Error::Ok);
+  for (const auto& tensor : *tensors) {
+    EXPECT_EQ(tensor.scalar_type, executorch::aten::ScalarType::Float);
+    const auto data = static_cast<const uint8_t*>(tensor.data);
+    bool in_buffer = false;
+    for (const auto& buffer : *buffers) {
+      in_buffer |= data >= buffer.data() &&
+          data + tensor.nbytes <= buffer.data() + buffer.size();
+    }
+    EXPECT_TRUE(in_buffer);
+  }
+
+  EXPECT_NE(module.memory_planned_tensors("backward").error(), Error::Ok);
+}
@@ -5,7 +5,7 @@ load(
 )
 load("@fbsource//xplat/executorch/build:runtime_wrapper.bzl", "runtime")
 
-def define_common_targets():
+def define_common_targets(is_fbcode = False):
     """Defines targets that should be shared between fbcode and xplat.
 
     The directory containing this targets.bzl file should also contain both
@@ -35,6 +35,30 @@ def define_common_targets():
             ],
         )
 
+        # TODO(dbort): Find a way to make these run for ANDROID/APPLE in xplat. The
+        # android and ios test determinators don't like the reference to the model
+        # file in fbcode. See https://fburl.com/9esapdmd
+        if not runtime.is_oss and is_fbcode:
+            runtime.cxx_test(
+                name = "weight_streamer_test" + aten_suffix,
+                srcs = [
+                    "weight_streamer_test.cpp",
+                ],
+                deps = [
+                    "//executorch/kernels/portable:generated_lib" + aten_suffix,
+                    "//executorch/extension/module:module" + aten_suffix,
+                    "//executorch/extension/tensor:tensor" + aten_suffix,
+                    "//executorch/runtime/core/exec_aten/testing_util:tensor_util" + aten_suffix,
+                    "//executorch/runtime/executor/test:managed_memory_manager",
+                ],
+                env = {
+                    "ET_MODULE_LINEAR_PATH": "$(location fbcode//executorch/test/models:exported_programs[ModuleLinear.pte])",
+                },
+                compiler_flags = [
+                    "-Wno-error=deprecated-declarations",
+                ],
+            )
+
     runtime.filegroup(
         name = "resources",
         srcs = native.glob([
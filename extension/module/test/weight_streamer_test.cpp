@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/module/weight_streamer.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include <executorch/extension/data_loader/mmap_data_loader.h>
+#include <executorch/extension/tensor/tensor.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
+#include <executorch/runtime/executor/program.h>
+#include <executorch/runtime/executor/test/managed_memory_manager.h>
+#include <executorch/runtime/platform/runtime.h>
+
+using namespace ::executorch::extension;
+using namespace ::executorch::runtime;
+using executorch::runtime::testing::ManagedMemoryManager;
+
+constexpr size_t kDefaultNonConstMemBytes = 32 * 1024U;
+constexpr size_t kDefaultRuntimeMemBytes = 32 * 1024U;
+
+class WeightStreamerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    runtime_init();
+
+    // Weight streaming needs pages that can be dropped, so don't mlock them.
+    auto loader = MmapDataLoader::from(
+        std::getenv("ET_MODULE_LINEAR_PATH"),
+        MmapDataLoader::MlockConfig::NoMlock);
+    ASSERT_EQ(loader.error(), Error::Ok);
+    loader_ = std::make_unique<MmapDataLoader>(std::move(loader.get()));
+
+    auto program = Program::load(loader_.get());
+    ASSERT_EQ(program.error(), Error::Ok);
+    program_ = std::make_unique<Program>(std::move(program.get()));
+  }
+
+  // The bytes of weights the prefetcher keeps resident at the start of the
+  // Method with the given budget.
+  static size_t full_window(const Method& method, size_t budget) {
+    size_t resident_bytes = 0;
+    for (size_t index = 0; index < method.num_instructions(); ++index) {
+      const auto nbytes = instruction_nbytes(method, index);
+      if (resident_bytes != 0 && resident_bytes + nbytes > budget) {
+        break;
+      }
+      resident_bytes += nbytes;
+    }
+    return resident_bytes;
+  }
+
+  static size_t instruction_nbytes(const Method& method, size_t index) {
+    Method::ConstantData constants[4];
+    const auto num_constants = method.get_constant_data(index, constants, 4);
+    EXPECT_EQ(num_constants.error(), Error::Ok);
+    EXPECT_LE(num_constants.get(), 4);
+    size_t nbytes = 0;
+    for (size_t i = 0; i < num_constants.get(); ++i) {
+      nbytes += constants[i].nbytes;
+    }
+    return nbytes;
+  }
+
+  // The prefetcher runs on its own thread, so wait for it to settle.
+  static bool wait_for_resident_bytes(
+      const WeightStreamer& streamer,
+      size_t expected) {
+    for (int i = 0; i < 1000; ++i) {
+      if (streamer.resident_bytes() == expected) {
+        return true;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return false;
+  }
+
+  std::unique_ptr<MmapDataLoader> loader_;
+  std::unique_ptr<Program> program_;
+};
+
+TEST_F(WeightStreamerTest, MatchesExecute) {
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  auto method = program_->load_method("forward", &mmm.get());
+  ASSERT_EQ(method.error(), Error::Ok);
+  ManagedMemoryManager streamed_mmm(
+      kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  auto streamed_method = program_->load_method("forward", &streamed_mmm.get());
+  ASSERT_EQ(streamed_method.error(), Error::Ok);
+
+  // Large enough for all the weights.
+  const size_t budget = 1 << 20;
+  const size_t total_bytes = full_window(*streamed_method, budget);
+  ASSERT_GT(total_bytes, 0);
+  auto streamer =
+      WeightStreamer::create(&streamed_method.get(), loader_.get(), budget);
+  ASSERT_EQ(streamer.error(), Error::Ok);
+  EXPECT_TRUE(wait_for_resident_bytes(*streamer.get(), total_bytes));
+
+  for (int run = 0; run < 3; ++run) {
+    auto input =
+        make_tensor_ptr({2, 2}, {1.f, 2.f, 3.f, static_cast<float>(run)});
+    ASSERT_EQ(method->set_input(*input, 0), Error::Ok);
+    ASSERT_EQ(streamed_method->set_input(*input, 0), Error::Ok);
+    ASSERT_EQ(method->execute(), Error::Ok);
+    ASSERT_EQ(streamer.get()->execute(), Error::Ok);
+
+    EXPECT_TENSOR_EQ(
+        streamed_method->get_output(0).toTensor(),
+        method->get_output(0).toTensor());
+    // The weights released during the run are paged in again for the next.
+    EXPECT_TRUE(wait_for_resident_bytes(*streamer.get(), total_bytes));
+  }
+}
+
+TEST_F(WeightStreamerTest, StaysWithinBudget) {
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  auto method = program_->load_method("forward", &mmm.get());
+  ASSERT_EQ(method.error(), Error::Ok);
+
+  // Only room for the weights of one instruction at a time.
+  const size_t budget = 1;
+  const size_t window = full_window(*method, budget);
+  ASSERT_GT(window, 0);
+  size_t max_instruction_bytes = 0;
+  for (size_t index = 0; index < method->num_instructions(); ++index) {
+    max_instruction_bytes =
+        std::max(max_instruction_bytes, instruction_nbytes(*method, index));
+  }
+  auto streamer = WeightStreamer::create(&method.get(), loader_.get(), budget);
+  ASSERT_EQ(streamer.error(), Error::Ok);
+  EXPECT_TRUE(wait_for_resident_bytes(*streamer.get(), window));
+
+  std::atomic<bool> done{false};
+  std::atomic<size_t> max_resident_bytes{0};
+  std::thread sampler([&] {
+    while (!done) {
+      const size_t resident_bytes = streamer.get()->resident_bytes();
+      if (resident_bytes > max_resident_bytes) {
+        max_resident_bytes = resident_bytes;
+      }
+    }
+  });
+  auto input = make_tensor_ptr({2, 2}, {1.f, 2.f, 3.f, 4.f});
+  for (int run = 0; run < 10; ++run) {
+    // Don't ASSERT here, which would return without joining the sampler.
+    EXPECT_EQ(method->set_input(*input, 0), Error::Ok);
+    EXPECT_EQ(streamer.get()->execute(), Error::Ok);
+    const auto data = method->get_output(0).toTensor().const_data_ptr<float>();
+    EXPECT_EQ(data[3], 14.f);
+  }
+  done = true;
+  sampler.join();
+
+  EXPECT_LE(max_resident_bytes, max_instruction_bytes);
+  EXPECT_TRUE(wait_for_resident_bytes(*streamer.get(), window));
+}
+
+TEST_F(WeightStreamerTest, RequiresBudget) {
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  auto method = program_->load_method("forward", &mmm.get());
+  ASSERT_EQ(method.error(), Error::Ok);
+
+  EXPECT_EQ(
+      WeightStreamer::create(&method.get(), loader_.get(), 0).error(),
+      Error::InvalidArgument);
+  EXPECT_EQ(
+      WeightStreamer::create(nullptr, loader_.get(), 1).error(),
+      Error::InvalidArgument);
+}
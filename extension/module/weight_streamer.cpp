@@ -0,0 +1,213 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/module/weight_streamer.h>
+
+#include <unistd.h>
+
+#include <cstdint>
+
+#include <executorch/runtime/core/event_tracer_hooks.h>
+#include <executorch/runtime/platform/log.h>
+#include <executorch/runtime/platform/profiler.h>
+
+namespace executorch {
+namespace extension {
+
+runtime::Result<std::unique_ptr<WeightStreamer>> WeightStreamer::create(
+    runtime::Method* method,
+    const MmapDataLoader* data_loader,
+    size_t resident_weight_budget) {
+  ET_CHECK_OR_RETURN_ERROR(
+      method != nullptr && data_loader != nullptr,
+      InvalidArgument,
+      "Method and data loader must be non-null");
+  ET_CHECK_OR_RETURN_ERROR(
+      resident_weight_budget > 0,
+      InvalidArgument,
+      "Resident weight budget must be greater than 0");
+
+  // Snapshot the weights each instruction reads, in execution order.
+  std::vector<Instruction> instructions(method->num_instructions());
+  for (size_t index = 0; index < instructions.size(); ++index) {
+    auto& instruction = instructions[index];
+    const auto num_constants =
+        ET_UNWRAP(method->get_constant_data(index, nullptr, 0));
+    instruction.constants.resize(num_constants);
+    ET_CHECK_OK_OR_RETURN_ERROR(
+        method
+            ->get_constant_data(
+                index, instruction.constants.data(), num_constants)
+            .error());
+    for (const auto& constant : instruction.constants) {
+      instruction.nbytes += constant.nbytes;
+    }
+  }
+  return std::unique_ptr<WeightStreamer>(new WeightStreamer(
+      method, data_loader, resident_weight_budget, std::move(instructions)));
+}
+
+WeightStreamer::WeightStreamer(
+    runtime::Method* method,
+    const MmapDataLoader* data_loader,
+    size_t resident_weight_budget,
+    std::vector<Instruction> instructions)
+    : method_(method),
+      data_loader_(data_loader),
+      resident_weight_budget_(resident_weight_budget),
+      instructions_(std::move(instructions)),
+      page_size_(static_cast<size_t>(::sysconf(_SC_PAGESIZE))),
+      prefetch_thread_([this] { prefetch_loop(); }) {}
+
+WeightStreamer::~WeightStreamer() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  prefetch_thread_.join();
+}
+
+runtime::Error WeightStreamer::execute() {
+  // Stepping bypasses Method::execute(), so trace the run the same way.
+  auto* event_tracer = method_->get_event_tracer();
+  runtime::internal::event_tracer_create_event_block(event_tracer, "Execute");
+  runtime::EventTracerEntry event_tracer_entry =
+      runtime::internal::event_tracer_begin_profiling_event(
+          event_tracer, "Method::execute");
+  EXECUTORCH_SCOPE_PROF("Method::execute");
+
+  const size_t num_instructions = instructions_.size();
+  size_t run_start_step = 0;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    run_start_step = next_release_step_;
+  }
+  size_t executed = 0;
+  runtime::Error error = runtime::Error::Ok;
+  for (;;) {
+    error = method_->step();
+    if (error != runtime::Error::Ok) {
+      break;
+    }
+    // Jumps can make the number of steps differ from the number of
+    // instructions; only the first `num_instructions` steps map onto the
+    // schedule.
+    if (executed < num_instructions) {
+      release(run_start_step + executed);
+      executed++;
+    }
+  }
+  // Keep the schedule aligned to the start of the Method for the next run,
+  // including after a failed step.
+  for (; executed < num_instructions; ++executed) {
+    release(run_start_step + executed);
+  }
+  runtime::internal::event_tracer_end_profiling_event(
+      event_tracer, event_tracer_entry);
+  if (error != runtime::Error::EndOfMethod) {
+    // Rewind the Method so that it can run again.
+    (void)method_->reset_execution();
+    return error;
+  }
+  return method_->reset_execution();
+}
+
+size_t WeightStreamer::resident_bytes() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return resident_bytes_;
+}
+
+void WeightStreamer::prefetch_loop() {
+  const size_t num_instructions = instructions_.size();
+  std::unique_lock<std::mutex> lock(mutex_);
+  for (;;) {
+    cv_.wait(lock, [&] {
+      if (stop_) {
+        return true;
+      }
+      // Never run a full lap ahead of execution.
+      if (num_instructions == 0 ||
+          next_prefetch_step_ >= next_release_step_ + num_instructions) {
+        return false;
+      }
+      const size_t nbytes =
+          instructions_[next_prefetch_step_ % num_instructions].nbytes;
+      // Always allow one instruction in, even if it alone exceeds the budget.
+      return resident_bytes_ == 0 ||
+          resident_bytes_ + nbytes <= resident_weight_budget_;
+    });
+    if (stop_) {
+      return;
+    }
+    // Claim the step before unlocking so that release() accounts for it.
+    const auto& instruction =
+        instructions_[next_prefetch_step_ % num_instructions];
+    next_prefetch_step_++;
+    resident_bytes_ += instruction.nbytes;
+
+    lock.unlock();
+    page_in(instruction);
+    lock.lock();
+  }
+}
+
+void WeightStreamer::page_in(const Instruction& instruction) const {
+  for (const auto& constant : instruction.constants) {
+    // Start asynchronous read-ahead for the whole tensor, then touch each page
+    // so that it is resident before the instruction runs. Hint failures are
+    // not fatal: the pages are faulted in on first use regardless.
+    (void)data_loader_->advise(
+        constant.data, constant.nbytes, MmapDataLoader::AccessHint::WillNeed);
+    const volatile uint8_t* data =
+        static_cast<const volatile uint8_t*>(constant.data);
+    for (size_t offset = 0; offset < constant.nbytes; offset += page_size_) {
+      (void)data[offset];
+    }
+  }
+}
+
+void WeightStreamer::release(size_t step) {
+  const auto& instruction = instructions_[step % instructions_.size()];
+  {
+    // Release under the lock so that the prefetcher cannot page in the same
+    // weights for the next run before they are dropped.
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& constant : instruction.constants) {
+      // advise() widens the range to whole pages, so shrink it to the pages
+      // that lie entirely inside the tensor first. The partial pages at
+      // either end may hold weights of other tensors.
+      const uintptr_t begin = reinterpret_cast<uintptr_t>(constant.data);
+      const uintptr_t end = begin + constant.nbytes;
+      const uintptr_t inner_begin =
+          (begin + page_size_ - 1) / page_size_ * page_size_;
+      const uintptr_t inner_end = end / page_size_ * page_size_;
+      if (inner_begin >= inner_end) {
+        continue;
+      }
+      const auto error = data_loader_->advise(
+          reinterpret_cast<const void*>(inner_begin),
+          inner_end - inner_begin,
+          MmapDataLoader::AccessHint::DontNeed);
+      if (error != runtime::Error::Ok) {
+        ET_LOG(Debug, "Failed to release weights of step %zu", step);
+      }
+    }
+    if (step < next_prefetch_step_) {
+      resident_bytes_ -= instruction.nbytes;
+    } else {
+      // Execution overtook the prefetcher; skip it past this step.
+      next_prefetch_step_ = step + 1;
+    }
+    next_release_step_ = step + 1;
+  }
+  cv_.notify_all();
+}
+
+} // namespace extension
+} // namespace executorch
@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <executorch/extension/data_loader/mmap_data_loader.h>
+#include <executorch/runtime/executor/method.h>
+
+namespace executorch {
+namespace extension {
+
+/**
+ * Executes a Method one instruction at a time while streaming its mmapped
+ * constant weights through a window ahead of execution.
+ *
+ * A background thread walks the instruction list ahead of execution and pages
+ * in the weights each upcoming instruction reads, as long as the total size of
+ * weights paged in but not yet released stays within the budget. After each
+ * instruction runs, the pages that lie entirely inside its weights are
+ * released with `MADV_DONTNEED` so that they can be reclaimed. The schedule
+ * wraps around at the end of the Method, so the weights of the first
+ * instructions are already resident when the next execution starts.
+ *
+ * The budget sizes the prefetch window; it does not cap resident memory.
+ * Pages shared between tensors stay resident, a single instruction whose
+ * weights exceed the budget is still paged in on its own, and the kernel may
+ * keep released pages cached. Weights owned by delegates are not covered,
+ * since backends copy or map them at init time.
+ */
+class WeightStreamer final {
+ public:
+  /**
+   * Creates a WeightStreamer for an initialized Method.
+   *
+   * @param[in] method The Method to execute. Must outlive the WeightStreamer.
+   * @param[in] data_loader The loader that mapped the Method's constant
+   *     segment. Must not lock pages with `mlock()`, and must outlive the
+   *     WeightStreamer.
+   * @param[in] resident_weight_budget Number of bytes of weights that may be
+   *     paged in ahead of execution.
+   *
+   * @returns A new WeightStreamer, with its background thread running.
+   */
+  static runtime::Result<std::unique_ptr<WeightStreamer>> create(
+      runtime::Method* method,
+      const MmapDataLoader* data_loader,
+      size_t resident_weight_budget);
+
+  ~WeightStreamer();
+
+  /**
+   * Executes the Method from start to end, streaming weights in and out.
+   * Inputs must already be set on the Method.
+   *
+   * @returns An Error to indicate success or failure.
+   */
+  ET_NODISCARD runtime::Error execute();
+
+  /**
+   * Returns the number of bytes of weights currently paged in ahead of
+   * execution and not yet released.
+   */
+  size_t resident_bytes() const;
+
+ private:
+  struct Instruction {
+    std::vector<runtime::Method::ConstantData> constants;
+    size_t nbytes = 0;
+  };
+
+  WeightStreamer(
+      runtime::Method* method,
+      const MmapDataLoader* data_loader,
+      size_t resident_weight_budget,
+      std::vector<Instruction> instructions);
+
+  WeightStreamer(const WeightStreamer&) = delete;
+  WeightStreamer& operator=(const WeightStreamer&) = delete;
+  WeightStreamer(WeightStreamer&&) = delete;
+  WeightStreamer& operator=(WeightStreamer&&) = delete;
+
+  void prefetch_loop();
+  void page_in(const Instruction& instruction) const;
+  void release(size_t step);
+
+  runtime::Method* const method_;
+  const MmapDataLoader* const data_loader_;
+  const size_t resident_weight_budget_;
+  const std::vector<Instruction> instructions_;
+  const size_t page_size_;
+
+  // Steps are counted monotonically across executions; the instruction for a
+  // step is `step % instructions_.size()`.
+  mutable std::mutex mutex_;
+  std::condition_variable cv_;
+  size_t next_prefetch_step_{0};
+  size_t next_release_step_{0};
+  size_t resident_bytes_{0};
+  bool stop_{false};
+  std::thread prefetch_thread_;
+};
+
+} // namespace extension
+} // namespace executorch
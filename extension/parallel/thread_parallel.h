@@ -14,6 +14,13 @@
 namespace executorch {
 namespace extension {
 
+/**
+ * Minimum number of elements a parallel_for task should process, so that
+ * small inputs do not pay the threadpool overhead. Callers whose work items
+ * span several elements divide it by the number of elements per item.
+ */
+constexpr int64_t kMinElementsPerTask = 32768;
+
 /**
  * A helper to run function in parallel.
  *
@@ -47,6 +54,7 @@ namespace executor {
 // TODO(T197294990): Remove these deprecated aliases once all users have moved
 // to the new `::executorch` namespaces.
 using ::executorch::extension::get_thread_num;
+using ::executorch::extension::kMinElementsPerTask;
 using ::executorch::extension::parallel_for;
 using ::executorch::extension::set_thread_num;
 } // namespace executor
@@ -7,6 +7,7 @@
  */
 
 #include <executorch/kernels/optimized/blas/CPUBlas.h>
+#include <executorch/kernels/optimized/blas/PackedGemm.h>
 
 #include <limits.h>
 
@@ -98,6 +99,18 @@ void gemm(
       c, &ldc_);
 #endif // ET_BUILD_FOR_APPLE
 #else
+  if (use_packed_gemm(m, n, k)) {
+    gemm_packed_<double>(
+        transa != TransposeType::NoTranspose,
+        transb != TransposeType::NoTranspose,
+        m, n, k,
+        alpha,
+        a, lda,
+        b, ldb,
+        beta,
+        c, ldc);
+    return;
+  }
   using acc_type = utils::compute_dtype<float>;
   gemm_impl(
       transa, transb,
@@ -139,6 +152,18 @@ void gemm(
 #endif // ET_BUILD_FOR_APPLE
 
 #else
+  if (use_packed_gemm(m, n, k)) {
+    gemm_packed_<float>(
+        transa != TransposeType::NoTranspose,
+        transb != TransposeType::NoTranspose,
+        m, n, k,
+        alpha,
+        a, lda,
+        b, ldb,
+        beta,
+        c, ldc);
+    return;
+  }
   using acc_type = utils::compute_dtype<float>;
   gemm_impl(
       transa, transb,
@@ -0,0 +1,324 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/optimized/blas/PackedGemm.h>
+
+#include <algorithm>
+#include <vector>
+
+#include <executorch/extension/parallel/thread_parallel.h>
+#include <executorch/kernels/optimized/blas/BlasKernel.h>
+#include <executorch/kernels/optimized/utils/math_utils.h>
+#include <executorch/kernels/optimized/utils/unroll.h>
+#include <executorch/kernels/optimized/vec/vec.h>
+
+namespace executorch {
+namespace cpublas {
+
+namespace {
+
+template <typename T>
+struct GemmBlocking {
+  using Vec = vec::Vectorized<T>;
+
+  // The microkernel computes a kMr x kNr tile of c in 2 * kNr vector
+  // accumulators. With 256-bit vectors that is 12 accumulators, which leaves
+  // room for the a and b operands in the 16 registers of AVX2; NEON has 32.
+  static constexpr int64_t kMr = 2 * Vec::size();
+  static constexpr int64_t kNr = 6;
+
+  // A kMc x kKc block of op(a) (128 KiB for float) stays in L2 while it is
+  // multiplied with a panel of op(b), and each kKc x kNr sliver of that panel
+  // stays in L1 while it is multiplied with the whole block. The kKc x kNc
+  // panel (3 MiB for float) is shared by all threads from the last-level
+  // cache.
+  static constexpr int64_t kKc = 256;
+  static constexpr int64_t kMc = 512 / sizeof(T);
+  static constexpr int64_t kNc = kNr * (2048 / sizeof(T));
+
+  // Number of kNr-column slivers of a panel that one parallel task multiplies
+  // with its block of op(a).
+  static constexpr int64_t kSliversPerTask = 16;
+
+  static_assert(kMc % kMr == 0, "kMc must be a multiple of kMr");
+};
+
+// Packs rows [i0, i0 + mc) and columns [l0, l0 + kc) of op(a) into slivers of
+// kMr rows; each sliver stores its kMr values for column l contiguously, in
+// increasing l. Rows past mc are zero-filled.
+template <typename T>
+void pack_a(
+    bool transa,
+    const T* a,
+    int64_t lda,
+    int64_t i0,
+    int64_t mc,
+    int64_t l0,
+    int64_t kc,
+    T* packed) {
+  constexpr int64_t kMr = GemmBlocking<T>::kMr;
+  for (int64_t ir = 0; ir < mc; ir += kMr) {
+    const int64_t mr = std::min(kMr, mc - ir);
+    if (transa) {
+      // op(a)(i, l) = a[l + i * lda]: contiguous along l.
+      for (int64_t i = 0; i < mr; ++i) {
+        const T* src = a + l0 + (i0 + ir + i) * lda;
+        for (int64_t l = 0; l < kc; ++l) {
+          packed[l * kMr + i] = src[l];
+        }
+      }
+    } else {
+      // op(a)(i, l) = a[i + l * lda]: contiguous along i.
+      for (int64_t l = 0; l < kc; ++l) {
+        const T* src = a + i0 + ir + (l0 + l) * lda;
+        for (int64_t i = 0; i < mr; ++i) {
+          packed[l * kMr + i] = src[i];
+        }
+      }
+    }
+    for (int64_t i = mr; i < kMr; ++i) {
+      for (int64_t l = 0; l < kc; ++l) {
+        packed[l * kMr + i] = T(0);
+      }
+    }
+    packed += kc * kMr;
+  }
+}
+
+// Packs rows [l0, l0 + kc) and columns [j0, j0 + nr) of op(b), nr <= kNr, into
+// one sliver that stores its kNr values for row l contiguously. Columns past
+// nr are zero-filled.
+template <typename T>
+void pack_b_sliver(
+    bool transb,
+    const T* b,
+    int64_t ldb,
+    int64_t l0,
+    int64_t kc,
+    int64_t j0,
+    int64_t nr,
+    T* packed) {
+  constexpr int64_t kNr = GemmBlocking<T>::kNr;
+  if (transb) {
+    // op(b)(l, j) = b[j + l * ldb]: contiguous along j.
+    for (int64_t l = 0; l < kc; ++l) {
+      const T* src = b + j0 + (l0 + l) * ldb;
+      for (int64_t j = 0; j < nr; ++j) {
+        packed[l * kNr + j] = src[j];
+      }
+    }
+  } else {
+    // op(b)(l, j) = b[l + j * ldb]: contiguous along l.
+    for (int64_t j = 0; j < nr; ++j) {
+      const T* src = b + l0 + (j0 + j) * ldb;
+      for (int64_t l = 0; l < kc; ++l) {
+        packed[l * kNr + j] = src[l];
+      }
+    }
+  }
+  for (int64_t j = nr; j < kNr; ++j) {
+    for (int64_t l = 0; l < kc; ++l) {
+      packed[l * kNr + j] = T(0);
+    }
+  }
+}
+
+// Computes c = beta * c + alpha * (ap @ bp) for one mr x nr tile of c, where
+// ap and bp are a packed sliver of op(a) and of op(b). c is not read when beta
+// is zero.
+template <typename T>
+void micro_kernel(
+    int64_t kc,
+    const T* ap,
+    const T* bp,
+    T* c,
+    int64_t ldc,
+    int64_t mr,
+    int64_t nr,
+    T alpha,
+    T beta) {
+  using Vec = vec::Vectorized<T>;
+  constexpr int64_t kMr = GemmBlocking<T>::kMr;
+  constexpr int64_t kNr = GemmBlocking<T>::kNr;
+
+  Vec acc0[kNr];
+  Vec acc1[kNr];
+  utils::ForcedUnroll<kNr>{}([&](auto j) ET_INLINE_ATTRIBUTE {
+    acc0[j] = Vec(T(0));
+    acc1[j] = Vec(T(0));
+  });
+  for (int64_t l = 0; l < kc; ++l) {
+    const Vec a0 = Vec::loadu(ap);
+    const Vec a1 = Vec::loadu(ap + Vec::size());
+    utils::ForcedUnroll<kNr>{}([&](auto j) ET_INLINE_ATTRIBUTE {
+      const Vec bj(bp[j]);
+      acc0[j] = vec::fmadd(a0, bj, acc0[j]);
+      acc1[j] = vec::fmadd(a1, bj, acc1[j]);
+    });
+    ap += kMr;
+    bp += kNr;
+  }
+
+  const Vec alpha_vec(alpha);
+  const Vec beta_vec(beta);
+  if (mr == kMr) {
+    for (int64_t j = 0; j < nr; ++j) {
+      T* cj = c + j * ldc;
+      Vec r0 = acc0[j] * alpha_vec;
+      Vec r1 = acc1[j] * alpha_vec;
+      if (beta != T(0)) {
+        r0 = vec::fmadd(Vec::loadu(cj), beta_vec, r0);
+        r1 = vec::fmadd(Vec::loadu(cj + Vec::size()), beta_vec, r1);
+      }
+      r0.store(cj);
+      r1.store(cj + Vec::size());
+    }
+  } else {
+    T tile[kMr];
+    for (int64_t j = 0; j < nr; ++j) {
+      T* cj = c + j * ldc;
+      acc0[j].store(tile);
+      acc1[j].store(tile + Vec::size());
+      for (int64_t i = 0; i < mr; ++i) {
+        cj[i] = beta == T(0) ? alpha * tile[i] : beta * cj[i] + alpha * tile[i];
+      }
+    }
+  }
+}
+
+} // namespace
+
+bool use_packed_gemm(int64_t m, int64_t n, int64_t k) {
+  constexpr int64_t kMinDim = 4;
+  constexpr int64_t kMinWork = 32 * 32 * 32;
+  return m >= kMinDim && n >= kMinDim && m * n * k >= kMinWork;
+}
+
+template <typename scalar_t>
+void gemm_packed_(
+    bool transa,
+    bool transb,
+    int64_t m,
+    int64_t n,
+    int64_t k,
+    scalar_t alpha,
+    const scalar_t* a,
+    int64_t lda,
+    const scalar_t* b,
+    int64_t ldb,
+    scalar_t beta,
+    scalar_t* c,
+    int64_t ldc) {
+  using Blocking = GemmBlocking<scalar_t>;
+  constexpr int64_t kMr = Blocking::kMr;
+  constexpr int64_t kNr = Blocking::kNr;
+  constexpr int64_t kKc = Blocking::kKc;
+  constexpr int64_t kMc = Blocking::kMc;
+  constexpr int64_t kNc = Blocking::kNc;
+  constexpr int64_t kSliversPerTask = Blocking::kSliversPerTask;
+
+  if (m == 0 || n == 0) {
+    return;
+  }
+  if (k == 0 || alpha == scalar_t(0)) {
+    // op(a) and op(b) are not referenced.
+    scale_(m, n, beta, c, ldc);
+    return;
+  }
+
+  std::vector<scalar_t> packed_b(
+      std::min(k, kKc) * std::min(kNc, utils::divup(n, kNr) * kNr));
+  for (int64_t jc = 0; jc < n; jc += kNc) {
+    const int64_t nc = std::min(kNc, n - jc);
+    const int64_t num_slivers = utils::divup(nc, kNr);
+    for (int64_t pc = 0; pc < k; pc += kKc) {
+      const int64_t kc = std::min(kKc, k - pc);
+      // Blocks after the first accumulate onto the partial result in c.
+      const scalar_t block_beta = pc == 0 ? beta : scalar_t(1);
+
+      executorch::extension::parallel_for(
+          0, num_slivers, 1, [&](int64_t begin, int64_t end) {
+            for (int64_t s = begin; s < end; ++s) {
+              pack_b_sliver(
+                  transb,
+                  b,
+                  ldb,
+                  pc,
+                  kc,
+                  jc + s * kNr,
+                  std::min(kNr, nc - s * kNr),
+                  packed_b.data() + s * kc * kNr);
+            }
+          });
+
+      // Tasks are ordered so that consecutive ones share a block of op(a),
+      // which each parallel chunk then packs only once.
+      const int64_t num_row_blocks = utils::divup(m, kMc);
+      const int64_t num_col_groups = utils::divup(num_slivers, kSliversPerTask);
+      executorch::extension::parallel_for(
+          0,
+          num_row_blocks * num_col_groups,
+          1,
+          [&](int64_t begin, int64_t end) {
+            std::vector<scalar_t> packed_a(kMc * kc);
+            int64_t packed_row_block = -1;
+            for (int64_t task = begin; task < end; ++task) {
+              const int64_t row_block = task / num_col_groups;
+              const int64_t col_group = task % num_col_groups;
+              const int64_t ic = row_block * kMc;
+              const int64_t mc = std::min(kMc, m - ic);
+              if (row_block != packed_row_block) {
+                pack_a(transa, a, lda, ic, mc, pc, kc, packed_a.data());
+                packed_row_block = row_block;
+              }
+              const int64_t sliver_end =
+                  std::min(num_slivers, (col_group + 1) * kSliversPerTask);
+              for (int64_t s = col_group * kSliversPerTask; s < sliver_end;
+                   ++s) {
+                const int64_t jr = s * kNr;
+                const scalar_t* bp = packed_b.data() + s * kc * kNr;
+                for (int64_t ir = 0; ir < mc; ir += kMr) {
+                  micro_kernel(
+                      kc,
+                      packed_a.data() + ir * kc,
+                      bp,
+                      c + (ic + ir) + (jc + jr) * ldc,
+                      ldc,
+                      std::min(kMr, mc - ir),
+                      std::min(kNr, nc - jr),
+                      alpha,
+                      block_beta);
+                }
+              }
+            }
+          });
+    }
+  }
+}
+
+// clang-format off
+template void gemm_packed_<float>(
+    bool transa, bool transb,
+    int64_t m, int64_t n, int64_t k,
+    float alpha,
+    const float *a, int64_t lda,
+    const float *b, int64_t ldb,
+    float beta,
+    float *c, int64_t ldc);
+template void gemm_packed_<double>(
+    bool transa, bool transb,
+    int64_t m, int64_t n, int64_t k,
+    double alpha,
+    const double *a, int64_t lda,
+    const double *b, int64_t ldb,
+    double beta,
+    double *c, int64_t ldc);
+// clang-format on
+
+} // namespace cpublas
+} // namespace executorch
@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace executorch {
+namespace cpublas {
+
+/**
+ * Returns whether gemm_packed_() is expected to be faster than the unpacked
+ * gemm_*_ loops in BlasKernel.h for a problem of the given size. Packing has a
+ * fixed cost per block that only pays off once the operands are large enough
+ * and neither output dimension is degenerate (i.e. the problem is not a
+ * matrix-vector product).
+ */
+bool use_packed_gemm(int64_t m, int64_t n, int64_t k);
+
+/**
+ * Column-major GEMM, c = alpha * op(a) @ op(b) + beta * c, using GotoBLAS-style
+ * packing and cache blocking.
+ *
+ * op(b) is split into column panels sized for the last-level cache and op(a)
+ * into row blocks sized for L2. Each block is copied into a contiguous buffer
+ * laid out in the order the Vectorized microkernel reads it, which then
+ * computes register-resident tiles of c. Tiles of each panel are computed in
+ * parallel with parallel_for().
+ *
+ * Only instantiated for float and double. When beta is zero, c is not read.
+ *
+ * @param[in] transa Whether op(a) is a.T.
+ * @param[in] transb Whether op(b) is b.T.
+ */
+template <typename scalar_t>
+void gemm_packed_(
+    bool transa,
+    bool transb,
+    int64_t m,
+    int64_t n,
+    int64_t k,
+    scalar_t alpha,
+    const scalar_t* a,
+    int64_t lda,
+    const scalar_t* b,
+    int64_t ldb,
+    scalar_t beta,
+    scalar_t* c,
+    int64_t ldc);
+
+} // namespace cpublas
+} // namespace executorch
@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// This file is compiled once per CPU capability level; keep its dependencies
+// limited to the vec library. See dispatch_stub.h.
+
+#include <executorch/kernels/optimized/cpu/binary_ops_kernel.h>
+
+#include <executorch/kernels/optimized/vec/functional.h>
+#include <executorch/kernels/optimized/vec/vec.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+namespace {
+
+template <typename CTYPE, typename Op>
+void map2_typed(
+    const void* a,
+    const void* b,
+    void* out,
+    size_t numel,
+    const Op& op) {
+  executorch::vec::map2<CTYPE>(
+      op,
+      static_cast<CTYPE*>(out),
+      static_cast<const CTYPE*>(a),
+      static_cast<const CTYPE*>(b),
+      static_cast<int64_t>(numel));
+}
+
+template <typename Op>
+void map2_floating(
+    exec_aten::ScalarType dtype,
+    const void* a,
+    const void* b,
+    void* out,
+    size_t numel,
+    const Op& op) {
+  if (dtype == exec_aten::ScalarType::Double) {
+    map2_typed<double>(a, b, out, numel, op);
+  } else {
+    map2_typed<float>(a, b, out, numel, op);
+  }
+}
+
+// Splats alpha, cast to the element type of Vec like extract_scalar() would.
+template <typename Vec>
+Vec splat(double alpha) {
+  return Vec(static_cast<typename Vec::value_type>(alpha));
+}
+
+void add_kernel(
+    exec_aten::ScalarType dtype,
+    const void* a,
+    const void* b,
+    double alpha,
+    void* out,
+    size_t numel) {
+  map2_floating(dtype, a, b, out, numel, [alpha](auto x, auto y) {
+    return x + splat<decltype(x)>(alpha) * y;
+  });
+}
+
+void sub_kernel(
+    exec_aten::ScalarType dtype,
+    const void* a,
+    const void* b,
+    double alpha,
+    void* out,
+    size_t numel) {
+  map2_floating(dtype, a, b, out, numel, [alpha](auto x, auto y) {
+    return x - splat<decltype(x)>(alpha) * y;
+  });
+}
+
+void mul_kernel(
+    exec_aten::ScalarType dtype,
+    const void* a,
+    const void* b,
+    void* out,
+    size_t numel) {
+  map2_floating(dtype, a, b, out, numel, [](auto x, auto y) { return x * y; });
+}
+
+void div_kernel(
+    exec_aten::ScalarType dtype,
+    const void* a,
+    const void* b,
+    void* out,
+    size_t numel) {
+  map2_floating(dtype, a, b, out, numel, [](auto x, auto y) { return x / y; });
+}
+
+} // namespace
+
+REGISTER_DISPATCH(add_stub, &add_kernel);
+REGISTER_DISPATCH(sub_stub, &sub_kernel);
+REGISTER_DISPATCH(mul_stub, &mul_kernel);
+REGISTER_DISPATCH(div_stub, &div_kernel);
+
+} // namespace native
+} // namespace executor
+} // namespace torch
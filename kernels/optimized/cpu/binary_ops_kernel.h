@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+#include <executorch/kernels/optimized/utils/dispatch_stub.h>
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+/**
+ * Computes out[i] = f(a[i], b[i]) for numel contiguous elements of dtype, which
+ * must be Float or Double.
+ */
+using binary_fn = void (*)(
+    exec_aten::ScalarType dtype,
+    const void* a,
+    const void* b,
+    void* out,
+    size_t numel);
+
+/**
+ * Computes out[i] = f(a[i], alpha * b[i]) for numel contiguous elements of
+ * dtype, which must be Float or Double. alpha is cast to dtype first.
+ */
+using binary_alpha_fn = void (*)(
+    exec_aten::ScalarType dtype,
+    const void* a,
+    const void* b,
+    double alpha,
+    void* out,
+    size_t numel);
+
+// Kernels are in binary_ops_kernel.cpp, which is compiled once per CPU
+// capability level. See dispatch_stub.h.
+DECLARE_DISPATCH(binary_alpha_fn, add_stub);
+DECLARE_DISPATCH(binary_alpha_fn, sub_stub);
+DECLARE_DISPATCH(binary_fn, mul_stub);
+DECLARE_DISPATCH(binary_fn, div_stub);
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -7,6 +7,7 @@
  */
 
 #include <executorch/kernels/optimized/cpu/binary_ops.h>
+#include <executorch/kernels/optimized/cpu/binary_ops_kernel.h>
 #include <executorch/kernels/optimized/vec/functional.h>
 #include <executorch/kernels/optimized/vec/vec.h>
 #include <executorch/kernels/portable/cpu/scalar_utils.h>
@@ -17,6 +18,9 @@
 namespace torch {
 namespace executor {
 namespace native {
+
+DEFINE_DISPATCH(add_stub);
+
 namespace {
 
 template <
@@ -131,13 +135,24 @@ Tensor& opt_add_out(
       ET_KERNEL_CHECK(
           ctx, utils::extract_scalar(alpha, &alpha_val), InvalidArgument, );
 
-      using Vec = executorch::vec::Vectorized<CTYPE>;
-      executorch::vec::map2<CTYPE>(
-          [alpha_val](Vec x, Vec y) { return x + Vec(alpha_val) * y; },
-          out.mutable_data_ptr<CTYPE>(),
-          a.const_data_ptr<CTYPE>(),
-          b.const_data_ptr<CTYPE>(),
-          out.numel());
+      if constexpr (
+          std::is_same_v<CTYPE, float> || std::is_same_v<CTYPE, double>) {
+        add_stub(
+            a_type,
+            a.const_data_ptr<CTYPE>(),
+            b.const_data_ptr<CTYPE>(),
+            static_cast<double>(alpha_val),
+            out.mutable_data_ptr<CTYPE>(),
+            out.numel());
+      } else {
+        using Vec = executorch::vec::Vectorized<CTYPE>;
+        executorch::vec::map2<CTYPE>(
+            [alpha_val](Vec x, Vec y) { return x + Vec(alpha_val) * y; },
+            out.mutable_data_ptr<CTYPE>(),
+            a.const_data_ptr<CTYPE>(),
+            b.const_data_ptr<CTYPE>(),
+            out.numel());
+      }
     });
   } else if (selected_optimized_path != ElementwiseOptimizedPath::kNone) {
     const Tensor* lhs;
@@ -0,0 +1,755 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <algorithm>
+#include <type_traits>
+#include <vector>
+
+#include <executorch/extension/parallel/thread_parallel.h>
+#include <executorch/kernels/optimized/blas/CPUBlas.h>
+#include <executorch/kernels/optimized/vec/functional.h>
+#include <executorch/kernels/optimized/vec/vec.h>
+#include <executorch/kernels/portable/cpu/util/dtype_util.h>
+#include <executorch/kernels/portable/cpu/util/kernel_ops_util.h>
+#include <executorch/runtime/core/exec_aten/util/dim_order_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+// `convolution.out` lowers every convolution to one of three kernels:
+//
+// - Depthwise convolutions (groups == in channels == out channels) are
+//   computed directly, vectorized along the contiguous dimension: output
+//   width for contiguous tensors, channels for channels-last tensors.
+// - Other convolutions unfold the input into a column buffer (im2col) and
+//   multiply it by the weight with cpublas::gemm. 1x1 convolutions with unit
+//   stride skip the unfolding, since the input already is that matrix.
+// - Transposed convolutions multiply the input by the weight with
+//   cpublas::gemm and scatter-add the result into the output (col2im).
+//
+// Contiguous (NCHW) and channels-last (NHWC) dim orders are both supported.
+// 1D convolutions are computed as 2D convolutions with a height of 1.
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = exec_aten::Tensor;
+using ScalarType = exec_aten::ScalarType;
+using IntArrayRef = exec_aten::ArrayRef<int64_t>;
+
+namespace {
+
+using executorch::cpublas::TransposeType;
+
+// Number of elements in each im2col buffer. Output tiles are sized so that
+// their column buffer fits in a per-core cache.
+constexpr int64_t kColBufferElements = 1 << 16;
+
+// Lower bound on the number of output pixels in a tile, to keep the gemm
+// shapes efficient.
+constexpr int64_t kMinTilePixels = 64;
+
+/**
+ * Element strides of the N, C, H and W dimensions of a 4D tensor. For the
+ * weight these are the out channel, in channel, height and width dimensions.
+ */
+struct Strides4D {
+  int64_t n;
+  int64_t c;
+  int64_t h;
+  int64_t w;
+};
+
+struct ConvParams {
+  int64_t batch;
+  int64_t in_c;
+  int64_t in_h;
+  int64_t in_w;
+  int64_t out_c;
+  int64_t out_h;
+  int64_t out_w;
+  int64_t k_h;
+  int64_t k_w;
+  int64_t stride_h;
+  int64_t stride_w;
+  int64_t pad_h;
+  int64_t pad_w;
+  int64_t dil_h;
+  int64_t dil_w;
+  int64_t groups;
+  bool channels_last;
+};
+
+/**
+ * Returns the sizes and element strides of `t` as a 4D tensor, inserting a
+ * unit height dimension into 3D tensors.
+ */
+void get_4d_sizes_and_strides(
+    const Tensor& t,
+    exec_aten::SizesType sizes[kTensorDimensionLimit],
+    exec_aten::DimOrderType dim_order[kTensorDimensionLimit],
+    Strides4D& strides) {
+  size_t ndim = t.dim();
+  if (t.dim() == 3) {
+    get_unsqueezed_sizes(t, 2, sizes, ndim);
+    get_unsqueezed_dim_order(t, 2, dim_order);
+  } else {
+    std::copy(t.sizes().begin(), t.sizes().end(), sizes);
+    std::copy(t.dim_order().begin(), t.dim_order().end(), dim_order);
+  }
+  exec_aten::StridesType strides_arr[kTensorDimensionLimit];
+  dim_order_to_stride_nocheck(sizes, dim_order, ndim, strides_arr);
+  strides = {strides_arr[0], strides_arr[1], strides_arr[2], strides_arr[3]};
+}
+
+int64_t divup(int64_t x, int64_t y) {
+  return (x + y - 1) / y;
+}
+
+/**
+ * Copies the weight of group convolution into a [out_c][K] matrix, where K
+ * enumerates (in channel, kernel y, kernel x) for contiguous tensors and
+ * (kernel y, kernel x, in channel) for channels-last tensors, to match the
+ * order of the column buffer. Returns the weight itself if it is already in
+ * that layout.
+ */
+template <typename CTYPE>
+const CTYPE* pack_weight(
+    const ConvParams& p,
+    const CTYPE* weight,
+    const Strides4D& ws,
+    std::vector<CTYPE>& buffer) {
+  const int64_t in_c_per_group = p.in_c / p.groups;
+  const int64_t k = in_c_per_group * p.k_h * p.k_w;
+  if (!p.channels_last && ws.n == k && ws.c == p.k_h * p.k_w &&
+      ws.h == p.k_w && ws.w == 1) {
+    return weight;
+  }
+  if (p.channels_last && ws.n == k && ws.c == 1 &&
+      ws.h == p.k_w * in_c_per_group && ws.w == in_c_per_group) {
+    return weight;
+  }
+  buffer.resize(p.out_c * k);
+  CTYPE* dst = buffer.data();
+  for (int64_t oc = 0; oc < p.out_c; ++oc) {
+    const CTYPE* w_oc = weight + oc * ws.n;
+    if (p.channels_last) {
+      for (int64_t kh = 0; kh < p.k_h; ++kh) {
+        for (int64_t kw = 0; kw < p.k_w; ++kw) {
+          for (int64_t ic = 0; ic < in_c_per_group; ++ic) {
+            *dst++ = w_oc[ic * ws.c + kh * ws.h + kw * ws.w];
+          }
+        }
+      }
+    } else {
+      for (int64_t ic = 0; ic < in_c_per_group; ++ic) {
+        for (int64_t kh = 0; kh < p.k_h; ++kh) {
+          for (int64_t kw = 0; kw < p.k_w; ++kw) {
+            *dst++ = w_oc[ic * ws.c + kh * ws.h + kw * ws.w];
+          }
+        }
+      }
+    }
+  }
+  return buffer.data();
+}
+
+/**
+ * Unfolds the input patches of `num_pixels` output pixels, starting at
+ * `pixel_begin`, into col[k][pixel] for a contiguous input of one batch and
+ * group.
+ */
+template <typename CTYPE>
+void im2col_nchw(
+    const ConvParams& p,
+    const CTYPE* in,
+    const Strides4D& is,
+    int64_t pixel_begin,
+    int64_t num_pixels,
+    CTYPE* col) {
+  const int64_t in_c_per_group = p.in_c / p.groups;
+  for (int64_t ic = 0; ic < in_c_per_group; ++ic) {
+    const CTYPE* in_c = in + ic * is.c;
+    for (int64_t kh = 0; kh < p.k_h; ++kh) {
+      for (int64_t kw = 0; kw < p.k_w; ++kw) {
+        int64_t oh = pixel_begin / p.out_w;
+        int64_t ow = pixel_begin % p.out_w;
+        for (int64_t t = 0; t < num_pixels; ++t) {
+          const int64_t ih = oh * p.stride_h - p.pad_h + kh * p.dil_h;
+          const int64_t iw = ow * p.stride_w - p.pad_w + kw * p.dil_w;
+          col[t] = (ih >= 0 && ih < p.in_h && iw >= 0 && iw < p.in_w)
+              ? in_c[ih * is.h + iw * is.w]
+              : static_cast<CTYPE>(0);
+          if (++ow == p.out_w) {
+            ow = 0;
+            ++oh;
+          }
+        }
+        col += num_pixels;
+      }
+    }
+  }
+}
+
+/**
+ * Channels-last counterpart of im2col_nchw, which unfolds into
+ * col[pixel][k] so that each kernel tap copies a run of channels.
+ */
+template <typename CTYPE>
+void im2col_nhwc(
+    const ConvParams& p,
+    const CTYPE* in,
+    const Strides4D& is,
+    int64_t pixel_begin,
+    int64_t num_pixels,
+    CTYPE* col) {
+  const int64_t in_c_per_group = p.in_c / p.groups;
+  int64_t oh = pixel_begin / p.out_w;
+  int64_t ow = pixel_begin % p.out_w;
+  for (int64_t t = 0; t < num_pixels; ++t) {
+    for (int64_t kh = 0; kh < p.k_h; ++kh) {
+      const int64_t ih = oh * p.stride_h - p.pad_h + kh * p.dil_h;
+      for (int64_t kw = 0; kw < p.k_w; ++kw) {
+        const int64_t iw = ow * p.stride_w - p.pad_w + kw * p.dil_w;
+        if (ih >= 0 && ih < p.in_h && iw >= 0 && iw < p.in_w) {
+          const CTYPE* src = in + ih * is.h + iw * is.w;
+          std::copy(src, src + in_c_per_group, col);
+        } else {
+          std::fill(col, col + in_c_per_group, static_cast<CTYPE>(0));
+        }
+        col += in_c_per_group;
+      }
+    }
+    if (++ow == p.out_w) {
+      ow = 0;
+      ++oh;
+    }
+  }
+}
+
+template <typename CTYPE>
+void conv2d_gemm(
+    const ConvParams& p,
+    const CTYPE* in,
+    const Strides4D& is,
+    const CTYPE* weight,
+    const Strides4D& ws,
+    const CTYPE* bias,
+    CTYPE* out,
+    const Strides4D& os) {
+  const int64_t in_c_per_group = p.in_c / p.groups;
+  const int64_t out_c_per_group = p.out_c / p.groups;
+  const int64_t k = in_c_per_group * p.k_h * p.k_w;
+  const int64_t out_hw = p.out_h * p.out_w;
+  const bool is_1x1 = p.k_h == 1 && p.k_w == 1 && p.stride_h == 1 &&
+      p.stride_w == 1 && p.pad_h == 0 && p.pad_w == 0;
+
+  std::vector<CTYPE> packed_weight;
+  const CTYPE* w = pack_weight(p, weight, ws, packed_weight);
+
+  const int64_t tile = std::clamp(
+      kColBufferElements / k, std::min(out_hw, kMinTilePixels), out_hw);
+  const int64_t num_tiles = divup(out_hw, tile);
+
+  executorch::extension::parallel_for(
+      0,
+      p.batch * p.groups * num_tiles,
+      1,
+      [&](int64_t begin, int64_t end) {
+        std::vector<CTYPE> col;
+        if (!is_1x1) {
+          col.resize(k * tile);
+        }
+        for (int64_t task = begin; task < end; ++task) {
+          const int64_t n = task / (p.groups * num_tiles);
+          const int64_t g = (task / num_tiles) % p.groups;
+          const int64_t pixel_begin = (task % num_tiles) * tile;
+          const int64_t num_pixels = std::min(tile, out_hw - pixel_begin);
+
+          const CTYPE* in_g = in + n * is.n + g * in_c_per_group * is.c;
+          const CTYPE* w_g = w + g * out_c_per_group * k;
+          const int64_t oc_begin = g * out_c_per_group;
+
+          // cpublas::gemm is column-major. For contiguous tensors the output
+          // tile is out[oc][pixel] = sum_k w[oc][k] * col[k][pixel]; for
+          // channels-last tensors it is its transpose, out[pixel][oc].
+          if (!p.channels_last) {
+            const CTYPE* a = in_g + pixel_begin;
+            int64_t lda = is.c;
+            if (!is_1x1) {
+              im2col_nchw(p, in_g, is, pixel_begin, num_pixels, col.data());
+              a = col.data();
+              lda = num_pixels;
+            }
+            CTYPE* c = out + n * os.n + oc_begin * os.c + pixel_begin;
+            executorch::cpublas::gemm(
+                TransposeType::NoTranspose,
+                TransposeType::NoTranspose,
+                num_pixels,
+                out_c_per_group,
+                k,
+                static_cast<CTYPE>(1),
+                a,
+                lda,
+                w_g,
+                k,
+                static_cast<CTYPE>(0),
+                c,
+                os.c);
+            if (bias != nullptr) {
+              for (int64_t oc = 0; oc < out_c_per_group; ++oc) {
+                CTYPE* c_oc = c + oc * os.c;
+                const CTYPE b = bias[oc_begin + oc];
+                for (int64_t t = 0; t < num_pixels; ++t) {
+                  c_oc[t] += b;
+                }
+              }
+            }
+          } else {
+            const CTYPE* b = in_g + pixel_begin * is.w;
+            int64_t ldb = is.w;
+            if (!is_1x1) {
+              im2col_nhwc(p, in_g, is, pixel_begin, num_pixels, col.data());
+              b = col.data();
+              ldb = k;
+            }
+            CTYPE* c = out + n * os.n + pixel_begin * os.w + oc_begin;
+            executorch::cpublas::gemm(
+                TransposeType::Transpose,
+                TransposeType::NoTranspose,
+                out_c_per_group,
+                num_pixels,
+                k,
+                static_cast<CTYPE>(1),
+                w_g,
+                k,
+                b,
+                ldb,
+                static_cast<CTYPE>(0),
+                c,
+                os.w);
+            if (bias != nullptr) {
+              for (int64_t t = 0; t < num_pixels; ++t) {
+                CTYPE* c_t = c + t * os.w;
+                for (int64_t oc = 0; oc < out_c_per_group; ++oc) {
+                  c_t[oc] += bias[oc_begin + oc];
+                }
+              }
+            }
+          }
+        }
+      });
+}
+
+/**
+ * Returns the range [begin, end) of output columns whose input column
+ * out * stride + offset lies in [0, size).
+ */
+std::pair<int64_t, int64_t>
+valid_output_range(int64_t offset, int64_t stride, int64_t size, int64_t out) {
+  const int64_t begin = offset >= 0 ? 0 : divup(-offset, stride);
+  const int64_t end =
+      size - 1 - offset < 0 ? 0 : (size - 1 - offset) / stride + 1;
+  return {std::min(begin, out), std::min(end, out)};
+}
+
+template <typename CTYPE>
+void depthwise_conv2d_nchw(
+    const ConvParams& p,
+    const CTYPE* in,
+    const Strides4D& is,
+    const CTYPE* weight,
+    const Strides4D& ws,
+    const CTYPE* bias,
+    CTYPE* out,
+    const Strides4D& os) {
+  executorch::extension::parallel_for(
+      0, p.batch * p.out_c, 1, [&](int64_t begin, int64_t end) {
+        for (int64_t plane = begin; plane < end; ++plane) {
+          const int64_t n = plane / p.out_c;
+          const int64_t c = plane % p.out_c;
+          const CTYPE* in_plane = in + n * is.n + c * is.c;
+          const CTYPE* w_plane = weight + c * ws.n;
+          CTYPE* out_plane = out + n * os.n + c * os.c;
+          const CTYPE b = bias != nullptr ? bias[c] : static_cast<CTYPE>(0);
+
+          for (int64_t oh = 0; oh < p.out_h; ++oh) {
+            CTYPE* out_row = out_plane + oh * os.h;
+            std::fill(out_row, out_row + p.out_w, b);
+            for (int64_t kh = 0; kh < p.k_h; ++kh) {
+              const int64_t ih = oh * p.stride_h - p.pad_h + kh * p.dil_h;
+              if (ih < 0 || ih >= p.in_h) {
+                continue;
+              }
+              const CTYPE* in_row = in_plane + ih * is.h;
+              for (int64_t kw = 0; kw < p.k_w; ++kw) {
+                const CTYPE w_val = w_plane[kh * ws.h + kw * ws.w];
+                const int64_t offset = kw * p.dil_w - p.pad_w;
+                const auto [ow_begin, ow_end] =
+                    valid_output_range(offset, p.stride_w, p.in_w, p.out_w);
+                int64_t ow = ow_begin;
+                if constexpr (std::is_floating_point_v<CTYPE>) {
+                  if (p.stride_w == 1) {
+                    using Vec = executorch::vec::Vectorized<CTYPE>;
+                    const Vec w_vec(w_val);
+                    for (; ow + Vec::size() <= ow_end; ow += Vec::size()) {
+                      executorch::vec::fmadd(
+                          w_vec,
+                          Vec::loadu(in_row + ow + offset),
+                          Vec::loadu(out_row + ow))
+                          .store(out_row + ow);
+                    }
+                  }
+                }
+                for (; ow < ow_end; ++ow) {
+                  out_row[ow] += w_val * in_row[ow * p.stride_w + offset];
+                }
+              }
+            }
+          }
+        }
+      });
+}
+
+template <typename CTYPE>
+void depthwise_conv2d_nhwc(
+    const ConvParams& p,
+    const CTYPE* in,
+    const Strides4D& is,
+    const CTYPE* weight,
+    const Strides4D& ws,
+    const CTYPE* bias,
+    CTYPE* out,
+    const Strides4D& os) {
+  using Vec = executorch::vec::Vectorized<CTYPE>;
+  const int64_t channels = p.out_c;
+  const int64_t taps = p.k_h * p.k_w;
+
+  // Lay the weight out as [tap][channel] so that each tap is one vector
+  // load per channel block.
+  std::vector<CTYPE> w_taps(taps * channels);
+  for (int64_t c = 0; c < channels; ++c) {
+    for (int64_t kh = 0; kh < p.k_h; ++kh) {
+      for (int64_t kw = 0; kw < p.k_w; ++kw) {
+        w_taps[(kh * p.k_w + kw) * channels + c] =
+            weight[c * ws.n + kh * ws.h + kw * ws.w];
+      }
+    }
+  }
+
+  executorch::extension::parallel_for(
+      0, p.batch * p.out_h, 1, [&](int64_t begin, int64_t end) {
+        for (int64_t row = begin; row < end; ++row) {
+          const int64_t n = row / p.out_h;
+          const int64_t oh = row % p.out_h;
+          const CTYPE* in_n = in + n * is.n;
+          for (int64_t ow = 0; ow < p.out_w; ++ow) {
+            CTYPE* out_px = out + n * os.n + oh * os.h + ow * os.w;
+            for (int64_t c = 0; c < channels; c += Vec::size()) {
+              const int64_t count =
+                  std::min<int64_t>(Vec::size(), channels - c);
+              Vec acc = bias != nullptr ? Vec::loadu(bias + c, count)
+                                        : Vec(static_cast<CTYPE>(0));
+              for (int64_t kh = 0; kh < p.k_h; ++kh) {
+                const int64_t ih = oh * p.stride_h - p.pad_h + kh * p.dil_h;
+                if (ih < 0 || ih >= p.in_h) {
+                  continue;
+                }
+                for (int64_t kw = 0; kw < p.k_w; ++kw) {
+                  const int64_t iw = ow * p.stride_w - p.pad_w + kw * p.dil_w;
+                  if (iw < 0 || iw >= p.in_w) {
+                    continue;
+                  }
+                  acc = executorch::vec::fmadd(
+                      Vec::loadu(
+                          w_taps.data() + (kh * p.k_w + kw) * channels + c,
+                          count),
+                      Vec::loadu(in_n + ih * is.h + iw * is.w + c, count),
+                      acc);
+                }
+              }
+              acc.store(out_px + c, count);
+            }
+          }
+        }
+      });
+}
+
+template <typename CTYPE>
+void conv_transpose2d_gemm(
+    const ConvParams& p,
+    const CTYPE* in,
+    const Strides4D& is,
+    const CTYPE* weight,
+    const Strides4D& ws,
+    const CTYPE* bias,
+    CTYPE* out,
+    const Strides4D& os) {
+  const int64_t in_c_per_group = p.in_c / p.groups;
+  const int64_t out_c_per_group = p.out_c / p.groups;
+  const int64_t m = out_c_per_group * p.k_h * p.k_w;
+  const int64_t in_hw = p.in_h * p.in_w;
+
+  // The weight is [in_c][out_c_per_group][k_h][k_w]; flatten each in
+  // channel into a row of m elements.
+  std::vector<CTYPE> packed_weight;
+  const CTYPE* w = weight;
+  if (!(ws.n == m && ws.c == p.k_h * p.k_w && ws.h == p.k_w && ws.w == 1)) {
+    packed_weight.resize(p.in_c * m);
+    CTYPE* dst = packed_weight.data();
+    for (int64_t ic = 0; ic < p.in_c; ++ic) {
+      for (int64_t oc = 0; oc < out_c_per_group; ++oc) {
+        for (int64_t kh = 0; kh < p.k_h; ++kh) {
+          for (int64_t kw = 0; kw < p.k_w; ++kw) {
+            *dst++ = weight[ic * ws.n + oc * ws.c + kh * ws.h + kw * ws.w];
+          }
+        }
+      }
+    }
+    w = packed_weight.data();
+  }
+
+  for (int64_t n = 0; n < p.batch; ++n) {
+    for (int64_t oc = 0; oc < p.out_c; ++oc) {
+      const CTYPE b = bias != nullptr ? bias[oc] : static_cast<CTYPE>(0);
+      for (int64_t oh = 0; oh < p.out_h; ++oh) {
+        for (int64_t ow = 0; ow < p.out_w; ++ow) {
+          out[n * os.n + oc * os.c + oh * os.h + ow * os.w] = b;
+        }
+      }
+    }
+  }
+
+  // col[m][pixel] = sum_ic w[ic][m] * in[ic][pixel], computed as its
+  // column-major transpose.
+  std::vector<CTYPE> col(m * in_hw);
+  for (int64_t n = 0; n < p.batch; ++n) {
+    for (int64_t g = 0; g < p.groups; ++g) {
+      const CTYPE* in_g = in + n * is.n + g * in_c_per_group * is.c;
+      executorch::cpublas::gemm(
+          p.channels_last ? TransposeType::Transpose
+                          : TransposeType::NoTranspose,
+          TransposeType::Transpose,
+          in_hw,
+          m,
+          in_c_per_group,
+          static_cast<CTYPE>(1),
+          in_g,
+          p.channels_last ? is.w : is.c,
+          w + g * in_c_per_group * m,
+          m,
+          static_cast<CTYPE>(0),
+          col.data(),
+          in_hw);
+
+      // Each output channel is only written from its own rows of col.
+      executorch::extension::parallel_for(
+          0, out_c_per_group, 1, [&](int64_t begin, int64_t end) {
+            for (int64_t oc = begin; oc < end; ++oc) {
+              CTYPE* out_c =
+                  out + n * os.n + (g * out_c_per_group + oc) * os.c;
+              for (int64_t kh = 0; kh < p.k_h; ++kh) {
+                for (int64_t kw = 0; kw < p.k_w; ++kw) {
+                  const CTYPE* col_row =
+                      col.data() + ((oc * p.k_h + kh) * p.k_w + kw) * in_hw;
+                  for (int64_t ih = 0; ih < p.in_h; ++ih) {
+                    const int64_t oh =
+                        ih * p.stride_h - p.pad_h + kh * p.dil_h;
+                    if (oh < 0 || oh >= p.out_h) {
+                      continue;
+                    }
+                    for (int64_t iw = 0; iw < p.in_w; ++iw) {
+                      const int64_t ow =
+                          iw * p.stride_w - p.pad_w + kw * p.dil_w;
+                      if (ow >= 0 && ow < p.out_w) {
+                        out_c[oh * os.h + ow * os.w] +=
+                            col_row[ih * p.in_w + iw];
+                      }
+                    }
+                  }
+                }
+              }
+            }
+          });
+    }
+  }
+}
+
+template <typename CTYPE>
+void convolution_kernel(
+    const ConvParams& p,
+    const CTYPE* in,
+    const Strides4D& is,
+    const CTYPE* weight,
+    const Strides4D& ws,
+    const CTYPE* bias,
+    CTYPE* out,
+    const Strides4D& os,
+    bool transposed) {
+  if (transposed) {
+    conv_transpose2d_gemm(p, in, is, weight, ws, bias, out, os);
+    return;
+  }
+  const bool is_depthwise =
+      p.groups > 1 && p.groups == p.in_c && p.groups == p.out_c;
+  if (is_depthwise && !p.channels_last) {
+    depthwise_conv2d_nchw(p, in, is, weight, ws, bias, out, os);
+    return;
+  }
+  if constexpr (std::is_floating_point_v<CTYPE>) {
+    if (is_depthwise) {
+      depthwise_conv2d_nhwc(p, in, is, weight, ws, bias, out, os);
+      return;
+    }
+  }
+  conv2d_gemm(p, in, is, weight, ws, bias, out, os);
+}
+
+} // namespace
+
+Tensor& opt_convolution_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    const Tensor& weight,
+    const exec_aten::optional<Tensor>& bias,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    bool transposed,
+    IntArrayRef output_padding,
+    int64_t groups,
+    Tensor& out) {
+  ET_KERNEL_CHECK(
+      ctx,
+      check_convolution_args(
+          in,
+          weight,
+          bias,
+          stride,
+          padding,
+          dilation,
+          transposed,
+          output_padding,
+          groups,
+          out),
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK(
+      ctx, tensors_have_same_dim_order(in, out), InvalidArgument, out);
+
+  size_t output_ndim = 0;
+  exec_aten::SizesType output_sizes[kTensorDimensionLimit];
+  get_convolution_out_target_size(
+      in,
+      weight,
+      stride,
+      padding,
+      dilation,
+      transposed,
+      output_padding,
+      groups,
+      output_sizes,
+      &output_ndim);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      output_size_is_valid({output_sizes, output_ndim}, in.dim() - 2),
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(out, {output_sizes, output_ndim}) == Error::Ok,
+      InvalidArgument,
+      out);
+
+  if (out.numel() == 0) {
+    return out;
+  }
+
+  exec_aten::SizesType in_sizes[kTensorDimensionLimit];
+  exec_aten::DimOrderType in_dim_order[kTensorDimensionLimit];
+  Strides4D in_strides;
+  get_4d_sizes_and_strides(in, in_sizes, in_dim_order, in_strides);
+
+  exec_aten::SizesType w_sizes[kTensorDimensionLimit];
+  exec_aten::DimOrderType w_dim_order[kTensorDimensionLimit];
+  Strides4D w_strides;
+  get_4d_sizes_and_strides(weight, w_sizes, w_dim_order, w_strides);
+
+  exec_aten::SizesType out_sizes[kTensorDimensionLimit];
+  exec_aten::DimOrderType out_dim_order[kTensorDimensionLimit];
+  Strides4D out_strides;
+  get_4d_sizes_and_strides(out, out_sizes, out_dim_order, out_strides);
+
+  const bool channels_last = is_channels_last_dim_order(in_dim_order, 4);
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      channels_last || is_contiguous_dim_order(in_dim_order, 4),
+      InvalidArgument,
+      out,
+      "Input must be in contiguous or channels-last dim order.");
+
+  // A 1D convolution is a 2D convolution with a height of 1, unit stride and
+  // dilation, and no padding along the height.
+  const bool is_1d = in.dim() == 3;
+  ConvParams p;
+  p.batch = in_sizes[0];
+  p.in_c = in_sizes[1];
+  p.in_h = in_sizes[2];
+  p.in_w = in_sizes[3];
+  p.out_c = out_sizes[1];
+  p.out_h = out_sizes[2];
+  p.out_w = out_sizes[3];
+  p.k_h = w_sizes[2];
+  p.k_w = w_sizes[3];
+  p.stride_h = is_1d ? 1 : val_at(stride, 0);
+  p.stride_w = is_1d ? stride[0] : val_at(stride, 1);
+  p.pad_h = is_1d ? 0 : val_at(padding, 0, /*default_value=*/0);
+  p.pad_w = is_1d ? padding[0] : val_at(padding, 1, /*default_value=*/0);
+  p.dil_h = is_1d ? 1 : val_at(dilation, 0);
+  p.dil_w = is_1d ? val_at(dilation, 0) : val_at(dilation, 1);
+  p.groups = groups;
+  p.channels_last = channels_last;
+
+  // @lint-ignore CLANGTIDY facebook-hte-CArray
+  static constexpr const char name[] = "convolution.out";
+
+  ET_SWITCH_REALH_TYPES(in.scalar_type(), ctx, name, CTYPE, [&]() {
+    // The bias may have a different dtype; convert it once up front.
+    std::vector<CTYPE> bias_data;
+    if (bias.has_value()) {
+      const auto load_bias =
+          utils::internal::get_load_to_common_fn<CTYPE, name>(
+              bias.value(), utils::SupportedTensorDtypes::REALHBF16);
+      const char* const bias_ptr =
+          reinterpret_cast<const char*>(bias.value().const_data_ptr());
+      bias_data.resize(p.out_c);
+      for (int64_t oc = 0; oc < p.out_c; ++oc) {
+        bias_data[oc] =
+            load_bias(&bias_ptr[oc * bias.value().element_size()]);
+      }
+    }
+    convolution_kernel<CTYPE>(
+        p,
+        in.const_data_ptr<CTYPE>(),
+        in_strides,
+        weight.const_data_ptr<CTYPE>(),
+        w_strides,
+        bias.has_value() ? bias_data.data() : nullptr,
+        out.mutable_data_ptr<CTYPE>(),
+        out_strides,
+        transposed);
+  });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
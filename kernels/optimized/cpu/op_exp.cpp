@@ -8,19 +8,20 @@
 
 #include <cmath>
 
-#include <executorch/kernels/optimized/vec/functional.h>
-#include <executorch/kernels/optimized/vec/vec.h>
+#include <executorch/kernels/optimized/cpu/unary_ops.h>
 #include <executorch/runtime/kernel/kernel_includes.h>
 
 namespace torch {
 namespace executor {
 namespace native {
 
+DEFINE_DISPATCH(exp_stub);
+
 namespace {
 
 /**
  * Fast path of natural exponential function. When no casting is required, CPU
- * vector intrinsics can be used.
+ * vector intrinsics can be used, with the widest ones the host supports.
  */
 template <
     typename CTYPE_IN,
@@ -34,9 +35,11 @@ void exp_data(
     const CTYPE_IN* in_data,
     const size_t numel,
     CTYPE_OUT* out_data) {
-  using Vec = executorch::vec::Vectorized<CTYPE_IN>;
-  executorch::vec::map<CTYPE_IN>(
-      [](Vec x) { return x.exp(); }, out_data, in_data, numel);
+  exp_stub(
+      CppTypeToScalarType<CTYPE_IN>::value,
+      in_data,
+      out_data,
+      numel);
 }
 
 /**
@@ -6,14 +6,12 @@
  * LICENSE file in the root directory of this source tree.
  */
 
-#ifdef __aarch64__
-#include <arm_neon.h>
-#include <sleef.h>
-#endif
-
 #include <cmath>
 #include <type_traits>
 
+#include <executorch/kernels/optimized/vec/functional.h>
+#include <executorch/kernels/optimized/vec/vec.h>
+#include <executorch/kernels/optimized/vec/vec_math.h>
 #include <executorch/kernels/portable/cpu/util/activation_ops_util.h>
 #include <executorch/runtime/kernel/kernel_includes.h>
 
@@ -66,30 +64,29 @@ void log_softmax_kernel(const Tensor& input, int64_t dim, Tensor& out) {
       }
       // calculate sum and exponential in softmax dim
       OUT_T temp_sum = 0;
-#ifndef __aarch64__
-      for (auto d = 0; d < dim_size; ++d) {
-        output_data[d * dim_stride] =
-            std::exp(input_data[d * dim_stride] - max_input);
-        temp_sum += output_data[d * dim_stride];
-      }
-#else
       auto d = 0;
-      for (; d + 4 < dim_size; d += 4) {
-        auto index = d * dim_stride;
-        float32x4_t in =
-            vld1q_f32(static_cast<const float*>(&input_data[index]));
-        float32x4_t out_ =
-            Sleef_expf4_u10(vsubq_f32(in, vmovq_n_f32(max_input)));
-        vst1q_f32(static_cast<float*>(&output_data[index]), out_);
-        temp_sum += vaddvq_f32(out_);
+      if constexpr (std::is_same_v<IN_T, OUT_T>) {
+        // Elements along the softmax dim are contiguous only when it is the
+        // innermost dim.
+        if (dim_stride == 1) {
+          using Vec = executorch::vec::Vectorized<OUT_T>;
+          const Vec max_vec(max_input);
+          Vec sum_vec(OUT_T(0));
+          for (; d + Vec::size() <= dim_size; d += Vec::size()) {
+            const Vec out_vec =
+                executorch::vec::vec_exp(Vec::loadu(input_data + d) - max_vec);
+            out_vec.store(output_data + d);
+            sum_vec = sum_vec + out_vec;
+          }
+          temp_sum = executorch::vec::vec_reduce_all<OUT_T>(
+              [](Vec& x, Vec& y) { return x + y; }, sum_vec);
+        }
       }
-
       for (; d < dim_size; ++d) {
         output_data[d * dim_stride] =
             std::exp(input_data[d * dim_stride] - max_input);
         temp_sum += output_data[d * dim_stride];
       }
-#endif // __aarch64__
 
       temp_sum = std::log(temp_sum);
 
@@ -7,6 +7,7 @@
  */
 
 #include <executorch/kernels/optimized/cpu/binary_ops.h>
+#include <executorch/kernels/optimized/cpu/binary_ops_kernel.h>
 #include <executorch/kernels/optimized/vec/functional.h>
 #include <executorch/kernels/optimized/vec/vec.h>
 #include <executorch/kernels/portable/cpu/scalar_utils.h>
@@ -19,6 +20,8 @@ namespace torch {
 namespace executor {
 namespace native {
 
+DEFINE_DISPATCH(mul_stub);
+
 using Tensor = exec_aten::Tensor;
 using ScalarType = exec_aten::ScalarType;
 
@@ -229,13 +232,23 @@ Tensor& opt_mul_out(
         "Failed to resize output tensor.");
 
     ET_SWITCH_REALB_TYPES(out_type, ctx, "mul.out", CTYPE, [&]() {
-      using Vec = executorch::vec::Vectorized<CTYPE>;
-      executorch::vec::map2<CTYPE>(
-          [](Vec x, Vec y) { return x * y; },
-          out.mutable_data_ptr<CTYPE>(),
-          a.const_data_ptr<CTYPE>(),
-          b.const_data_ptr<CTYPE>(),
-          out.numel());
+      if constexpr (
+          std::is_same_v<CTYPE, float> || std::is_same_v<CTYPE, double>) {
+        mul_stub(
+            out_type,
+            a.const_data_ptr<CTYPE>(),
+            b.const_data_ptr<CTYPE>(),
+            out.mutable_data_ptr<CTYPE>(),
+            out.numel());
+      } else {
+        using Vec = executorch::vec::Vectorized<CTYPE>;
+        executorch::vec::map2<CTYPE>(
+            [](Vec x, Vec y) { return x * y; },
+            out.mutable_data_ptr<CTYPE>(),
+            a.const_data_ptr<CTYPE>(),
+            b.const_data_ptr<CTYPE>(),
+            out.numel());
+      }
     });
   } else if (selected_optimized_path != ElementwiseOptimizedPath::kNone) {
     return handle_broadcast_mul(ctx, a, b, out, selected_optimized_path);
@@ -0,0 +1,248 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+
+#include <executorch/extension/parallel/thread_parallel.h>
+#include <executorch/kernels/optimized/vec/functional.h>
+#include <executorch/kernels/optimized/vec/vec.h>
+#include <executorch/kernels/optimized/vec/vec_math.h>
+#include <executorch/kernels/portable/cpu/util/activation_ops_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+// `_softmax_out` applies the Softmax function along one dimension of an
+// n-dimensional input Tensor, so that the elements of each slice along that
+// dimension lie in [0, 1] and sum to 1.
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = exec_aten::Tensor;
+
+namespace {
+
+int64_t grain_size_for(int64_t elements_per_item) {
+  return std::max<int64_t>(
+      1,
+      ::executorch::extension::kMinElementsPerTask /
+          std::max<int64_t>(1, elements_per_item));
+}
+
+/**
+ * Softmax over the innermost, contiguous dimension: each row of `dim_size`
+ * elements is reduced with full-width vectors.
+ */
+template <typename CTYPE>
+void softmax_lastdim_kernel(
+    const CTYPE* __restrict__ in_data,
+    CTYPE* __restrict__ out_data,
+    int64_t outer_size,
+    int64_t dim_size) {
+  using Vec = executorch::vec::Vectorized<CTYPE>;
+  executorch::extension::parallel_for(
+      0,
+      outer_size,
+      grain_size_for(dim_size),
+      [&](int64_t begin, int64_t end) {
+        for (int64_t row = begin; row < end; ++row) {
+          const CTYPE* input = in_data + row * dim_size;
+          CTYPE* output = out_data + row * dim_size;
+
+          // Each value is offset by the row maximum before calling exp to
+          // preserve numerical stability.
+          const CTYPE max_input = executorch::vec::reduce_all<CTYPE>(
+              [](Vec& x, Vec& y) { return executorch::vec::maximum(x, y); },
+              input,
+              dim_size);
+
+          const Vec max_vec(max_input);
+          Vec sum_vec(CTYPE(0));
+          int64_t d = 0;
+          for (; d + Vec::size() <= dim_size; d += Vec::size()) {
+            Vec exp_vec =
+                executorch::vec::vec_exp(Vec::loadu(input + d) - max_vec);
+            exp_vec.store(output + d);
+            sum_vec = sum_vec + exp_vec;
+          }
+          CTYPE sum = executorch::vec::vec_reduce_all<CTYPE>(
+              [](Vec& x, Vec& y) { return x + y; }, sum_vec);
+          for (; d < dim_size; ++d) {
+            output[d] = std::exp(input[d] - max_input);
+            sum += output[d];
+          }
+
+          const Vec scale_vec(CTYPE(1) / sum);
+          executorch::vec::map<CTYPE>(
+              [scale_vec](Vec x) { return x * scale_vec; },
+              output,
+              output,
+              dim_size);
+        }
+      });
+}
+
+/**
+ * Softmax over a non-innermost dimension. Elements that are adjacent in the
+ * inner dimensions are independent, so each vector lane handles one of them
+ * while stepping over the softmax dimension with stride `inner_size`.
+ */
+template <typename CTYPE>
+void softmax_strided_kernel(
+    const CTYPE* __restrict__ in_data,
+    CTYPE* __restrict__ out_data,
+    int64_t outer_size,
+    int64_t dim_size,
+    int64_t inner_size) {
+  using Vec = executorch::vec::Vectorized<CTYPE>;
+  const int64_t vec_size = Vec::size();
+  const int64_t num_chunks = (inner_size + vec_size - 1) / vec_size;
+  const int64_t outer_stride = dim_size * inner_size;
+
+  executorch::extension::parallel_for(
+      0,
+      outer_size * num_chunks,
+      grain_size_for(dim_size * vec_size),
+      [&](int64_t begin, int64_t end) {
+        for (int64_t task = begin; task < end; ++task) {
+          const int64_t outer_idx = task / num_chunks;
+          const int64_t inner_idx = (task % num_chunks) * vec_size;
+          const int64_t count = std::min(vec_size, inner_size - inner_idx);
+          const CTYPE* input = in_data + outer_idx * outer_stride + inner_idx;
+          CTYPE* output = out_data + outer_idx * outer_stride + inner_idx;
+
+          Vec max_vec = Vec::loadu(input, count);
+          for (int64_t d = 1; d < dim_size; ++d) {
+            max_vec = executorch::vec::maximum(
+                max_vec, Vec::loadu(input + d * inner_size, count));
+          }
+
+          Vec sum_vec(CTYPE(0));
+          for (int64_t d = 0; d < dim_size; ++d) {
+            Vec exp_vec = executorch::vec::vec_exp(
+                Vec::loadu(input + d * inner_size, count) - max_vec);
+            exp_vec.store(output + d * inner_size, count);
+            sum_vec = sum_vec + exp_vec;
+          }
+
+          // Lanes past `count` load zeros, so their sum is dim_size and the
+          // reciprocal stays finite.
+          const Vec scale_vec = Vec(CTYPE(1)) / sum_vec;
+          for (int64_t d = 0; d < dim_size; ++d) {
+            (Vec::loadu(output + d * inner_size, count) * scale_vec)
+                .store(output + d * inner_size, count);
+          }
+        }
+      });
+}
+
+/**
+ * Fallback for reduced-precision types, which have no Vectorized
+ * specialization. Accumulates in float.
+ */
+template <typename CTYPE>
+void softmax_scalar_kernel(
+    const CTYPE* in_data,
+    CTYPE* out_data,
+    int64_t outer_size,
+    int64_t dim_size,
+    int64_t inner_size) {
+  const int64_t outer_stride = dim_size * inner_size;
+  for (int64_t outer_idx = 0; outer_idx < outer_size; ++outer_idx) {
+    for (int64_t inner_idx = 0; inner_idx < inner_size; ++inner_idx) {
+      const CTYPE* input = in_data + outer_idx * outer_stride + inner_idx;
+      CTYPE* output = out_data + outer_idx * outer_stride + inner_idx;
+
+      float max_input = static_cast<float>(input[0]);
+      for (int64_t d = 1; d < dim_size; ++d) {
+        max_input =
+            std::max(max_input, static_cast<float>(input[d * inner_size]));
+      }
+      float sum = 0;
+      for (int64_t d = 0; d < dim_size; ++d) {
+        sum += std::exp(static_cast<float>(input[d * inner_size]) - max_input);
+      }
+      for (int64_t d = 0; d < dim_size; ++d) {
+        output[d * inner_size] = static_cast<CTYPE>(
+            std::exp(static_cast<float>(input[d * inner_size]) - max_input) /
+            sum);
+      }
+    }
+  }
+}
+
+template <typename CTYPE>
+void softmax_kernel(const Tensor& in, int64_t dim, Tensor& out) {
+  const CTYPE* const in_data = in.const_data_ptr<CTYPE>();
+  CTYPE* const out_data = out.mutable_data_ptr<CTYPE>();
+
+  if (in.numel() == 0) {
+    return;
+  }
+
+  const int64_t dim_size = in.dim() == 0 ? 1 : in.size(dim);
+  int64_t outer_size = 1;
+  int64_t inner_size = 1;
+  for (int64_t i = 0; i < dim; ++i) {
+    outer_size *= in.size(i);
+  }
+  for (int64_t i = dim + 1; i < in.dim(); ++i) {
+    inner_size *= in.size(i);
+  }
+
+  if constexpr (std::is_floating_point_v<CTYPE>) {
+    if (inner_size == 1) {
+      softmax_lastdim_kernel(in_data, out_data, outer_size, dim_size);
+    } else {
+      softmax_strided_kernel(
+          in_data, out_data, outer_size, dim_size, inner_size);
+    }
+  } else {
+    softmax_scalar_kernel(in_data, out_data, outer_size, dim_size, inner_size);
+  }
+}
+
+} // namespace
+
+// _softmax.out(Tensor self, int dim, bool half_to_float, *, Tensor(a!) out)
+// -> Tensor(a!)
+Tensor& opt_softmax_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    int64_t dim,
+    bool half_to_float,
+    Tensor& out) {
+  (void)ctx;
+
+  ET_KERNEL_CHECK(
+      ctx,
+      check_softmax_args(in, dim, half_to_float, out),
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK(
+      ctx, resize_tensor(out, in.sizes()) == Error::Ok, InvalidArgument, out);
+
+  ET_KERNEL_CHECK(
+      ctx, tensors_have_same_dim_order(in, out), InvalidArgument, out);
+
+  // Adjust for negative dim
+  dim = dim < 0 ? dim + nonzero_dim(in) : dim;
+
+  ET_SWITCH_FLOATH_TYPES(in.scalar_type(), ctx, "_softmax.out", CTYPE, [&]() {
+    softmax_kernel<CTYPE>(in, dim, out);
+  });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
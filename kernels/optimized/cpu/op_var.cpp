@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <cmath>
+
+#include <executorch/kernels/optimized/cpu/reduce_ops.h>
+#include <executorch/kernels/portable/cpu/scalar_utils.h>
+#include <executorch/kernels/portable/cpu/util/reduce_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = exec_aten::Tensor;
+using ScalarType = exec_aten::ScalarType;
+
+namespace {
+
+/**
+ * Two passes over the input: the first writes the mean of each output into
+ * `out`, the second replaces it with the sum of squared deviations from that
+ * mean divided by `denominator`.
+ */
+template <typename CTYPE_IN, typename CTYPE_OUT>
+void compute_variance(
+    const Tensor& in,
+    Tensor& out,
+    optional<ArrayRef<int64_t>> dim_list,
+    const size_t num,
+    const double denominator) {
+  CTYPE_OUT* out_data = out.mutable_data_ptr<CTYPE_OUT>();
+  if (num == 0 || denominator <= 0) {
+    for (ssize_t out_ix = 0; out_ix < out.numel(); ++out_ix) {
+      out_data[out_ix] = NAN;
+    }
+    return;
+  }
+
+  parallel_map_reduce_over_dim_list<
+      CTYPE_IN,
+      CTYPE_OUT,
+      reduce::SumOp<CTYPE_OUT>>(
+      in,
+      dim_list,
+      nullptr,
+      [](auto v, auto) { return v; },
+      [&](int64_t out_ix, CTYPE_OUT sum) { out_data[out_ix] = sum / num; });
+
+  parallel_map_reduce_over_dim_list<
+      CTYPE_IN,
+      CTYPE_OUT,
+      reduce::SumOp<CTYPE_OUT>>(
+      in,
+      dim_list,
+      out_data,
+      [](auto v, auto mean) { return (v - mean) * (v - mean); },
+      [&](int64_t out_ix, CTYPE_OUT sum2) {
+        out_data[out_ix] = sum2 / denominator;
+      });
+}
+
+} // namespace
+
+// var.out(Tensor self, int[1]? dim, bool unbiased=True, bool keepdim=False,
+// *, Tensor(a!) out) -> Tensor(a!)
+Tensor& opt_var_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    optional<ArrayRef<int64_t>> dim_list,
+    bool unbiased,
+    bool keepdim,
+    Tensor& out) {
+  (void)ctx;
+
+  ET_KERNEL_CHECK(
+      ctx,
+      check_reduction_args(in, dim_list, keepdim, {}, out),
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK(ctx, tensor_is_floating_type(in), InvalidArgument, out);
+  ET_KERNEL_CHECK(ctx, tensor_is_floating_type(out), InvalidArgument, out);
+
+  ET_KERNEL_CHECK(
+      ctx, tensors_have_same_dim_order(in, out), InvalidArgument, out);
+
+  ET_KERNEL_CHECK(ctx, tensor_is_default_dim_order(in), InvalidArgument, out);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_reduction_out(in, dim_list, keepdim, out) == Error::Ok,
+      InvalidArgument,
+      out);
+
+  const size_t num = get_reduced_dim_product(in, dim_list);
+  const size_t denom = unbiased ? num - 1 : num;
+
+  constexpr auto name = "var.out";
+
+  ET_SWITCH_FLOAT_TYPES(in.scalar_type(), ctx, name, CTYPE_IN, [&] {
+    ET_SWITCH_FLOAT_TYPES(out.scalar_type(), ctx, name, CTYPE_OUT, [&] {
+      compute_variance<CTYPE_IN, CTYPE_OUT>(in, out, dim_list, num, denom);
+    });
+  });
+
+  return out;
+}
+
+// var.correction_out(Tensor self, int[1]? dim=None, *,
+// Scalar? correction=None, bool keepdim=False, Tensor(a!) out) -> Tensor(a!)
+Tensor& opt_var_correction_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    optional<ArrayRef<int64_t>> dim_list,
+    const optional<Scalar>& correction,
+    bool keepdim,
+    Tensor& out) {
+  (void)ctx;
+
+  ET_KERNEL_CHECK(
+      ctx,
+      check_reduction_args(in, dim_list, keepdim, {}, out),
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_reduction_out(in, dim_list, keepdim, out) == Error::Ok,
+      InvalidArgument,
+      out);
+
+  constexpr auto name = "var.correction_out";
+
+  double correction_val = 1;
+  if (correction.has_value()) {
+    ScalarType corr_type = utils::get_scalar_dtype(correction.value());
+    ET_SWITCH_SCALAR_OBJ_TYPES(corr_type, ctx, name, CTYPE_CORR, [&]() {
+      CTYPE_CORR corr_val = 0;
+      utils::extract_scalar(correction.value(), &corr_val);
+      correction_val = static_cast<double>(corr_val);
+    });
+  }
+
+  const size_t num = get_reduced_dim_product(in, dim_list);
+  const double denom = num - correction_val;
+
+  ET_SWITCH_FLOAT_TYPES(in.scalar_type(), ctx, name, CTYPE_IN, [&] {
+    ET_SWITCH_FLOAT_TYPES(out.scalar_type(), ctx, name, CTYPE_OUT, [&] {
+      compute_variance<CTYPE_IN, CTYPE_OUT>(in, out, dim_list, num, denom);
+    });
+  });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
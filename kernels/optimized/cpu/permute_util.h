@@ -0,0 +1,373 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#include <executorch/extension/parallel/thread_parallel.h>
+#include <executorch/kernels/optimized/vec/vec.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+// Permuted copies for permute_copy, transpose_copy and friends.
+//
+// The copy is described by one entry per output dimension holding its size
+// and the strides of that dimension in the input and in the output. Size-1
+// dimensions are dropped and dimensions whose strides chain in both tensors
+// are merged, which turns e.g. [B, S, H, D] -> [B, H, S, D] into rows of D
+// contiguous elements and a pure 2D transpose into a single pair of
+// dimensions. The remaining work is then one of:
+//
+//   - the innermost output dimension is contiguous in the input as well:
+//     each row is a memcpy;
+//   - another dimension is contiguous in the input: the copy is a batch of
+//     2D transposes, done in cache-sized blocks of 8x8 tiles;
+//   - neither (strided input): an element-wise walk.
+//
+// Work is split over the outer dimensions with parallel_for.
+
+namespace torch {
+namespace executor {
+namespace native {
+namespace permute {
+
+// Rows of the input-contiguous dimension handled by each transpose task.
+constexpr int64_t kTransposeBlockRows = 64;
+
+// Tile edge of the innermost transpose loop.
+constexpr int64_t kTransposeTile = 8;
+
+struct PermuteDim {
+  int64_t size;
+  int64_t in_stride;
+  int64_t out_stride;
+};
+
+/**
+ * Fills `dims` with one entry per non-trivial output dimension, ordered from
+ * the largest output stride to the smallest and with chained dimensions
+ * merged. `perm[i]` is the input dimension that becomes output dimension i.
+ * Returns the number of entries.
+ */
+inline int64_t make_permute_dims(
+    const Tensor& in,
+    const int64_t* perm,
+    const Tensor& out,
+    PermuteDim* dims) {
+  int64_t ndims = 0;
+  for (int64_t i = 0; i < out.dim(); ++i) {
+    if (out.size(i) != 1) {
+      dims[ndims++] = {out.size(i), in.strides()[perm[i]], out.strides()[i]};
+    }
+  }
+  std::stable_sort(
+      dims, dims + ndims, [](const PermuteDim& a, const PermuteDim& b) {
+        return a.out_stride > b.out_stride;
+      });
+
+  int64_t merged = 0;
+  for (int64_t i = 0; i < ndims; ++i) {
+    if (merged > 0) {
+      PermuteDim& prev = dims[merged - 1];
+      if (prev.in_stride == dims[i].in_stride * dims[i].size &&
+          prev.out_stride == dims[i].out_stride * dims[i].size) {
+        prev = {
+            prev.size * dims[i].size, dims[i].in_stride, dims[i].out_stride};
+        continue;
+      }
+    }
+    dims[merged++] = dims[i];
+  }
+  return merged;
+}
+
+/**
+ * Returns the input and output offsets of the element at flat index `index`
+ * over `dims`.
+ */
+inline void offsets_for_index(
+    const PermuteDim* dims,
+    int64_t ndims,
+    int64_t index,
+    int64_t* coord,
+    int64_t& in_offset,
+    int64_t& out_offset) {
+  in_offset = 0;
+  out_offset = 0;
+  for (int64_t i = ndims - 1; i >= 0; --i) {
+    coord[i] = index % dims[i].size;
+    index /= dims[i].size;
+    in_offset += coord[i] * dims[i].in_stride;
+    out_offset += coord[i] * dims[i].out_stride;
+  }
+}
+
+/**
+ * Advances `coord` to the next index over `dims`, updating the offsets.
+ */
+inline void increment_offsets(
+    const PermuteDim* dims,
+    int64_t ndims,
+    int64_t* coord,
+    int64_t& in_offset,
+    int64_t& out_offset) {
+  for (int64_t i = ndims - 1; i >= 0; --i) {
+    in_offset += dims[i].in_stride;
+    out_offset += dims[i].out_stride;
+    if (++coord[i] < dims[i].size) {
+      return;
+    }
+    in_offset -= dims[i].size * dims[i].in_stride;
+    out_offset -= dims[i].size * dims[i].out_stride;
+    coord[i] = 0;
+  }
+}
+
+/**
+ * Calls `fn(in_offset, out_offset)` for every index over `dims`, split
+ * across threads in chunks of at least `grain_size` indices.
+ */
+template <typename Func>
+void parallel_for_each_offset(
+    const PermuteDim* dims,
+    int64_t ndims,
+    int64_t grain_size,
+    const Func& fn) {
+  int64_t count = 1;
+  for (int64_t i = 0; i < ndims; ++i) {
+    count *= dims[i].size;
+  }
+  executorch::extension::parallel_for(
+      0, count, grain_size, [&](int64_t begin, int64_t end) {
+        int64_t coord[kTensorDimensionLimit];
+        int64_t in_offset;
+        int64_t out_offset;
+        offsets_for_index(dims, ndims, begin, coord, in_offset, out_offset);
+        for (int64_t i = begin; i < end; ++i) {
+          fn(in_offset, out_offset);
+          increment_offsets(dims, ndims, coord, in_offset, out_offset);
+        }
+      });
+}
+
+/**
+ * dst[c * ld_dst + r] = src[r * ld_src + c] for a rows x cols tile.
+ */
+template <typename T>
+inline void transpose_tile(
+    const T* src,
+    int64_t ld_src,
+    T* dst,
+    int64_t ld_dst,
+    int64_t rows,
+    int64_t cols) {
+  for (int64_t c = 0; c < cols; ++c) {
+    for (int64_t r = 0; r < rows; ++r) {
+      dst[c * ld_dst + r] = src[r * ld_src + c];
+    }
+  }
+}
+
+template <typename T>
+inline void transpose_full_tile(
+    const T* src,
+    int64_t ld_src,
+    T* dst,
+    int64_t ld_dst) {
+  transpose_tile(src, ld_src, dst, ld_dst, kTransposeTile, kTransposeTile);
+}
+
+#if defined(CPU_CAPABILITY_AVX2)
+// 32-bit elements use the AVX2 shuffle network of the vec library. The
+// shuffles only move bits, so this is exact for any 32-bit type.
+template <>
+inline void transpose_full_tile<uint32_t>(
+    const uint32_t* src,
+    int64_t ld_src,
+    uint32_t* dst,
+    int64_t ld_dst) {
+  executorch::vec::transpose_mxn<float, 8, 8>(
+      reinterpret_cast<const float*>(src),
+      ld_src,
+      reinterpret_cast<float*>(dst),
+      ld_dst);
+}
+#endif
+
+/**
+ * out[r * ld_out + c] = in[c * ld_in + r] for r in [row_begin, row_end) and
+ * c in [0, cols), where `in` is contiguous along r and `out` along c.
+ */
+template <typename T>
+void transpose_rows(
+    const T* in,
+    int64_t ld_in,
+    T* out,
+    int64_t ld_out,
+    int64_t row_begin,
+    int64_t row_end,
+    int64_t cols) {
+  int64_t c = 0;
+  for (; c + kTransposeTile <= cols; c += kTransposeTile) {
+    int64_t r = row_begin;
+    for (; r + kTransposeTile <= row_end; r += kTransposeTile) {
+      transpose_full_tile(
+          in + c * ld_in + r, ld_in, out + r * ld_out + c, ld_out);
+    }
+    transpose_tile(
+        in + c * ld_in + r,
+        ld_in,
+        out + r * ld_out + c,
+        ld_out,
+        kTransposeTile,
+        row_end - r);
+  }
+  transpose_tile(
+      in + c * ld_in + row_begin,
+      ld_in,
+      out + row_begin * ld_out + c,
+      ld_out,
+      cols - c,
+      row_end - row_begin);
+}
+
+template <typename T>
+void permute_copy_impl(
+    const T* in_data,
+    T* out_data,
+    PermuteDim* dims,
+    int64_t ndims) {
+  if (ndims == 0) {
+    out_data[0] = in_data[0];
+    return;
+  }
+
+  const PermuteDim inner = dims[ndims - 1];
+  if (inner.in_stride == 1 && inner.out_stride == 1) {
+    // Rows that are contiguous in both tensors.
+    parallel_for_each_offset(
+        dims,
+        ndims - 1,
+        std::max<int64_t>(
+            1, executorch::extension::kMinElementsPerTask / inner.size),
+        [&](int64_t in_offset, int64_t out_offset) {
+          std::memcpy(
+              out_data + out_offset,
+              in_data + in_offset,
+              inner.size * sizeof(T));
+        });
+    return;
+  }
+
+  int64_t k = ndims - 2;
+  while (k >= 0 && dims[k].in_stride != 1) {
+    --k;
+  }
+  if (k < 0 || inner.out_stride != 1) {
+    parallel_for_each_offset(
+        dims,
+        ndims,
+        executorch::extension::kMinElementsPerTask,
+        [&](int64_t in_offset, int64_t out_offset) {
+          out_data[out_offset] = in_data[in_offset];
+        });
+    return;
+  }
+
+  // A batch of 2D transposes: dims[k] is contiguous in the input and the
+  // innermost dimension is contiguous in the output. Each task handles a
+  // block of rows of one transpose.
+  const PermuteDim rows = dims[k];
+  std::copy(dims + k + 1, dims + ndims - 1, dims + k);
+  const int64_t outer_ndims = ndims - 2;
+  int64_t outer_count = 1;
+  for (int64_t i = 0; i < outer_ndims; ++i) {
+    outer_count *= dims[i].size;
+  }
+  const int64_t num_blocks =
+      (rows.size + kTransposeBlockRows - 1) / kTransposeBlockRows;
+  executorch::extension::parallel_for(
+      0,
+      outer_count * num_blocks,
+      std::max<int64_t>(
+          1,
+          executorch::extension::kMinElementsPerTask /
+              (kTransposeBlockRows * inner.size)),
+      [&](int64_t begin, int64_t end) {
+        int64_t coord[kTensorDimensionLimit];
+        for (int64_t task = begin; task < end; ++task) {
+          int64_t in_offset;
+          int64_t out_offset;
+          offsets_for_index(
+              dims,
+              outer_ndims,
+              task / num_blocks,
+              coord,
+              in_offset,
+              out_offset);
+          const int64_t row_begin = (task % num_blocks) * kTransposeBlockRows;
+          transpose_rows(
+              in_data + in_offset,
+              inner.in_stride,
+              out_data + out_offset,
+              rows.out_stride,
+              row_begin,
+              std::min(row_begin + kTransposeBlockRows, rows.size),
+              inner.size);
+        }
+      });
+}
+
+template <size_t kSize>
+struct Bytes {
+  uint8_t data[kSize];
+};
+
+} // namespace permute
+
+/**
+ * Copies `in` into `out` such that output dimension i is input dimension
+ * `perm[i]`. Works on the raw bytes of any dtype and on any dim order, as
+ * long as `out` has been resized to the permuted sizes.
+ */
+inline void permute_tensor(const Tensor& in, const int64_t* perm, Tensor& out) {
+  if (out.numel() == 0) {
+    return;
+  }
+  permute::PermuteDim dims[kTensorDimensionLimit];
+  const int64_t ndims = permute::make_permute_dims(in, perm, out, dims);
+
+  const void* in_data = in.const_data_ptr();
+  void* out_data = out.mutable_data_ptr();
+#define ET_PERMUTE_COPY_CASE(SIZE, T)                                    \
+  case SIZE:                                                             \
+    permute::permute_copy_impl(                                          \
+        static_cast<const T*>(in_data),                                  \
+        static_cast<T*>(out_data),                                       \
+        dims,                                                            \
+        ndims);                                                          \
+    break;
+
+  switch (in.element_size()) {
+    ET_PERMUTE_COPY_CASE(1, uint8_t)
+    ET_PERMUTE_COPY_CASE(2, uint16_t)
+    ET_PERMUTE_COPY_CASE(4, uint32_t)
+    ET_PERMUTE_COPY_CASE(8, uint64_t)
+    ET_PERMUTE_COPY_CASE(16, permute::Bytes<16>)
+    default:
+      ET_CHECK_MSG(
+          false, "Unsupported element size %zu", (size_t)in.element_size());
+  }
+#undef ET_PERMUTE_COPY_CASE
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
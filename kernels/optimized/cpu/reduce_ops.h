@@ -0,0 +1,516 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+#include <executorch/extension/parallel/thread_parallel.h>
+#include <executorch/kernels/optimized/vec/functional.h>
+#include <executorch/kernels/optimized/vec/vec.h>
+#include <executorch/kernels/portable/cpu/util/reduce_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+// Reductions over a list of dimensions for the optimized sum, mean, amax and
+// var kernels.
+//
+// A contiguous input whose reduced dimensions are adjacent (ignoring size-1
+// dimensions) is viewed as [outer, size, inner] and reduced over the middle
+// dimension:
+//
+//   - inner == 1: each output reduces a contiguous row of `size` elements,
+//     with several vector accumulators per row;
+//   - inner > 1: each vector lane accumulates one output column while
+//     stepping over the `size` rows, so loads stay contiguous.
+//
+// In both cases runs of kPairwiseBlock elements are accumulated linearly and
+// the partial results are combined pairwise, which keeps the rounding error
+// of float sums growing with log(size) rather than size. Outputs are split
+// across threads with parallel_for. Other inputs fall back to
+// map_reduce_over_dim_list from the portable reduce_util, still parallelized
+// over outputs.
+
+namespace torch {
+namespace executor {
+namespace native {
+namespace reduce {
+
+// Number of elements (or rows) accumulated linearly before partial results
+// are combined pairwise.
+constexpr int64_t kPairwiseBlock = 256;
+
+// Vectors of adjacent output columns accumulated together when reducing
+// over an outer dimension.
+constexpr int64_t kColumnVecs = 4;
+
+/**
+ * Accumulation type: reduced-precision floats accumulate in float.
+ */
+template <typename T>
+using acc_type = std::conditional_t<
+    std::is_same<T, exec_aten::Half>::value ||
+        std::is_same<T, exec_aten::BFloat16>::value,
+    float,
+    T>;
+
+template <typename T>
+struct SumOp {
+  static T identity() {
+    return static_cast<T>(0);
+  }
+  template <typename V>
+  static V reduce(const V& acc, const V& x) {
+    return acc + x;
+  }
+};
+
+/**
+ * Maximum that propagates NaN.
+ */
+template <typename T>
+struct MaxOp {
+  static T identity() {
+    return std::numeric_limits<T>::has_infinity
+        ? -std::numeric_limits<T>::infinity()
+        : std::numeric_limits<T>::lowest();
+  }
+  static T reduce(const T& acc, const T& x) {
+    return std::isnan(x) || x > acc ? x : acc;
+  }
+  static executorch::vec::Vectorized<T> reduce(
+      const executorch::vec::Vectorized<T>& acc,
+      const executorch::vec::Vectorized<T>& x) {
+    return executorch::vec::maximum(acc, x);
+  }
+};
+
+/**
+ * `in` viewed as a row-major [outer, size, inner] tensor that is reduced over
+ * its middle dimension, giving an [outer, inner] output.
+ */
+struct ReduceShape {
+  int64_t outer;
+  int64_t size;
+  int64_t inner;
+};
+
+/**
+ * Returns whether reducing `in` over `dim_list` can be described by a
+ * ReduceShape, and computes it if so. A null or empty `dim_list` reduces
+ * over all dimensions.
+ */
+inline bool get_reduce_shape(
+    const Tensor& in,
+    const exec_aten::optional<exec_aten::ArrayRef<int64_t>>& dim_list,
+    ReduceShape& shape) {
+  bool is_reduced[kTensorDimensionLimit];
+  const bool reduce_all = !dim_list.has_value() ||
+      dim_list.value().size() == 0 || in.dim() == 0;
+  std::fill(is_reduced, is_reduced + kTensorDimensionLimit, reduce_all);
+  if (!reduce_all) {
+    for (const int64_t d : dim_list.value()) {
+      is_reduced[d < 0 ? d + in.dim() : d] = true;
+    }
+  }
+
+  // After dropping size-1 dimensions, the reduced dimensions must form a
+  // single run.
+  shape = {1, 1, 1};
+  bool seen_reduced = false;
+  for (int64_t d = 0; d < in.dim(); ++d) {
+    if (in.size(d) == 1) {
+      continue;
+    }
+    if (is_reduced[d]) {
+      if (shape.inner != 1) {
+        return false;
+      }
+      seen_reduced = true;
+      shape.size *= in.size(d);
+    } else if (seen_reduced) {
+      shape.inner *= in.size(d);
+    } else {
+      shape.outer *= in.size(d);
+    }
+  }
+  return true;
+}
+
+/**
+ * Reduces the elements in [begin, end) by splitting the range in halves down
+ * to runs of at most kPairwiseBlock elements, which `block` reduces
+ * linearly.
+ */
+template <typename Acc, typename BlockFn, typename CombineFn>
+Acc pairwise_reduce(
+    int64_t begin,
+    int64_t end,
+    const BlockFn& block,
+    const CombineFn& combine) {
+  if (end - begin <= kPairwiseBlock) {
+    return block(begin, end);
+  }
+  const int64_t mid = begin + (end - begin) / 2;
+  return combine(
+      pairwise_reduce<Acc>(begin, mid, block, combine),
+      pairwise_reduce<Acc>(mid, end, block, combine));
+}
+
+template <typename T>
+constexpr bool can_vectorize() {
+  return std::is_same<T, float>::value || std::is_same<T, double>::value;
+}
+
+/**
+ * Reduces map(data[i], p) over the `size` contiguous elements of `data`.
+ */
+template <typename CTYPE_IN, typename CTYPE_ACC, typename Op, typename MapFn>
+CTYPE_ACC reduce_row(
+    const CTYPE_IN* data,
+    int64_t size,
+    CTYPE_ACC p,
+    const MapFn& map) {
+  const auto combine = [](CTYPE_ACC a, CTYPE_ACC b) {
+    return Op::reduce(a, b);
+  };
+  if constexpr (
+      std::is_same<CTYPE_IN, CTYPE_ACC>::value &&
+      can_vectorize<CTYPE_ACC>()) {
+    using Vec = executorch::vec::Vectorized<CTYPE_ACC>;
+    constexpr int64_t kVecSize = Vec::size();
+    const Vec p_vec(p);
+    return pairwise_reduce<CTYPE_ACC>(
+        0,
+        size,
+        [&](int64_t begin, int64_t end) {
+          std::array<Vec, 4> acc;
+          acc.fill(Vec(Op::identity()));
+          int64_t i = begin;
+          for (; i + 4 * kVecSize <= end; i += 4 * kVecSize) {
+            for (int64_t j = 0; j < 4; ++j) {
+              acc[j] = Op::reduce(
+                  acc[j], map(Vec::loadu(data + i + j * kVecSize), p_vec));
+            }
+          }
+          for (; i + kVecSize <= end; i += kVecSize) {
+            acc[0] = Op::reduce(acc[0], map(Vec::loadu(data + i), p_vec));
+          }
+          const Vec total = Op::reduce(
+              Op::reduce(acc[0], acc[1]), Op::reduce(acc[2], acc[3]));
+          CTYPE_ACC result = executorch::vec::vec_reduce_all<CTYPE_ACC>(
+              [](Vec& a, Vec& b) { return Op::reduce(a, b); }, total);
+          for (; i < end; ++i) {
+            result = Op::reduce(result, map(data[i], p));
+          }
+          return result;
+        },
+        combine);
+  } else {
+    return pairwise_reduce<CTYPE_ACC>(
+        0,
+        size,
+        [&](int64_t begin, int64_t end) {
+          CTYPE_ACC result = Op::identity();
+          for (int64_t i = begin; i < end; ++i) {
+            result =
+                Op::reduce(result, map(static_cast<CTYPE_ACC>(data[i]), p));
+          }
+          return result;
+        },
+        combine);
+  }
+}
+
+/**
+ * Reduces the [outer, size] view of `in` over its rows.
+ */
+template <
+    typename CTYPE_IN,
+    typename CTYPE_ACC,
+    typename Op,
+    typename MapFn,
+    typename FinishFn>
+void reduce_rows(
+    const CTYPE_IN* in,
+    const ReduceShape& shape,
+    const CTYPE_ACC* param,
+    const MapFn& map,
+    const FinishFn& finish) {
+  executorch::extension::parallel_for(
+      0,
+      shape.outer,
+      std::max<int64_t>(
+          1, executorch::extension::kMinElementsPerTask / shape.size),
+      [&](int64_t begin, int64_t end) {
+        for (int64_t m = begin; m < end; ++m) {
+          const CTYPE_ACC p =
+              param == nullptr ? CTYPE_ACC(0) : CTYPE_ACC(param[m]);
+          finish(
+              m,
+              reduce_row<CTYPE_IN, CTYPE_ACC, Op>(
+                  in + m * shape.size, shape.size, p, map));
+        }
+      });
+}
+
+/**
+ * Reduces the [outer, size, inner] view of `in` over its middle dimension,
+ * `kLanes` adjacent output columns at a time. `Lanes` holds the accumulators
+ * for those columns; `load(ptr, count)` reads up to `kLanes` contiguous
+ * values into one, and `store(lanes, index, count)` passes them to `finish`.
+ */
+template <
+    typename CTYPE_ACC,
+    typename Op,
+    typename Lanes,
+    int64_t kLanes,
+    typename LoadFn,
+    typename MapFn,
+    typename StoreFn>
+void reduce_columns_impl(
+    const ReduceShape& shape,
+    const CTYPE_ACC* param,
+    const LoadFn& load,
+    const MapFn& map,
+    const StoreFn& store) {
+  const int64_t num_chunks = (shape.inner + kLanes - 1) / kLanes;
+  executorch::extension::parallel_for(
+      0,
+      shape.outer * num_chunks,
+      std::max<int64_t>(
+          1,
+          executorch::extension::kMinElementsPerTask / (shape.size * kLanes)),
+      [&](int64_t begin, int64_t end) {
+        for (int64_t task = begin; task < end; ++task) {
+          const int64_t m = task / num_chunks;
+          const int64_t k = (task % num_chunks) * kLanes;
+          const int64_t count = std::min(kLanes, shape.inner - k);
+          const int64_t out_ix = m * shape.inner + k;
+          const int64_t in_offset = m * shape.size * shape.inner + k;
+          const Lanes p = param == nullptr
+              ? Lanes(CTYPE_ACC(0))
+              : Lanes::load(param + out_ix, count);
+
+          const Lanes acc = pairwise_reduce<Lanes>(
+              0,
+              shape.size,
+              [&](int64_t row_begin, int64_t row_end) {
+                Lanes lanes(Op::identity());
+                for (int64_t r = row_begin; r < row_end; ++r) {
+                  lanes.reduce(
+                      load(in_offset + r * shape.inner, count), p, map);
+                }
+                return lanes;
+              },
+              [](Lanes a, const Lanes& b) {
+                a.combine(b);
+                return a;
+              });
+          store(acc, out_ix, count);
+        }
+      });
+}
+
+/**
+ * kColumnVecs vectors of accumulators.
+ */
+template <typename T, typename Op>
+struct VecLanes {
+  using Vec = executorch::vec::Vectorized<T>;
+  static constexpr int64_t kSize = kColumnVecs * Vec::size();
+
+  std::array<Vec, kColumnVecs> v;
+
+  explicit VecLanes(T value) {
+    v.fill(Vec(value));
+  }
+
+  static VecLanes load(const T* data, int64_t count) {
+    VecLanes lanes(T(0));
+    for (int64_t j = 0; j * Vec::size() < count; ++j) {
+      lanes.v[j] = Vec::loadu(
+          data + j * Vec::size(),
+          std::min<int64_t>(Vec::size(), count - j * Vec::size()));
+    }
+    return lanes;
+  }
+
+  template <typename MapFn>
+  void reduce(const VecLanes& x, const VecLanes& p, const MapFn& map) {
+    for (int64_t j = 0; j < kColumnVecs; ++j) {
+      v[j] = Op::reduce(v[j], map(x.v[j], p.v[j]));
+    }
+  }
+
+  void combine(const VecLanes& other) {
+    for (int64_t j = 0; j < kColumnVecs; ++j) {
+      v[j] = Op::reduce(v[j], other.v[j]);
+    }
+  }
+};
+
+/**
+ * kColumnVecs * 8 scalar accumulators, for types without a vector path.
+ */
+template <typename T, typename Op>
+struct ScalarLanes {
+  static constexpr int64_t kSize = kColumnVecs * 8;
+
+  std::array<T, kSize> v;
+
+  explicit ScalarLanes(T value) {
+    v.fill(value);
+  }
+
+  template <typename U>
+  static ScalarLanes load(const U* data, int64_t count) {
+    ScalarLanes lanes(T(0));
+    for (int64_t j = 0; j < count; ++j) {
+      lanes.v[j] = static_cast<T>(data[j]);
+    }
+    return lanes;
+  }
+
+  template <typename MapFn>
+  void reduce(const ScalarLanes& x, const ScalarLanes& p, const MapFn& map) {
+    for (int64_t j = 0; j < kSize; ++j) {
+      v[j] = Op::reduce(v[j], map(x.v[j], p.v[j]));
+    }
+  }
+
+  void combine(const ScalarLanes& other) {
+    for (int64_t j = 0; j < kSize; ++j) {
+      v[j] = Op::reduce(v[j], other.v[j]);
+    }
+  }
+};
+
+template <
+    typename CTYPE_IN,
+    typename CTYPE_ACC,
+    typename Op,
+    typename MapFn,
+    typename FinishFn>
+void reduce_columns(
+    const CTYPE_IN* in,
+    const ReduceShape& shape,
+    const CTYPE_ACC* param,
+    const MapFn& map,
+    const FinishFn& finish) {
+  if constexpr (
+      std::is_same<CTYPE_IN, CTYPE_ACC>::value &&
+      can_vectorize<CTYPE_ACC>()) {
+    using Lanes = VecLanes<CTYPE_ACC, Op>;
+    reduce_columns_impl<CTYPE_ACC, Op, Lanes, Lanes::kSize>(
+        shape,
+        param,
+        [&](int64_t offset, int64_t count) {
+          return Lanes::load(in + offset, count);
+        },
+        map,
+        [&](const Lanes& lanes, int64_t out_ix, int64_t count) {
+          CTYPE_ACC values[Lanes::kSize];
+          for (int64_t j = 0; j < kColumnVecs; ++j) {
+            lanes.v[j].store(values + j * Lanes::Vec::size());
+          }
+          for (int64_t j = 0; j < count; ++j) {
+            finish(out_ix + j, values[j]);
+          }
+        });
+  } else {
+    using Lanes = ScalarLanes<CTYPE_ACC, Op>;
+    reduce_columns_impl<CTYPE_ACC, Op, Lanes, Lanes::kSize>(
+        shape,
+        param,
+        [&](int64_t offset, int64_t count) {
+          return Lanes::load(in + offset, count);
+        },
+        map,
+        [&](const Lanes& lanes, int64_t out_ix, int64_t count) {
+          for (int64_t j = 0; j < count; ++j) {
+            finish(out_ix + j, lanes.v[j]);
+          }
+        });
+  }
+}
+
+} // namespace reduce
+
+/**
+ * For each output index i of reducing `in` over `dim_list`, reduces
+ * map(in[j], param[i]) over the reduced elements j with `Op` and calls
+ * finish(i, result). Elements are converted to CTYPE_ACC before `map`, which
+ * must accept both CTYPE_ACC and Vectorized<CTYPE_ACC> arguments. `param`
+ * may be null, in which case map receives zeros, and may alias the output
+ * written by `finish`: param[i] is always read before finish(i, ...) is
+ * called.
+ */
+template <
+    typename CTYPE_IN,
+    typename CTYPE_ACC,
+    typename Op,
+    typename MapFn,
+    typename FinishFn>
+void parallel_map_reduce_over_dim_list(
+    const Tensor& in,
+    const exec_aten::optional<exec_aten::ArrayRef<int64_t>>& dim_list,
+    const CTYPE_ACC* param,
+    const MapFn& map,
+    const FinishFn& finish) {
+  const int64_t out_numel = get_out_numel(in, dim_list);
+  if (in.numel() == 0) {
+    for (int64_t out_ix = 0; out_ix < out_numel; ++out_ix) {
+      finish(out_ix, Op::identity());
+    }
+    return;
+  }
+
+  reduce::ReduceShape shape;
+  if (tensor_is_contiguous(in) &&
+      reduce::get_reduce_shape(in, dim_list, shape)) {
+    const CTYPE_IN* in_data = in.const_data_ptr<CTYPE_IN>();
+    if (shape.inner == 1) {
+      reduce::reduce_rows<CTYPE_IN, CTYPE_ACC, Op>(
+          in_data, shape, param, map, finish);
+    } else {
+      reduce::reduce_columns<CTYPE_IN, CTYPE_ACC, Op>(
+          in_data, shape, param, map, finish);
+    }
+    return;
+  }
+
+  const int64_t reduced_numel =
+      std::max<int64_t>(1, get_reduced_dim_product(in, dim_list));
+  executorch::extension::parallel_for(
+      0,
+      out_numel,
+      std::max<int64_t>(
+          1, executorch::extension::kMinElementsPerTask / reduced_numel),
+      [&](int64_t begin, int64_t end) {
+        for (int64_t out_ix = begin; out_ix < end; ++out_ix) {
+          const CTYPE_ACC p =
+              param == nullptr ? CTYPE_ACC(0) : CTYPE_ACC(param[out_ix]);
+          finish(
+              out_ix,
+              map_reduce_over_dim_list<CTYPE_IN, CTYPE_ACC>(
+                  [&](CTYPE_IN v) { return map(static_cast<CTYPE_ACC>(v), p); },
+                  [](CTYPE_ACC v, CTYPE_ACC acc) { return Op::reduce(acc, v); },
+                  in,
+                  dim_list,
+                  out_ix));
+        }
+      });
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
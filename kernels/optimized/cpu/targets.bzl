@@ -1,40 +1,60 @@
 load("@fbsource//xplat/executorch/build:runtime_wrapper.bzl", "runtime")
-load("@fbsource//xplat/executorch/kernels/optimized:op_registration_util.bzl", "define_op_target", "is_op_disabled", "op_target")
+load("@fbsource//xplat/executorch/kernels/optimized:op_registration_util.bzl", "define_dispatch_library", "define_op_target", "is_op_disabled", "op_target")
 
 _OPTIMIZED_ATEN_OPS = (
     op_target(
         name = "op_add",
         deps = [
             ":binary_ops",
+            ":binary_ops_kernel",
             "//executorch/kernels/portable/cpu:scalar_utils",
             "//executorch/kernels/portable/cpu/util:broadcast_util",
         ],
     ),
+    op_target(
+        name = "op_amax",
+        deps = [
+            ":reduce_ops",
+            "//executorch/kernels/portable/cpu/util:reduce_util",
+        ],
+    ),
     op_target(
         name = "op_bmm",
         deps = [
             "//executorch/kernels/optimized:libblas",
         ],
     ),
+    op_target(
+        name = "op_convolution",
+        deps = [
+            "//executorch/extension/parallel:thread_parallel",
+            "//executorch/kernels/optimized:libblas",
+            "//executorch/kernels/portable/cpu/util:dtype_util",
+            "//executorch/kernels/portable/cpu/util:kernel_ops_util",
+        ],
+    ),
     op_target(
         name = "op_div",
         deps = [
             ":binary_ops",
+            ":binary_ops_kernel",
             "//executorch/kernels/portable/cpu:scalar_utils",
             "//executorch/kernels/portable/cpu/util:broadcast_util",
         ],
     ),
-    op_target(name = "op_exp"),
-    op_target(name = "op_sigmoid"),
     op_target(
-        name = "op_gelu",
-        deps = select({
-            "DEFAULT": [],
-            "ovr_config//cpu:arm64": [
-                "fbsource//third-party/sleef:sleef_arm",
-            ],
-        }),
+        name = "op_exp",
+        deps = [
+            ":unary_ops",
+        ],
+    ),
+    op_target(
+        name = "op_sigmoid",
+        deps = [
+            ":unary_ops",
+        ],
     ),
+    op_target(name = "op_gelu"),
     op_target(
         name = "op_le",
         deps = [
@@ -50,15 +70,16 @@ _OPTIMIZED_ATEN_OPS = (
     ),
     op_target(
         name = "op_log_softmax",
-        deps = select({
-            "DEFAULT": [
-                "//executorch/kernels/portable/cpu/util:activation_ops_util",
-            ],
-            "ovr_config//cpu:arm64": [
-                "//executorch/kernels/portable/cpu/util:activation_ops_util",
-                "fbsource//third-party/sleef:sleef_arm",
-            ],
-        }),
+        deps = [
+            "//executorch/kernels/portable/cpu/util:activation_ops_util",
+        ],
+    ),
+    op_target(
+        name = "op_mean",
+        deps = [
+            ":reduce_ops",
+            "//executorch/kernels/portable/cpu/util:reduce_util",
+        ],
     ),
     op_target(
         name = "op_mm",
@@ -71,6 +92,7 @@ _OPTIMIZED_ATEN_OPS = (
         name = "op_mul",
         deps = [
             ":binary_ops",
+            ":binary_ops_kernel",
             "//executorch/kernels/portable/cpu:scalar_utils",
             "//executorch/kernels/portable/cpu/util:broadcast_util",
             "//executorch/runtime/core/exec_aten/util:tensor_util",
@@ -84,14 +106,51 @@ _OPTIMIZED_ATEN_OPS = (
         ],
     ),
     op_target(name = "op_neg"),
+    op_target(
+        name = "op_permute_copy",
+        deps = [
+            ":permute_util",
+            "//executorch/kernels/portable/cpu/util:copy_ops_util",
+        ],
+    ),
+    op_target(
+        name = "op_softmax",
+        deps = [
+            "//executorch/extension/parallel:thread_parallel",
+            "//executorch/kernels/portable/cpu/util:activation_ops_util",
+        ],
+    ),
     op_target(
         name = "op_sub",
         deps = [
             ":binary_ops",
+            ":binary_ops_kernel",
             "//executorch/kernels/portable/cpu:scalar_utils",
             "//executorch/kernels/portable/cpu/util:broadcast_util",
         ],
     ),
+    op_target(
+        name = "op_sum",
+        deps = [
+            ":reduce_ops",
+            "//executorch/kernels/portable/cpu/util:reduce_util",
+        ],
+    ),
+    op_target(
+        name = "op_transpose_copy",
+        deps = [
+            ":permute_util",
+            "//executorch/kernels/portable/cpu/util:transpose_util",
+        ],
+    ),
+    op_target(
+        name = "op_var",
+        deps = [
+            ":reduce_ops",
+            "//executorch/kernels/portable/cpu:scalar_utils",
+            "//executorch/kernels/portable/cpu/util:reduce_util",
+        ],
+    ),
 )
 
 def define_common_targets():
@@ -117,6 +176,18 @@ def define_common_targets():
         exported_deps = ["//executorch/runtime/core:core"],
     )
 
+    define_dispatch_library(
+        name = "binary_ops_kernel",
+        srcs = ["binary_ops_kernel.cpp"],
+        exported_headers = ["binary_ops_kernel.h"],
+    )
+
+    define_dispatch_library(
+        name = "unary_ops",
+        srcs = ["unary_ops_kernel.cpp"],
+        exported_headers = ["unary_ops.h"],
+    )
+
     runtime.cxx_library(
         name = "cpu_optimized",
         srcs = [],
@@ -134,3 +205,28 @@ def define_common_targets():
             "//executorch/kernels/optimized:libutils",
         ],
     )
+
+    runtime.cxx_library(
+        name = "permute_util",
+        srcs = [],
+        exported_headers = ["permute_util.h"],
+        visibility = ["//executorch/kernels/optimized/..."],
+        exported_deps = [
+            "//executorch/extension/parallel:thread_parallel",
+            "//executorch/kernels/optimized:libvec",
+            "//executorch/runtime/kernel:kernel_includes",
+        ],
+    )
+
+    runtime.cxx_library(
+        name = "reduce_ops",
+        srcs = [],
+        exported_headers = ["reduce_ops.h"],
+        visibility = ["//executorch/kernels/optimized/..."],
+        exported_deps = [
+            "//executorch/extension/parallel:thread_parallel",
+            "//executorch/kernels/optimized:libvec",
+            "//executorch/kernels/portable/cpu/util:reduce_util",
+            "//executorch/runtime/kernel:kernel_includes",
+        ],
+    )
@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+#include <executorch/kernels/optimized/utils/dispatch_stub.h>
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+/**
+ * Computes out[i] = f(in[i]) for numel contiguous elements of dtype, which must
+ * be Float or Double.
+ */
+using unary_fn =
+    void (*)(exec_aten::ScalarType dtype, const void* in, void* out, size_t numel);
+
+// Kernels are in unary_ops_kernel.cpp, which is compiled once per CPU
+// capability level. See dispatch_stub.h.
+DECLARE_DISPATCH(unary_fn, exp_stub);
+DECLARE_DISPATCH(unary_fn, sigmoid_stub);
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// This file is compiled once per CPU capability level; keep its dependencies
+// limited to the vec library. See dispatch_stub.h.
+
+#include <executorch/kernels/optimized/cpu/unary_ops.h>
+
+#include <executorch/kernels/optimized/vec/functional.h>
+#include <executorch/kernels/optimized/vec/vec.h>
+#include <executorch/kernels/optimized/vec/vec_math.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+namespace {
+
+template <typename CTYPE, typename Op>
+void map_typed(const void* in, void* out, size_t numel, const Op& op) {
+  executorch::vec::map<CTYPE>(
+      op,
+      static_cast<CTYPE*>(out),
+      static_cast<const CTYPE*>(in),
+      static_cast<int64_t>(numel));
+}
+
+template <typename Op>
+void map_floating(
+    exec_aten::ScalarType dtype,
+    const void* in,
+    void* out,
+    size_t numel,
+    const Op& op) {
+  if (dtype == exec_aten::ScalarType::Double) {
+    map_typed<double>(in, out, numel, op);
+  } else {
+    map_typed<float>(in, out, numel, op);
+  }
+}
+
+void exp_kernel(
+    exec_aten::ScalarType dtype,
+    const void* in,
+    void* out,
+    size_t numel) {
+  map_floating(dtype, in, out, numel, [](auto x) {
+    return executorch::vec::vec_exp(x);
+  });
+}
+
+void sigmoid_kernel(
+    exec_aten::ScalarType dtype,
+    const void* in,
+    void* out,
+    size_t numel) {
+  map_floating(dtype, in, out, numel, [](auto x) {
+    return executorch::vec::vec_sigmoid(x);
+  });
+}
+
+} // namespace
+
+REGISTER_DISPATCH(exp_stub, &exp_kernel);
+REGISTER_DISPATCH(sigmoid_stub, &sigmoid_kernel);
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -203,7 +203,9 @@ def define_libs(is_fbcode=False):
                 "//executorch/...",
                 "@EXECUTORCH_CLIENTS",
             ],
-            preprocessor_flags = get_preprocessor_flags(),
+            # The packed GEMM microkernel is built on the vec library.
+            preprocessor_flags = get_preprocessor_flags() + get_vec_preprocessor_flags(),
+            cxx_platform_preprocessor_flags = get_vec_cxx_preprocessor_flags(),
             fbandroid_platform_preprocessor_flags = [
                 (
                     "^android-arm64.*$",
@@ -227,7 +229,9 @@ def define_libs(is_fbcode=False):
             deps = select({
                 ":linux-x86_64": [mkl_dep] if not runtime.is_oss else [],
                 "DEFAULT": [],
-            }) + LIBBLAS_DEPS,
+            }) + LIBBLAS_DEPS + get_vec_deps() + [
+                "//executorch/kernels/optimized:libvec",
+            ],
             exported_deps = [
                 "//executorch/extension/parallel:thread_parallel",
                 "//executorch/kernels/optimized:libutils",
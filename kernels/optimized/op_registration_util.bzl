@@ -10,6 +10,98 @@ load(
     "get_compiler_optimization_flags",
 )
 
+# Compiler flags for each CPU capability level above DEFAULT. The level's name
+# selects the REGISTER_DISPATCH slot and the vec specializations; see
+# kernels/optimized/utils/dispatch_stub.h.
+_CPU_CAPABILITY_COMPILER_FLAGS = {
+    "AVX2": ["-mavx2", "-mfma"],
+    "AVX512": ["-mavx512f", "-mavx512bw", "-mavx512vl", "-mavx512dq", "-mfma"],
+}
+
+def _get_dispatch_sleef_dep():
+    """Returns the sleef target the capability variants link, or None.
+
+    The AVX2 and AVX512 vec specializations call sleef. It is not vendored in
+    OSS, so there the variants are only built when the executorch.sleef_dep
+    buckconfig names a sleef library to link.
+    """
+    if not runtime.is_oss:
+        return "fbsource//third-party/sleef:sleef"
+    return native.read_config("executorch", "sleef_dep", None)
+
+def define_dispatch_library(name, srcs, exported_headers, deps = []):
+    """Defines a cxx_library whose sources are compiled once per CPU capability.
+
+    The sources register kernels with REGISTER_DISPATCH. The library itself
+    holds the DEFAULT variant. On x86-64, when sleef is available, it also
+    exports one library per capability level in
+    _CPU_CAPABILITY_COMPILER_FLAGS, together with the
+    ET_HAVE_<level>_CPU_DEFINITION flag that lets DispatchStub select it at
+    runtime.
+
+    Args:
+        name: The name of the target.
+        srcs: Sources to compile for each capability level. They should only
+            depend on the vec library, since everything they include is
+            compiled with the level's instruction set.
+        exported_headers: Headers that declare the stubs.
+        deps: Optional extra deps for every variant.
+    """
+    variant_deps = deps + [
+        "//executorch/kernels/optimized:libvec",
+        "//executorch/kernels/optimized:libutils",
+        "//executorch/runtime/core/exec_aten:lib",
+    ]
+
+    # Kernel sources often have helpers with no prototypes, like op targets.
+    compiler_flags = ["-Wno-missing-prototypes"] + get_compiler_optimization_flags()
+
+    capability_targets = []
+    sleef_dep = _get_dispatch_sleef_dep()
+    if sleef_dep != None:
+        for capability, capability_flags in _CPU_CAPABILITY_COMPILER_FLAGS.items():
+            capability_name = "{}_{}".format(name, capability.lower())
+            runtime.cxx_library(
+                name = capability_name,
+                srcs = srcs,
+                headers = exported_headers,
+                compiler_flags = compiler_flags + capability_flags,
+                preprocessor_flags = [
+                    "-DCPU_CAPABILITY={}".format(capability),
+                    "-DCPU_CAPABILITY_{}".format(capability),
+                ],
+                exported_preprocessor_flags = [
+                    "-DET_HAVE_{}_CPU_DEFINITION".format(capability),
+                ],
+                visibility = ["//executorch/kernels/optimized/..."],
+                deps = variant_deps + [sleef_dep],
+            )
+            capability_targets.append(":" + capability_name)
+
+    runtime.cxx_library(
+        name = name,
+        srcs = srcs,
+        exported_headers = exported_headers,
+        compiler_flags = compiler_flags,
+        preprocessor_flags = get_vec_preprocessor_flags(),
+        visibility = ["//executorch/kernels/optimized/..."],
+        deps = get_vec_deps(),
+        exported_deps = variant_deps + select({
+            "DEFAULT": [],
+            "ovr_config//cpu:x86_64": capability_targets,
+        }),
+        # Like op targets, the DEFAULT variant needs sleef as a direct
+        # dependency on Android; see define_op_library().
+        fbandroid_platform_deps = [
+            (
+                "^android-arm64.*$",
+                [
+                    "fbsource//third-party/sleef:sleef_arm",
+                ],
+            ),
+        ],
+    )
+
 def op_target(name, deps = []):
     """Registers an optimized implementation for an operator overload group.
 
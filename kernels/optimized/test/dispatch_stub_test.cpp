@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Register a kernel for every level from this one translation unit, as a build
+// with all variants would.
+#define ET_HAVE_AVX2_CPU_DEFINITION
+#define ET_HAVE_AVX512_CPU_DEFINITION
+
+#include <executorch/kernels/optimized/utils/dispatch_stub.h>
+
+#include <gtest/gtest.h>
+
+using executorch::utils::CPUCapability;
+using executorch::utils::get_cpu_capability;
+
+namespace {
+
+using capability_fn = int (*)(int);
+
+int default_kernel(int x) {
+  return x;
+}
+
+int avx2_kernel(int x) {
+  return 2 * x;
+}
+
+int avx512_kernel(int x) {
+  return 3 * x;
+}
+
+DECLARE_DISPATCH(capability_fn, test_stub);
+DEFINE_DISPATCH(test_stub);
+REGISTER_ARCH_DISPATCH(test_stub, DEFAULT, &default_kernel);
+REGISTER_ARCH_DISPATCH(test_stub, AVX2, &avx2_kernel);
+REGISTER_ARCH_DISPATCH(test_stub, AVX512, &avx512_kernel);
+
+} // namespace
+
+TEST(DispatchStubTest, ChoosesHighestSupportedLevel) {
+  using Stub = test_stub_DECLARE_DISPATCH_type;
+  EXPECT_EQ(Stub::choose_cpu_impl(CPUCapability::DEFAULT), &default_kernel);
+  EXPECT_EQ(Stub::choose_cpu_impl(CPUCapability::AVX2), &avx2_kernel);
+  EXPECT_EQ(Stub::choose_cpu_impl(CPUCapability::AVX512), &avx512_kernel);
+}
+
+TEST(DispatchStubTest, CallsKernelForHostCapability) {
+  const int expected_multiplier = static_cast<int>(get_cpu_capability()) + 1;
+  EXPECT_EQ(test_stub(7), 7 * expected_multiplier);
+  // The choice is cached.
+  EXPECT_EQ(test_stub(5), 5 * expected_multiplier);
+}
+
+TEST(DispatchStubTest, CapabilityIsStable) {
+  EXPECT_EQ(get_cpu_capability(), get_cpu_capability());
+#if !defined(__x86_64__) && !defined(__i386__)
+  EXPECT_EQ(get_cpu_capability(), CPUCapability::DEFAULT);
+#endif
+}
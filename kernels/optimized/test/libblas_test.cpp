@@ -11,6 +11,7 @@
 #include <executorch/kernels/optimized/blas/CPUBlas.h>
 #include <executorch/runtime/core/exec_aten/exec_aten.h>
 
+#include <limits>
 #include <vector>
 
 #define TEST_FORALL_SUPPORTED_CTYPES(_, N) \
@@ -76,3 +77,127 @@ void test_matmul_ones() {
 TEST(BlasTest, MatmulOnes) {
   TEST_FORALL_SUPPORTED_CTYPES(test_matmul_ones, 25);
 }
+
+namespace {
+
+// Column-major reference: c = alpha * op(a) @ op(b) + beta * c.
+template <typename T>
+void reference_gemm(
+    bool transa,
+    bool transb,
+    int64_t m,
+    int64_t n,
+    int64_t k,
+    T alpha,
+    const std::vector<T>& a,
+    int64_t lda,
+    const std::vector<T>& b,
+    int64_t ldb,
+    T beta,
+    std::vector<T>& c,
+    int64_t ldc) {
+  for (int64_t j = 0; j < n; ++j) {
+    for (int64_t i = 0; i < m; ++i) {
+      double dot = 0;
+      for (int64_t l = 0; l < k; ++l) {
+        const T a_il = transa ? a[l + i * lda] : a[i + l * lda];
+        const T b_lj = transb ? b[j + l * ldb] : b[l + j * ldb];
+        dot += static_cast<double>(a_il) * static_cast<double>(b_lj);
+      }
+      c[i + j * ldc] = static_cast<T>(alpha * dot + beta * c[i + j * ldc]);
+    }
+  }
+}
+
+template <typename T>
+void test_matmul_matches_reference(
+    bool transa,
+    bool transb,
+    int64_t m,
+    int64_t n,
+    int64_t k,
+    T alpha,
+    T beta) {
+  using executorch::cpublas::TransposeType;
+
+  // Leading dimensions larger than the minimum exercise strided access.
+  const int64_t lda = (transa ? k : m) + 3;
+  const int64_t ldb = (transb ? n : k) + 1;
+  const int64_t ldc = m + 2;
+  std::vector<T> a(lda * (transa ? m : k));
+  std::vector<T> b(ldb * (transb ? k : n));
+  std::vector<T> c(ldc * n);
+  for (size_t i = 0; i < a.size(); ++i) {
+    a[i] = static_cast<T>(static_cast<int>(i % 7) - 3) / 4;
+  }
+  for (size_t i = 0; i < b.size(); ++i) {
+    b[i] = static_cast<T>(static_cast<int>(i % 5) - 2) / 2;
+  }
+  for (size_t i = 0; i < c.size(); ++i) {
+    c[i] = static_cast<T>(i % 3);
+  }
+  std::vector<T> expected = c;
+  reference_gemm(
+      transa, transb, m, n, k, alpha, a, lda, b, ldb, beta, expected, ldc);
+
+  // clang-format off
+  executorch::cpublas::gemm(
+      transa ? TransposeType::Transpose : TransposeType::NoTranspose,
+      transb ? TransposeType::Transpose : TransposeType::NoTranspose,
+      m, n, k,
+      alpha,
+      a.data(), lda,
+      b.data(), ldb,
+      beta,
+      c.data(), ldc);
+  // clang-format on
+
+  for (int64_t j = 0; j < n; ++j) {
+    for (int64_t i = 0; i < m; ++i) {
+      ASSERT_NEAR(c[i + j * ldc], expected[i + j * ldc], 1e-3)
+          << "transa=" << transa << " transb=" << transb << " i=" << i
+          << " j=" << j;
+    }
+    // Padding between columns is left untouched.
+    for (int64_t i = m; i < ldc; ++i) {
+      ASSERT_EQ(c[i + j * ldc], static_cast<T>((i + j * ldc) % 3));
+    }
+  }
+}
+
+} // namespace
+
+TEST(BlasTest, MatmulMatchesReference) {
+  // Sizes cover partial microkernel tiles and several blocks along m and k.
+  for (bool transa : {false, true}) {
+    for (bool transb : {false, true}) {
+      test_matmul_matches_reference<float>(
+          transa, transb, 37, 29, 45, 1.0f, 0.0f);
+      test_matmul_matches_reference<float>(
+          transa, transb, 150, 41, 300, 0.5f, 2.0f);
+      test_matmul_matches_reference<double>(
+          transa, transb, 70, 13, 270, -1.0, 1.0);
+    }
+  }
+}
+
+TEST(BlasTest, MatmulZeroBetaIgnoresNaN) {
+  using executorch::cpublas::TransposeType;
+  constexpr int64_t N = 40;
+  std::vector<float> a(N * N, 1.0f);
+  std::vector<float> b(N * N, 1.0f);
+  std::vector<float> c(N * N, std::numeric_limits<float>::quiet_NaN());
+
+  // clang-format off
+  executorch::cpublas::gemm(
+      TransposeType::NoTranspose, TransposeType::NoTranspose,
+      N, N, N,
+      1.0f,
+      a.data(), N,
+      b.data(), N,
+      0.0f,
+      c.data(), N);
+  // clang-format on
+
+  EXPECT_TRUE(check_all_equal_to(c, static_cast<float>(N)));
+}
@@ -10,7 +10,12 @@
 
 #include <executorch/kernels/optimized/vec/functional.h>
 #include <executorch/kernels/optimized/vec/vec.h>
+#include <executorch/kernels/optimized/vec/vec_math.h>
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <type_traits>
 #include <vector>
 
 #define TEST_FORALL_SUPPORTED_CTYPES(_) \
@@ -72,3 +77,281 @@ void test_load_and_add() {
 TEST(VecFloatTest, LoadAndAdd) {
   TEST_FORALL_SUPPORTED_CTYPES(test_load_and_add);
 }
+
+template <typename T>
+void test_partial_load_and_store() {
+  using Vec = executorch::vec::Vectorized<T>;
+
+  constexpr size_t kVecSize = static_cast<size_t>(Vec::size());
+
+  std::vector<T> in(kVecSize);
+  fill_monotonic(in, 1);
+
+  for (size_t count = 0; count <= kVecSize; ++count) {
+    // Lanes past count are loaded as zero.
+    const Vec loaded = Vec::loadu(in.data(), count);
+    std::vector<T> all(kVecSize);
+    loaded.store(all.data());
+    for (size_t i = 0; i < kVecSize; ++i) {
+      EXPECT_EQ(all[i], i < count ? in[i] : static_cast<T>(0));
+    }
+
+    // Only the first count elements are written.
+    std::vector<T> out(kVecSize, static_cast<T>(-1));
+    Vec::loadu(in.data()).store(out.data(), count);
+    for (size_t i = 0; i < kVecSize; ++i) {
+      EXPECT_EQ(out[i], i < count ? in[i] : static_cast<T>(-1));
+    }
+
+    // set() takes the first count lanes from its second argument.
+    std::vector<T> blended(kVecSize);
+    Vec::set(Vec(static_cast<T>(0)), Vec::loadu(in.data()), count)
+        .store(blended.data());
+    for (size_t i = 0; i < kVecSize; ++i) {
+      EXPECT_EQ(blended[i], i < count ? in[i] : static_cast<T>(0));
+    }
+  }
+}
+
+TEST(VecFloatTest, PartialLoadAndStore) {
+  TEST_FORALL_SUPPORTED_CTYPES(test_partial_load_and_store);
+}
+
+template <typename T>
+void test_compare_and_clamp() {
+  using Vec = executorch::vec::Vectorized<T>;
+
+  constexpr size_t kVecSize = static_cast<size_t>(Vec::size());
+  const T threshold = static_cast<T>(kVecSize / 2);
+
+  std::vector<T> in(kVecSize);
+  fill_monotonic(in);
+  const Vec in_vec = Vec::loadu(in.data());
+
+  std::vector<T> gt(kVecSize);
+  in_vec.gt(Vec(threshold)).store(gt.data());
+  std::vector<T> le(kVecSize);
+  in_vec.le(Vec(threshold)).store(le.data());
+  std::vector<T> selected(kVecSize);
+  Vec::blendv(Vec(static_cast<T>(0)), in_vec, in_vec > Vec(threshold))
+      .store(selected.data());
+  std::vector<T> clamped(kVecSize);
+  executorch::vec::clamp(in_vec, Vec(static_cast<T>(1)), Vec(threshold))
+      .store(clamped.data());
+
+  for (size_t i = 0; i < kVecSize; ++i) {
+    EXPECT_EQ(gt[i], static_cast<T>(in[i] > threshold ? 1 : 0));
+    EXPECT_EQ(le[i], static_cast<T>(in[i] <= threshold ? 1 : 0));
+    EXPECT_EQ(selected[i], in[i] > threshold ? in[i] : static_cast<T>(0));
+    EXPECT_EQ(
+        clamped[i],
+        std::min(std::max(in[i], static_cast<T>(1)), threshold));
+  }
+}
+
+TEST(VecFloatTest, CompareAndClamp) {
+  TEST_FORALL_SUPPORTED_CTYPES(test_compare_and_clamp);
+}
+
+TEST(VecFloatTest, MaximumPropagatesNaN) {
+  using Vec = executorch::vec::Vectorized<float>;
+
+  std::vector<float> a(Vec::size(), 1.0f);
+  std::vector<float> b(Vec::size(), 2.0f);
+  a[0] = std::numeric_limits<float>::quiet_NaN();
+  b[Vec::size() - 1] = std::numeric_limits<float>::quiet_NaN();
+
+  std::vector<float> out(Vec::size());
+  executorch::vec::maximum(Vec::loadu(a.data()), Vec::loadu(b.data()))
+      .store(out.data());
+
+  EXPECT_TRUE(std::isnan(out[0]));
+  EXPECT_TRUE(std::isnan(out[Vec::size() - 1]));
+  for (size_t i = 1; i + 1 < Vec::size(); ++i) {
+    EXPECT_EQ(out[i], 2.0f);
+  }
+}
+
+TEST(VecFloatTest, MapExpMatchesStd) {
+  using Vec = executorch::vec::Vectorized<float>;
+
+  // Not a multiple of the vector size, to cover the tail.
+  std::vector<float> in(3 * Vec::size() + 3);
+  for (size_t i = 0; i < in.size(); ++i) {
+    in[i] = -4.0f + 0.25f * static_cast<float>(i);
+  }
+  std::vector<float> out(in.size());
+  executorch::vec::map<float>(
+      [](Vec x) { return x.exp(); }, out.data(), in.data(), in.size());
+
+  for (size_t i = 0; i < in.size(); ++i) {
+    EXPECT_NEAR(out[i], std::exp(in[i]), 1e-6f * std::exp(in[i]));
+  }
+}
+
+TEST(VecFloatTest, RoundHalfToEven) {
+  using Vec = executorch::vec::Vectorized<float>;
+
+  std::vector<float> in = {-2.5f, -1.5f, -0.5f, 0.5f, 1.5f, 2.5f, 2.4f, -2.6f};
+  in.resize(Vec::size(), 3.5f);
+  std::vector<float> out(in.size());
+  Vec::loadu(in.data()).round().store(out.data());
+
+  for (size_t i = 0; i < in.size(); ++i) {
+    EXPECT_EQ(out[i], std::nearbyint(in[i]));
+  }
+}
+
+template <typename T>
+void test_convert_int8() {
+  // Not a multiple of any vector size, to cover the tails.
+  constexpr int kSize = 100;
+  std::vector<T> in(kSize);
+  for (int i = 0; i < kSize; ++i) {
+    in[i] = std::is_signed<T>::value ? static_cast<T>(i * 5 - 250)
+                                     : static_cast<T>(i * 5 % 256);
+  }
+  std::vector<float> widened(kSize);
+  executorch::vec::convert(in.data(), widened.data(), kSize);
+  for (int i = 0; i < kSize; ++i) {
+    EXPECT_EQ(widened[i], static_cast<float>(in[i]));
+  }
+
+  // Narrowing truncates toward zero, like static_cast.
+  for (int i = 0; i < kSize; ++i) {
+    widened[i] += std::is_signed<T>::value && in[i] < 0 ? -0.75f : 0.75f;
+  }
+  std::vector<T> narrowed(kSize);
+  executorch::vec::convert(widened.data(), narrowed.data(), kSize);
+  EXPECT_EQ(narrowed, in);
+}
+
+TEST(VecConvertTest, Int8AndFloat) {
+  test_convert_int8<int8_t>();
+  test_convert_int8<uint8_t>();
+}
+
+namespace {
+
+// Applies `vec_fn` to `in` and checks each lane against the double precision
+// `ref_fn`, within `rtol` relative or `atol` absolute error.
+template <typename VecFn, typename RefFn>
+void check_vec_math(
+    const std::vector<float>& in,
+    const VecFn& vec_fn,
+    const RefFn& ref_fn,
+    double rtol,
+    double atol) {
+  std::vector<float> out(in.size());
+  executorch::vec::map<float>(vec_fn, out.data(), in.data(), in.size());
+  for (size_t i = 0; i < in.size(); ++i) {
+    const double expected = ref_fn(static_cast<double>(in[i]));
+    if (std::isnan(expected)) {
+      EXPECT_TRUE(std::isnan(out[i])) << "x = " << in[i];
+    } else if (std::isinf(static_cast<float>(expected))) {
+      EXPECT_EQ(out[i], static_cast<float>(expected)) << "x = " << in[i];
+    } else {
+      EXPECT_NEAR(out[i], expected, atol + rtol * std::fabs(expected))
+          << "x = " << in[i];
+    }
+  }
+}
+
+// A sweep over [-range, range], plus values that exercise special cases.
+std::vector<float> vec_math_inputs(float range) {
+  std::vector<float> in;
+  for (float x = -range; x <= range; x += range / 1000.0f) {
+    in.push_back(x);
+  }
+  for (float x : {0.0f,
+                  -0.0f,
+                  1e-30f,
+                  -1e-30f,
+                  88.7f,
+                  -87.3f,
+                  -100.0f,
+                  1000.0f,
+                  -1000.0f,
+                  std::numeric_limits<float>::infinity(),
+                  -std::numeric_limits<float>::infinity(),
+                  std::numeric_limits<float>::quiet_NaN()}) {
+    in.push_back(x);
+  }
+  return in;
+}
+
+} // namespace
+
+TEST(VecMathTest, Exp) {
+  using Vec = executorch::vec::Vectorized<float>;
+  check_vec_math(
+      vec_math_inputs(100.0f),
+      [](Vec x) { return executorch::vec::vec_exp(x); },
+      [](double x) { return std::exp(x); },
+      2e-7,
+      // Subnormal results.
+      2e-45);
+}
+
+TEST(VecMathTest, Tanh) {
+  using Vec = executorch::vec::Vectorized<float>;
+  check_vec_math(
+      vec_math_inputs(10.0f),
+      [](Vec x) { return executorch::vec::vec_tanh(x); },
+      [](double x) { return std::tanh(x); },
+      2e-7,
+      0);
+}
+
+TEST(VecMathTest, Erf) {
+  using Vec = executorch::vec::Vectorized<float>;
+  check_vec_math(
+      vec_math_inputs(5.0f),
+      [](Vec x) { return executorch::vec::vec_erf(x); },
+      [](double x) { return std::erf(x); },
+      0,
+      2e-7);
+}
+
+TEST(VecMathTest, Sigmoid) {
+  using Vec = executorch::vec::Vectorized<float>;
+  check_vec_math(
+      vec_math_inputs(100.0f),
+      [](Vec x) { return executorch::vec::vec_sigmoid(x); },
+      [](double x) { return 1.0 / (1.0 + std::exp(-x)); },
+      4e-7,
+      // Subnormal results flush to zero.
+      std::numeric_limits<float>::min());
+}
+
+TEST(VecMathTest, Gelu) {
+  using Vec = executorch::vec::Vectorized<float>;
+  check_vec_math(
+      vec_math_inputs(10.0f),
+      [](Vec x) { return executorch::vec::vec_gelu(x); },
+      [](double x) { return 0.5 * x * (1.0 + std::erf(x * M_SQRT1_2)); },
+      2e-7,
+      5e-7);
+  check_vec_math(
+      vec_math_inputs(10.0f),
+      [](Vec x) { return executorch::vec::vec_gelu_tanh(x); },
+      [](double x) {
+        const double inner = std::sqrt(2.0 / M_PI) * (x + 0.044715 * x * x * x);
+        return 0.5 * x * (1.0 + std::tanh(inner));
+      },
+      2e-7,
+      5e-7);
+}
+
+TEST(VecMathTest, DoubleUsesVectorizedMethods) {
+  using Vec = executorch::vec::Vectorized<double>;
+  std::vector<double> in(Vec::size());
+  for (size_t i = 0; i < in.size(); ++i) {
+    in[i] = -2.0 + 0.5 * static_cast<double>(i);
+  }
+  std::vector<double> out(in.size());
+  executorch::vec::vec_sigmoid(Vec::loadu(in.data())).store(out.data());
+  for (size_t i = 0; i < in.size(); ++i) {
+    EXPECT_NEAR(out[i], 1.0 / (1.0 + std::exp(-in[i])), 1e-12);
+  }
+}
@@ -41,3 +41,9 @@ def define_common_targets():
     _lib_test_bin("libvec_test_bin")
     _lib_test_bin("moments_utils_test_bin", in_cpu = True)
     _lib_test_bin("libblas_test_bin")
+
+    runtime.cxx_test(
+        name = "dispatch_stub_test",
+        srcs = ["dispatch_stub_test.cpp"],
+        deps = ["//executorch/kernels/optimized:libutils"],
+    )
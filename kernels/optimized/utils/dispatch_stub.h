@@ -0,0 +1,194 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+
+// Runtime CPU dispatch for optimized kernels, modeled on ATen's DispatchStub.
+//
+// A kernel that benefits from wider vectors is written once, in a translation
+// unit that only depends on the vec library, and that file is compiled once per
+// capability level:
+//
+//   DEFAULT: no extra flags
+//   AVX2:    -DCPU_CAPABILITY=AVX2 -DCPU_CAPABILITY_AVX2 -mavx2 -mfma
+//   AVX512:  -DCPU_CAPABILITY=AVX512 -DCPU_CAPABILITY_AVX512 -mavx512f
+//            -mavx512bw -mavx512vl -mavx512dq -mfma
+//
+// The CPU_CAPABILITY define gives each copy of the vec library its own inline
+// namespace so that the copies are not merged by the linker. Each copy
+// registers its kernel with REGISTER_DISPATCH, and the operator calls the stub,
+// which picks the best registered kernel the host supports on first use:
+//
+//   // my_kernel.h
+//   using my_fn = void (*)(const float*, float*, size_t);
+//   DECLARE_DISPATCH(my_fn, my_stub);
+//
+//   // op_my.cpp (compiled once, without capability flags)
+//   DEFINE_DISPATCH(my_stub);
+//   ... my_stub(in, out, n);
+//
+//   // my_kernel.cpp (compiled once per capability level)
+//   REGISTER_DISPATCH(my_stub, &my_kernel_impl);
+//
+// Builds that compile the AVX2 or AVX512 variant must define
+// ET_HAVE_AVX2_CPU_DEFINITION or ET_HAVE_AVX512_CPU_DEFINITION for every
+// translation unit that calls a stub, so that the stub knows the variant
+// exists.
+//
+// Only translation units compiled without capability flags may call a stub:
+// the detection code below is inline, and the linker could otherwise keep a
+// copy that was compiled for a newer CPU than the host.
+
+namespace executorch {
+namespace utils {
+
+enum class CPUCapability {
+  DEFAULT = 0,
+  AVX2 = 1,
+  AVX512 = 2,
+};
+
+namespace internal {
+
+inline CPUCapability compute_cpu_capability() {
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+  __builtin_cpu_init();
+  // The ET_CPU_CAPABILITY environment variable can lower the detected
+  // capability, e.g. to compare variants or to work around a bad kernel.
+  const char* override_capability = std::getenv("ET_CPU_CAPABILITY");
+  if (override_capability != nullptr) {
+    if (strcmp(override_capability, "default") == 0) {
+      return CPUCapability::DEFAULT;
+    }
+    if (strcmp(override_capability, "avx2") == 0 &&
+        __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+      return CPUCapability::AVX2;
+    }
+  }
+  if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") &&
+      __builtin_cpu_supports("avx512vl") &&
+      __builtin_cpu_supports("avx512dq") && __builtin_cpu_supports("fma")) {
+    return CPUCapability::AVX512;
+  }
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+    return CPUCapability::AVX2;
+  }
+#endif
+  return CPUCapability::DEFAULT;
+}
+
+} // namespace internal
+
+/**
+ * Returns the highest capability level supported by the host CPU. Detection
+ * runs once, on the first call.
+ */
+inline CPUCapability get_cpu_capability() {
+  static const CPUCapability capability = internal::compute_cpu_capability();
+  return capability;
+}
+
+template <typename FnPtr, typename T>
+struct DispatchStub;
+
+/**
+ * Base of the stubs declared by DECLARE_DISPATCH(). T is the stub type, which
+ * holds the kernel registered for each level in its DEFAULT, AVX2 and AVX512
+ * static members.
+ */
+template <typename rT, typename T, typename... Args>
+struct DispatchStub<rT (*)(Args...), T> {
+  using FnPtr = rT (*)(Args...);
+
+  DispatchStub() = default;
+  DispatchStub(const DispatchStub&) = delete;
+  DispatchStub& operator=(const DispatchStub&) = delete;
+
+  template <typename... ArgTypes>
+  rT operator()(ArgTypes&&... args) {
+    FnPtr fn = cpu_dispatch_ptr_.load(std::memory_order_relaxed);
+    if (fn == nullptr) {
+      // Racing threads all choose the same kernel, so the store is benign.
+      fn = choose_cpu_impl(get_cpu_capability());
+      cpu_dispatch_ptr_.store(fn, std::memory_order_relaxed);
+    }
+    return (*fn)(std::forward<ArgTypes>(args)...);
+  }
+
+  /**
+   * Returns the kernel registered for the highest level that does not exceed
+   * `capability`. Exposed so that tests can exercise each variant.
+   */
+  static FnPtr choose_cpu_impl(CPUCapability capability) {
+#ifdef ET_HAVE_AVX512_CPU_DEFINITION
+    if (capability >= CPUCapability::AVX512) {
+      return T::AVX512;
+    }
+#endif
+#ifdef ET_HAVE_AVX2_CPU_DEFINITION
+    if (capability >= CPUCapability::AVX2) {
+      return T::AVX2;
+    }
+#endif
+    (void)capability;
+    return T::DEFAULT;
+  }
+
+ private:
+  std::atomic<FnPtr> cpu_dispatch_ptr_{nullptr};
+};
+
+} // namespace utils
+} // namespace executorch
+
+/**
+ * Declares a stub named `name` that dispatches calls to kernels of type `fn`.
+ * The kernels must be registered in the same namespace.
+ */
+#define DECLARE_DISPATCH(fn, name)                                      \
+  struct name##_DECLARE_DISPATCH_type                                   \
+      : ::executorch::utils::                                           \
+            DispatchStub<fn, name##_DECLARE_DISPATCH_type> {            \
+    name##_DECLARE_DISPATCH_type() = default;                           \
+    /* Defined by REGISTER_DISPATCH for each compiled level. */         \
+    static FnPtr DEFAULT;                                               \
+    static FnPtr AVX2;                                                  \
+    static FnPtr AVX512;                                                \
+  };                                                                    \
+  extern struct name##_DECLARE_DISPATCH_type name
+
+/**
+ * Defines the stub declared by DECLARE_DISPATCH(). Must appear in exactly one
+ * translation unit, which is compiled without capability flags.
+ */
+#define DEFINE_DISPATCH(name) struct name##_DECLARE_DISPATCH_type name
+
+/**
+ * Registers `fn` as the `arch` (DEFAULT, AVX2 or AVX512) kernel of the stub.
+ * The registration is a constant-initialized variable, so it does not depend
+ * on static initialization order.
+ */
+#define REGISTER_ARCH_DISPATCH(name, arch, fn) \
+  name##_DECLARE_DISPATCH_type::FnPtr name##_DECLARE_DISPATCH_type::arch = fn
+
+/**
+ * Registers `fn` for the capability level this translation unit is compiled
+ * for.
+ */
+#if defined(CPU_CAPABILITY_AVX512)
+#define REGISTER_DISPATCH(name, fn) REGISTER_ARCH_DISPATCH(name, AVX512, fn)
+#elif defined(CPU_CAPABILITY_AVX2)
+#define REGISTER_DISPATCH(name, fn) REGISTER_ARCH_DISPATCH(name, AVX2, fn)
+#else
+#define REGISTER_DISPATCH(name, fn) REGISTER_ARCH_DISPATCH(name, DEFAULT, fn)
+#endif
@@ -526,7 +526,9 @@ public:
         vnegq_f32(values.val[1]));
   }
   Vectorized<float> round() const {
-    return map(std::round);
+    float32x4_t r0 = vrndnq_f32(values.val[0]);
+    float32x4_t r1 = vrndnq_f32(values.val[1]);
+    return Vectorized<float>(r0, r1);
   }
   Vectorized<float> tan() const {
     return USE_SLEEF(
@@ -327,6 +327,98 @@ inline void convert(const int32_t *src, double *dst, int64_t n) {
   }
 }
 
+template <>
+inline void convert(const int8_t *src, float *dst, int64_t n) {
+  int64_t i;
+  // Sign-extend 8 bytes at a time to int32_t, then convert.
+#ifndef _MSC_VER
+# pragma unroll
+#endif
+  for (i = 0; i <= (n - Vectorized<float>::size()); i += Vectorized<float>::size()) {
+    auto input_vec = _mm256_cvtepi8_epi32(
+        _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + i)));
+    _mm256_storeu_ps(dst + i, _mm256_cvtepi32_ps(input_vec));
+  }
+#ifndef _MSC_VER
+# pragma unroll
+#endif
+  for (; i < n; i++) {
+    dst[i] = static_cast<float>(src[i]);
+  }
+}
+
+template <>
+inline void convert(const uint8_t *src, float *dst, int64_t n) {
+  int64_t i;
+#ifndef _MSC_VER
+# pragma unroll
+#endif
+  for (i = 0; i <= (n - Vectorized<float>::size()); i += Vectorized<float>::size()) {
+    auto input_vec = _mm256_cvtepu8_epi32(
+        _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + i)));
+    _mm256_storeu_ps(dst + i, _mm256_cvtepi32_ps(input_vec));
+  }
+#ifndef _MSC_VER
+# pragma unroll
+#endif
+  for (; i < n; i++) {
+    dst[i] = static_cast<float>(src[i]);
+  }
+}
+
+// Truncates 32 floats to int32_t and packs them into bytes with saturation.
+// _mm256_packs_* work within 128-bit lanes, so the result holds groups of
+// four values in the order 0, 2, 4, 6, 1, 3, 5, 7 and needs a permute.
+template <bool is_unsigned>
+inline __m256i pack_float_to_int8(const float *src) {
+  auto a = _mm256_cvttps_epi32(_mm256_loadu_ps(src));
+  auto b = _mm256_cvttps_epi32(_mm256_loadu_ps(src + 8));
+  auto c = _mm256_cvttps_epi32(_mm256_loadu_ps(src + 16));
+  auto d = _mm256_cvttps_epi32(_mm256_loadu_ps(src + 24));
+  auto ab = _mm256_packs_epi32(a, b);
+  auto cd = _mm256_packs_epi32(c, d);
+  auto abcd = is_unsigned ? _mm256_packus_epi16(ab, cd)
+                          : _mm256_packs_epi16(ab, cd);
+  return _mm256_permutevar8x32_epi32(
+      abcd, _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7));
+}
+
+template <>
+inline void convert(const float *src, int8_t *dst, int64_t n) {
+  int64_t i;
+#ifndef _MSC_VER
+# pragma unroll
+#endif
+  for (i = 0; i <= (n - 32); i += 32) {
+    _mm256_storeu_si256(
+        reinterpret_cast<__m256i*>(dst + i), pack_float_to_int8<false>(src + i));
+  }
+#ifndef _MSC_VER
+# pragma unroll
+#endif
+  for (; i < n; i++) {
+    dst[i] = static_cast<int8_t>(src[i]);
+  }
+}
+
+template <>
+inline void convert(const float *src, uint8_t *dst, int64_t n) {
+  int64_t i;
+#ifndef _MSC_VER
+# pragma unroll
+#endif
+  for (i = 0; i <= (n - 32); i += 32) {
+    _mm256_storeu_si256(
+        reinterpret_cast<__m256i*>(dst + i), pack_float_to_int8<true>(src + i));
+  }
+#ifndef _MSC_VER
+# pragma unroll
+#endif
+  for (; i < n; i++) {
+    dst[i] = static_cast<uint8_t>(src[i]);
+  }
+}
+
 template <>
 class Vectorized<int16_t> : public Vectorizedi {
 private:
@@ -339,9 +339,9 @@ public:
     return ret;
   }
   Vectorized<T> round() const {
-    // TODO(T149257433): implement custom round that rounds midway numbers to
-    // the nearest even integer.
-    return map(std::round);
+    // Rounds midway numbers to the nearest even integer, as the AVX2 and
+    // AVX-512 specializations do.
+    return map(std::nearbyint);
   }
   Vectorized<T> sin() const {
     return map(std::sin);
@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+// DO NOT DEFINE STATIC DATA IN THIS HEADER!
+// See Note [Do not compile initializers with AVX]
+
+#include <cmath>
+
+#include <executorch/kernels/optimized/vec/vec.h>
+
+// Vectorized transcendental functions that do not depend on a vector math
+// library.
+//
+// Vectorized<float>::exp() and friends call SLEEF where it is linked, and
+// otherwise fall back to calling libm once per lane. The functions below are
+// written in terms of Vectorized<float> arithmetic instead: range reduction
+// followed by a polynomial, as in Cephes and SLEEF. They therefore compile to
+// AVX2, AVX-512 or NEON code with the rest of the vec library, and to plain
+// (auto-vectorizable) loops in DEFAULT builds.
+//
+// Maximum errors measured against a double precision reference:
+//
+//   vec_exp      1 ulp; subnormal results within 1 subnormal ulp
+//   vec_tanh     1 ulp
+//   vec_erf      2e-7 absolute
+//   vec_sigmoid  3 ulp; results below FLT_MIN flush to zero
+//   vec_gelu, vec_gelu_tanh  follow from vec_erf and vec_tanh
+//
+// Infinities and NaNs are propagated as libm does. For other element types
+// the functions call the corresponding Vectorized<T> methods.
+
+namespace executorch {
+namespace vec {
+
+// See Note [CPU_CAPABILITY namespace]
+inline namespace CPU_CAPABILITY {
+
+namespace internal {
+
+/**
+ * Returns 2^n for each lane of `n`, which must hold integers in
+ * [-126, 127]. Builds the IEEE-754 bit pattern of the result directly.
+ */
+inline Vectorized<float> pow2_int(const Vectorized<float>& n) {
+  // (n + 127) << 23, computed in float: the product is an integer below
+  // 2^31 with at most 8 significant bits, so it is exact.
+  const Vectorized<float> biased =
+      (n + Vectorized<float>(127.0f)) * Vectorized<float>(8388608.0f);
+#if defined(__aarch64__)
+  return Vectorized<float>(
+      vreinterpretq_f32_s32(vcvtq_s32_f32(biased.get_low())),
+      vreinterpretq_f32_s32(vcvtq_s32_f32(biased.get_high())));
+#else
+  return cast<float>(convert_to_int_of_same_size(biased));
+#endif
+}
+
+} // namespace internal
+
+template <typename T>
+inline Vectorized<T> vec_exp(const Vectorized<T>& x) {
+  return x.exp();
+}
+
+/**
+ * exp(x) = 2^n * exp(r), where n = round(x / ln 2) and |r| <= ln(2) / 2.
+ * exp(r) is the Cephes expf polynomial.
+ */
+inline Vectorized<float> vec_exp(const Vectorized<float>& x) {
+  using Vec = Vectorized<float>;
+  // Below kMinInput the result rounds to zero. Above kMaxInput it
+  // overflows, which the clamped input still produces.
+  const Vec kMinInput(-103.972084f);
+  const Vec kMaxInput(88.8f);
+  const Vec kLog2e(1.44269504088896341f);
+  const Vec kNegLn2Hi(-0.693359375f);
+  const Vec kNegLn2Lo(2.12194440e-4f);
+
+  const Vec clamped = minimum(maximum(x, kMinInput), kMaxInput);
+  const Vec n = (clamped * kLog2e).round();
+  // Cody-Waite reduction: n * kNegLn2Hi is exact.
+  Vec r = fmadd(n, kNegLn2Hi, clamped);
+  r = fmadd(n, kNegLn2Lo, r);
+
+  Vec p(1.9875691500e-4f);
+  p = fmadd(p, r, Vec(1.3981999507e-3f));
+  p = fmadd(p, r, Vec(8.3334519073e-3f));
+  p = fmadd(p, r, Vec(4.1665795894e-2f));
+  p = fmadd(p, r, Vec(1.6666665459e-1f));
+  p = fmadd(p, r, Vec(5.0000001201e-1f));
+  p = fmadd(p * r, r, r + Vec(1.0f));
+
+  // n lies in [-150, 128], so apply 2^n in two steps to keep each exponent
+  // representable. This also yields subnormal results and overflows to
+  // infinity.
+  const Vec n1 = (n * Vec(0.5f)).round();
+  const Vec n2 = n - n1;
+  Vec result = p * internal::pow2_int(n1) * internal::pow2_int(n2);
+
+  result = Vec::blendv(result, Vec(0.0f), x < kMinInput);
+  return Vec::blendv(result, x, x != x);
+}
+
+template <typename T>
+inline Vectorized<T> vec_tanh(const Vectorized<T>& x) {
+  return x.tanh();
+}
+
+/**
+ * tanh(x) = 1 - 2 / (exp(2|x|) + 1) with the sign of x. Below |x| = 0.625,
+ * where that loses precision, uses the Cephes tanhf polynomial instead.
+ */
+inline Vectorized<float> vec_tanh(const Vectorized<float>& x) {
+  using Vec = Vectorized<float>;
+  const Vec one(1.0f);
+  const Vec abs_x = x.abs();
+
+  const Vec z = x * x;
+  Vec p(-5.70498872745e-3f);
+  p = fmadd(p, z, Vec(2.06390887954e-2f));
+  p = fmadd(p, z, Vec(-5.37397155531e-2f));
+  p = fmadd(p, z, Vec(1.33314422036e-1f));
+  p = fmadd(p, z, Vec(-3.33332819422e-1f));
+  const Vec small = fmadd(p * z, x, x);
+
+  // exp overflows to infinity for large |x|, giving exactly 1.
+  Vec large = one - Vec(2.0f) / (vec_exp(abs_x + abs_x) + one);
+  large = Vec::blendv(large, large.neg(), x < Vec(0.0f));
+
+  return Vec::blendv(large, small, abs_x < Vec(0.625f));
+}
+
+template <typename T>
+inline Vectorized<T> vec_erf(const Vectorized<T>& x) {
+  return x.erf();
+}
+
+/**
+ * Below |x| = 1, erf(x) = x * P(x^2) with the Cephes erff polynomial. Above,
+ * Abramowitz and Stegun formula 7.1.26:
+ * erf(|x|) = 1 - (a1 t + ... + a5 t^5) exp(-x^2), where t = 1 / (1 + p|x|).
+ */
+inline Vectorized<float> vec_erf(const Vectorized<float>& x) {
+  using Vec = Vectorized<float>;
+  const Vec one(1.0f);
+  const Vec abs_x = x.abs();
+  const Vec z = x * x;
+
+  Vec q(7.853861353153693e-5f);
+  q = fmadd(q, z, Vec(-8.010193625184903e-4f));
+  q = fmadd(q, z, Vec(5.188327685732524e-3f));
+  q = fmadd(q, z, Vec(-2.685381193529856e-2f));
+  q = fmadd(q, z, Vec(1.128358514861418e-1f));
+  q = fmadd(q, z, Vec(-3.761262582423300e-1f));
+  q = fmadd(q, z, Vec(1.128379165726710f));
+  const Vec small = x * q;
+
+  const Vec t = one / fmadd(Vec(0.3275911f), abs_x, one);
+  Vec p(1.061405429f);
+  p = fmadd(p, t, Vec(-1.453152027f));
+  p = fmadd(p, t, Vec(1.421413741f));
+  p = fmadd(p, t, Vec(-0.284496736f));
+  p = fmadd(p, t, Vec(0.254829592f));
+  p = p * t;
+  Vec large = one - p * vec_exp(z.neg());
+  large = Vec::blendv(large, large.neg(), x < Vec(0.0f));
+
+  return Vec::blendv(large, small, abs_x < one);
+}
+
+template <typename T>
+inline Vectorized<T> vec_sigmoid(const Vectorized<T>& x) {
+  const Vectorized<T> one(static_cast<T>(1));
+  return one / (one + vec_exp(x.neg()));
+}
+
+/**
+ * gelu(x) = x / 2 * (1 + erf(x / sqrt(2))).
+ */
+template <typename T>
+inline Vectorized<T> vec_gelu(const Vectorized<T>& x) {
+  const Vectorized<T> half(static_cast<T>(0.5));
+  const Vectorized<T> one(static_cast<T>(1));
+  const Vectorized<T> kAlpha(static_cast<T>(M_SQRT1_2));
+  return half * x * (one + vec_erf(x * kAlpha));
+}
+
+/**
+ * The tanh approximation of gelu:
+ * x / 2 * (1 + tanh(sqrt(2 / pi) * (x + 0.044715 * x^3))).
+ */
+template <typename T>
+inline Vectorized<T> vec_gelu_tanh(const Vectorized<T>& x) {
+  const Vectorized<T> half(static_cast<T>(0.5));
+  const Vectorized<T> one(static_cast<T>(1));
+  const Vectorized<T> kBeta(static_cast<T>(M_SQRT2 * M_2_SQRTPI * 0.5));
+  const Vectorized<T> kKappa(static_cast<T>(0.044715));
+  const Vectorized<T> inner = kBeta * fmadd(kKappa * x * x, x, x);
+  return half * x * (one + vec_tanh(inner));
+}
+
+} // namespace CPU_CAPABILITY
+
+} // namespace vec
+} // namespace executorch
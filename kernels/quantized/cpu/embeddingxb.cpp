@@ -6,12 +6,19 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <executorch/kernels/optimized/vec/functional.h>
+#include <executorch/kernels/optimized/vec/vec.h>
 #include <executorch/kernels/quantized/cpu/embeddingxb.h>
 #include <executorch/runtime/kernel/kernel_includes.h>
 #include <algorithm>
 #include <cassert>
 #include <cinttypes>
 #include <cmath>
+#include <type_traits>
+
+#ifdef ET_USE_THREADPOOL
+#include <executorch/extension/parallel/thread_parallel.h>
+#endif
 
 namespace torch {
 namespace executor {
@@ -23,32 +30,138 @@ using ScalarType = exec_aten::ScalarType;
 
 namespace {
 
-static inline int32_t
-weight_value(const unsigned char* w_data, int32_t index, int32_t weight_nbit) {
-  if (weight_nbit == 2) {
-    int32_t subbyte = index % 4;
-    index >>= 2;
-    switch (subbyte) {
-      case 0:
-        return (int32_t)(w_data[index] & 3) - 2;
-      case 1:
-        return (int32_t)((w_data[index] & 12) >> 2) - 2;
-      case 2:
-        return (int32_t)((w_data[index] & 48) >> 4) - 2;
-      case 3:
-        return (int32_t)((w_data[index] & 192) >> 6) - 2;
-    }
-  } else if (weight_nbit == 4) {
-    int32_t odd = index & 1;
-    index >>= 1;
-    if (odd) {
-      return (int32_t)(w_data[index] & 0x0F) - 8;
+// Number of values unpacked from a row at a time. A multiple of the number of
+// values per byte for every supported weight_nbit.
+constexpr int32_t kUnpackBlockSize = 1024;
+
+#if defined(CPU_CAPABILITY_AVX2)
+/**
+ * Interleaves the bytes of `a` and `b` and stores the 64 results.
+ * _mm256_unpack*_epi8 interleave within 128-bit lanes, so the lanes are
+ * put back in order before storing.
+ */
+inline void store_interleaved(__m256i a, __m256i b, int8_t* out) {
+  const __m256i lo = _mm256_unpacklo_epi8(a, b);
+  const __m256i hi = _mm256_unpackhi_epi8(a, b);
+  _mm256_storeu_si256(
+      reinterpret_cast<__m256i*>(out), _mm256_permute2x128_si256(lo, hi, 0x20));
+  _mm256_storeu_si256(
+      reinterpret_cast<__m256i*>(out + 32),
+      _mm256_permute2x128_si256(lo, hi, 0x31));
+}
+
+// Unpacks 32 bytes of 4-bit values.
+inline void unpack_4bit_block(const uint8_t* w_data, int8_t* values) {
+  const __m256i mask = _mm256_set1_epi8(0x0F);
+  const __m256i offset = _mm256_set1_epi8(8);
+  const __m256i bytes =
+      _mm256_loadu_si256(reinterpret_cast<const __m256i*>(w_data));
+  // There is no 8-bit shift; shifting 16-bit lanes and masking is the same.
+  const __m256i high = _mm256_sub_epi8(
+      _mm256_and_si256(_mm256_srli_epi16(bytes, 4), mask), offset);
+  const __m256i low = _mm256_sub_epi8(_mm256_and_si256(bytes, mask), offset);
+  store_interleaved(high, low, values);
+}
+
+// Unpacks 32 bytes of 2-bit values.
+inline void unpack_2bit_block(const uint8_t* w_data, int8_t* values) {
+  const __m256i mask = _mm256_set1_epi8(3);
+  const __m256i offset = _mm256_set1_epi8(2);
+  const __m256i bytes =
+      _mm256_loadu_si256(reinterpret_cast<const __m256i*>(w_data));
+  const auto field = [&](int shift) {
+    return _mm256_sub_epi8(
+        _mm256_and_si256(_mm256_srli_epi16(bytes, shift), mask), offset);
+  };
+  // Pairs of values 0 and 1, and 2 and 3, then groups of all four.
+  const __m256i v0 = field(0);
+  const __m256i v1 = field(2);
+  const __m256i v2 = field(4);
+  const __m256i v3 = field(6);
+  const __m256i v01_lo = _mm256_unpacklo_epi8(v0, v1);
+  const __m256i v01_hi = _mm256_unpackhi_epi8(v0, v1);
+  const __m256i v23_lo = _mm256_unpacklo_epi8(v2, v3);
+  const __m256i v23_hi = _mm256_unpackhi_epi8(v2, v3);
+  // Per 128-bit lane, bytes 0-3, 4-7, 8-11 and 12-15.
+  const __m256i q0 = _mm256_unpacklo_epi16(v01_lo, v23_lo);
+  const __m256i q1 = _mm256_unpackhi_epi16(v01_lo, v23_lo);
+  const __m256i q2 = _mm256_unpacklo_epi16(v01_hi, v23_hi);
+  const __m256i q3 = _mm256_unpackhi_epi16(v01_hi, v23_hi);
+  __m256i* out = reinterpret_cast<__m256i*>(values);
+  _mm256_storeu_si256(out, _mm256_permute2x128_si256(q0, q1, 0x20));
+  _mm256_storeu_si256(out + 1, _mm256_permute2x128_si256(q2, q3, 0x20));
+  _mm256_storeu_si256(out + 2, _mm256_permute2x128_si256(q0, q1, 0x31));
+  _mm256_storeu_si256(out + 3, _mm256_permute2x128_si256(q2, q3, 0x31));
+}
+
+constexpr int32_t kUnpackBytesPerBlock = 32;
+#elif defined(__aarch64__)
+// Unpacks 16 bytes of 4-bit values.
+inline void unpack_4bit_block(const uint8_t* w_data, int8_t* values) {
+  const uint8x16_t bytes = vld1q_u8(w_data);
+  const int8x16_t offset = vdupq_n_s8(8);
+  int8x16x2_t result;
+  result.val[0] = vsubq_s8(vreinterpretq_s8_u8(vshrq_n_u8(bytes, 4)), offset);
+  result.val[1] = vsubq_s8(
+      vreinterpretq_s8_u8(vandq_u8(bytes, vdupq_n_u8(0x0F))), offset);
+  vst2q_s8(values, result);
+}
+
+// Unpacks 16 bytes of 2-bit values.
+inline void unpack_2bit_block(const uint8_t* w_data, int8_t* values) {
+  const uint8x16_t bytes = vld1q_u8(w_data);
+  const uint8x16_t mask = vdupq_n_u8(3);
+  const int8x16_t offset = vdupq_n_s8(2);
+  int8x16x4_t result;
+  result.val[0] = vsubq_s8(vreinterpretq_s8_u8(vandq_u8(bytes, mask)), offset);
+  result.val[1] = vsubq_s8(
+      vreinterpretq_s8_u8(vandq_u8(vshrq_n_u8(bytes, 2), mask)), offset);
+  result.val[2] = vsubq_s8(
+      vreinterpretq_s8_u8(vandq_u8(vshrq_n_u8(bytes, 4), mask)), offset);
+  result.val[3] = vsubq_s8(vreinterpretq_s8_u8(vshrq_n_u8(bytes, 6)), offset);
+  vst4q_s8(values, result);
+}
+
+constexpr int32_t kUnpackBytesPerBlock = 16;
+#endif
+
+/**
+ * Unpacks the `num_values` packed values starting at `w_data` into signed
+ * integers. 4-bit values are stored high nibble first and offset by 8; 2-bit
+ * values are stored lowest bits first and offset by 2. Whole vectors of bytes
+ * are unpacked with AVX2 or NEON, and the remaining bytes one at a time.
+ */
+void unpack_values(
+    const uint8_t* w_data,
+    int8_t* values,
+    int32_t num_values,
+    int32_t weight_nbit) {
+  ET_CHECK_MSG(weight_nbit == 4 || weight_nbit == 2, "invalid weight_nbit");
+  const int32_t values_per_byte = 8 / weight_nbit;
+  const int32_t num_bytes = num_values / values_per_byte;
+  int32_t i = 0;
+#if defined(CPU_CAPABILITY_AVX2) || defined(__aarch64__)
+  for (; i + kUnpackBytesPerBlock <= num_bytes; i += kUnpackBytesPerBlock) {
+    if (weight_nbit == 4) {
+      unpack_4bit_block(w_data + i, values + 2 * i);
     } else {
-      return (int32_t)((w_data[index] >> 4) & 0x0F) - 8;
+      unpack_2bit_block(w_data + i, values + 4 * i);
+    }
+  }
+#endif
+  if (weight_nbit == 4) {
+    for (; i < num_bytes; ++i) {
+      values[2 * i] = static_cast<int8_t>((w_data[i] >> 4) - 8);
+      values[2 * i + 1] = static_cast<int8_t>((w_data[i] & 0x0F) - 8);
+    }
+  } else {
+    for (; i < num_bytes; ++i) {
+      values[4 * i] = static_cast<int8_t>((w_data[i] & 3) - 2);
+      values[4 * i + 1] = static_cast<int8_t>(((w_data[i] >> 2) & 3) - 2);
+      values[4 * i + 2] = static_cast<int8_t>(((w_data[i] >> 4) & 3) - 2);
+      values[4 * i + 3] = static_cast<int8_t>((w_data[i] >> 6) - 2);
     }
   }
-
-  ET_CHECK_MSG(false, "invalid weight_nbit");
 }
 
 static inline int32_t get_embedding_dim(
@@ -191,33 +304,78 @@ void embedding_xbit_per_channel(
     zero_points = opt_weight_zero_points.value().const_data_ptr<CTYPE_PARAMS>();
   }
 
-  for (int i = 0; i < indices.numel(); i++) {
-    int64_t index = indices_ptr[i];
-    // If using groupwise embedding
-    int32_t qparams_index = index * num_groups_per_channel;
-    CTYPE_PARAMS zp = 0.0;
-    const CTYPE_PARAMS* scale_ptr = scales + qparams_index;
-    const CTYPE_PARAMS* zero_points_ptr = nullptr;
-    if (opt_weight_zero_points.has_value()) {
-      zero_points_ptr = zero_points + qparams_index;
-    }
-
-    const uint8_t* w_data =
-        weight.const_data_ptr<uint8_t>() + weight.size(1) * index;
-
-    for (int j = 0; j < embedding_dim; ++j) {
-      int32_t group_id = j / group_size;
-      const CTYPE_PARAMS scale = scale_ptr[group_id];
-      if (opt_weight_zero_points.has_value()) {
-        zp = zero_points_ptr[group_id];
+  const uint8_t* weight_data = weight.const_data_ptr<uint8_t>();
+  const int64_t packed_dim = weight.size(1);
+  const int32_t values_per_byte = 8 / weight_nbit;
+
+  // Dequantizes one row at a time: unpacks a block of the row to int8, widens
+  // it to float, then applies (value - zero_point) * scale per group.
+  const auto dequantize_rows = [&](int64_t begin, int64_t end) {
+    using Vec = executorch::vec::Vectorized<float>;
+    int8_t values[kUnpackBlockSize];
+    float values_float[kUnpackBlockSize];
+    for (int64_t i = begin; i < end; ++i) {
+      const int64_t index = indices_ptr[i];
+      // If using groupwise embedding
+      const int64_t qparams_index = index * num_groups_per_channel;
+      const CTYPE_PARAMS* scale_ptr = scales + qparams_index;
+      const CTYPE_PARAMS* zero_points_ptr =
+          zero_points != nullptr ? zero_points + qparams_index : nullptr;
+      const uint8_t* w_data = weight_data + packed_dim * index;
+      CTYPE_OUT* out_row = out_data + i * embedding_dim;
+
+      for (int32_t block = 0; block < embedding_dim;
+           block += kUnpackBlockSize) {
+        const int32_t block_size =
+            std::min(kUnpackBlockSize, embedding_dim - block);
+        unpack_values(
+            w_data + block / values_per_byte, values, block_size, weight_nbit);
+        float* block_out = values_float;
+        if constexpr (std::is_same_v<CTYPE_OUT, float>) {
+          block_out = out_row + block;
+        }
+        executorch::vec::convert(values, block_out, block_size);
+
+        // Each run of the block that lies within one quantization group.
+        for (int32_t j = 0; j < block_size;) {
+          const int32_t group_id = (block + j) / group_size;
+          const int32_t run_end =
+              std::min(block_size, (group_id + 1) * group_size - block);
+          const Vec scale(static_cast<float>(scale_ptr[group_id]));
+          const Vec zp(
+              zero_points_ptr != nullptr
+                  ? static_cast<float>(zero_points_ptr[group_id])
+                  : 0.0f);
+          executorch::vec::map<float>(
+              [&](Vec x) { return (x - zp) * scale; },
+              block_out + j,
+              block_out + j,
+              run_end - j);
+          j = run_end;
+        }
+
+        if constexpr (!std::is_same_v<CTYPE_OUT, float>) {
+          for (int32_t j = 0; j < block_size; ++j) {
+            out_row[block + j] = static_cast<CTYPE_OUT>(values_float[j]);
+          }
+        }
       }
-      out_data[j] = static_cast<CTYPE_OUT>(
-          (static_cast<float>(weight_value(w_data, j, weight_nbit)) -
-           static_cast<float>(zp)) *
-          static_cast<float>(scale));
     }
-    out_data += embedding_dim;
-  }
+  };
+
+  const int64_t num_indices = indices.numel();
+#ifdef ET_USE_THREADPOOL
+  ::executorch::extension::parallel_for(
+      0,
+      num_indices,
+      std::max<int64_t>(
+          1,
+          ::executorch::extension::kMinElementsPerTask /
+              std::max(1, embedding_dim)),
+      dequantize_rows);
+#else
+  dequantize_rows(0, num_indices);
+#endif
 }
 
 void resize_out_tensor(
@@ -6,7 +6,10 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <executorch/kernels/optimized/vec/functional.h>
+#include <executorch/kernels/optimized/vec/vec.h>
 #include <executorch/kernels/portable/cpu/util/reduce_util.h>
+#include <executorch/kernels/quantized/cpu/quantized_ops_util.h>
 #include <executorch/runtime/kernel/kernel_includes.h>
 #include <algorithm>
 #include <cinttypes>
@@ -23,6 +26,19 @@ using Tensor = exec_aten::Tensor;
 using Scalar = exec_aten::Scalar;
 using ScalarType = exec_aten::ScalarType;
 
+float get_scale(const Tensor& scale, size_t channel_ix) {
+  ET_CHECK_MSG(
+      (scale.scalar_type() == ScalarType::Double) ||
+          (scale.scalar_type() == ScalarType::Float),
+      "scale.scalar_type() %" PRId8 " is not double or float type",
+      static_cast<int8_t>(scale.scalar_type()));
+  if (scale.scalar_type() == ScalarType::Double) {
+    return static_cast<float>(scale.const_data_ptr<double>()[channel_ix]);
+  } else {
+    return scale.const_data_ptr<float>()[channel_ix];
+  }
+}
+
 namespace {
 
 /**
@@ -63,6 +79,103 @@ void check_dequantize_per_tensor_args(
       quant_max);
 }
 
+// Number of elements the vectorized path converts to float at a time, so that
+// the scaling pass reads them back from L1.
+constexpr int64_t kDequantizeBlockSize = 1024;
+
+// Integers up to this magnitude are exactly representable as float.
+constexpr int64_t kMaxExactFloatInteger = int64_t(1) << 24;
+
+/**
+ * Returns true if the vectorized kernels below handle this input and output:
+ * contiguous int8 or uint8 values dequantized to float.
+ */
+bool can_dequantize_vectorized(const Tensor& input, const Tensor& out) {
+  return (input.scalar_type() == ScalarType::Char ||
+          input.scalar_type() == ScalarType::Byte) &&
+      out.scalar_type() == ScalarType::Float && is_contiguous(input) &&
+      is_contiguous(out);
+}
+
+/**
+ * Dequantizes `numel` consecutive values that share a scale and zero point.
+ * Matches the scalar kernels exactly: (in - zero_point) is computed in float,
+ * where it is exact whenever zero_point is.
+ */
+template <typename CTYPE_IN>
+void dequantize_contiguous(
+    const CTYPE_IN* in,
+    float* out,
+    int64_t numel,
+    float scale,
+    int64_t zero_point) {
+  if (zero_point < -kMaxExactFloatInteger ||
+      zero_point > kMaxExactFloatInteger) {
+    for (int64_t i = 0; i < numel; ++i) {
+      out[i] = static_cast<float>((in[i] - zero_point) * scale);
+    }
+    return;
+  }
+  using Vec = executorch::vec::Vectorized<float>;
+  const Vec scale_vec(scale);
+  const Vec zero_point_vec(static_cast<float>(zero_point));
+  for (int64_t i = 0; i < numel; i += kDequantizeBlockSize) {
+    const int64_t n = std::min(kDequantizeBlockSize, numel - i);
+    executorch::vec::convert(in + i, out + i, n);
+    executorch::vec::map<float>(
+        [&](Vec x) { return (x - zero_point_vec) * scale_vec; },
+        out + i,
+        out + i,
+        n);
+  }
+}
+
+template <typename CTYPE_IN>
+void dequantize_per_tensor_vectorized(
+    const Tensor& input,
+    float scale,
+    int64_t zero_point,
+    Tensor& out) {
+  const CTYPE_IN* in_data = input.const_data_ptr<CTYPE_IN>();
+  float* out_data = out.mutable_data_ptr<float>();
+  const int64_t numel = input.numel();
+  for_each_row_segment(numel, numel, [&](int64_t begin, int64_t end, int64_t) {
+    dequantize_contiguous(
+        in_data + begin, out_data + begin, end - begin, scale, zero_point);
+  });
+}
+
+/**
+ * Views the input as [outer, channels, inner], where channels is the size of
+ * `axis`, so that every row of `inner` elements shares one scale and zero
+ * point.
+ */
+template <typename CTYPE_IN>
+void dequantize_per_channel_vectorized(
+    const Tensor& input,
+    const Tensor& scale,
+    const int64_t* zero_point_data,
+    int64_t axis,
+    Tensor& out) {
+  const CTYPE_IN* in_data = input.const_data_ptr<CTYPE_IN>();
+  float* out_data = out.mutable_data_ptr<float>();
+  const int64_t num_channels = input.size(axis);
+  int64_t inner_size = 1;
+  for (int64_t i = axis + 1; i < input.dim(); ++i) {
+    inner_size *= input.size(i);
+  }
+  for_each_row_segment(
+      input.numel(), inner_size, [&](int64_t begin, int64_t end, int64_t row) {
+        const int64_t channel = row % num_channels;
+        dequantize_contiguous(
+            in_data + begin,
+            out_data + begin,
+            end - begin,
+            get_scale(scale, channel),
+            zero_point_data != nullptr ? zero_point_data[channel] : 0);
+      });
+}
+
 } // namespace
 
 /**
@@ -91,6 +204,17 @@ Tensor& dequantize_per_tensor_out(
   check_dequantize_per_tensor_args(
       input, quant_min, quant_max, dtype, out_dtype, out);
 
+  if (can_dequantize_vectorized(input, out)) {
+    if (input.scalar_type() == ScalarType::Char) {
+      dequantize_per_tensor_vectorized<int8_t>(
+          input, static_cast<float>(scale), zero_point, out);
+    } else {
+      dequantize_per_tensor_vectorized<uint8_t>(
+          input, static_cast<float>(scale), zero_point, out);
+    }
+    return out;
+  }
+
   // calculate the dequantized output, cast scale to float to match fbgemm
   // behavior
 #define DEQUANTIZE_IMPL(IN_CTYPE, OUT_CTYPE, out_dtype)                        \
@@ -172,19 +296,6 @@ Tensor& dequantize_per_tensor_tensor_args_out(
   return out;
 }
 
-float get_scale(const Tensor& scale, size_t channel_ix) {
-  ET_CHECK_MSG(
-      (scale.scalar_type() == ScalarType::Double) ||
-          (scale.scalar_type() == ScalarType::Float),
-      "scale.scalar_type() %" PRId8 " is not double or float type",
-      static_cast<int8_t>(scale.scalar_type()));
-  if (scale.scalar_type() == ScalarType::Double) {
-    return static_cast<float>(scale.const_data_ptr<double>()[channel_ix]);
-  } else {
-    return scale.const_data_ptr<float>()[channel_ix];
-  }
-}
-
 Tensor& dequantize_per_channel_out(
     const Tensor& input,
     const Tensor& scale,
@@ -229,6 +340,24 @@ Tensor& dequantize_per_channel_out(
   check_dequantize_per_tensor_args(
       input, quant_min, quant_max, dtype, out_dtype, out);
 
+  const int64_t* zero_point_data;
+  if (opt_zero_points.has_value()) {
+    zero_point_data = opt_zero_points.value().const_data_ptr<int64_t>();
+  } else {
+    zero_point_data = nullptr;
+  }
+
+  if (can_dequantize_vectorized(input, out)) {
+    if (input.scalar_type() == ScalarType::Char) {
+      dequantize_per_channel_vectorized<int8_t>(
+          input, scale, zero_point_data, axis, out);
+    } else {
+      dequantize_per_channel_vectorized<uint8_t>(
+          input, scale, zero_point_data, axis, out);
+    }
+    return out;
+  }
+
   // a list contains all dimensions except axis
   int64_t dims[kTensorDimensionLimit];
   for (int64_t i = 0; i < input.dim() - 1; i++) {
@@ -238,12 +367,6 @@ Tensor& dequantize_per_channel_out(
       dims[i] = i + 1;
     }
   }
-  const int64_t* zero_point_data;
-  if (opt_zero_points.has_value()) {
-    zero_point_data = opt_zero_points.value().const_data_ptr<int64_t>();
-  } else {
-    zero_point_data = nullptr;
-  }
 
   exec_aten::optional<exec_aten::ArrayRef<int64_t>> optional_dim_list{
       exec_aten::ArrayRef<int64_t>{dims, size_t(input.dim() - 1)}};
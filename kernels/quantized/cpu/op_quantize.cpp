@@ -6,7 +6,10 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <executorch/kernels/optimized/vec/functional.h>
+#include <executorch/kernels/optimized/vec/vec.h>
 #include <executorch/kernels/portable/cpu/util/reduce_util.h>
+#include <executorch/kernels/quantized/cpu/quantized_ops_util.h>
 #include <executorch/runtime/kernel/kernel_includes.h>
 #include <algorithm>
 #include <cinttypes>
@@ -85,6 +88,117 @@ void check_quantize_per_tensor_args(
       quant_max);
 }
 
+// Number of elements the vectorized path quantizes into a float buffer before
+// narrowing them to the output type.
+constexpr int64_t kQuantizeBlockSize = 1024;
+
+/**
+ * Returns true if the vectorized kernels below handle this input and output:
+ * contiguous float values quantized to int8 or uint8.
+ */
+bool can_quantize_vectorized(const Tensor& input, const Tensor& out) {
+  return input.scalar_type() == ScalarType::Float &&
+      (out.scalar_type() == ScalarType::Char ||
+       out.scalar_type() == ScalarType::Byte) &&
+      is_contiguous(input) && is_contiguous(out);
+}
+
+/**
+ * Quantizes `numel` consecutive values that share a scale and zero point.
+ * Produces the same results as quantize_val: Vectorized<float>::round()
+ * rounds half to even like std::nearbyint, and since the rounded value plus
+ * the zero point is an integer, clamping it in float before the conversion
+ * is equivalent to clamping the converted integer.
+ */
+template <typename CTYPE_OUT>
+void quantize_contiguous(
+    const float* in,
+    CTYPE_OUT* out,
+    int64_t numel,
+    double scale,
+    int64_t zero_point,
+    int64_t quant_min,
+    int64_t quant_max) {
+  using Vec = executorch::vec::Vectorized<float>;
+  const Vec inv_scale(1.0f / static_cast<float>(scale));
+  const Vec zero_point_vec(
+      static_cast<float>(static_cast<int32_t>(zero_point)));
+  const Vec quant_min_vec(static_cast<float>(quant_min));
+  const Vec quant_max_vec(static_cast<float>(quant_max));
+  float buffer[kQuantizeBlockSize];
+  for (int64_t i = 0; i < numel; i += kQuantizeBlockSize) {
+    const int64_t n = std::min(kQuantizeBlockSize, numel - i);
+    executorch::vec::map<float>(
+        [&](Vec x) {
+          const Vec q = (x * inv_scale).round() + zero_point_vec;
+          return executorch::vec::minimum(
+              executorch::vec::maximum(q, quant_min_vec), quant_max_vec);
+        },
+        buffer,
+        in + i,
+        n);
+    executorch::vec::convert(buffer, out + i, n);
+  }
+}
+
+template <typename CTYPE_OUT>
+void quantize_per_tensor_vectorized(
+    const Tensor& input,
+    double scale,
+    int64_t zero_point,
+    int64_t quant_min,
+    int64_t quant_max,
+    Tensor& out) {
+  const float* in_data = input.const_data_ptr<float>();
+  CTYPE_OUT* out_data = out.mutable_data_ptr<CTYPE_OUT>();
+  const int64_t numel = input.numel();
+  for_each_row_segment(numel, numel, [&](int64_t begin, int64_t end, int64_t) {
+    quantize_contiguous(
+        in_data + begin,
+        out_data + begin,
+        end - begin,
+        scale,
+        zero_point,
+        quant_min,
+        quant_max);
+  });
+}
+
+/**
+ * Views the input as [outer, channels, inner], where channels is the size of
+ * `axis`, so that every row of `inner` elements shares one scale and zero
+ * point.
+ */
+template <typename CTYPE_OUT>
+void quantize_per_channel_vectorized(
+    const Tensor& input,
+    const double* scale_data,
+    const int64_t* zero_point_data,
+    int64_t axis,
+    int64_t quant_min,
+    int64_t quant_max,
+    Tensor& out) {
+  const float* in_data = input.const_data_ptr<float>();
+  CTYPE_OUT* out_data = out.mutable_data_ptr<CTYPE_OUT>();
+  const int64_t num_channels = input.size(axis);
+  int64_t inner_size = 1;
+  for (int64_t i = axis + 1; i < input.dim(); ++i) {
+    inner_size *= input.size(i);
+  }
+  for_each_row_segment(
+      input.numel(), inner_size, [&](int64_t begin, int64_t end, int64_t row) {
+        const int64_t channel = row % num_channels;
+        quantize_contiguous(
+            in_data + begin,
+            out_data + begin,
+            end - begin,
+            scale_data[channel],
+            zero_point_data[channel],
+            quant_min,
+            quant_max);
+      });
+}
+
 } // namespace
 
 template <typename T, typename K>
@@ -120,6 +234,17 @@ Tensor& quantize_per_tensor_out(
 
   check_quantize_per_tensor_args(input, quant_min, quant_max, dtype, out);
 
+  if (can_quantize_vectorized(input, out)) {
+    if (out.scalar_type() == ScalarType::Char) {
+      quantize_per_tensor_vectorized<int8_t>(
+          input, scale, zero_point, quant_min, quant_max, out);
+    } else {
+      quantize_per_tensor_vectorized<uint8_t>(
+          input, scale, zero_point, quant_min, quant_max, out);
+    }
+    return out;
+  }
+
   // calculate the quantized input
 #define QUANTIZE_IMPL(IN_CTYPE, OUT_CTYPE, out_dtype)                          \
   case ScalarType::out_dtype: {                                                \
@@ -281,17 +406,29 @@ Tensor& quantize_per_channel_out(
 
   check_quantize_per_tensor_args(input, quant_min, quant_max, dtype, out);
 
+  const double* scale_data = scale.const_data_ptr<double>();
+  const int64_t* zero_point_data = zero_point.const_data_ptr<int64_t>();
+
+  if (can_quantize_vectorized(input, out)) {
+    if (out.scalar_type() == ScalarType::Char) {
+      quantize_per_channel_vectorized<int8_t>(
+          input, scale_data, zero_point_data, axis, quant_min, quant_max, out);
+    } else {
+      quantize_per_channel_vectorized<uint8_t>(
+          input, scale_data, zero_point_data, axis, quant_min, quant_max, out);
+    }
+    return out;
+  }
+
   // a list contains all dimensions except axis
   int64_t dims[kTensorDimensionLimit];
   for (int64_t i = 0; i < input.dim() - 1; i++) {
     if (i < axis) {
       dims[i] = i;
     } else {
-      dims[i] = i - 1;
+      dims[i] = i + 1;
     }
   }
-  const double* scale_data = scale.const_data_ptr<double>();
-  const int64_t* zero_point_data = zero_point.const_data_ptr<int64_t>();
 
   exec_aten::optional<exec_aten::ArrayRef<int64_t>> optional_dim_list{
       exec_aten::ArrayRef<int64_t>{dims, size_t(input.dim() - 1)}};
@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <executorch/runtime/kernel/kernel_includes.h>
+#include <algorithm>
+#include <cstdint>
+
+#ifdef ET_USE_THREADPOOL
+#include <executorch/extension/parallel/thread_parallel.h>
+#endif
+
+namespace torch {
+namespace executor {
+namespace native {
+
+/**
+ * Returns true if the elements of `t` are laid out as a flat row-major array.
+ */
+inline bool is_contiguous(const exec_aten::Tensor& t) {
+  int64_t expected_stride = 1;
+  for (int64_t i = t.dim() - 1; i >= 0; --i) {
+    if (t.size(i) != 1 && t.strides()[i] != expected_stride) {
+      return false;
+    }
+    expected_stride *= t.size(i);
+  }
+  return true;
+}
+
+/**
+ * Splits [0, numel) into chunks, across threads when ExecuTorch is built with
+ * a threadpool, and calls `f(begin, end, row)` for each run of elements that
+ * lies within a single row of `row_size` elements.
+ */
+template <typename Func>
+void for_each_row_segment(int64_t numel, int64_t row_size, const Func& f) {
+  const auto run = [&](int64_t begin, int64_t end) {
+    while (begin < end) {
+      const int64_t row = begin / row_size;
+      const int64_t segment_end = std::min(end, (row + 1) * row_size);
+      f(begin, segment_end, row);
+      begin = segment_end;
+    }
+  };
+#ifdef ET_USE_THREADPOOL
+  ::executorch::extension::parallel_for(
+      0, numel, ::executorch::extension::kMinElementsPerTask, run);
+#else
+  run(0, numel);
+#endif
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
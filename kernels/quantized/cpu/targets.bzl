@@ -1,6 +1,20 @@
 load("@fbsource//xplat/executorch/build:runtime_wrapper.bzl", "runtime")
 load("@fbsource//xplat/executorch/kernels/portable:op_registration_util.bzl", "define_op_target", "op_target")
 
+def use_threadpool():
+    return native.read_config("executorch", "quantized_use_threadpool", "true") == "true"
+
+def get_threadpool_deps():
+    # The threadpool defines ET_USE_THREADPOOL, which splits the quantize,
+    # dequantize and embedding kernels across threads. Targets without one
+    # set executorch.quantized_use_threadpool=false.
+    if use_threadpool():
+        return [
+            "//executorch/extension/parallel:thread_parallel",
+            "//executorch/extension/threadpool:threadpool",
+        ]
+    return []
+
 _QUANT_OPS = (
     op_target(
         name = "op_add",
@@ -14,10 +28,14 @@ _QUANT_OPS = (
     op_target(
         name = "op_dequantize",
         deps = [
+            "//executorch/kernels/optimized:libvec",
             "//executorch/kernels/portable/cpu/util:reduce_util",
+            "//executorch/kernels/quantized/cpu:quantized_ops_util",
         ],
         _aten_mode_deps = [
+            "//executorch/kernels/optimized:libvec",
             "//executorch/kernels/portable/cpu/util:reduce_util_aten",
+            "//executorch/kernels/quantized/cpu:quantized_ops_util_aten",
         ],
     ),
     op_target(
@@ -52,10 +70,14 @@ _QUANT_OPS = (
     op_target(
         name = "op_quantize",
         deps = [
+            "//executorch/kernels/optimized:libvec",
             "//executorch/kernels/portable/cpu/util:reduce_util",
+            "//executorch/kernels/quantized/cpu:quantized_ops_util",
         ],
         _aten_mode_deps = [
+            "//executorch/kernels/optimized:libvec",
             "//executorch/kernels/portable/cpu/util:reduce_util_aten",
+            "//executorch/kernels/quantized/cpu:quantized_ops_util_aten",
         ],
     ),
 )
@@ -76,6 +98,21 @@ def define_common_targets():
         exported_deps = quant_op_targets,
     )
 
+    for aten_mode in (True, False):
+        aten_suffix = "_aten" if aten_mode else ""
+
+        # Only the portable build splits the kernels across the threadpool.
+        runtime.cxx_library(
+            name = "quantized_ops_util" + aten_suffix,
+            exported_headers = ["quantized_ops_util.h"],
+            visibility = [
+                "//executorch/kernels/quantized/...",
+            ],
+            exported_deps = [
+                "//executorch/runtime/kernel:kernel_includes" + aten_suffix,
+            ] + ([] if aten_mode else get_threadpool_deps()),
+        )
+
     runtime.cxx_library(
         name = "embeddingxb",
         srcs = ["embeddingxb.cpp"],
@@ -83,7 +120,10 @@ def define_common_targets():
         visibility = [
             "//executorch/kernels/quantized/...",
         ],
-        deps = ["//executorch/runtime/kernel:kernel_includes"],
+        deps = [
+            "//executorch/kernels/optimized:libvec",
+            "//executorch/runtime/kernel:kernel_includes",
+        ] + get_threadpool_deps(),
     )
 
     runtime.cxx_library(
@@ -93,7 +133,10 @@ def define_common_targets():
         visibility = [
             "//executorch/kernels/quantized/...",
         ],
-        deps = ["//executorch/runtime/kernel:kernel_includes_aten"],
+        deps = [
+            "//executorch/kernels/optimized:libvec",
+            "//executorch/runtime/kernel:kernel_includes_aten",
+        ],
     )
 
     runtime.cxx_library(
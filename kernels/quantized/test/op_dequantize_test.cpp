@@ -16,6 +16,7 @@
 
 #include <gtest/gtest.h>
 #include <limits>
+#include <vector>
 
 using namespace ::testing;
 using exec_aten::ArrayRef;
@@ -195,3 +196,72 @@ TEST(OpDequantizeOutTest, DequantizePerChannel) {
       out);
   EXPECT_TENSOR_EQ(out, expected);
 }
+
+TEST(OpDequantizeOutTest, DequantizePerChannelInnerAxis) {
+  TensorFactory<ScalarType::Char> tf_char;
+  TensorFactory<ScalarType::Double> tf_double;
+  TensorFactory<ScalarType::Long> tf_long;
+
+  Tensor input = tf_char.full({2, 3, 2}, 20);
+  Tensor scale = tf_double.make({3}, {0.5, 1, 2});
+  Tensor zero_point = tf_long.make({3}, {-10, 0, 10});
+  int64_t quant_min = -128;
+  int64_t quant_max = 127;
+
+  TensorFactory<ScalarType::Float> tfo;
+  Tensor out = tfo.zeros({2, 3, 2});
+  // (20 + 10) * 0.5
+  // (20 - 0) * 1
+  // (20 - 10) * 2
+  Tensor expected =
+      tfo.make({2, 3, 2}, {15, 15, 20, 20, 20, 20, 15, 15, 20, 20, 20, 20});
+  dequantize_per_channel_out(
+      input,
+      scale,
+      zero_point,
+      /*axis=*/1,
+      quant_min,
+      quant_max,
+      ScalarType::Char,
+      optional<ScalarType>(),
+      out);
+
+  EXPECT_TENSOR_EQ(out, expected);
+}
+
+/// Dequantizes enough values to exercise the vectorized kernels, including
+/// their partial blocks, and checks them against the scalar formula.
+template <ScalarType DTYPE>
+void test_large_input(int64_t zero_point) {
+  using CTYPE = typename TensorFactory<DTYPE>::ctype;
+  TensorFactory<DTYPE> tf;
+  TensorFactory<ScalarType::Float> tfo;
+
+  constexpr int kNumel = 2 * 1024 + 37;
+  const double scale = 0.1;
+  std::vector<CTYPE> input_data(kNumel);
+  std::vector<float> expected_data(kNumel);
+  for (int i = 0; i < kNumel; ++i) {
+    input_data[i] = static_cast<CTYPE>(i * 7);
+    expected_data[i] =
+        (input_data[i] - zero_point) * static_cast<float>(scale);
+  }
+
+  Tensor input = tf.make({kNumel}, input_data);
+  Tensor out = tfo.zeros({kNumel});
+  dequantize_per_tensor_out(
+      input,
+      scale,
+      zero_point,
+      std::numeric_limits<CTYPE>::min(),
+      std::numeric_limits<CTYPE>::max(),
+      DTYPE,
+      optional<ScalarType>(),
+      out);
+  EXPECT_TENSOR_EQ(out, tfo.make({kNumel}, expected_data));
+}
+
+TEST(OpDequantizeOutTest, LargeInputMatchesReference) {
+  test_large_input<ScalarType::Char>(-3);
+  test_large_input<ScalarType::Byte>(128);
+}
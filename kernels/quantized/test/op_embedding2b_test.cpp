@@ -15,6 +15,7 @@
 
 #include <gtest/gtest.h>
 #include <limits>
+#include <vector>
 
 using namespace ::testing;
 using exec_aten::ArrayRef;
@@ -188,3 +189,54 @@ TEST(OpQuantizedEmbedding2bTest, TestGroupWiseQuantizedEmbeddingDeath3) {
           out),
       "");
 }
+
+TEST(OpQuantizedEmbedding2bTest, TestLongRowsMatchReference) {
+  et_pal_init();
+  TensorFactory<ScalarType::Byte> tfb;
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Long> tfl;
+
+  // Rows longer than one unpacking block, with groups that straddle blocks
+  // and a row length that is not a whole number of vectors.
+  constexpr int kNumEmbeddings = 4;
+  constexpr int kEmbeddingDim = 2420;
+  constexpr int kNumGroups = 5;
+  constexpr int kGroupSize = kEmbeddingDim / kNumGroups;
+
+  std::vector<uint8_t> qweight_data(kNumEmbeddings * kEmbeddingDim / 4);
+  for (size_t i = 0; i < qweight_data.size(); ++i) {
+    qweight_data[i] = static_cast<uint8_t>(i * 37 + 11);
+  }
+  std::vector<float> scales_data(kNumEmbeddings * kNumGroups);
+  std::vector<float> zero_points_data(kNumEmbeddings * kNumGroups);
+  for (size_t i = 0; i < scales_data.size(); ++i) {
+    scales_data[i] = 0.25f * (i + 1);
+    zero_points_data[i] = static_cast<float>(i % 3) - 1;
+  }
+  std::vector<int64_t> indices_data = {3, 0, 2, 3, 1};
+
+  std::vector<float> expected_data;
+  for (int64_t index : indices_data) {
+    for (int j = 0; j < kEmbeddingDim; ++j) {
+      const uint8_t packed = qweight_data[(index * kEmbeddingDim + j) / 4];
+      const int value = ((packed >> (2 * (j % 4))) & 3) - 2;
+      const int qparams_index = index * kNumGroups + j / kGroupSize;
+      expected_data.push_back(
+          (value - zero_points_data[qparams_index]) *
+          scales_data[qparams_index]);
+    }
+  }
+
+  Tensor qweight =
+      tfb.make({kNumEmbeddings, kEmbeddingDim / 4}, qweight_data);
+  Tensor weight_scales = tf.make({kNumEmbeddings, kNumGroups}, scales_data);
+  Tensor weight_zero_points =
+      tf.make({kNumEmbeddings, kNumGroups}, zero_points_data);
+  Tensor indices = tfl.make({5}, indices_data);
+  Tensor out = tf.zeros({5, kEmbeddingDim});
+
+  quantized_embedding_2bit_out(
+      qweight, weight_scales, weight_zero_points, -2, 1, indices, out);
+
+  EXPECT_TENSOR_EQ(out, tf.make({5, kEmbeddingDim}, expected_data));
+}
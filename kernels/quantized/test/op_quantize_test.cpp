@@ -14,7 +14,10 @@
 #include <executorch/test/utils/DeathTest.h>
 
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
 #include <limits>
+#include <vector>
 
 using namespace ::testing;
 using exec_aten::ArrayRef;
@@ -141,3 +144,122 @@ TEST(OpQuantizeOutTest, QuantizePerChannel) {
 
   EXPECT_TENSOR_EQ(out, expected);
 }
+
+TEST(OpQuantizeOutTest, QuantizePerChannelInnerAxis) {
+  TensorFactory<ScalarType::Float> tf_float;
+  TensorFactory<ScalarType::Double> tf_double;
+  TensorFactory<ScalarType::Long> tf_long;
+
+  Tensor input = tf_float.full({2, 3, 2}, 4);
+  Tensor scale = tf_double.make({3}, {0.5, 1, 2});
+  Tensor zero_point = tf_long.make({3}, {-10, 0, 10});
+  int64_t quant_min = -128;
+  int64_t quant_max = 127;
+
+  TensorFactory<ScalarType::Char> tfo;
+  Tensor out = tfo.zeros({2, 3, 2});
+  // 4 / 0.5 - 10
+  // 4 / 1 + 0
+  // 4 / 2 + 10
+  Tensor expected =
+      tfo.make({2, 3, 2}, {-2, -2, 4, 4, 12, 12, -2, -2, 4, 4, 12, 12});
+  quantize_per_channel_out(
+      input, scale, zero_point, 1, quant_min, quant_max, ScalarType::Char, out);
+
+  EXPECT_TENSOR_EQ(out, expected);
+}
+
+/// Int16 outputs take the scalar path, which quantizes each channel over
+/// every dimension but `axis`. Distinct input values and per-channel scales
+/// catch a wrong list of those dimensions.
+TEST(OpQuantizeOutTest, QuantizePerChannelScalarPath) {
+  TensorFactory<ScalarType::Float> tf_float;
+  TensorFactory<ScalarType::Double> tf_double;
+  TensorFactory<ScalarType::Long> tf_long;
+  TensorFactory<ScalarType::Short> tfo;
+
+  const std::vector<int32_t> sizes = {2, 3, 4};
+  const int64_t numel = 2 * 3 * 4;
+  std::vector<float> input_data(numel);
+  for (int64_t i = 0; i < numel; ++i) {
+    input_data[i] = (i - 7) * 1.5f;
+  }
+  Tensor input = tf_float.make(sizes, input_data);
+  const int64_t quant_min = -1000;
+  const int64_t quant_max = 1000;
+
+  for (int64_t axis = 0; axis < 3; ++axis) {
+    const int64_t num_channels = sizes[axis];
+    std::vector<double> scales(num_channels);
+    std::vector<int64_t> zero_points(num_channels);
+    for (int64_t c = 0; c < num_channels; ++c) {
+      scales[c] = 0.5 * (c + 1);
+      zero_points[c] = 10 * c - 5;
+    }
+
+    // The channel of flat index i is its index along `axis`.
+    int64_t inner_size = 1;
+    for (int64_t d = axis + 1; d < 3; ++d) {
+      inner_size *= sizes[d];
+    }
+    std::vector<int16_t> expected_data(numel);
+    for (int64_t i = 0; i < numel; ++i) {
+      const int64_t c = (i / inner_size) % num_channels;
+      const float inv_scale = 1.0f / static_cast<float>(scales[c]);
+      const float q = std::nearbyint(input_data[i] * inv_scale);
+      expected_data[i] = static_cast<int16_t>(std::min<float>(
+          std::max<float>(q + zero_points[c], quant_min), quant_max));
+    }
+
+    Tensor scale = tf_double.make({static_cast<int32_t>(num_channels)}, scales);
+    Tensor zero_point =
+        tf_long.make({static_cast<int32_t>(num_channels)}, zero_points);
+    Tensor out = tfo.zeros(sizes);
+    quantize_per_channel_out(
+        input,
+        scale,
+        zero_point,
+        axis,
+        quant_min,
+        quant_max,
+        ScalarType::Short,
+        out);
+    EXPECT_TENSOR_EQ(out, tfo.make(sizes, expected_data));
+  }
+}
+
+/// Quantizes enough values to exercise the vectorized kernels, including
+/// their partial blocks, and checks them against quantize_val's formula.
+template <ScalarType DTYPE>
+void test_large_input(
+    int64_t zero_point,
+    int64_t quant_min,
+    int64_t quant_max) {
+  using CTYPE = typename TensorFactory<DTYPE>::ctype;
+  TensorFactory<ScalarType::Float> tf_float;
+  TensorFactory<DTYPE> tfo;
+
+  constexpr int kNumel = 2 * 1024 + 37;
+  const double scale = 0.25;
+  std::vector<float> input_data(kNumel);
+  std::vector<CTYPE> expected_data(kNumel);
+  for (int i = 0; i < kNumel; ++i) {
+    // Covers values past both ends of the range, and ties that must round to
+    // the nearest even integer.
+    input_data[i] = (i - kNumel / 2) * 0.125f;
+    const float q = std::nearbyint(input_data[i] / static_cast<float>(scale));
+    expected_data[i] = static_cast<CTYPE>(std::min<float>(
+        std::max<float>(q + zero_point, quant_min), quant_max));
+  }
+
+  Tensor input = tf_float.make({kNumel}, input_data);
+  Tensor out = tfo.zeros({kNumel});
+  quantize_per_tensor_out(
+      input, scale, zero_point, quant_min, quant_max, DTYPE, out);
+  EXPECT_TENSOR_EQ(out, tfo.make({kNumel}, expected_data));
+}
+
+TEST(OpQuantizeOutTest, LargeInputMatchesReference) {
+  test_large_input<ScalarType::Char>(3, -128, 127);
+  test_large_input<ScalarType::Byte>(128, 0, 255);
+}
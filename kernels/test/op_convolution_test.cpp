@@ -728,3 +728,198 @@ TEST_F(OpConvCorrectnessTest, InvalidOutputPadding) {
           groups,
           out));
 }
+
+namespace {
+
+// The shape and parameters of a forward 2D convolution.
+struct Conv2DShape {
+  int32_t batch;
+  int32_t in_c;
+  int32_t in_h;
+  int32_t in_w;
+  int32_t out_c;
+  int32_t k_h;
+  int32_t k_w;
+  int64_t stride[2];
+  int64_t padding[2];
+  int64_t dilation[2];
+  int64_t groups;
+
+  int32_t out_h() const {
+    return (in_h + 2 * padding[0] - dilation[0] * (k_h - 1) - 1) / stride[0] +
+        1;
+  }
+  int32_t out_w() const {
+    return (in_w + 2 * padding[1] - dilation[1] * (k_w - 1) - 1) / stride[1] +
+        1;
+  }
+};
+
+// Values in [1, 10), different enough between neighbors to catch indexing
+// errors.
+std::vector<float> make_conv_data(size_t numel, size_t seed) {
+  std::vector<float> data(numel);
+  for (size_t i = 0; i < numel; ++i) {
+    data[i] = ((i + seed) * 7919 % 90 + 10) / 10.0f;
+  }
+  return data;
+}
+
+// A direct convolution in double, on contiguous NCHW data.
+std::vector<float> reference_conv2d(
+    const Conv2DShape& s,
+    const std::vector<float>& input,
+    const std::vector<float>& weight,
+    const std::vector<float>& bias) {
+  const int32_t out_h = s.out_h();
+  const int32_t out_w = s.out_w();
+  const int32_t in_c_per_group = s.in_c / s.groups;
+  const int32_t out_c_per_group = s.out_c / s.groups;
+  std::vector<float> out(s.batch * s.out_c * out_h * out_w);
+  for (int32_t n = 0; n < s.batch; ++n) {
+    for (int32_t oc = 0; oc < s.out_c; ++oc) {
+      const int32_t g = oc / out_c_per_group;
+      for (int32_t oy = 0; oy < out_h; ++oy) {
+        for (int32_t ox = 0; ox < out_w; ++ox) {
+          double sum = bias[oc];
+          for (int32_t ic = 0; ic < in_c_per_group; ++ic) {
+            for (int32_t ky = 0; ky < s.k_h; ++ky) {
+              for (int32_t kx = 0; kx < s.k_w; ++kx) {
+                const int64_t iy =
+                    oy * s.stride[0] - s.padding[0] + ky * s.dilation[0];
+                const int64_t ix =
+                    ox * s.stride[1] - s.padding[1] + kx * s.dilation[1];
+                if (iy < 0 || iy >= s.in_h || ix < 0 || ix >= s.in_w) {
+                  continue;
+                }
+                const int32_t c = g * in_c_per_group + ic;
+                sum += static_cast<double>(
+                           input[((n * s.in_c + c) * s.in_h + iy) * s.in_w +
+                                 ix]) *
+                    weight[((oc * in_c_per_group + ic) * s.k_h + ky) * s.k_w +
+                           kx];
+              }
+            }
+          }
+          out[((n * s.out_c + oc) * out_h + oy) * out_w + ox] = sum;
+        }
+      }
+    }
+  }
+  return out;
+}
+
+} // namespace
+
+class OpConvReferenceTest : public OpConvOutTest {
+ protected:
+  // Runs a 2D convolution with contiguous or channels-last tensors, or with
+  // 3D tensors if `is_1d` (the height must then be 1), and compares it with
+  // reference_conv2d.
+  void test_against_reference(
+      const Conv2DShape& s,
+      bool channels_last,
+      bool is_1d = false) {
+    TensorFactory<ScalarType::Float> tf;
+
+    const std::vector<int32_t> in_sizes = {s.batch, s.in_c, s.in_h, s.in_w};
+    const std::vector<int32_t> w_sizes = {
+        s.out_c, static_cast<int32_t>(s.in_c / s.groups), s.k_h, s.k_w};
+    const std::vector<int32_t> out_sizes = {
+        s.batch, s.out_c, s.out_h(), s.out_w()};
+    const auto numel = [](const std::vector<int32_t>& sizes) {
+      size_t result = 1;
+      for (auto size : sizes) {
+        result *= size;
+      }
+      return result;
+    };
+    const std::vector<float> input_data = make_conv_data(numel(in_sizes), 0);
+    const std::vector<float> weight_data = make_conv_data(numel(w_sizes), 1);
+    const std::vector<float> bias_data = make_conv_data(s.out_c, 2);
+    const std::vector<float> expected_data =
+        reference_conv2d(s, input_data, weight_data, bias_data);
+
+    // 1D tensors drop the height.
+    const auto to_1d = [](std::vector<int32_t> sizes) {
+      sizes.erase(sizes.begin() + 2);
+      return sizes;
+    };
+    Tensor input = tf.make(is_1d ? to_1d(in_sizes) : in_sizes, input_data);
+    Tensor weight = tf.make(is_1d ? to_1d(w_sizes) : w_sizes, weight_data);
+    Tensor expected =
+        tf.make(is_1d ? to_1d(out_sizes) : out_sizes, expected_data);
+    Tensor out = tf.zeros(is_1d ? to_1d(out_sizes) : out_sizes);
+    if (channels_last) {
+      input = tf.channels_last_like(input);
+      weight = tf.channels_last_like(weight);
+      expected = tf.channels_last_like(expected);
+      out = tf.channels_last_like(out);
+    }
+    optional<Tensor> bias(tf.make({s.out_c}, bias_data));
+
+    const size_t num_dims = is_1d ? 1 : 2;
+    const int64_t output_padding[] = {0, 0};
+    op_convolution_out(
+        input,
+        weight,
+        bias,
+        {is_1d ? s.stride + 1 : s.stride, num_dims},
+        {is_1d ? s.padding + 1 : s.padding, num_dims},
+        {is_1d ? s.dilation + 1 : s.dilation, num_dims},
+        false,
+        {output_padding, num_dims},
+        s.groups,
+        out);
+    EXPECT_TENSOR_CLOSE_WITH_TOL(out, expected, 1e-5, 1e-3);
+  }
+};
+
+TEST_F(OpConvReferenceTest, Depthwise) {
+  // groups == in channels == out channels, with an output wider than a
+  // vector and a remainder.
+  const Conv2DShape s = {
+      2, 8, 9, 21, 8, 3, 3, {1, 1}, {1, 1}, {1, 1}, /*groups=*/8};
+  test_against_reference(s, /*channels_last=*/false);
+}
+
+TEST_F(OpConvReferenceTest, DepthwiseChannelsLast) {
+  // More channels than fit in a vector, and a remainder.
+  const Conv2DShape s = {
+      1, 19, 7, 6, 19, 3, 3, {2, 1}, {1, 2}, {1, 2}, /*groups=*/19};
+  test_against_reference(s, /*channels_last=*/true);
+}
+
+TEST_F(OpConvReferenceTest, Pointwise) {
+  // A 1x1 convolution with unit stride and no padding skips im2col.
+  const Conv2DShape s = {
+      2, 6, 5, 7, 4, 1, 1, {1, 1}, {0, 0}, {1, 1}, /*groups=*/1};
+  test_against_reference(s, /*channels_last=*/false);
+  test_against_reference(s, /*channels_last=*/true);
+}
+
+TEST_F(OpConvReferenceTest, GroupedIm2col) {
+  const Conv2DShape s = {
+      2, 6, 8, 7, 9, 3, 2, {2, 1}, {1, 0}, {1, 2}, /*groups=*/3};
+  test_against_reference(s, /*channels_last=*/false);
+  test_against_reference(s, /*channels_last=*/true);
+}
+
+TEST_F(OpConvReferenceTest, MultipleTiles) {
+  // 576 columns per output pixel make tiles of 113 pixels, so the 16x16
+  // output spans several tiles and ends with a partial one.
+  const Conv2DShape s = {
+      1, 64, 16, 16, 4, 3, 3, {1, 1}, {1, 1}, {1, 1}, /*groups=*/1};
+  test_against_reference(s, /*channels_last=*/false);
+  test_against_reference(s, /*channels_last=*/true);
+}
+
+TEST_F(OpConvReferenceTest, Conv1D) {
+  const Conv2DShape s = {
+      2, 4, 1, 19, 6, 1, 3, {1, 2}, {0, 1}, {1, 2}, /*groups=*/2};
+  test_against_reference(s, /*channels_last=*/false, /*is_1d=*/true);
+
+  const Conv2DShape depthwise = {
+      1, 5, 1, 11, 5, 1, 3, {1, 1}, {0, 1}, {1, 1}, /*groups=*/5};
+  test_against_reference(depthwise, /*channels_last=*/false, /*is_1d=*/true);
+}
@@ -401,3 +401,48 @@ TEST_F(OpSumOutTest, InfinityAndNANTest) {
     }));
   // clang-format on
 }
+
+TEST_F(OpSumOutTest, LargeInputMatchesReference) {
+  // Small integers, so that every summation order gives exact results.
+  TensorFactory<ScalarType::Float> tf;
+  const std::vector<int32_t> sizes = {6, 300, 41};
+  std::vector<float> data(6 * 300 * 41);
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<float>(static_cast<int>(i * 7 % 11) - 5);
+  }
+  Tensor self = tf.make(sizes, data);
+
+  const std::vector<std::vector<int64_t>> dim_lists = {{1}, {2}, {0, 2}, {}};
+  for (const auto& dims : dim_lists) {
+    bool reduced[3] = {dims.empty(), dims.empty(), dims.empty()};
+    for (int64_t d : dims) {
+      reduced[d] = true;
+    }
+    std::vector<int32_t> out_sizes;
+    for (int64_t d = 0; d < 3; ++d) {
+      out_sizes.push_back(reduced[d] ? 1 : sizes[d]);
+    }
+    std::vector<float> expected(
+        (reduced[0] ? 1 : 6) * (reduced[1] ? 1 : 300) * (reduced[2] ? 1 : 41));
+    for (int64_t a = 0; a < 6; ++a) {
+      for (int64_t b = 0; b < 300; ++b) {
+        for (int64_t c = 0; c < 41; ++c) {
+          const int64_t out_ix =
+              ((reduced[0] ? 0 : a) * (reduced[1] ? 1 : 300) +
+               (reduced[1] ? 0 : b)) *
+                  (reduced[2] ? 1 : 41) +
+              (reduced[2] ? 0 : c);
+          expected[out_ix] += data[(a * 300 + b) * 41 + c];
+        }
+      }
+    }
+
+    Tensor out = tf.zeros(out_sizes);
+    optional<ArrayRef<int64_t>> dim_list;
+    if (!dims.empty()) {
+      dim_list = ArrayRef<int64_t>(dims.data(), dims.size());
+    }
+    op_sum_intlist_out(self, dim_list, /*keepdim=*/true, {}, out);
+    EXPECT_TENSOR_EQ(out, tf.make(out_sizes, expected));
+  }
+}
@@ -146,6 +146,54 @@ TEST_F(OpTransposeIntCopyTest, ThreeDTranspose) {
   // clang-format on
 }
 
+// Sizes that are not multiples of the tile size, in a batch of transposes,
+// for element sizes of 1, 4 and 8 bytes.
+TEST_F(OpTransposeIntCopyTest, LargeBatchedTransposeMatchesReference) {
+  const std::vector<int32_t> sizes = {3, 37, 75};
+  const std::vector<int32_t> new_sizes = {3, 75, 37};
+  std::vector<int32_t> in_data(3 * 37 * 75);
+  std::vector<int32_t> expected(in_data.size());
+  for (int32_t b = 0; b < 3; ++b) {
+    for (int32_t i = 0; i < 37; ++i) {
+      for (int32_t j = 0; j < 75; ++j) {
+        const int32_t value = (b * 37 + i) * 75 + j;
+        in_data[value] = value % 127;
+        expected[(b * 75 + j) * 37 + i] = value % 127;
+      }
+    }
+  }
+
+  TensorFactory<ScalarType::Int> tf_int;
+  Tensor out_int = tf_int.zeros(new_sizes);
+  op_transpose_copy_int_out(tf_int.make(sizes, in_data), 1, 2, out_int);
+  EXPECT_TENSOR_EQ(out_int, tf_int.make(new_sizes, expected));
+
+  TensorFactory<ScalarType::Char> tf_char;
+  Tensor out_char = tf_char.zeros(new_sizes);
+  op_transpose_copy_int_out(
+      tf_char.make(sizes, std::vector<int8_t>(in_data.begin(), in_data.end())),
+      2,
+      1,
+      out_char);
+  EXPECT_TENSOR_EQ(
+      out_char,
+      tf_char.make(
+          new_sizes, std::vector<int8_t>(expected.begin(), expected.end())));
+
+  TensorFactory<ScalarType::Double> tf_double;
+  Tensor out_double = tf_double.zeros(new_sizes);
+  op_transpose_copy_int_out(
+      tf_double.make(
+          sizes, std::vector<double>(in_data.begin(), in_data.end())),
+      -1,
+      -2,
+      out_double);
+  EXPECT_TENSOR_EQ(
+      out_double,
+      tf_double.make(
+          new_sizes, std::vector<double>(expected.begin(), expected.end())));
+}
+
 // transpose an out of bounds dim
 TEST_F(OpTransposeIntCopyTest, OutOfBoundDimDies) {
   TensorFactory<ScalarType::Float> tf;
@@ -771,7 +771,7 @@ Error Method::init(executorch_flatbuffer::ExecutionPlan* s_plan) {
     }
   }
 
-  step_state_ = StepState{0, 0};
+  step_state_ = StepState{0, 0, false};
 
   init_state_ = InitializationState::Initialized;
   return Error::Ok;
@@ -1184,10 +1184,10 @@ Error Method::execute_instruction() {
 
 Error Method::reset_execution() {
   ET_CHECK_OR_RETURN_ERROR(
-      step_state_.chain_idx == n_chains_,
+      step_state_.chain_idx == n_chains_ || step_state_.failed,
       InvalidState,
       "Cannot reset until EndOfMethod has been reached.");
-  step_state_ = StepState{0, 0};
+  step_state_ = StepState{0, 0, false};
   return Error::Ok;
 }
 
@@ -1244,6 +1244,7 @@ Error Method::step() {
 
   auto status = execute_instruction();
   if (status != Error::Ok) {
+    step_state_.failed = true;
     return status;
   }
 
@@ -1297,6 +1298,7 @@ Error Method::execute() {
               static_cast<DebugHandle>(step_state_.instr_idx));
       auto status = execute_instruction();
       if (status != Error::Ok) {
+        step_state_.failed = true;
         return status;
       }
     }
@@ -1370,6 +1372,121 @@ EventTracer* Method::get_event_tracer() {
   return event_tracer_;
 }
 
+size_t Method::num_instructions() const {
+  size_t num_instructions = 0;
+  for (size_t i = 0; i < n_chains_; ++i) {
+    num_instructions += chains_[i].argument_lists_.size();
+  }
+  return num_instructions;
+}
+
+Result<size_t> Method::get_constant_data(
+    size_t instruction_index,
+    ConstantData* constant_data,
+    size_t length) const {
+  ET_CHECK_OR_RETURN_ERROR(
+      initialized(),
+      InvalidState,
+      "Cannot list constant data until method has been initialized.");
+  ET_CHECK_OR_RETURN_ERROR(
+      constant_data != nullptr || length == 0,
+      InvalidArgument,
+      "constant_data cannot be null");
+
+  // Find the chain that contains the instruction.
+  size_t chain_idx = 0;
+  size_t instr_idx = instruction_index;
+  while (chain_idx < n_chains_ &&
+         instr_idx >= chains_[chain_idx].argument_lists_.size()) {
+    instr_idx -= chains_[chain_idx].argument_lists_.size();
+    chain_idx++;
+  }
+  ET_CHECK_OR_RETURN_ERROR(
+      chain_idx < n_chains_,
+      InvalidArgument,
+      "Instruction index %zu >= num instructions %zu",
+      instruction_index,
+      num_instructions());
+
+  // Only kernel and delegate calls have arguments; other instructions have an
+  // empty list.
+  const auto args = chains_[chain_idx].argument_lists_[instr_idx];
+  const auto s_values = serialization_plan_->values();
+  size_t num_constants = 0;
+  const auto add_if_constant = [&](size_t value_index) {
+    // Constant tensors have serialized data but no memory-planned location.
+    // See parseTensor().
+    const auto s_tensor = s_values->Get(value_index)->val_as_Tensor();
+    if (s_tensor == nullptr || s_tensor->data_buffer_idx() == 0 ||
+        s_tensor->allocation_info() != nullptr ||
+        !values_[value_index].isTensor()) {
+      return;
+    }
+    if (num_constants < length) {
+      const auto& tensor = values_[value_index].toTensor();
+      constant_data[num_constants] =
+          ConstantData{tensor.const_data_ptr(), tensor.nbytes()};
+    }
+    num_constants++;
+  };
+  for (size_t i = 0; i < args.size(); ++i) {
+    const size_t value_index = args[i] - values_;
+    const auto s_value = s_values->Get(value_index);
+    // Lists hold indices of their elements in values_, like
+    // parseTensorList() and parseListOptionalType() read them. None entries
+    // of an optional list are -1.
+    const flatbuffers::Vector<int32_t>* items = nullptr;
+    if (s_value->val_type() == executorch_flatbuffer::KernelTypes::TensorList) {
+      items = s_value->val_as_TensorList()->items();
+    } else if (
+        s_value->val_type() ==
+        executorch_flatbuffer::KernelTypes::OptionalTensorList) {
+      items = s_value->val_as_OptionalTensorList()->items();
+    }
+    if (items == nullptr) {
+      add_if_constant(value_index);
+      continue;
+    }
+    for (int32_t item : *items) {
+      if (item >= 0 && static_cast<size_t>(item) < n_value_) {
+        add_if_constant(static_cast<size_t>(item));
+      }
+    }
+  }
+  return num_constants;
+}
+
+Result<size_t> Method::get_memory_planned_tensors(
+    PlannedTensorData* tensors,
+    size_t length) const {
+  ET_CHECK_OR_RETURN_ERROR(
+      initialized(),
+      InvalidState,
+      "Cannot list planned tensors until method has been initialized.");
+  ET_CHECK_OR_RETURN_ERROR(
+      tensors != nullptr || length == 0,
+      InvalidArgument,
+      "tensors cannot be null");
+
+  const auto s_values = serialization_plan_->values();
+  size_t num_tensors = 0;
+  for (size_t i = 0; i < n_value_; ++i) {
+    // Memory-planned tensors have an allocation_info. See parseTensor().
+    const auto s_tensor = s_values->Get(i)->val_as_Tensor();
+    if (s_tensor == nullptr || s_tensor->allocation_info() == nullptr ||
+        !values_[i].isTensor()) {
+      continue;
+    }
+    const auto& tensor = values_[i].toTensor();
+    if (num_tensors < length) {
+      tensors[num_tensors] = PlannedTensorData{
+          tensor.const_data_ptr(), tensor.nbytes(), tensor.scalar_type()};
+    }
+    num_tensors++;
+  }
+  return num_tensors;
+}
+
 Method::~Method() {
   // Destroy the values. It's necessary in ATen mode, where the refcount of
   // Tensors needs to be decremented properly.
@@ -202,8 +202,8 @@ class Method final {
    *
    * @retval Error:Ok on success
    * @retval Error::InvalidState if called before step-based execution reached
-   *     the end of the Method. This means it is not possible to recover a
-   *     Method that failed mid-execution.
+   *     the end of the Method, unless the last step() failed. A Method that
+   *     failed mid-execution can be reset to run again from the start.
    */
   ET_EXPERIMENTAL ET_NODISCARD Error reset_execution();
 
@@ -232,6 +232,78 @@ class Method final {
 
   EventTracer* get_event_tracer();
 
+  /**
+   * A region of constant (non-memory-planned) tensor data, typically a weight
+   * that lives in the Program's constant segment.
+   */
+  struct ConstantData {
+    /// Start of the tensor data.
+    const void* data;
+    /// Size of the tensor data in bytes.
+    size_t nbytes;
+  };
+
+  /**
+   * EXPERIMENTAL: Returns the total number of instructions in the Method,
+   * across all chains.
+   */
+  ET_EXPERIMENTAL size_t num_instructions() const;
+
+  /**
+   * EXPERIMENTAL: Lists the constant tensors read by an instruction,
+   * including the elements of its tensor list arguments. Together with
+   * `num_instructions()`, this describes the order in which weights will be
+   * touched during execution, which data loaders can use to prefetch or
+   * release them.
+   *
+   * @param[in] instruction_index Index of the instruction, counting from the
+   *     start of the first chain in execution order. Must be less than
+   *     `num_instructions()`.
+   * @param[out] constant_data Array to receive the constant tensors read by
+   *     the instruction. May be null if `length` is zero.
+   * @param[in] length Number of entries in `constant_data`.
+   *
+   * @returns The number of constant tensors read by the instruction. Only the
+   *     first `min(length, <return value>)` entries of `constant_data` are
+   *     written.
+   * @retval Error::InvalidState The Method is not initialized.
+   * @retval Error::InvalidArgument `instruction_index` is out of range.
+   */
+  ET_EXPERIMENTAL ET_NODISCARD Result<size_t> get_constant_data(
+      size_t instruction_index,
+      ConstantData* constant_data,
+      size_t length) const;
+
+  /**
+   * A tensor whose data lives in one of the Method's memory-planned buffers,
+   * either an activation or mutable state such as a KV cache.
+   */
+  struct PlannedTensorData {
+    /// Start of the tensor data.
+    const void* data;
+    /// Size of the tensor data in bytes.
+    size_t nbytes;
+    /// Type of the tensor elements.
+    exec_aten::ScalarType scalar_type;
+  };
+
+  /**
+   * EXPERIMENTAL: Lists the tensors whose data the memory plan places in the
+   * Method's memory-planned buffers. Tensors may share memory if they are
+   * not live at the same time.
+   *
+   * @param[out] tensors Array to receive the tensors. May be null if `length`
+   *     is zero.
+   * @param[in] length Number of entries in `tensors`.
+   *
+   * @returns The number of memory-planned tensors. Only the first
+   *     `min(length, <return value>)` entries of `tensors` are written.
+   * @retval Error::InvalidState The Method is not initialized.
+   */
+  ET_EXPERIMENTAL ET_NODISCARD Result<size_t> get_memory_planned_tensors(
+      PlannedTensorData* tensors,
+      size_t length) const;
+
   /// DEPRECATED: Use MethodMeta instead to access metadata, and set_input to
   /// update Method inputs.
   ET_DEPRECATED const EValue& get_input(size_t i) const;
@@ -265,6 +337,8 @@ class Method final {
   struct StepState {
     size_t chain_idx;
     size_t instr_idx;
+    // Whether the last step() failed, leaving execution mid-Method.
+    bool failed;
   };
 
   Method(
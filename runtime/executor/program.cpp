@@ -282,6 +282,52 @@ Result<MethodMeta> Program::method_meta(const char* method_name) const {
   return MethodMeta(plan.get());
 }
 
+Result<size_t> Program::get_method_segments(
+    const char* method_name,
+    SegmentRange* segments,
+    size_t length) const {
+  auto plan = get_execution_plan(internal_program_, method_name);
+  if (!plan.ok()) {
+    return plan.error();
+  }
+  const auto* delegates = plan.get()->delegates();
+  if (delegates == nullptr || loader_ == nullptr ||
+      segment_base_offset_ == 0) {
+    return 0;
+  }
+  const size_t num_segments = internal_program_->segments()->size();
+  size_t count = 0;
+  // Method::init() initializes the delegates in this order.
+  for (size_t i = 0; i < delegates->size(); ++i) {
+    const auto* delegate = delegates->Get(i);
+    const auto* processed = delegate->processed();
+    if (processed == nullptr ||
+        processed->location() !=
+            executorch_flatbuffer::DataLocation::SEGMENT) {
+      continue;
+    }
+    ET_CHECK_OR_RETURN_ERROR(
+        processed->index() < num_segments,
+        InvalidProgram,
+        "Segment index %u out of range (>= %zu)",
+        processed->index(),
+        num_segments);
+    if (count < length) {
+      const auto* segment = internal_program_->segments()->Get(
+          processed->index());
+      segments[count] = SegmentRange{
+          segment_base_offset_ + static_cast<size_t>(segment->offset()),
+          static_cast<size_t>(segment->size()),
+          DataLoader::SegmentInfo(
+              DataLoader::SegmentInfo::Type::Backend,
+              processed->index(),
+              delegate->id()->c_str())};
+    }
+    count++;
+  }
+  return count;
+}
+
 Result<const void*> Program::get_constant_buffer_data(
     size_t buffer_index,
     size_t nbytes) const {
@@ -141,6 +141,40 @@ class Program final {
    */
   Result<MethodMeta> method_meta(const char* method_name) const;
 
+  /**
+   * EXPERIMENTAL: A segment of the program data that load_method() reads
+   * through the DataLoader.
+   */
+  struct SegmentRange {
+    /// Byte offset of the segment within the program data.
+    size_t offset;
+    /// Size of the segment in bytes.
+    size_t size;
+    /// The SegmentInfo that load_method() passes to DataLoader::load(). Its
+    /// descriptor is owned by the Program.
+    DataLoader::SegmentInfo segment_info;
+  };
+
+  /**
+   * EXPERIMENTAL: Lists the segments that load_method() reads for the named
+   * method, in the order it reads them, so that a DataLoader can start
+   * reading them ahead of time. These are the delegate blobs stored outside
+   * the flatbuffer; the constant segment is read by load() itself.
+   *
+   * @param[in] method_name The name of the method.
+   * @param[out] segments Array to receive the segments. May be null if
+   *     `length` is zero.
+   * @param[in] length Number of entries in `segments`.
+   *
+   * @returns The number of segments the method reads. Only the first
+   *     `min(length, <return value>)` entries of `segments` are written.
+   * @retval Error::InvalidArgument There is no method with that name.
+   */
+  ET_EXPERIMENTAL ET_NODISCARD Result<size_t> get_method_segments(
+      const char* method_name,
+      SegmentRange* segments,
+      size_t length) const;
+
   /**
    * DEPRECATED: Get the pytree encoding string for the output. Deprecated as
    * this functionality will eventually move out of the core program into a
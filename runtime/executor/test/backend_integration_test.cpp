@@ -14,6 +14,7 @@
 
 #include <executorch/extension/data_loader/buffer_data_loader.h>
 #include <executorch/extension/data_loader/file_data_loader.h>
+#include <executorch/extension/data_loader/prefetching_file_data_loader.h>
 #include <executorch/extension/runner_util/inputs.h>
 #include <executorch/runtime/backend/interface.h>
 #include <executorch/runtime/core/error.h>
@@ -43,6 +44,7 @@ using executorch::runtime::Method;
 using executorch::runtime::Program;
 using executorch::runtime::Result;
 using executorch::runtime::testing::ManagedMemoryManager;
+using executorch::extension::PrefetchingFileDataLoader;
 using torch::executor::util::FileDataLoader;
 
 /**
@@ -530,6 +532,83 @@ TEST_P(BackendIntegrationTest, SegmentInfoIsPassedIntoDataLoader) {
   EXPECT_EQ(backend_load_was_called, using_segments());
 }
 
+TEST_P(BackendIntegrationTest, GetMethodSegmentsListsBackendLoads) {
+  Result<FileDataLoader> loader = FileDataLoader::from(program_path());
+  ASSERT_EQ(loader.error(), Error::Ok);
+  DataLoaderSpy spy_loader(&loader.get());
+  Result<Program> program = Program::load(&spy_loader);
+  ASSERT_EQ(program.error(), Error::Ok);
+
+  Result<size_t> num_segments =
+      program->get_method_segments("forward", nullptr, 0);
+  ASSERT_EQ(num_segments.error(), Error::Ok);
+  EXPECT_EQ(*num_segments > 0, using_segments());
+  std::vector<Program::SegmentRange> segments(*num_segments);
+  Result<size_t> written = program->get_method_segments(
+      "forward", segments.data(), segments.size());
+  ASSERT_EQ(written.error(), Error::Ok);
+  EXPECT_EQ(*written, segments.size());
+  EXPECT_EQ(
+      program->get_method_segments("not_a_method", nullptr, 0).error(),
+      Error::InvalidArgument);
+
+  // load_method() reads exactly the listed segments, in order.
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  const size_t first_op = spy_loader.operations().size();
+  Result<Method> method = program->load_method("forward", &mmm.get());
+  ASSERT_EQ(method.error(), Error::Ok);
+  std::vector<const DataLoaderSpy::Operation*> backend_loads;
+  for (size_t i = first_op; i < spy_loader.operations().size(); ++i) {
+    const auto& op = spy_loader.operations()[i];
+    if (op.op == DataLoaderSpy::Operation::Load &&
+        op.segment_info->segment_type ==
+            DataLoader::SegmentInfo::Type::Backend) {
+      backend_loads.push_back(&op);
+    }
+  }
+  ASSERT_EQ(backend_loads.size(), segments.size());
+  for (size_t i = 0; i < segments.size(); ++i) {
+    EXPECT_EQ(backend_loads[i]->offset, segments[i].offset);
+    EXPECT_EQ(backend_loads[i]->size, segments[i].size);
+    EXPECT_EQ(
+        backend_loads[i]->segment_info->segment_index,
+        segments[i].segment_info.segment_index);
+    EXPECT_STREQ(
+        backend_loads[i]->segment_info->descriptor,
+        segments[i].segment_info.descriptor);
+  }
+}
+
+TEST_P(BackendIntegrationTest, PrefetchedMethodSegmentsLoad) {
+  const void* processed_data = nullptr;
+  size_t processed_size = 0;
+  StubBackend::singleton().install_init(
+      [&](FreeableBuffer* processed,
+          ET_UNUSED ArrayRef<CompileSpec> compile_specs,
+          ET_UNUSED BackendInitContext& backend_init_context)
+          -> Result<DelegateHandle*> {
+        processed_data = processed->data();
+        processed_size = processed->size();
+        return nullptr;
+      });
+
+  Result<PrefetchingFileDataLoader> loader =
+      PrefetchingFileDataLoader::from(program_path());
+  ASSERT_EQ(loader.error(), Error::Ok);
+  Result<Program> program = Program::load(&loader.get());
+  ASSERT_EQ(program.error(), Error::Ok);
+  ASSERT_EQ(loader->prefetch_method(*program, "forward"), Error::Ok);
+  EXPECT_EQ(
+      loader->prefetch_method(*program, "not_a_method"),
+      Error::InvalidArgument);
+
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> method = program->load_method("forward", &mmm.get());
+  ASSERT_EQ(method.error(), Error::Ok);
+  EXPECT_NE(processed_data, nullptr);
+  EXPECT_GT(processed_size, 0);
+}
+
 TEST_P(BackendIntegrationTest, GetMethodNameDuringInitSuccess) {
   Result<FileDataLoader> loader = FileDataLoader::from(program_path());
   ASSERT_EQ(loader.error(), Error::Ok);
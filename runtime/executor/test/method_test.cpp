@@ -6,8 +6,10 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <algorithm>
 #include <cstdlib>
 #include <filesystem>
+#include <vector>
 
 #include <executorch/extension/data_loader/file_data_loader.h>
 #include <executorch/extension/runner_util/inputs.h>
@@ -292,6 +294,97 @@ TEST_F(MethodTest, ConstantBufferTest) {
   ASSERT_EQ(err, Error::Ok);
 }
 
+TEST_F(MethodTest, GetConstantDataTest) {
+  // ModuleLinear computes a * x + b, with 2x2 float constants a = 3 and b = 2,
+  // stored in the constant segment or in the program flatbuffer.
+  for (const char* name : {"linear", "linear_constant_buffer"}) {
+    ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+    Result<Method> method = programs_[name]->load_method("forward", &mmm.get());
+    ASSERT_EQ(method.error(), Error::Ok);
+
+    std::vector<float> constant_values;
+    for (size_t index = 0; index < method->num_instructions(); ++index) {
+      // A null array with zero length only counts the constants.
+      Result<size_t> num_constants =
+          method->get_constant_data(index, nullptr, 0);
+      ASSERT_EQ(num_constants.error(), Error::Ok);
+      if (num_constants.get() == 0) {
+        continue;
+      }
+
+      std::vector<Method::ConstantData> constants(num_constants.get());
+      Result<size_t> written = method->get_constant_data(
+          index, constants.data(), constants.size());
+      ASSERT_EQ(written.error(), Error::Ok);
+      EXPECT_EQ(written.get(), num_constants.get());
+      for (const auto& constant : constants) {
+        ASSERT_NE(constant.data, nullptr);
+        ASSERT_EQ(constant.nbytes, 4 * sizeof(float));
+        const float* data = static_cast<const float*>(constant.data);
+        for (size_t i = 1; i < 4; ++i) {
+          EXPECT_EQ(data[i], data[0]);
+        }
+        constant_values.push_back(data[0]);
+      }
+
+      // Only as many entries as fit are written, but all are counted. Each
+      // instruction of ModuleLinear reads a single constant, so this writes
+      // none.
+      Method::ConstantData sentinel = {nullptr, 123};
+      std::vector<Method::ConstantData> truncated(constants.size(), sentinel);
+      Result<size_t> counted = method->get_constant_data(
+          index, truncated.data(), constants.size() - 1);
+      ASSERT_EQ(counted.error(), Error::Ok);
+      EXPECT_EQ(counted.get(), constants.size());
+      for (size_t i = 0; i + 1 < constants.size(); ++i) {
+        EXPECT_EQ(truncated[i].data, constants[i].data);
+        EXPECT_EQ(truncated[i].nbytes, constants[i].nbytes);
+      }
+      EXPECT_EQ(truncated.back().data, nullptr);
+      EXPECT_EQ(truncated.back().nbytes, 123);
+    }
+    std::sort(constant_values.begin(), constant_values.end());
+    EXPECT_EQ(constant_values, std::vector<float>({2.f, 3.f}));
+
+    Method::ConstantData constant;
+    EXPECT_EQ(
+        method->get_constant_data(method->num_instructions(), &constant, 1)
+            .error(),
+        Error::InvalidArgument);
+    EXPECT_EQ(
+        method->get_constant_data(0, nullptr, 1).error(),
+        Error::InvalidArgument);
+  }
+}
+
+TEST_F(MethodTest, GetConstantDataListsOptionalTensorListItems) {
+  // ModuleIndex computes x[1::2, torch.tensor([1, 2])]. The constant index
+  // tensor is an element of the optional tensor list passed to index.Tensor,
+  // next to a None.
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> method =
+      programs_["index"]->load_method("forward", &mmm.get());
+  ASSERT_EQ(method.error(), Error::Ok);
+
+  std::vector<Method::ConstantData> constants;
+  for (size_t index = 0; index < method->num_instructions(); ++index) {
+    Method::ConstantData instruction_constants[4];
+    Result<size_t> num_constants =
+        method->get_constant_data(index, instruction_constants, 4);
+    ASSERT_EQ(num_constants.error(), Error::Ok);
+    ASSERT_LE(num_constants.get(), 4);
+    constants.insert(
+        constants.end(),
+        instruction_constants,
+        instruction_constants + num_constants.get());
+  }
+  ASSERT_EQ(constants.size(), 1);
+  ASSERT_EQ(constants[0].nbytes, 2 * sizeof(int64_t));
+  const int64_t* data = static_cast<const int64_t*>(constants[0].data);
+  EXPECT_EQ(data[0], 1);
+  EXPECT_EQ(data[1], 2);
+}
+
 /*
  * TODO(T161163608): Test is disabled due to a resize bug in tensor_index_out of
  * the portable op lib
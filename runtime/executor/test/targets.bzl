@@ -139,6 +139,9 @@ def define_common_targets(is_fbcode = False):
                 "//executorch/kernels/portable:generated_lib",
             ],
             env = modules_env,
+            compiler_flags = [
+                "-Wno-error=deprecated-declarations",
+            ],
         )
 
         runtime.cxx_test(
@@ -210,6 +213,7 @@ def define_common_targets(is_fbcode = False):
                 "//executorch/runtime/executor:program",
                 "//executorch/extension/data_loader:buffer_data_loader",
                 "//executorch/extension/data_loader:file_data_loader",
+                "//executorch/extension/data_loader:prefetching_file_data_loader",
                 "//executorch/extension/runner_util:inputs",
             ],
             env = {
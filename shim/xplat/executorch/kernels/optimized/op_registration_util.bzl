@@ -12,6 +12,82 @@ load(
     "get_vec_preprocessor_flags",
 )
 
+# Compiler flags for each CPU capability level above DEFAULT. The level's name
+# selects the REGISTER_DISPATCH slot and the vec specializations; see
+# kernels/optimized/utils/dispatch_stub.h.
+_CPU_CAPABILITY_COMPILER_FLAGS = {
+    "AVX2": ["-mavx2", "-mfma"],
+    "AVX512": ["-mavx512f", "-mavx512bw", "-mavx512vl", "-mavx512dq", "-mfma"],
+}
+
+def define_dispatch_library(name, srcs, exported_headers, deps = []):
+    """Defines a cxx_library whose sources are compiled once per CPU capability.
+
+    The sources register kernels with REGISTER_DISPATCH. The library itself
+    holds the DEFAULT variant. The AVX2 and AVX512 vec specializations call
+    sleef, which is not vendored, so the variants for those levels are only
+    built on x86-64 when the executorch.sleef_dep buckconfig names a sleef
+    library to link.
+
+    Args:
+        name: The name of the target.
+        srcs: Sources to compile for each capability level. They should only
+            depend on the vec library, since everything they include is
+            compiled with the level's instruction set.
+        exported_headers: Headers that declare the stubs.
+        deps: Optional extra deps for every variant.
+    """
+    variant_deps = deps + [
+        "//executorch/kernels/optimized:libvec",
+        "//executorch/kernels/optimized:libutils",
+        "//executorch/runtime/core/exec_aten:lib",
+    ]
+
+    capability_targets = []
+    sleef_dep = native.read_config("executorch", "sleef_dep", None)
+    if sleef_dep != None:
+        for capability, capability_flags in _CPU_CAPABILITY_COMPILER_FLAGS.items():
+            capability_name = "{}_{}".format(name, capability.lower())
+            runtime.cxx_library(
+                name = capability_name,
+                srcs = srcs,
+                headers = exported_headers,
+                compiler_flags = ["-Wno-missing-prototypes"] + capability_flags,
+                preprocessor_flags = [
+                    "-DCPU_CAPABILITY={}".format(capability),
+                    "-DCPU_CAPABILITY_{}".format(capability),
+                ],
+                exported_preprocessor_flags = [
+                    "-DET_HAVE_{}_CPU_DEFINITION".format(capability),
+                ],
+                visibility = ["//executorch/kernels/optimized/..."],
+                deps = variant_deps + [sleef_dep],
+            )
+            capability_targets.append(":" + capability_name)
+
+    runtime.cxx_library(
+        name = name,
+        srcs = srcs,
+        exported_headers = exported_headers,
+        compiler_flags = ["-Wno-missing-prototypes"],
+        preprocessor_flags = get_vec_preprocessor_flags(),
+        visibility = ["//executorch/kernels/optimized/..."],
+        exported_deps = variant_deps + select({
+            "DEFAULT": [],
+            "ovr_config//cpu:x86_64": capability_targets,
+        }),
+        # Like op targets, the DEFAULT variant needs sleef as a direct
+        # dependency on Android; see define_op_library().
+        fbandroid_platform_deps = [
+            (
+                "^android-arm64.*$",
+                [
+                    "fbsource//third-party/sleef:sleef_arm",
+                ],
+            ),
+        ],
+    )
+
 def op_target(name, deps = []):
     """Registers an optimized implementation for an operator overload group.
 
@@ -133,6 +209,5 @@ def define_op_target(name, deps):
     )
 
 def is_op_disabled(name):
-    # TODO (gjcomer) Enable ops with sleef dependency in OSS
-    disabled_ops = ["op_gelu", "op_log_softmax"]
-    return name in disabled_ops
+    # All ops are enabled for OSS builds.
+    return False
@@ -103,6 +103,19 @@ class ModuleAddHalf(nn.Module):
         )
 
 
+class ModuleAddLarge(nn.Module):
+    """Like ModuleAdd, with memory-planned buffers that span many KiB."""
+
+    def __init__(self):
+        super().__init__()
+
+    def forward(self, x, y):
+        return torch.add(x, y)
+
+    def get_random_inputs(self):
+        return (torch.randn(32, 64), torch.randn(32, 64))
+
+
 class ModuleDynamicCatUnallocatedIO(nn.Module):
     def __init__(self):
         super(ModuleDynamicCatUnallocatedIO, self).__init__()
@@ -145,6 +158,27 @@ class ModuleLinear(torch.nn.Module):
         return (torch.ones(2, 2, dtype=torch.float),)
 
 
+class ModuleStateful(nn.Module):
+    """A text decoder with an explicit state, as run by the LLM runner's
+    StatefulTextDecoderRunner: forward(tokens, start_pos, state) returns the
+    logits and the new state. The state is the sum of the tokens so far."""
+
+    def __init__(self):
+        super().__init__()
+
+    def forward(self, tokens: torch.Tensor, start_pos: torch.Tensor, state):
+        new_state = state + tokens
+        logits = torch.mul(new_state, 2.0).reshape(1, 1, 4)
+        return logits, new_state
+
+    def get_random_inputs(self):
+        return (
+            torch.tensor([[1]], dtype=torch.long),
+            torch.tensor([0], dtype=torch.long),
+            torch.zeros(1, 4),
+        )
+
+
 class ModuleMultipleEntry(torch.nn.Module):
     def __init__(self):
         super().__init__()
@@ -61,12 +61,14 @@ def define_common_targets():
     MODULES_TO_EXPORT = [
         "ModuleAdd",
         "ModuleAddHalf",
+        "ModuleAddLarge",
         "ModuleBasic",
         "ModuleLinear",
         "ModuleMultipleEntry",
         "ModuleIndex",
         "ModuleDynamicCatUnallocatedIO",
         "ModuleSimpleTrain",
+        "ModuleStateful",
     ]
 
     # Generates Executorch .pte program files for various modules at build time.